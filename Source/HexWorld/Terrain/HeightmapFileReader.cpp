@@ -0,0 +1,177 @@
+//
+// (C) Copyright 2024 Dirk Michael
+// dirkmichaelnm@gmail.com
+//
+
+#include "HeightmapFileReader.h"
+
+#include "IImageWrapper.h"
+#include "IImageWrapperModule.h"
+#include "Async/ParallelFor.h"
+#include "HAL/PlatformFileManager.h"
+
+// Defines the log category of this class.
+DEFINE_LOG_CATEGORY(HeightmapFileReader)
+
+// The factor that scales a 16 bit sample to the 8 bit range, 65535 / 257 = 255
+#define SAMPLE_16_TO_8 257
+
+/**
+ * Maps the specified heightmap file and determines its size.
+ *
+ * @param Filename The name of the heightmap file.
+ * @param Format The format of the file, it is detected by the file extension if it is set to auto.
+ * @param RawWidth The width of a raw heightmap counted in pixels, zero for a square heightmap.
+ */
+FHeightmapFileReader::FHeightmapFileReader(const FString& Filename, const EHeightmapFormat Format,
+                                           const int32 RawWidth)
+{
+	Samples = nullptr;
+	BytesPerSample = 1;
+	SizeX = 0;
+	SizeY = 0;
+
+	// Map the whole file
+	MappedFile = TUniquePtr<IMappedFileHandle>(FPlatformFileManager::Get().GetPlatformFile().OpenMapped(*Filename));
+	if (!MappedFile.IsValid() || MappedFile->GetFileSize() <= 0)
+	{
+		UE_LOG(HeightmapFileReader, Warning, TEXT("Heightmap file %s could not be opened."), *Filename);
+		return;
+	}
+	MappedRegion = TUniquePtr<IMappedFileRegion>(MappedFile->MapRegion(0, MappedFile->GetFileSize()));
+	if (!MappedRegion.IsValid())
+	{
+		UE_LOG(HeightmapFileReader, Warning, TEXT("Heightmap file %s could not be mapped."), *Filename);
+		return;
+	}
+
+	// Interpret the mapped data according to the format
+	switch (Format == AutoFormat ? DetectFormat(Filename) : Format)
+	{
+	case PngFormat:
+		InitPng(Filename);
+		break;
+	case RawR16Format:
+		BytesPerSample = 2;
+		InitRaw(Filename, RawWidth);
+		break;
+	default:
+		InitRaw(Filename, RawWidth);
+		break;
+	}
+}
+
+/**
+ * Converts the pixels into tile heights, the rows are converted in parallel. 16 bit samples are scaled to the
+ * 8 bit range first, so the height factor has the same meaning for both sample sizes. Z = Value / HeightFactor.
+ *
+ * @param HeightFactor The factor used to calculate the height of a tile from the value of a pixel.
+ * @param SeaLevel The height that defines the sea level, it is subtracted from every height.
+ *
+ * @return The height grid, empty if the file is invalid.
+ */
+FHexHeightGrid FHeightmapFileReader::ReadHeights(const int32 HeightFactor, const int32 SeaLevel) const
+{
+	if (!IsValid())
+	{
+		return FHexHeightGrid();
+	}
+	auto HeightGrid = FHexHeightGrid(SizeX, SizeY);
+	const auto Divisor = FMath::Max(HeightFactor, 1) * (BytesPerSample == 2 ? SAMPLE_16_TO_8 : 1);
+	// Every row writes its own tiles, so the rows can be converted in parallel
+	ParallelFor(SizeY, [this, &HeightGrid, Divisor, SeaLevel](const int32 Y)
+	{
+		const auto Row = Samples + static_cast<int64>(Y) * SizeX * BytesPerSample;
+		for (auto X = 0; X < SizeX; X++)
+		{
+			// The 16 bit samples are stored little endian
+			const auto Value = BytesPerSample == 2 ? Row[X * 2] | Row[X * 2 + 1] << 8 : Row[X];
+			HeightGrid.SetHeight(X, Y, Value / Divisor - SeaLevel);
+		}
+	});
+	return HeightGrid;
+}
+
+/**
+ * Returns the format of the specified file according to its extension.
+ *
+ * @param Filename The name of the heightmap file.
+ *
+ * @return The format, raw 8 bit for unknown extensions.
+ */
+EHeightmapFormat FHeightmapFileReader::DetectFormat(const FString& Filename)
+{
+	const auto Extension = FPaths::GetExtension(Filename);
+	if (Extension.Equals(TEXT("png"), ESearchCase::IgnoreCase))
+	{
+		return PngFormat;
+	}
+	if (Extension.Equals(TEXT("r16"), ESearchCase::IgnoreCase)
+		|| Extension.Equals(TEXT("raw16"), ESearchCase::IgnoreCase))
+	{
+		return RawR16Format;
+	}
+	return RawR8Format;
+}
+
+/**
+ * Determines the size of a raw heightmap from the size of the mapped region.
+ *
+ * @param Filename The name of the heightmap file.
+ * @param RawWidth The width of the heightmap counted in pixels, zero for a square heightmap.
+ */
+void FHeightmapFileReader::InitRaw(const FString& Filename, const int32 RawWidth)
+{
+	// A raw file contains nothing but the samples
+	const auto SampleCount = MappedRegion->GetMappedSize() / BytesPerSample;
+	const auto Width = RawWidth > 0 ? static_cast<int64>(RawWidth) : FMath::FloorToInt64(FMath::Sqrt(SampleCount));
+	const auto Length = Width > 0 ? SampleCount / Width : 0;
+	if (Width == 0 || Width * Length * BytesPerSample != MappedRegion->GetMappedSize() || Length > MAX_int32
+		|| Width * Length > MAX_int32)
+	{
+		UE_LOG(HeightmapFileReader, Warning, TEXT("Size of raw heightmap file %s does not match a width of %lld."),
+		       *Filename, Width);
+		return;
+	}
+	SizeX = Width;
+	SizeY = Length;
+	Samples = MappedRegion->GetMappedPtr();
+
+	// Log
+	UE_LOG(HeightmapFileReader, Display, TEXT("Raw heightmap %s mapped (%d x %d, %d bit)."), *Filename, SizeX, SizeY,
+	       BytesPerSample * 8);
+}
+
+/**
+ * Decodes the mapped PNG file.
+ *
+ * @param Filename The name of the heightmap file.
+ */
+void FHeightmapFileReader::InitPng(const FString& Filename)
+{
+	// Decode straight from the mapped pages, colour images are converted to gray
+	auto& ImageWrapperModule = FModuleManager::LoadModuleChecked<IImageWrapperModule>(TEXT("ImageWrapper"));
+	const auto ImageWrapper = ImageWrapperModule.CreateImageWrapper(EImageFormat::PNG);
+	if (!ImageWrapper.IsValid() || !ImageWrapper->SetCompressed(MappedRegion->GetMappedPtr(),
+	                                                            MappedRegion->GetMappedSize()))
+	{
+		UE_LOG(HeightmapFileReader, Warning, TEXT("Heightmap file %s is no valid PNG file."), *Filename);
+		return;
+	}
+	BytesPerSample = ImageWrapper->GetBitDepth() > 8 ? 2 : 1;
+	if (!ImageWrapper->GetRaw(ERGBFormat::Gray, BytesPerSample * 8, DecodedData))
+	{
+		UE_LOG(HeightmapFileReader, Warning, TEXT("Heightmap file %s could not be decoded."), *Filename);
+		return;
+	}
+	SizeX = ImageWrapper->GetWidth();
+	SizeY = ImageWrapper->GetHeight();
+	Samples = DecodedData.GetData();
+	// The compressed data is not needed anymore
+	MappedRegion.Reset();
+	MappedFile.Reset();
+
+	// Log
+	UE_LOG(HeightmapFileReader, Display, TEXT("PNG heightmap %s decoded (%d x %d, %d bit)."), *Filename, SizeX, SizeY,
+	       BytesPerSample * 8);
+}
@@ -0,0 +1,125 @@
+//
+// (C) Copyright 2024 Dirk Michael
+// dirkmichaelnm@gmail.com
+//
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HeightmapFormat.h"
+#include "HexHeightGrid.h"
+#include "Async/MappedFileHandle.h"
+
+// Defines the log category of this class.
+DECLARE_LOG_CATEGORY_EXTERN(HeightmapFileReader, Log, All);
+
+/**
+ * This class reads the heights of the tiles from a heightmap file without any texture. Raw files are memory mapped
+ * and converted directly from the mapped pages, PNG files are mapped and decoded into a single buffer. Every pixel
+ * of the heightmap is a tile.
+ */
+class HEXWORLD_API FHeightmapFileReader
+{
+public:
+	/**
+	 * Maps the specified heightmap file and determines its size.
+	 *
+	 * @param Filename The name of the heightmap file.
+	 * @param Format The format of the file, it is detected by the file extension if it is set to auto.
+	 * @param RawWidth The width of a raw heightmap counted in pixels, zero for a square heightmap.
+	 */
+	FHeightmapFileReader(const FString& Filename, const EHeightmapFormat Format, const int32 RawWidth);
+
+	/**
+	 * Returns <b>true</b>, if the file exists and its size matches its format.
+	 *
+	 * @return The validity flag.
+	 */
+	FORCEINLINE bool IsValid() const { return Samples != nullptr; }
+
+	/**
+	 * Returns the width of the heightmap counted in pixels.
+	 *
+	 * @return The width.
+	 */
+	FORCEINLINE int32 GetSizeX() const { return SizeX; }
+
+	/**
+	 * Returns the length of the heightmap counted in pixels.
+	 *
+	 * @return The length.
+	 */
+	FORCEINLINE int32 GetSizeY() const { return SizeY; }
+
+	/**
+	 * Converts the pixels into tile heights, the rows are converted in parallel. 16 bit samples are scaled to the
+	 * 8 bit range first, so the height factor has the same meaning for both sample sizes. Z = Value / HeightFactor.
+	 *
+	 * @param HeightFactor The factor used to calculate the height of a tile from the value of a pixel.
+	 * @param SeaLevel The height that defines the sea level, it is subtracted from every height.
+	 *
+	 * @return The height grid, empty if the file is invalid.
+	 */
+	FHexHeightGrid ReadHeights(const int32 HeightFactor, const int32 SeaLevel) const;
+
+	/**
+	 * Returns the format of the specified file according to its extension.
+	 *
+	 * @param Filename The name of the heightmap file.
+	 *
+	 * @return The format, raw 8 bit for unknown extensions.
+	 */
+	static EHeightmapFormat DetectFormat(const FString& Filename);
+
+private:
+	/**
+	 * The handle of the mapped file.
+	 */
+	TUniquePtr<IMappedFileHandle> MappedFile;
+
+	/**
+	 * The mapped region covering the whole file.
+	 */
+	TUniquePtr<IMappedFileRegion> MappedRegion;
+
+	/**
+	 * The decoded pixels of a PNG file.
+	 */
+	TArray64<uint8> DecodedData;
+
+	/**
+	 * Pointer to the first pixel, either in the mapped region or in the decoded data, or <i>nullptr</i>, if the file
+	 * is invalid.
+	 */
+	const uint8* Samples;
+
+	/**
+	 * The number of bytes of a pixel, 1 or 2.
+	 */
+	int32 BytesPerSample;
+
+	/**
+	 * The width of the heightmap counted in pixels.
+	 */
+	int32 SizeX;
+
+	/**
+	 * The length of the heightmap counted in pixels.
+	 */
+	int32 SizeY;
+
+	/**
+	 * Determines the size of a raw heightmap from the size of the mapped region.
+	 *
+	 * @param Filename The name of the heightmap file.
+	 * @param RawWidth The width of the heightmap counted in pixels, zero for a square heightmap.
+	 */
+	void InitRaw(const FString& Filename, const int32 RawWidth);
+
+	/**
+	 * Decodes the mapped PNG file.
+	 *
+	 * @param Filename The name of the heightmap file.
+	 */
+	void InitPng(const FString& Filename);
+};
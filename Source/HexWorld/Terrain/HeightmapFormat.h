@@ -0,0 +1,20 @@
+//
+// (C) Copyright 2024 Dirk Michael
+// dirkmichaelnm@gmail.com
+//
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * This enumeration defines the file formats a heightmap can be read from.
+ */
+UENUM()
+enum EHeightmapFormat
+{
+	AutoFormat = 0 UMETA(DisplayName = "Detect by Extension"),
+	RawR8Format = 1 UMETA(DisplayName = "Raw (8 Bit)"),
+	RawR16Format = 2 UMETA(DisplayName = "Raw (16 Bit, Little Endian)"),
+	PngFormat = 3 UMETA(DisplayName = "PNG (Grayscale)")
+};
@@ -0,0 +1,339 @@
+//
+// (C) Copyright 2024 Dirk Michael
+// dirkmichaelnm@gmail.com
+//
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HexHeightGrid.h"
+
+/**
+ * This class is a boolean layer over the tiles of a hex grid, e.g. water, coast, visible or explored tiles. Every row
+ * is stored in its own 64 bit words, so the combinations of masks, the counting and the iteration process 64 tiles
+ * per operation. The dilation and the erosion shift the rows by the six-neighbour offsets of the offset rows, the
+ * tiles beyond the edge of the grid count as not set.
+ */
+class HEXWORLD_API FHexGridMask
+{
+public:
+	/**
+	 * Creates an empty mask.
+	 */
+	FHexGridMask()
+	{
+		SizeX = 0;
+		SizeY = 0;
+		WordsPerRow = 0;
+	}
+
+	/**
+	 * Creates a mask of the specified size with all bits set to the specified value.
+	 *
+	 * @param InSizeX The width of the grid counted in tiles.
+	 * @param InSizeY The length of the grid counted in tiles.
+	 * @param bValue The initial value of all bits.
+	 */
+	FHexGridMask(const int32 InSizeX, const int32 InSizeY, const bool bValue = false)
+	{
+		SizeX = FMath::Max(InSizeX, 0);
+		SizeY = FMath::Max(InSizeY, 0);
+		WordsPerRow = FMath::DivideAndRoundUp(SizeX, 64);
+		Words.Init(bValue ? ~0ull : 0ull, WordsPerRow * SizeY);
+		ClearPadding();
+	}
+
+	/**
+	 * Creates a mask of all tiles whose height is not above the specified height, e.g. the water with a height of 0.
+	 *
+	 * @param HeightGrid The height grid.
+	 * @param MaximalZ The maximal height of the tiles in the mask.
+	 *
+	 * @return The mask.
+	 */
+	static FHexGridMask CreateFromHeights(const FHexHeightGrid& HeightGrid, const int32 MaximalZ)
+	{
+		auto Mask = FHexGridMask(HeightGrid.GetSizeX(), HeightGrid.GetSizeY());
+		for (auto Y = 0; Y < Mask.SizeY; Y++)
+		{
+			for (auto Word = 0; Word < Mask.WordsPerRow; Word++)
+			{
+				// Collect the bits of a word before storing it
+				auto Bits = 0ull;
+				for (auto Bit = 0; Bit < FMath::Min(64, Mask.SizeX - Word * 64); Bit++)
+				{
+					Bits |= static_cast<uint64>(HeightGrid.GetHeight(Word * 64 + Bit, Y) <= MaximalZ) << Bit;
+				}
+				Mask.Words[Word + Y * Mask.WordsPerRow] = Bits;
+			}
+		}
+		return Mask;
+	}
+
+	/**
+	 * Returns the width of the grid counted in tiles.
+	 *
+	 * @return The width.
+	 */
+	FORCEINLINE int32 GetSizeX() const { return SizeX; }
+
+	/**
+	 * Returns the length of the grid counted in tiles.
+	 *
+	 * @return The length.
+	 */
+	FORCEINLINE int32 GetSizeY() const { return SizeY; }
+
+	/**
+	 * Checks if the specified coordinates are within the grid.
+	 *
+	 * @param X The X coordinate of the tile.
+	 * @param Y The Y coordinate of the tile.
+	 *
+	 * @return If the coordinates are valid then <b>true</b>, otherwise <b>false</b>.
+	 */
+	FORCEINLINE bool Contains(const int32 X, const int32 Y) const { return X >= 0 && X < SizeX && Y >= 0 && Y < SizeY; }
+
+	/**
+	 * Returns the bit of the tile at the specified coordinates.
+	 *
+	 * @param X The X coordinate of the tile.
+	 * @param Y The Y coordinate of the tile.
+	 *
+	 * @return The bit, <b>false</b> for coordinates outside of the grid.
+	 */
+	FORCEINLINE bool Get(const int32 X, const int32 Y) const
+	{
+		return Contains(X, Y) && (Words[(X >> 6) + Y * WordsPerRow] >> (X & 63) & 1) != 0;
+	}
+
+	/**
+	 * Sets the bit of the tile at the specified coordinates, which must be within the grid.
+	 *
+	 * @param X The X coordinate of the tile.
+	 * @param Y The Y coordinate of the tile.
+	 * @param bValue The new value of the bit.
+	 */
+	FORCEINLINE void Set(const int32 X, const int32 Y, const bool bValue)
+	{
+		auto& Word = Words[(X >> 6) + Y * WordsPerRow];
+		Word = bValue ? Word | 1ull << (X & 63) : Word & ~(1ull << (X & 63));
+	}
+
+	/**
+	 * Keeps only the bits that are also set in the other mask of the same size.
+	 *
+	 * @param Other The other mask.
+	 *
+	 * @return This mask.
+	 */
+	FHexGridMask& operator&=(const FHexGridMask& Other)
+	{
+		check(Words.Num() == Other.Words.Num());
+		for (auto Index = 0; Index < Words.Num(); Index++)
+		{
+			Words[Index] &= Other.Words[Index];
+		}
+		return *this;
+	}
+
+	/**
+	 * Adds the bits that are set in the other mask of the same size.
+	 *
+	 * @param Other The other mask.
+	 *
+	 * @return This mask.
+	 */
+	FHexGridMask& operator|=(const FHexGridMask& Other)
+	{
+		check(Words.Num() == Other.Words.Num());
+		for (auto Index = 0; Index < Words.Num(); Index++)
+		{
+			Words[Index] |= Other.Words[Index];
+		}
+		return *this;
+	}
+
+	/**
+	 * Clears the bits that are set in the other mask of the same size.
+	 *
+	 * @param Other The other mask.
+	 *
+	 * @return This mask.
+	 */
+	FHexGridMask& AndNot(const FHexGridMask& Other)
+	{
+		check(Words.Num() == Other.Words.Num());
+		for (auto Index = 0; Index < Words.Num(); Index++)
+		{
+			Words[Index] &= ~Other.Words[Index];
+		}
+		return *this;
+	}
+
+	/**
+	 * Inverts all bits within the grid.
+	 *
+	 * @return This mask.
+	 */
+	FHexGridMask& Invert()
+	{
+		for (auto& Word : Words)
+		{
+			Word = ~Word;
+		}
+		ClearPadding();
+		return *this;
+	}
+
+	/**
+	 * Returns the number of set bits.
+	 *
+	 * @return The bit count.
+	 */
+	int32 CountSetBits() const
+	{
+		auto Count = 0;
+		for (const auto Word : Words)
+		{
+			Count += FMath::CountBits(Word);
+		}
+		return Count;
+	}
+
+	/**
+	 * Returns a mask with the bits of all tiles that are set or have a set neighbour.
+	 *
+	 * @return The dilated mask.
+	 */
+	FHexGridMask Dilate() const
+	{
+		auto Result = FHexGridMask(SizeX, SizeY);
+		for (auto Y = 0; Y < SizeY; Y++)
+		{
+			// Odd rows are shifted by half a tile to the right, so their upper and lower neighbours are X and X + 1,
+			// the neighbours of even rows are X - 1 and X
+			const auto bOdd = (Y & 1) != 0;
+			for (auto Word = 0; Word < WordsPerRow; Word++)
+			{
+				auto Bits = GetWord(Y, Word) | GetLeftNeighbours(Y, Word) | GetRightNeighbours(Y, Word);
+				for (const auto NeighbourY : {Y - 1, Y + 1})
+				{
+					if (NeighbourY >= 0 && NeighbourY < SizeY)
+					{
+						Bits |= GetWord(NeighbourY, Word)
+							| (bOdd ? GetRightNeighbours(NeighbourY, Word) : GetLeftNeighbours(NeighbourY, Word));
+					}
+				}
+				Result.Words[Word + Y * WordsPerRow] = Bits;
+			}
+		}
+		Result.ClearPadding();
+		return Result;
+	}
+
+	/**
+	 * Returns a mask with the bits of all tiles that are set and whose neighbours within the grid are set.
+	 *
+	 * @return The eroded mask.
+	 */
+	FHexGridMask Erode() const
+	{
+		auto Inverted = *this;
+		return Inverted.Invert().Dilate().Invert();
+	}
+
+	/**
+	 * Calls the specified function for the coordinates of every set bit in row-major order.
+	 *
+	 * @param Function The function receiving the X and the Y coordinate.
+	 */
+	template <typename FunctionType>
+	void ForEachSetBit(FunctionType&& Function) const
+	{
+		for (auto Y = 0; Y < SizeY; Y++)
+		{
+			for (auto Word = 0; Word < WordsPerRow; Word++)
+			{
+				// Skip empty words and visit the set bits from the lowest one
+				for (auto Bits = GetWord(Y, Word); Bits != 0; Bits &= Bits - 1)
+				{
+					Function(Word * 64 + static_cast<int32>(FMath::CountTrailingZeros64(Bits)), Y);
+				}
+			}
+		}
+	}
+
+private:
+	/**
+	 * The width of the grid counted in tiles.
+	 */
+	int32 SizeX;
+
+	/**
+	 * The length of the grid counted in tiles.
+	 */
+	int32 SizeY;
+
+	/**
+	 * The number of words of a row.
+	 */
+	int32 WordsPerRow;
+
+	/**
+	 * The bits of all tiles, row by row, the bits beyond the width of the grid are always cleared.
+	 */
+	TArray<uint64> Words;
+
+	/**
+	 * Returns a word of a row.
+	 *
+	 * @param Y The Y coordinate of the row.
+	 * @param Word The index of the word within the row.
+	 *
+	 * @return The word.
+	 */
+	FORCEINLINE uint64 GetWord(const int32 Y, const int32 Word) const { return Words[Word + Y * WordsPerRow]; }
+
+	/**
+	 * Returns a word of a row shifted by one tile, so every bit gets the bit of its left neighbour.
+	 *
+	 * @param Y The Y coordinate of the row.
+	 * @param Word The index of the word within the row.
+	 *
+	 * @return The bits of the neighbours.
+	 */
+	FORCEINLINE uint64 GetLeftNeighbours(const int32 Y, const int32 Word) const
+	{
+		return GetWord(Y, Word) << 1 | (Word > 0 ? GetWord(Y, Word - 1) >> 63 : 0ull);
+	}
+
+	/**
+	 * Returns a word of a row shifted by one tile, so every bit gets the bit of its right neighbour.
+	 *
+	 * @param Y The Y coordinate of the row.
+	 * @param Word The index of the word within the row.
+	 *
+	 * @return The bits of the neighbours.
+	 */
+	FORCEINLINE uint64 GetRightNeighbours(const int32 Y, const int32 Word) const
+	{
+		return GetWord(Y, Word) >> 1 | (Word < WordsPerRow - 1 ? GetWord(Y, Word + 1) << 63 : 0ull);
+	}
+
+	/**
+	 * Clears the bits beyond the width of the grid in the last word of every row.
+	 */
+	void ClearPadding()
+	{
+		if ((SizeX & 63) == 0)
+		{
+			return;
+		}
+		const auto Mask = (1ull << (SizeX & 63)) - 1;
+		for (auto Y = 0; Y < SizeY; Y++)
+		{
+			Words[WordsPerRow - 1 + Y * WordsPerRow] &= Mask;
+		}
+	}
+};
@@ -0,0 +1,268 @@
+//
+// (C) Copyright 2024 Dirk Michael
+// dirkmichaelnm@gmail.com
+//
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "TileDirection.h"
+
+// The height stored in the ghost border around the grid, it marks a missing neighbour
+#define HEX_HEIGHT_NONE MIN_int16
+
+/**
+ * This class contains the heights of all tiles of a terrain. It is a plain container without any dependency to the
+ * object system, so it can be filled and read from any thread. The heights are stored as 16 bit integers surrounded
+ * by a ghost border of one tile, so the six neighbours of every tile can be read with precomputed index offsets
+ * without any bounds check. A missing neighbour has the height HEX_HEIGHT_NONE.
+ */
+class HEXWORLD_API FHexHeightGrid
+{
+public:
+	/**
+	 * Creates an empty grid.
+	 */
+	FHexHeightGrid()
+	{
+		SizeX = 0;
+		SizeY = 0;
+		Stride = 2;
+		InitNeighbourOffsets();
+	}
+
+	/**
+	 * Creates a grid of the specified size with all heights set to zero.
+	 *
+	 * @param InSizeX The width of the grid counted in tiles.
+	 * @param InSizeY The length of the grid counted in tiles.
+	 */
+	FHexHeightGrid(const int32 InSizeX, const int32 InSizeY)
+	{
+		SizeX = FMath::Max(InSizeX, 0);
+		SizeY = FMath::Max(InSizeY, 0);
+		Stride = SizeX + 2;
+		InitNeighbourOffsets();
+		if (SizeX > 0 && SizeY > 0)
+		{
+			// Fill the ghost border and clear the inner tiles
+			Heights.Init(HEX_HEIGHT_NONE, Stride * (SizeY + 2));
+			for (auto Y = 0; Y < SizeY; Y++)
+			{
+				FMemory::Memzero(&Heights[GetIndex(0, Y)], SizeX * sizeof(int16));
+			}
+		}
+	}
+
+	/**
+	 * Returns the width of the grid counted in tiles.
+	 *
+	 * @return The width.
+	 */
+	FORCEINLINE int32 GetSizeX() const { return SizeX; }
+
+	/**
+	 * Returns the length of the grid counted in tiles.
+	 *
+	 * @return The length.
+	 */
+	FORCEINLINE int32 GetSizeY() const { return SizeY; }
+
+	/**
+	 * Returns the number of tiles.
+	 *
+	 * @return The tile count.
+	 */
+	FORCEINLINE int32 Num() const { return SizeX * SizeY; }
+
+	/**
+	 * Returns <b>true</b>, if the grid contains no tiles.
+	 *
+	 * @return The empty flag.
+	 */
+	FORCEINLINE bool IsEmpty() const { return Heights.IsEmpty(); }
+
+	/**
+	 * Checks if the specified coordinates are within the grid.
+	 *
+	 * @param X The X coordinate of the tile.
+	 * @param Y The Y coordinate of the tile.
+	 *
+	 * @return If the coordinates are valid then <b>true</b>, otherwise <b>false</b>.
+	 */
+	FORCEINLINE bool Contains(const int32 X, const int32 Y) const { return X >= 0 && X < SizeX && Y >= 0 && Y < SizeY; }
+
+	/**
+	 * Returns the height of the tile at the specified coordinates, which must be within the grid.
+	 *
+	 * @param X The X coordinate of the tile.
+	 * @param Y The Y coordinate of the tile.
+	 *
+	 * @return The height of the tile.
+	 */
+	FORCEINLINE int32 GetHeight(const int32 X, const int32 Y) const { return Heights[GetIndex(X, Y)]; }
+
+	/**
+	 * Sets the height of the tile at the specified coordinates, which must be within the grid. The height is clamped
+	 * to the range of 16 bit integers.
+	 *
+	 * @param X The X coordinate of the tile.
+	 * @param Y The Y coordinate of the tile.
+	 * @param Z The height of the tile.
+	 */
+	FORCEINLINE void SetHeight(const int32 X, const int32 Y, const int32 Z)
+	{
+		Heights[GetIndex(X, Y)] = FMath::Clamp(Z, HEX_HEIGHT_NONE + 1, MAX_int16);
+	}
+
+	/**
+	 * Returns the height of the neighbour of the tile at the specified coordinates, which must be within the grid.
+	 *
+	 * @param X The X coordinate of the tile.
+	 * @param Y The Y coordinate of the tile.
+	 * @param Direction The direction of the neighbour.
+	 *
+	 * @return The height of the neighbour or HEX_HEIGHT_NONE, if there is no neighbour in that direction.
+	 */
+	FORCEINLINE int32 GetNeighbourHeight(const int32 X, const int32 Y, const ETileDirection Direction) const
+	{
+		return Heights[GetIndex(X, Y) + NeighbourOffsets[Y & 1][Direction]];
+	}
+
+	/**
+	 * Returns the coordinate offset of the neighbour in the specified direction. Odd rows are shifted by half a tile
+	 * to the right, so the offset depends on the parity of the row.
+	 *
+	 * @param Y The Y coordinate of the tile.
+	 * @param Direction The direction of the neighbour.
+	 *
+	 * @return The offset to be added to the coordinates of the tile.
+	 */
+	static FORCEINLINE FIntPoint GetNeighbourOffset(const int32 Y, const ETileDirection Direction)
+	{
+		static const FIntPoint Offsets[2][6] = {
+			{{0, 1}, {1, 0}, {0, -1}, {-1, -1}, {-1, 0}, {-1, 1}},
+			{{1, 1}, {1, 0}, {1, -1}, {0, -1}, {-1, 0}, {0, 1}}
+		};
+		return Offsets[Y & 1][Direction];
+	}
+
+	/**
+	 * Returns the height of the lowest tile.
+	 *
+	 * @return The minimal height, zero for an empty grid.
+	 */
+	int32 GetMinimalHeight() const
+	{
+		auto MinimalZ = IsEmpty() ? 0 : MAX_int32;
+		for (auto Y = 0; Y < SizeY; Y++)
+		{
+			for (auto X = 0; X < SizeX; X++)
+			{
+				MinimalZ = FMath::Min<int32>(MinimalZ, Heights[GetIndex(X, Y)]);
+			}
+		}
+		return MinimalZ;
+	}
+
+	/**
+	 * Returns the height of the highest tile.
+	 *
+	 * @return The maximal height, zero for an empty grid.
+	 */
+	int32 GetMaximalHeight() const
+	{
+		auto MaximalZ = IsEmpty() ? 0 : MIN_int32;
+		for (auto Y = 0; Y < SizeY; Y++)
+		{
+			for (auto X = 0; X < SizeX; X++)
+			{
+				MaximalZ = FMath::Max<int32>(MaximalZ, Heights[GetIndex(X, Y)]);
+			}
+		}
+		return MaximalZ;
+	}
+
+	/**
+	 * Returns the raw storage including the ghost border, e.g. for hashing.
+	 *
+	 * @return The array of heights.
+	 */
+	FORCEINLINE const TArray<int16>& GetData() const { return Heights; }
+
+	/**
+	 * Returns the coordinates of all tiles whose height differs from the height in the specified grid. Both grids
+	 * must have the same size.
+	 *
+	 * @param Other The grid to be compared with.
+	 *
+	 * @return The coordinates of the changed tiles.
+	 */
+	TArray<FIntPoint> FindChangedTiles(const FHexHeightGrid& Other) const
+	{
+		check(SizeX == Other.SizeX && SizeY == Other.SizeY);
+		auto ChangedTiles = TArray<FIntPoint>();
+		for (auto Y = 0; Y < SizeY; Y++)
+		{
+			for (auto X = 0; X < SizeX; X++)
+			{
+				if (Heights[GetIndex(X, Y)] != Other.Heights[GetIndex(X, Y)])
+				{
+					ChangedTiles.Add(FIntPoint(X, Y));
+				}
+			}
+		}
+		return ChangedTiles;
+	}
+
+private:
+	/**
+	 * The width of the grid counted in tiles.
+	 */
+	int32 SizeX;
+
+	/**
+	 * The length of the grid counted in tiles.
+	 */
+	int32 SizeY;
+
+	/**
+	 * The width of a row of the storage including the ghost border.
+	 */
+	int32 Stride;
+
+	/**
+	 * The index offsets of the six neighbours for even and odd rows.
+	 */
+	int32 NeighbourOffsets[2][6];
+
+	/**
+	 * The heights of the tiles surrounded by the ghost border, Index = (X + 1) + (Y + 1) * Stride.
+	 */
+	TArray<int16> Heights;
+
+	/**
+	 * Returns the storage index of the tile at the specified coordinates.
+	 *
+	 * @param X The X coordinate of the tile.
+	 * @param Y The Y coordinate of the tile.
+	 *
+	 * @return The storage index.
+	 */
+	FORCEINLINE int32 GetIndex(const int32 X, const int32 Y) const { return X + 1 + (Y + 1) * Stride; }
+
+	/**
+	 * Calculates the index offsets of the neighbours from the coordinate offsets and the stride.
+	 */
+	void InitNeighbourOffsets()
+	{
+		for (auto Parity = 0; Parity < 2; Parity++)
+		{
+			for (auto Direction = 0; Direction < 6; Direction++)
+			{
+				const auto Offset = GetNeighbourOffset(Parity, static_cast<ETileDirection>(Direction));
+				NeighbourOffsets[Parity][Direction] = Offset.X + Offset.Y * Stride;
+			}
+		}
+	}
+};
@@ -0,0 +1,204 @@
+//
+// (C) Copyright 2024 Dirk Michael
+// dirkmichaelnm@gmail.com
+//
+
+#include "HexMapData.h"
+
+#if WITH_EDITOR
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "Misc/PackageName.h"
+#include "UObject/SavePackage.h"
+#endif
+
+// Defines the log category of this class.
+DEFINE_LOG_CATEGORY(HexMapData)
+
+/**
+ * Default constructor.
+ */
+UHexMapData::UHexMapData()
+{
+	SizeX = 0;
+	SizeY = 0;
+	bEroded = false;
+	// The data is loaded together with the asset, so it is available as soon as an async load completes
+	HeightData.SetBulkDataFlags(BULKDATA_ForceInlinePayload);
+	LayerData.SetBulkDataFlags(BULKDATA_ForceInlinePayload);
+}
+
+/**
+ * Serializes the properties and the bulk data.
+ *
+ * @param Ar The archive.
+ */
+void UHexMapData::Serialize(FArchive& Ar)
+{
+	Super::Serialize(Ar);
+	HeightData.Serialize(Ar, this);
+	LayerData.Serialize(Ar, this);
+}
+
+/**
+ * Creates a height grid from the stored heights.
+ *
+ * @param SeaLevel The height that defines the sea level, it is subtracted from every height.
+ *
+ * @return The height grid.
+ */
+FHexHeightGrid UHexMapData::ReadHeightGrid(const int32 SeaLevel) const
+{
+	const auto TileCount = static_cast<int64>(SizeX) * SizeY;
+	if (TileCount == 0 || HeightData.GetBulkDataSize() != TileCount * sizeof(int16))
+	{
+		UE_LOG(HexMapData, Warning, TEXT("Map data %s contains no valid heights."), *GetName());
+		return FHexHeightGrid();
+	}
+	auto HeightGrid = FHexHeightGrid(SizeX, SizeY);
+	const auto Heights = static_cast<const int16*>(HeightData.LockReadOnly());
+	for (auto Y = 0; Y < SizeY; Y++)
+	{
+		for (auto X = 0; X < SizeX; X++)
+		{
+			HeightGrid.SetHeight(X, Y, Heights[X + Y * SizeX] - SeaLevel);
+		}
+	}
+	HeightData.Unlock();
+	return HeightGrid;
+}
+
+/**
+ * Replaces the stored heights and removes all layers, as they do not match the new size.
+ *
+ * @param HeightGrid The height grid.
+ * @param SeaLevel The height that defines the sea level, it is added to every height.
+ * @param bInEroded If <b>true</b>, the heights are already eroded.
+ */
+void UHexMapData::SetHeightGrid(const FHexHeightGrid& HeightGrid, const int32 SeaLevel, const bool bInEroded)
+{
+	SizeX = HeightGrid.GetSizeX();
+	SizeY = HeightGrid.GetSizeY();
+	bEroded = bInEroded;
+	// Store the heights as 16 bit integers
+	HeightData.Lock(LOCK_READ_WRITE);
+	const auto Heights = static_cast<int16*>(HeightData.Realloc(HeightGrid.Num() * sizeof(int16)));
+	for (auto Index = 0; Index < HeightGrid.Num(); Index++)
+	{
+		const auto Z = HeightGrid.GetHeight(Index % SizeX, Index / SizeX);
+		Heights[Index] = FMath::Clamp(Z + SeaLevel, MIN_int16, MAX_int16);
+	}
+	HeightData.Unlock();
+	// Remove the layers
+	LayerNames.Empty();
+	LayerData.Lock(LOCK_READ_WRITE);
+	LayerData.Realloc(0);
+	LayerData.Unlock();
+	MarkPackageDirty();
+}
+
+/**
+ * Returns the values of the layer with the specified name, Index = X + Y * SizeX.
+ *
+ * @param Name The name of the layer.
+ *
+ * @return The values of the layer, empty if there is no such layer.
+ */
+TArray<uint8> UHexMapData::ReadLayer(const FName& Name) const
+{
+	auto Values = TArray<uint8>();
+	const auto Layer = LayerNames.IndexOfByKey(Name);
+	const auto TileCount = SizeX * SizeY;
+	if (Layer == INDEX_NONE || LayerData.GetBulkDataSize() != static_cast<int64>(LayerNames.Num()) * TileCount)
+	{
+		return Values;
+	}
+	const auto Data = static_cast<const uint8*>(LayerData.LockReadOnly());
+	Values.Append(Data + static_cast<int64>(Layer) * TileCount, TileCount);
+	LayerData.Unlock();
+	return Values;
+}
+
+/**
+ * Adds or replaces the layer with the specified name.
+ *
+ * @param Name The name of the layer.
+ * @param Values The values of the layer, one per tile, Index = X + Y * SizeX.
+ */
+void UHexMapData::SetLayer(const FName& Name, const TArray<uint8>& Values)
+{
+	const auto TileCount = SizeX * SizeY;
+	if (Values.Num() != TileCount)
+	{
+		UE_LOG(HexMapData, Warning, TEXT("Layer %s has %d values, but the map has %d tiles."), *Name.ToString(),
+		       Values.Num(), TileCount);
+		return;
+	}
+	// A new layer is appended at the end of the layer data, the existing layers are kept by the reallocation
+	auto Layer = LayerNames.IndexOfByKey(Name);
+	if (Layer == INDEX_NONE)
+	{
+		Layer = LayerNames.Add(Name);
+	}
+	LayerData.Lock(LOCK_READ_WRITE);
+	const auto Data = static_cast<uint8*>(LayerData.Realloc(static_cast<int64>(LayerNames.Num()) * TileCount));
+	FMemory::Memcpy(Data + static_cast<int64>(Layer) * TileCount, Values.GetData(), TileCount);
+	LayerData.Unlock();
+	MarkPackageDirty();
+}
+
+#if WITH_EDITOR
+/**
+ * Creates a map data asset from the specified height grid and saves its package. An existing asset with the same
+ * name is replaced.
+ *
+ * @param PackagePath The content path of the directory the asset is created in (e.g. /Game/Terrain).
+ * @param AssetName The name of the asset.
+ * @param HeightGrid The height grid.
+ * @param SeaLevel The height that defines the sea level, it is added to every height.
+ * @param bInEroded If <b>true</b>, the heights are already eroded.
+ *
+ * @return The map data or <i>nullptr</i>, if the asset could not be created.
+ */
+UHexMapData* UHexMapData::CreateAsset(const FString& PackagePath, const FString& AssetName,
+                                      const FHexHeightGrid& HeightGrid, const int32 SeaLevel, const bool bInEroded)
+{
+	// Create the package and the map data
+	const auto PackageName = FPaths::Combine(PackagePath, AssetName);
+	const auto Package = CreatePackage(*PackageName);
+	Package->FullyLoad();
+	// The map data saved before may still be loaded, its data is replaced instead of the object
+	auto MapData = FindObject<UHexMapData>(Package, *AssetName);
+	const auto bCreated = MapData == nullptr;
+	if (bCreated)
+	{
+		MapData = NewObject<UHexMapData>(Package, *AssetName, RF_Public | RF_Standalone);
+	}
+	else
+	{
+		MapData->Modify();
+	}
+	MapData->SetHeightGrid(HeightGrid, SeaLevel, bInEroded);
+
+	// Register a new asset and save it
+	if (bCreated)
+	{
+		FAssetRegistryModule::AssetCreated(MapData);
+	}
+	const auto Filename = FPackageName::LongPackageNameToFilename(PackageName,
+	                                                              FPackageName::GetAssetPackageExtension());
+	auto SaveArgs = FSavePackageArgs();
+	SaveArgs.TopLevelFlags = RF_Public | RF_Standalone;
+	if (!UPackage::SavePackage(Package, MapData, *Filename, SaveArgs))
+	{
+		UE_LOG(HexMapData, Error, TEXT("Package %s could not be saved."), *PackageName);
+		return nullptr;
+	}
+
+	// Log
+	UE_LOG(HexMapData, Display, TEXT("Map data %s created (%d x %d tiles)."), *PackageName, MapData->SizeX,
+	       MapData->SizeY);
+
+	// Return the map data
+	return MapData;
+}
+#endif
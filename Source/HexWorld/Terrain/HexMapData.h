@@ -0,0 +1,153 @@
+//
+// (C) Copyright 2024 Dirk Michael
+// dirkmichaelnm@gmail.com
+//
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HexHeightGrid.h"
+#include "Serialization/BulkData.h"
+#include "HexMapData.generated.h"
+
+// Defines the log category of this class.
+DECLARE_LOG_CATEGORY_EXTERN(HexMapData, Log, All);
+
+/**
+ * This asset contains the heights of all tiles of a map and optional layers with one byte per tile, e.g. biomes or
+ * start positions. The data is stored as bulk data that is loaded together with the asset, so the asset can be loaded
+ * asynchronously and is ready to use in cooked builds without any texture.
+ */
+UCLASS(BlueprintType)
+class HEXWORLD_API UHexMapData : public UObject
+{
+	GENERATED_BODY()
+
+public:
+	/**
+	 * Default constructor.
+	 */
+	UHexMapData();
+
+	/**
+	 * Serializes the properties and the bulk data.
+	 *
+	 * @param Ar The archive.
+	 */
+	virtual void Serialize(FArchive& Ar) override;
+
+	/**
+	 * Returns the width of the map counted in tiles.
+	 *
+	 * @return The width.
+	 */
+	FORCEINLINE int32 GetSizeX() const { return SizeX; }
+
+	/**
+	 * Returns the length of the map counted in tiles.
+	 *
+	 * @return The length.
+	 */
+	FORCEINLINE int32 GetSizeY() const { return SizeY; }
+
+	/**
+	 * Returns the names of the layers.
+	 *
+	 * @return The layer names.
+	 */
+	FORCEINLINE const TArray<FName>& GetLayerNames() const { return LayerNames; }
+
+	/**
+	 * Returns <b>true</b>, if the heights were saved from an eroded build and must not be eroded again.
+	 *
+	 * @return The eroded flag.
+	 */
+	FORCEINLINE bool IsEroded() const { return bEroded; }
+
+	/**
+	 * Creates a height grid from the stored heights.
+	 *
+	 * @param SeaLevel The height that defines the sea level, it is subtracted from every height.
+	 *
+	 * @return The height grid.
+	 */
+	FHexHeightGrid ReadHeightGrid(const int32 SeaLevel) const;
+
+	/**
+	 * Replaces the stored heights and removes all layers, as they do not match the new size.
+	 *
+	 * @param HeightGrid The height grid.
+	 * @param SeaLevel The height that defines the sea level, it is added to every height.
+	 * @param bInEroded If <b>true</b>, the heights are already eroded.
+	 */
+	void SetHeightGrid(const FHexHeightGrid& HeightGrid, const int32 SeaLevel, const bool bInEroded);
+
+	/**
+	 * Returns the values of the layer with the specified name, Index = X + Y * SizeX.
+	 *
+	 * @param Name The name of the layer.
+	 *
+	 * @return The values of the layer, empty if there is no such layer.
+	 */
+	TArray<uint8> ReadLayer(const FName& Name) const;
+
+	/**
+	 * Adds or replaces the layer with the specified name.
+	 *
+	 * @param Name The name of the layer.
+	 * @param Values The values of the layer, one per tile, Index = X + Y * SizeX.
+	 */
+	void SetLayer(const FName& Name, const TArray<uint8>& Values);
+
+#if WITH_EDITOR
+	/**
+	 * Creates a map data asset from the specified height grid and saves its package. An existing asset with the same
+	 * name is replaced.
+	 *
+	 * @param PackagePath The content path of the directory the asset is created in (e.g. /Game/Terrain).
+	 * @param AssetName The name of the asset.
+	 * @param HeightGrid The height grid.
+	 * @param SeaLevel The height that defines the sea level, it is added to every height.
+	 * @param bInEroded If <b>true</b>, the heights are already eroded.
+	 *
+	 * @return The map data or <i>nullptr</i>, if the asset could not be created.
+	 */
+	static UHexMapData* CreateAsset(const FString& PackagePath, const FString& AssetName,
+	                                const FHexHeightGrid& HeightGrid, const int32 SeaLevel, const bool bInEroded);
+#endif
+
+private:
+	/**
+	 * The width of the map counted in tiles.
+	 */
+	UPROPERTY(VisibleAnywhere, Category = "Map Data")
+	int32 SizeX;
+
+	/**
+	 * The length of the map counted in tiles.
+	 */
+	UPROPERTY(VisibleAnywhere, Category = "Map Data")
+	int32 SizeY;
+
+	/**
+	 * The names of the layers in the order of their values in the layer data.
+	 */
+	UPROPERTY(VisibleAnywhere, Category = "Map Data")
+	TArray<FName> LayerNames;
+
+	/**
+	 * If <b>true</b>, the heights were saved from an eroded build, so the erosion is skipped when they are read.
+	 */
+	UPROPERTY(VisibleAnywhere, Category = "Map Data")
+	bool bEroded;
+
+	/**
+	 * The heights of the tiles as 16 bit integers, Index = X + Y * SizeX.
+	 */
+	FByteBulkData HeightData;
+
+	/**
+	 * The values of all layers with one byte per tile, one layer after the other.
+	 */
+	FByteBulkData LayerData;
+};
@@ -0,0 +1,164 @@
+//
+// (C) Copyright 2024 Dirk Michael
+// dirkmichaelnm@gmail.com
+//
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * This class is the counter-based random generator of all generation code. A random value is a pure function of the
+ * seed, the stream and a counter, e.g. the index of a tile and the number of the draw for that tile, so it does not
+ * depend on the order of the calls or the thread count. The generator has no mutable state and can be used from any
+ * thread. The values are generated with the Squares algorithm, which needs four multiplications per value.
+ */
+class HEXWORLD_API FHexRandom
+{
+public:
+	/**
+	 * Creates a generator for the specified seed and stream. Different streams of the same seed are independent, e.g.
+	 * one stream for the heights and one for the decoration.
+	 *
+	 * @param Seed The seed.
+	 * @param Stream The ID of the stream.
+	 */
+	FHexRandom(const int32 Seed, const uint32 Stream)
+	{
+		// Mix the seed and the stream into a key with well distributed bits, the key has to be odd
+		Key = Mix(static_cast<uint64>(static_cast<uint32>(Seed)) << 32 | Stream) | 1ull;
+	}
+
+	/**
+	 * Combines the index of an item, e.g. a tile, and the number of a draw for that item into a counter.
+	 *
+	 * @param Index The index of the item.
+	 * @param Draw The number of the draw.
+	 *
+	 * @return The counter.
+	 */
+	static FORCEINLINE uint64 MakeCounter(const int32 Index, const uint32 Draw)
+	{
+		return static_cast<uint64>(static_cast<uint32>(Index)) << 32 | Draw;
+	}
+
+	/**
+	 * Returns the random value for the specified counter.
+	 *
+	 * @param Counter The counter.
+	 *
+	 * @return The random value.
+	 */
+	FORCEINLINE uint32 GetUInt32(const uint64 Counter) const
+	{
+		return Squares(Counter, Key);
+	}
+
+	/**
+	 * Returns the random fraction for the specified counter.
+	 *
+	 * @param Counter The counter.
+	 *
+	 * @return The random fraction within [0, 1).
+	 */
+	FORCEINLINE double GetFraction(const uint64 Counter) const
+	{
+		return GetUInt32(Counter) * (1.0 / 4294967296.0);
+	}
+
+	/**
+	 * Returns the random number within the specified range for the specified counter.
+	 *
+	 * @param Counter The counter.
+	 * @param Min The minimum.
+	 * @param Max The maximum, exclusive.
+	 *
+	 * @return The random number.
+	 */
+	FORCEINLINE double GetRange(const uint64 Counter, const double Min, const double Max) const
+	{
+		return Min + (Max - Min) * GetFraction(Counter);
+	}
+
+	/**
+	 * Returns the random integer within the specified range for the specified counter.
+	 *
+	 * @param Counter The counter.
+	 * @param Min The minimum.
+	 * @param Max The maximum, inclusive.
+	 *
+	 * @return The random integer.
+	 */
+	FORCEINLINE int32 GetIntRange(const uint64 Counter, const int32 Min, const int32 Max) const
+	{
+		const auto Range = static_cast<uint64>(static_cast<int64>(Max) - Min + 1);
+		return Min + static_cast<int32>(GetUInt32(Counter) * Range >> 32);
+	}
+
+	/**
+	 * Fills the specified array with the random values of consecutive counters. The values are independent of each
+	 * other, so the loop is unrolled into lanes the compiler can vectorize.
+	 *
+	 * @param FirstCounter The counter of the first value.
+	 * @param Values The array to be filled.
+	 */
+	void Fill(const uint64 FirstCounter, TArrayView<uint32> Values) const
+	{
+		const auto Num = Values.Num();
+		auto Index = 0;
+		for (; Index + 4 <= Num; Index += 4)
+		{
+			Values[Index + 0] = Squares(FirstCounter + Index + 0, Key);
+			Values[Index + 1] = Squares(FirstCounter + Index + 1, Key);
+			Values[Index + 2] = Squares(FirstCounter + Index + 2, Key);
+			Values[Index + 3] = Squares(FirstCounter + Index + 3, Key);
+		}
+		for (; Index < Num; Index++)
+		{
+			Values[Index] = Squares(FirstCounter + Index, Key);
+		}
+	}
+
+private:
+	/**
+	 * The key derived from the seed and the stream.
+	 */
+	uint64 Key;
+
+	/**
+	 * Calculates the random value of a counter with the Squares algorithm (Widynski 2020).
+	 *
+	 * @param Counter The counter.
+	 * @param InKey The key.
+	 *
+	 * @return The random value.
+	 */
+	static FORCEINLINE uint32 Squares(const uint64 Counter, const uint64 InKey)
+	{
+		auto X = Counter * InKey;
+		const auto Y = X;
+		const auto Z = Y + InKey;
+		X = X * X + Y;
+		X = X >> 32 | X << 32;
+		X = X * X + Z;
+		X = X >> 32 | X << 32;
+		X = X * X + Y;
+		X = X >> 32 | X << 32;
+		return static_cast<uint32>((X * X + Z) >> 32);
+	}
+
+	/**
+	 * Scrambles the bits of a value with the SplitMix64 finalizer.
+	 *
+	 * @param Value The value.
+	 *
+	 * @return The scrambled value.
+	 */
+	static FORCEINLINE uint64 Mix(uint64 Value)
+	{
+		Value += 0x9E3779B97F4A7C15ull;
+		Value = (Value ^ Value >> 30) * 0xBF58476D1CE4E5B9ull;
+		Value = (Value ^ Value >> 27) * 0x94D049BB133111EBull;
+		return Value ^ Value >> 31;
+	}
+};
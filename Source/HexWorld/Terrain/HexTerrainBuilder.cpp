@@ -0,0 +1,1615 @@
+//
+// (C) Copyright 2024 Dirk Michael
+// dirkmichaelnm@gmail.com
+//
+
+#include "HexTerrainBuilder.h"
+
+#include "IntVectorTypes.h"
+#include "Async/ParallelFor.h"
+#include "Hash/xxhash.h"
+
+// Defines the log category of this class.
+DEFINE_LOG_CATEGORY(HexTerrainBuilder)
+// Define the enum range for tile directions.
+ENUM_RANGE_BY_FIRST_AND_LAST(ETileDirection, ETileDirection::TopRight, ETileDirection::TopLeft)
+
+// The width of a tile
+#define TILE_WIDTH sqrt(3.0) / 2.0
+// The factor for creating a vertex key
+#define KEY_FACTOR 1000000.0
+// The estimated memory needed for generating the mesh of a single tile
+#define SCRATCH_BYTES_PER_TILE 32768
+// The index of the center vertex within the vertex grid of a tile
+#define TILE_CENTER_VERTEX 1072
+// The distance in tiles up to which a changed tile affects the mesh sections of other tiles
+#define AFFECTED_TILE_MARGIN 2
+
+/**
+ * Defines the indicies of the vertices for each of the six parts of a hexagon tile.
+ */
+const int32 EdgeVertices[6][35] = {
+	// Top Right
+	{
+		1600, 1536, 1472, 1408, 1344,
+		1732, 1668, 1604, 1540, 1476, 1412,
+		1864, 1800, 1736, 1672, 1608, 1544, 1480,
+		1996, 1932, 1868, 1804, 1740, 1676, 1612, 1548,
+		2128, 2064, 2000, 1936, 1872, 1808, 1744, 1680, 1616
+	},
+	// Right
+	{
+		1344, 1212, 1080, 948, 816,
+		1412, 1280, 1148, 1016, 884, 752,
+		1480, 1348, 1216, 1084, 952, 820, 688,
+		1548, 1416, 1284, 1152, 1020, 888, 756, 624,
+		1616, 1484, 1352, 1220, 1088, 956, 824, 692, 560
+	},
+	// Bottom Right
+	{
+		816, 748, 680, 612, 544,
+		752, 684, 616, 548, 480, 412,
+		688, 620, 552, 484, 416, 348, 280,
+		624, 556, 488, 420, 352, 284, 216, 148,
+		560, 492, 424, 356, 288, 220, 152, 84, 16
+	},
+	// Bottom Left
+	{
+		544, 608, 672, 736, 800,
+		412, 476, 540, 604, 668, 732,
+		280, 344, 408, 472, 536, 600, 664,
+		148, 212, 276, 340, 404, 468, 532, 596,
+		16, 80, 144, 208, 272, 336, 400, 464, 528
+	},
+	// Left
+	{
+		800, 932, 1064, 1196, 1328,
+		732, 864, 996, 1128, 1260, 1392,
+		664, 796, 928, 1060, 1192, 1324, 1456,
+		596, 728, 860, 992, 1124, 1256, 1388, 1520,
+		528, 660, 792, 924, 1056, 1188, 1320, 1452, 1584
+	},
+	// Top Left
+	{
+		1328, 1396, 1464, 1532, 1600,
+		1392, 1460, 1528, 1596, 1664, 1732,
+		1456, 1524, 1592, 1660, 1728, 1796, 1864,
+		1520, 1588, 1656, 1724, 1792, 1860, 1928, 1996,
+		1584, 1652, 1720, 1788, 1856, 1924, 1992, 2060, 2128
+	}
+};
+
+/**
+ * Creates a new builder. The chunk layout, the terrain size and the noise lattices are calculated immediately.
+ *
+ * @param InSettings The parameters of the mesh generation.
+ * @param InHeightGrid The heights of all tiles.
+ */
+FHexTerrainBuilder::FHexTerrainBuilder(const FHexTerrainSettings& InSettings, FHexHeightGrid InHeightGrid)
+{
+	Settings = InSettings;
+	HeightGrid = MoveTemp(InHeightGrid);
+	SizeX = HeightGrid.GetSizeX();
+	SizeY = HeightGrid.GetSizeY();
+	// Classify the water and the coast once instead of scanning the neighbours of every tile
+	WaterMask = FHexGridMask::CreateFromHeights(HeightGrid, 0);
+	CoastMask = WaterMask.Dilate().AndNot(WaterMask);
+	Init();
+}
+
+/**
+ * Creates a new builder reading the heights from a tile page store. The pages of the tiles of a chunk and its
+ * border have to be prefetched before the chunk is generated.
+ *
+ * @param InSettings The parameters of the mesh generation.
+ * @param InPageStore The tile page store.
+ */
+FHexTerrainBuilder::FHexTerrainBuilder(const FHexTerrainSettings& InSettings,
+                                       const TSharedPtr<const FHexTilePageStore>& InPageStore)
+{
+	Settings = InSettings;
+	PageStore = InPageStore;
+	SizeX = PageStore.IsValid() && PageStore->IsValid() ? PageStore->GetSizeX() : 0;
+	SizeY = PageStore.IsValid() && PageStore->IsValid() ? PageStore->GetSizeY() : 0;
+	Init();
+}
+
+/**
+ * Calculates the chunk layout, the terrain size and the noise lattices.
+ */
+void FHexTerrainBuilder::Init()
+{
+	PeakScratchBytes = 0;
+
+	// Limit the chunk size, so that a chunk including its border stays within the memory budget
+	ChunkSize = CalculateChunkSize(Settings);
+	// Calculate the number of chunks
+	ChunkCountX = FMath::DivideAndRoundUp(SizeX, ChunkSize);
+	ChunkCountY = FMath::DivideAndRoundUp(SizeY, ChunkSize);
+	// Calculate the terrain size
+	TerrainSize = CalculateTerrainSize(Settings, SizeX, SizeY);
+	// Create the noise lattices for the distortion
+	CreateNoiseLattices();
+}
+
+/**
+ * Returns the number of chunks that may be generated at the same time without exceeding the mesh memory budget.
+ *
+ * @return The chunk count, at least one.
+ */
+int32 FHexTerrainBuilder::GetParallelChunkLimit() const
+{
+	// Without a budget, every worker thread may generate a chunk
+	const auto Workers = FMath::Max(FTaskGraphInterface::Get().GetNumWorkerThreads(), 1);
+	if (Settings.MeshMemoryBudget <= 0)
+	{
+		return Workers;
+	}
+	// Otherwise the estimated memory of all chunks in flight has to fit into the budget
+	const auto ChunkBytes = FMath::Square(ChunkSize + 2.0) * SCRATCH_BYTES_PER_TILE;
+	const auto Limit = FMath::FloorToInt32(Settings.MeshMemoryBudget * 1024.0 * 1024.0 / ChunkBytes);
+	return FMath::Clamp(Limit, 1, Workers);
+}
+
+/**
+ * Calculates the effective chunk size, it is reduced so that a chunk including its border stays within the mesh
+ * memory budget.
+ *
+ * @param InSettings The parameters of the mesh generation.
+ *
+ * @return The chunk size counted in tiles.
+ */
+int32 FHexTerrainBuilder::CalculateChunkSize(const FHexTerrainSettings& InSettings)
+{
+	const auto Size = FMath::Max(InSettings.ChunkSize, 1);
+	if (InSettings.MeshMemoryBudget <= 0)
+	{
+		return Size;
+	}
+	const auto BudgetTiles = InSettings.MeshMemoryBudget * 1024.0 * 1024.0 / SCRATCH_BYTES_PER_TILE;
+	return FMath::Clamp(FMath::FloorToInt32(FMath::Sqrt(BudgetTiles)) - 2, 1, Size);
+}
+
+/**
+ * Calculates a hash over the settings and the height grid.
+ *
+ * @return The hash value.
+ */
+uint64 FHexTerrainBuilder::CalculateHash() const
+{
+	auto Builder = FXxHash64Builder();
+	// Adds a value to the hash
+	const auto Add = [&Builder](const auto& Value)
+	{
+		Builder.Update(&Value, sizeof(Value));
+	};
+	// Adds the noise parameter to the hash
+	const auto AddNoise = [&Add](const FNoiseParameter& Params)
+	{
+		Add(Params.Size);
+		Add(Params.Offset);
+		Add(Params.Octaves);
+		Add(Params.Frequency);
+		Add(Params.Amplitude);
+		Add(Params.Redistribution);
+	};
+
+	// The height grid, the tile page store has the hash of its heights
+	Add(SizeX);
+	Add(SizeY);
+	if (PageStore.IsValid())
+	{
+		Add(PageStore->GetHash());
+	}
+	else
+	{
+		Builder.Update(HeightGrid.GetData().GetData(), HeightGrid.GetData().Num() * sizeof(int16));
+	}
+	// The mesh parameter
+	Add(Settings.HeightUnit);
+	Add(Settings.WallEdgeHeight);
+	Add(Settings.WaterOffset);
+	Add(Settings.Scale);
+	Add(ChunkSize);
+	// The distortion parameter
+	AddNoise(Settings.NoiseParameterX);
+	AddNoise(Settings.NoiseParameterY);
+	AddNoise(Settings.NoiseParameterZ);
+	Add(Settings.bUseNoiseLattice);
+	Add(Settings.NoiseLatticeMaxError);
+	// The wrapping
+	Add(Settings.bWrapX);
+
+	// Return the hash
+	return Builder.Finalize().Hash;
+}
+
+/**
+ * Generates the mesh section data for the specified chunk.
+ *
+ * @param Chunk The index of the chunk.
+ * @param SectionMask The section types to be generated, bit N stands for section type N. The sections of the other
+ *                    types stay empty.
+ *
+ * @return The chunk data struct.
+ */
+FHexTerrainChunkData FHexTerrainBuilder::GenerateChunk(const int32 Chunk, const int32 SectionMask) const
+{
+	auto ChunkData = FHexTerrainChunkData();
+	ChunkData.Chunk = Chunk;
+	if (SectionMask & (1 << TerrainSection))
+	{
+		ChunkData.Sections[TerrainSection] = GenerateTerrainSectionData(Chunk);
+	}
+	if (SectionMask & (1 << WaterSection))
+	{
+		ChunkData.Sections[WaterSection] = GenerateWaterSectionData(Chunk);
+	}
+	if (SectionMask & (1 << CollisionSection))
+	{
+		ChunkData.Sections[CollisionSection] = GenerateCollisionSectionData(Chunk);
+	}
+	return ChunkData;
+}
+
+/**
+ * Generates the specified chunks in parallel.
+ *
+ * @param Chunks The indices of the chunks.
+ * @param SectionMask The section types to be generated, bit N stands for section type N. The sections of the other
+ *                    types stay empty.
+ *
+ * @return The chunk data structs in the order of the specified indices.
+ */
+TArray<FHexTerrainChunkData> FHexTerrainBuilder::GenerateChunks(const TArray<int32>& Chunks,
+                                                                const int32 SectionMask) const
+{
+	auto Result = TArray<FHexTerrainChunkData>();
+	Result.SetNum(Chunks.Num());
+	// Every chunk only reads the builder and writes its own result
+	ParallelFor(Chunks.Num(), [this, &Chunks, &Result, SectionMask](const int32 I)
+	{
+		Result[I] = GenerateChunk(Chunks[I], SectionMask);
+	});
+	return Result;
+}
+
+/**
+ * Calculates the size of the terrain from the number of tiles.
+ *
+ * @param InSettings The parameters of the mesh generation.
+ * @param InSizeX The width of the terrain counted in tiles.
+ * @param InSizeY The length of the terrain counted in tiles.
+ *
+ * @return The terrain size struct.
+ */
+FTerrainSize FHexTerrainBuilder::CalculateTerrainSize(const FHexTerrainSettings& InSettings, const int32 InSizeX,
+                                                      const int32 InSizeY)
+{
+	const auto Width = TILE_WIDTH;
+	auto Size = FTerrainSize();
+	// The left corners of the first even row and the bottom corners of the first row
+	Size.MinimalX = -Width / 2.0 * InSettings.Scale;
+	Size.MinimalY = -0.5 * InSettings.Scale;
+	// The right corners of the last odd row and the top corners of the last row
+	Size.MaximalX = (InSizeX * Width - (InSizeY > 1 ? 0.0 : Width / 2.0)) * InSettings.Scale;
+	Size.MaximalY = (InSizeY * 0.75 - 0.25) * InSettings.Scale;
+	// A wrapping terrain repeats after every column of tiles
+	Size.bWrapX = InSettings.bWrapX;
+	Size.WrapWidth = InSizeX * Width * InSettings.Scale;
+	return Size;
+}
+
+/**
+ * Returns the tile whose center is the nearest to the specified position.
+ *
+ * @param Position The position relative to the terrain.
+ *
+ * @return The tile coordinates, they may be outside of the terrain.
+ */
+FIntPoint FHexTerrainBuilder::GetTileAt(const FVector2D& Position) const
+{
+	// The centers of the rows are 0.75 apart, every odd row is shifted by half a tile
+	const auto Y = FMath::RoundToInt32(Position.Y / Settings.Scale / 0.75);
+	const auto X = FMath::RoundToInt32((Position.X / Settings.Scale - ((Y & 1) == 0 ? 0.0 : TILE_WIDTH / 2.0))
+		/ (TILE_WIDTH));
+	return FIntPoint(X, Y);
+}
+
+/**
+ * Returns the rectangle of tile coordinates covered by the specified chunk. The maximum is exclusive.
+ *
+ * @param Chunk The index of the chunk.
+ *
+ * @return The tile rectangle.
+ */
+FIntRect FHexTerrainBuilder::GetChunkRect(const int32 Chunk) const
+{
+	const auto MinX = Chunk % ChunkCountX * ChunkSize;
+	const auto MinY = Chunk / ChunkCountX * ChunkSize;
+	return FIntRect(MinX, MinY, FMath::Min(MinX + ChunkSize, SizeX), FMath::Min(MinY + ChunkSize, SizeY));
+}
+
+/**
+ * Returns the chunks whose mesh sections depend on the heights of the specified tiles. Besides the chunks
+ * containing the tiles, these are the chunks containing their neighbours or using them for the border normals.
+ *
+ * @param Tiles The coordinates of the tiles.
+ *
+ * @return The sorted indices of the chunks.
+ */
+TArray<int32> FHexTerrainBuilder::GetAffectedChunks(const TArray<FIntPoint>& Tiles) const
+{
+	// A tile changes the walls of its neighbours, which in turn are the border ring of the chunks next to them
+	const auto Margin = AFFECTED_TILE_MARGIN;
+	// Mark every chunk overlapping the margin around a tile
+	auto Affected = TBitArray<>(false, GetChunkCount());
+	for (const auto& Tile : Tiles)
+	{
+		const auto MinY = FMath::Max(Tile.Y - Margin, 0) / ChunkSize;
+		const auto MaxY = FMath::Min(Tile.Y + Margin, SizeY - 1) / ChunkSize;
+		for (auto X = Tile.X - Margin; X <= Tile.X + Margin; X++)
+		{
+			// In a wrapping terrain the margin continues on the opposite side
+			if (!Settings.bWrapX && (X < 0 || X >= SizeX))
+			{
+				continue;
+			}
+			const auto ChunkX = (X % SizeX + SizeX) % SizeX / ChunkSize;
+			for (auto ChunkY = MinY; ChunkY <= MaxY; ChunkY++)
+			{
+				Affected[ChunkX + ChunkY * ChunkCountX] = true;
+			}
+		}
+	}
+	// Collect the marked chunks
+	auto Chunks = TArray<int32>();
+	for (TConstSetBitIterator<> It(Affected); It; ++It)
+	{
+		Chunks.Add(It.GetIndex());
+	}
+	return Chunks;
+}
+
+/**
+ * Returns the undistorted center of the top face of the tile at the specified coordinates, which must be within
+ * the height grid.
+ *
+ * @param X The X coordinate of the tile.
+ * @param Y The Y coordinate of the tile.
+ *
+ * @return The center vector.
+ */
+FVector FHexTerrainBuilder::GetTileCenter(const int32 X, const int32 Y) const
+{
+	// The center is the middle vertex of the vertex grid of a tile
+	return CalculateVertex(GetTile(X, Y).GetValue(), TILE_CENTER_VERTEX, 1.0);
+}
+
+/**
+ * Generates the mesh section data for the terrain of the specified chunk.
+ *
+ * @param Chunk The index of the chunk.
+ *
+ * @return Mesh section data struct.
+ */
+FMeshSectionData FHexTerrainBuilder::GenerateTerrainSectionData(const int32 Chunk) const
+{
+	// The mesh data struct
+	auto MeshData = FMeshData();
+	// Generate the tiles of the chunk
+	const auto Rect = GetChunkRect(Chunk);
+	GenerateTerrainMeshData(MeshData, Rect);
+	// Remember the counts of the chunk
+	const auto VertexCount = MeshData.VertexArray.Num();
+	const auto IndexCount = MeshData.TriangleArray.Num();
+	// Generate the ring of tiles around the chunk, so that the normals at the border match the neighbour chunks
+	// In a wrapping terrain the ring continues beyond the edge with the tiles of the opposite side
+	const auto RingMinX = Settings.bWrapX ? Rect.Min.X - 1 : FMath::Max(Rect.Min.X - 1, 0);
+	const auto RingMaxX = Settings.bWrapX ? Rect.Max.X + 1 : FMath::Min(Rect.Max.X + 1, SizeX);
+	for (auto Y = FMath::Max(Rect.Min.Y - 1, 0); Y < FMath::Min(Rect.Max.Y + 1, SizeY); Y++)
+	{
+		for (auto X = RingMinX; X < RingMaxX; X++)
+		{
+			if (!Rect.Contains(FIntPoint(X, Y)))
+			{
+				GenerateTerrainTile(MeshData, *GetTile(X, Y));
+			}
+		}
+	}
+	// Calculate the final buffers
+	return CreateMeshSectionData(MeshData, VertexCount, IndexCount);
+}
+
+/**
+ * Generates the mesh section data for the water of the specified chunk.
+ *
+ * @param Chunk The index of the chunk.
+ *
+ * @return Mesh section data struct.
+ */
+FMeshSectionData FHexTerrainBuilder::GenerateWaterSectionData(const int32 Chunk) const
+{
+	// The mesh data struct
+	auto MeshData = FMeshData();
+	// Generate the tiles of the chunk, the water is flat and needs no border
+	GenerateWaterMeshData(MeshData, GetChunkRect(Chunk));
+	// Calculate the final buffers
+	return CreateMeshSectionData(MeshData, MeshData.VertexArray.Num(), MeshData.TriangleArray.Num());
+}
+
+/**
+ * Generates the mesh section data for the collision of the specified chunk. Every tile gets a flat hexagon cap at
+ * the height of its center and a wall quad towards every lower neighbour.
+ *
+ * @param Chunk The index of the chunk.
+ *
+ * @return Mesh section data struct without normals and UV coordinates.
+ */
+FMeshSectionData FHexTerrainBuilder::GenerateCollisionSectionData(const int32 Chunk) const
+{
+	// The vertex indices of the center and the corners of a tile in clockwise order, starting at the top corner
+	const int32 CapVertices[7] = {1072, 2128, 1616, 560, 16, 528, 1584};
+
+	// The mesh section data struct
+	auto MeshSectionData = FMeshSectionData();
+	// Adds a distorted vertex and returns its index
+	const auto Add = [this, &MeshSectionData](const FVector& Vertex)
+	{
+		return MeshSectionData.Vertices.Add(Vertex + Distort(Vertex));
+	};
+
+	// Iterate over all tiles of the chunk
+	const auto Rect = GetChunkRect(Chunk);
+	for (auto Y = Rect.Min.Y; Y < Rect.Max.Y; Y++)
+	{
+		for (auto X = Rect.Min.X; X < Rect.Max.X; X++)
+		{
+			const auto Tile = GetTile(X, Y).GetValue();
+			// Add the cap as a fan around the center
+			const auto Center = Add(CalculateVertex(Tile, CapVertices[0], 1.0));
+			for (auto I = 1; I < 7; I++)
+			{
+				const auto Corner = Add(CalculateVertex(Tile, CapVertices[I], 1.0));
+				MeshSectionData.Triangles.Append({Center, Corner, Center + (I < 6 ? I + 1 : 1)});
+			}
+			// Add a wall towards every lower neighbour
+			for (const auto Direction : TEnumRange<ETileDirection>())
+			{
+				const auto Neighbour = GetNeighbour(Tile, Direction);
+				if (!Neighbour.IsSet() || Neighbour->Position.Z >= Tile.Position.Z)
+				{
+					continue;
+				}
+				// The wall reaches from the center height of the tile down to the center height of the neighbour
+				const auto Bottom = (Neighbour->Position.Z - Tile.Position.Z) * 4.0 + 1.0;
+				const auto Start = EdgeVertices[Direction][26];
+				const auto End = EdgeVertices[Direction][34];
+				const auto I0 = Add(CalculateVertex(Tile, Start, 1.0));
+				const auto I1 = Add(CalculateVertex(Tile, End, 1.0));
+				const auto I2 = Add(CalculateVertex(Tile, Start, Bottom));
+				const auto I3 = Add(CalculateVertex(Tile, End, Bottom));
+				MeshSectionData.Triangles.Append({I0, I2, I1, I1, I2, I3});
+			}
+		}
+	}
+
+	// Return the mesh section data struct
+	return MeshSectionData;
+}
+
+/**
+ * Calculates the final mesh buffers from the specified mesh data. Vertices and triangles beyond the specified
+ * counts were only generated to calculate seamless normals at the border of the chunk and are removed.
+ *
+ * @param MeshData The mesh data struct. Its arrays are moved into the result.
+ * @param VertexCount The number of vertices that belong to the chunk.
+ * @param IndexCount The number of triangle indices that belong to the chunk.
+ *
+ * @return Mesh section data struct.
+ */
+FMeshSectionData FHexTerrainBuilder::CreateMeshSectionData(FMeshData& MeshData, const int32 VertexCount,
+                                                           const int32 IndexCount) const
+{
+	// Remember the peak memory of the generation
+	const auto ScratchBytes = MeshData.GetAllocatedSize();
+	auto Peak = PeakScratchBytes.load(std::memory_order_relaxed);
+	while (Peak < ScratchBytes && !PeakScratchBytes.compare_exchange_weak(Peak, ScratchBytes))
+	{
+	}
+	// The vertex map is not needed anymore
+	MeshData.VertexMap.Empty();
+
+	// The mesh section data struct
+	auto MeshSectionData = FMeshSectionData();
+	// Calculate the attributes over all triangles and free the raw vertices as soon as possible
+	MeshSectionData.UVs = CalculateUVArray(MeshData, TerrainSize);
+	MeshData.RawVertexArray.Empty();
+	MeshSectionData.Normals = CalculateNormalArray(MeshData);
+	MeshSectionData.Vertices = MoveTemp(MeshData.VertexArray);
+	MeshSectionData.Triangles = MoveTemp(MeshData.TriangleArray);
+	// Remove the vertices and triangles of the border, chunk triangles only use the vertices added first
+	MeshSectionData.Vertices.SetNum(VertexCount);
+	MeshSectionData.Normals.SetNum(VertexCount);
+	MeshSectionData.UVs.SetNum(VertexCount);
+	MeshSectionData.Triangles.SetNum(IndexCount);
+	// Return the mesh section data struct
+	return MeshSectionData;
+}
+
+/**
+ * Creates the lattices caching the distortion noise for all three axes, if the noise lattice is enabled.
+ */
+void FHexTerrainBuilder::CreateNoiseLattices()
+{
+	// Check, if the lattice is enabled and there are tiles
+	if (!Settings.bUseNoiseLattice || SizeX == 0 || SizeY == 0)
+	{
+		return;
+	}
+
+	// Find the lowest and the highest tile, the tile page store knows them without loading any page
+	const auto MinimalZ = PageStore.IsValid() ? PageStore->GetMinimalZ() : HeightGrid.GetMinimalHeight();
+	const auto MaximalZ = PageStore.IsValid() ? PageStore->GetMaximalZ() : HeightGrid.GetMaximalHeight();
+	// Calculate the range of the vertex coordinates
+	const auto MinX = TerrainSize.MinimalX;
+	const auto MaxX = TerrainSize.MaximalX;
+	const auto MinY = TerrainSize.MinimalY;
+	const auto MaxY = TerrainSize.MaximalY;
+	const auto MinZ = MinimalZ * Settings.HeightUnit * 4.0 * Settings.Scale;
+	const auto MaxZ = (MaximalZ * 4.0 + 3.0) * Settings.HeightUnit * Settings.Scale;
+
+	// Create the lattices, every axis is distorted by the noise of the other two coordinates
+	NoiseLatticeX = CreateNoiseLattice(Settings.NoiseParameterX, FBox2D(FVector2D(MinY, MinZ), FVector2D(MaxY, MaxZ)));
+	NoiseLatticeY = CreateNoiseLattice(Settings.NoiseParameterY, FBox2D(FVector2D(MinX, MinZ), FVector2D(MaxX, MaxZ)));
+	NoiseLatticeZ = CreateNoiseLattice(Settings.NoiseParameterZ, FBox2D(FVector2D(MinX, MinY), FVector2D(MaxX, MaxY)));
+
+	// Log
+	UE_LOG(HexTerrainBuilder, Display, TEXT("Noise lattices created (Error X: %f, Y: %f, Z: %f)."),
+	       NoiseLatticeX->GetMeasuredError(), NoiseLatticeY->GetMeasuredError(), NoiseLatticeZ->GetMeasuredError());
+}
+
+/**
+ * Creates a lattice caching the distortion noise for the specified noise parameter.
+ *
+ * @param Params The noise parameter.
+ * @param Region The region of the noise function covered by the vertices of the terrain.
+ *
+ * @return The shared pointer to the lattice.
+ */
+TSharedPtr<FNoiseLattice> FHexTerrainBuilder::CreateNoiseLattice(const FNoiseParameter& Params,
+                                                                 const FBox2D& Region) const
+{
+	// The lattice is never finer than the distance between two vertices
+	const auto MinimalSpacing = TILE_WIDTH / 32.0 * Settings.Scale;
+	// Start with half of the wave length of the highest octave
+	auto InitialSpacing = MinimalSpacing;
+	if (Params.Octaves > 0 && Params.Frequency > 0.0)
+	{
+		const auto MaximalFrequency = Params.Frequency * FMath::Pow(2.0, Params.Octaves - 1);
+		InitialSpacing = FMath::Min(Params.Size.X, Params.Size.Y) / MaximalFrequency / 2.0;
+	}
+	// Create the lattice
+	return FNoiseLattice::Create([Params](const double Px, const double Py)
+	{
+		return Noise(Px, Py, Params);
+	}, InitialSpacing, MinimalSpacing, Settings.NoiseLatticeMaxError, Region);
+}
+
+/**
+ * Generates the mesh data for the water of all tiles within the specified rectangle.
+ * 
+ * @param MeshData The mesh data struct. 
+ * @param Rect The rectangle of tile coordinates. The maximum is exclusive.
+ */
+void FHexTerrainBuilder::GenerateWaterMeshData(FMeshData& MeshData, const FIntRect& Rect) const
+{
+	// Iterate over all tiles of the rectangle
+	for (auto Y = Rect.Min.Y; Y < Rect.Max.Y; Y++)
+	{
+		for (auto X = Rect.Min.X; X < Rect.Max.X; X++)
+		{
+			GenerateWaterTile(MeshData, *GetTile(X, Y));
+		}
+	}
+}
+
+/**
+ * Generates the mesh data for the terrain of all tiles within the specified rectangle.
+ * 
+ * @param MeshData The mesh data struct. 
+ * @param Rect The rectangle of tile coordinates. The maximum is exclusive.
+ */
+void FHexTerrainBuilder::GenerateTerrainMeshData(FMeshData& MeshData, const FIntRect& Rect) const
+{
+	// Iterate over all tiles of the rectangle
+	for (auto Y = Rect.Min.Y; Y < Rect.Max.Y; Y++)
+	{
+		for (auto X = Rect.Min.X; X < Rect.Max.X; X++)
+		{
+			GenerateTerrainTile(MeshData, *GetTile(X, Y));
+		}
+	}
+}
+
+/**
+ * Generates the mesh data for the water of the specified tile.
+ * 
+ * @param MeshData The mesh data struct. 
+ * @param Tile The tile the mesh data is generated for.
+ */
+void FHexTerrainBuilder::GenerateWaterTile(FMeshData& MeshData, const FTile& Tile) const
+{
+	// Calculate the height of the vertices
+	const auto Height = Settings.HeightUnit * 3.0 - Settings.WaterOffset;
+
+	if (Tile.Position.Z <= 0 || HasCoast(Tile))
+	{
+		for (auto Row = 0; Row < 8; Row++)
+		{
+			for (auto Col = 0; Col < 9 + Row; Col++)
+			{
+				const auto Offset = Col * 68 + Row * 64;
+
+				AddVertex(MeshData, Tile, 16 + Offset, Height, true, true);
+				AddVertex(MeshData, Tile, 80 + Offset, Height, true, true);
+				AddVertex(MeshData, Tile, 148 + Offset, Height, true, true);
+
+				AddVertex(MeshData, Tile, 1996 - Offset, Height, true, true);
+				AddVertex(MeshData, Tile, 2128 - Offset, Height, true, true);
+				AddVertex(MeshData, Tile, 2064 - Offset, Height, true, true);
+
+				if (Col < 8 + Row)
+				{
+					AddVertex(MeshData, Tile, 16 + Offset, Height, true, true);
+					AddVertex(MeshData, Tile, 148 + Offset, Height, true, true);
+					AddVertex(MeshData, Tile, 84 + Offset, Height, true, true);
+
+					AddVertex(MeshData, Tile, 1996 - Offset, Height, true, true);
+					AddVertex(MeshData, Tile, 2060 - Offset, Height, true, true);
+					AddVertex(MeshData, Tile, 2128 - Offset, Height, true, true);
+				}
+			}
+		}
+	}
+}
+
+/**
+ * Generates the mesh data for the terrain of the specified tile.
+ * 
+ * @param MeshData The mesh data struct. 
+ * @param Tile The tile the mesh data is generated for.
+ */
+void FHexTerrainBuilder::GenerateTerrainTile(FMeshData& MeshData, const FTile& Tile) const
+{
+	// Generate the center part of the tile mesh
+	GenerateTerrainTileCenter(MeshData, Tile);
+	// Iterate over all directions of the tile
+	for (const auto Direction : TEnumRange<ETileDirection>())
+	{
+		// Get neighbour heights
+		const auto Heights = GetNeighbourHeights(Tile, Direction);
+		const auto LeftZ = Heights[0];
+		const auto CenterZ = Heights[1];
+		const auto RightZ = Heights[2];
+		// Generate the inner edge
+		GenerateTerrainTileInnerEdge(MeshData, Tile, Direction, CenterZ);
+		// Generate the outer edge
+		GenerateTerrainTileOuterEdge(MeshData, Tile, Direction, LeftZ, CenterZ, RightZ);
+		// Generate the inner corners
+		GenerateTerrainTileInnerCorners(MeshData, Tile, Direction, LeftZ, CenterZ, RightZ);
+		// Generate the outer corners
+		GenerateTerrainTileOuterCorners(MeshData, Tile, Direction, LeftZ, CenterZ, RightZ);
+		// Generate the center wall
+		GenerateTerrainTileCenterWall(MeshData, Tile, Direction, CenterZ);
+		// Generate left side wall
+		GenerateTerrainTileSideWall(MeshData, Tile, Direction, CenterZ, LeftZ, 27, 11);
+		// Generate right side wall
+		GenerateTerrainTileSideWall(MeshData, Tile, Direction, CenterZ, RightZ, 17, 33);
+		// Generate left side corner wall
+		GenerateTerrainTileLeftCornerWall(MeshData, Tile, Direction, CenterZ, LeftZ);
+		// Generate right side corner wall
+		GenerateTerrainTileRightCornerWall(MeshData, Tile, Direction, CenterZ, RightZ);
+	}
+}
+
+/**
+ * Generates the mesh data for the center part of the tile mesh.
+ * 
+ * @param MeshData The mesh data struct. 
+ * @param Tile The tile the mesh data is generated for.
+ */
+void FHexTerrainBuilder::GenerateTerrainTileCenter(FMeshData& MeshData, const FTile& Tile) const
+{
+	// Rows of the mesh
+	for (auto Row = 0; Row < 4; Row++)
+	{
+		// Columns of the mesh
+		for (auto Col = 0; Col < Row + 5; Col++)
+		{
+			// Calculate offset of vertex position index
+			const auto Offset = Col * 68 + Row * 64;
+			// Add triangle part 1
+			AddVertex(MeshData, Tile, 544 + Offset, 1.0);
+			AddVertex(MeshData, Tile, 608 + Offset, 1.0);
+			AddVertex(MeshData, Tile, 676 + Offset, 1.0);
+			// Add triangle part 2
+			AddVertex(MeshData, Tile, 1600 - Offset, 1.0);
+			AddVertex(MeshData, Tile, 1536 - Offset, 1.0);
+			AddVertex(MeshData, Tile, 1468 - Offset, 1.0);
+			if (Col < Row + 4)
+			{
+				// Add triangle part 3
+				AddVertex(MeshData, Tile, 544 + Offset, 1.0);
+				AddVertex(MeshData, Tile, 676 + Offset, 1.0);
+				AddVertex(MeshData, Tile, 612 + Offset, 1.0);
+				// Add triangle part 4
+				AddVertex(MeshData, Tile, 1600 - Offset, 1.0);
+				AddVertex(MeshData, Tile, 1468 - Offset, 1.0);
+				AddVertex(MeshData, Tile, 1532 - Offset, 1.0);
+			}
+		}
+	}
+}
+
+/**
+ * Generates the mesh data for the inner edge in the specified direction for the specified tile.
+ * 
+ * @param MeshData The mesh data struct. 
+ * @param Tile The tile the mesh data is generated for.
+ * @param Direction The direction of the inner edge.
+ * @param CenterZ The height of the neighbour in the specified direction.
+ */
+void FHexTerrainBuilder::GenerateTerrainTileInnerEdge(FMeshData& MeshData, const FTile& Tile,
+                                                      const ETileDirection Direction, const int32 CenterZ) const
+{
+	// Calculate additional heights
+	const auto H1 = Tile.Position.Z > CenterZ ? 0.5 : Tile.Position.Z < CenterZ ? 1.5 : 1.0;
+	const auto H2 = Tile.Position.Z > CenterZ ? 0.0 : Tile.Position.Z < CenterZ ? 2.0 : 1.0;
+	// Calculate mesh data
+	for (auto Col = 0; Col < 4; Col++)
+	{
+		AddTriangle(MeshData, Tile, Direction, Col, 1.0, Col + 6, H1, Col + 1, 1.0);
+		AddTriangle(MeshData, Tile, Direction, Col, 1.0, Col + 12, H2, Col + 6, H1);
+		AddTriangle(MeshData, Tile, Direction, Col + 1, 1.0, Col + 6, H1, Col + 13, H2);
+		AddTriangle(MeshData, Tile, Direction, Col + 6, H1, Col + 12, H2, Col + 13, H2);
+	}
+}
+
+/**
+ * Generates the mesh data for the outer edge in the specified direction for the specified tile.
+ * 
+ * @param MeshData The mesh data struct. 
+ * @param Tile The tile the mesh data is generated for.
+ * @param Direction The direction of the outer edge.
+ * @param LeftZ The height of the neighbour of the left side of the specified direction.
+ * @param CenterZ The height of the neighbour in the specified direction.
+ * @param RightZ The height of the neighbour of the right side of the specified direction.
+ */
+void FHexTerrainBuilder::GenerateTerrainTileOuterEdge(FMeshData& MeshData, const FTile& Tile,
+                                                      const ETileDirection Direction, const int32 LeftZ,
+                                                      const int32 CenterZ, const int32 RightZ) const
+{
+	const auto TileZ = Tile.Position.Z;
+
+	const auto Hc0 = TileZ > CenterZ ? (CenterZ - TileZ) * 4.0 + 4.0 : TileZ < CenterZ ? 2.0 : 1.0;
+	const auto Hc1 = TileZ > CenterZ ? (CenterZ - TileZ) * 4.0 + 3.5 : TileZ < CenterZ ? 2.5 : 1.0;
+	const auto Hc2 = TileZ > CenterZ ? (CenterZ - TileZ) * 4.0 + 3.0 : TileZ < CenterZ ? 3.0 : 1.0;
+
+	const auto Hl0 = TileZ != CenterZ ? Hc0 : TileZ > LeftZ ? 0.0 : TileZ < LeftZ ? 2.0 : Hc0;
+	const auto Hl1 = TileZ != CenterZ ? Hc1 : TileZ > LeftZ ? 0.5 : TileZ < LeftZ ? 1.5 : Hc1;
+	const auto Hl2 = TileZ != CenterZ ? Hc2 : Hl0;
+
+	const auto Hr0 = TileZ != CenterZ ? Hc0 : TileZ > RightZ ? 0.0 : TileZ < RightZ ? 2.0 : Hc0;
+	const auto Hr1 = TileZ != CenterZ ? Hc1 : TileZ > RightZ ? 0.5 : TileZ < RightZ ? 1.5 : Hc1;
+	const auto Hr2 = TileZ != CenterZ ? Hc2 : Hr0;
+
+	AddTriangle(MeshData, Tile, Direction, 11, Hl0, 19, Hl1, 12, Hc0);
+	AddTriangle(MeshData, Tile, Direction, 11, Hl0, 27, Hl2, 19, Hl1);
+	AddTriangle(MeshData, Tile, Direction, 12, Hc0, 19, Hl1, 28, Hc2);
+	AddTriangle(MeshData, Tile, Direction, 19, Hl1, 27, Hl2, 28, Hc2);
+
+	for (auto Col = 1; Col < 5; Col++)
+	{
+		AddTriangle(MeshData, Tile, Direction, Col + 11, Hc0, Col + 19, Hc1, Col + 12, Hc0);
+		AddTriangle(MeshData, Tile, Direction, Col + 11, Hc0, Col + 27, Hc2, Col + 19, Hc1);
+		AddTriangle(MeshData, Tile, Direction, Col + 12, Hc0, Col + 19, Hc1, Col + 28, Hc2);
+		AddTriangle(MeshData, Tile, Direction, Col + 19, Hc1, Col + 27, Hc2, Col + 28, Hc2);
+	}
+
+	AddTriangle(MeshData, Tile, Direction, 16, Hc0, 24, Hr1, 17, Hr0);
+	AddTriangle(MeshData, Tile, Direction, 16, Hc0, 32, Hc2, 24, Hr1);
+	AddTriangle(MeshData, Tile, Direction, 17, Hr0, 24, Hr1, 33, Hr2);
+	AddTriangle(MeshData, Tile, Direction, 24, Hr1, 32, Hc2, 33, Hr2);
+}
+
+/**
+ * Generates the mesh data for the left and right inner corner in the specified direction for the specified tile.
+ * 
+ * @param MeshData The mesh data struct. 
+ * @param Tile The tile the mesh data is generated for.
+ * @param Direction The direction of the inner corner.
+ * @param LeftZ The height of the neighbour of the left side of the specified direction.
+ * @param CenterZ The height of the neighbour in the specified direction.
+ * @param RightZ The height of the neighbour of the right side of the specified direction.
+ */
+void FHexTerrainBuilder::GenerateTerrainTileInnerCorners(FMeshData& MeshData, const FTile& Tile,
+                                                         const ETileDirection Direction, const int32 LeftZ,
+                                                         const int32 CenterZ, const int32 RightZ) const
+{
+	// Get left corner heights
+	const auto LeftHeights = CalculateInnerCornerHeights(Tile, CenterZ, LeftZ);
+	const auto Lh0 = LeftHeights[0];
+	const auto Lh1 = LeftHeights[1];
+	const auto Lh2 = LeftHeights[2];
+	const auto Lh3 = LeftHeights[3];
+	// Generate left corner mesh data
+	AddTriangle(MeshData, Tile, Direction, 0, Lh0, 5, Lh2, 12, Lh1);
+	AddTriangle(MeshData, Tile, Direction, 5, Lh2, 11, Lh3, 12, Lh1);
+
+	// Get right corner heights
+	const auto RightHeights = CalculateInnerCornerHeights(Tile, CenterZ, RightZ);
+	const auto Rh0 = RightHeights[0];
+	const auto Rh1 = RightHeights[1];
+	const auto Rh2 = RightHeights[2];
+	const auto Rh3 = RightHeights[3];
+	// Generate right corner mesh data
+	AddTriangle(MeshData, Tile, Direction, 4, Rh0, 16, Rh1, 10, Rh2);
+	AddTriangle(MeshData, Tile, Direction, 10, Rh2, 16, Rh1, 17, Rh3);
+}
+
+/**
+ * Generates the mesh data for the left and right outer corner in the specified direction for the specified tile.
+ * 
+ * @param MeshData The mesh data struct. 
+ * @param Tile The tile the mesh data is generated for.
+ * @param Direction The direction of the outer corner.
+ * @param LeftZ The height of the neighbour of the left side of the specified direction.
+ * @param CenterZ The height of the neighbour in the specified direction.
+ * @param RightZ The height of the neighbour of the right side of the specified direction.
+ */
+void FHexTerrainBuilder::GenerateTerrainTileOuterCorners(FMeshData& MeshData, const FTile& Tile,
+                                                         const ETileDirection Direction, const int32 LeftZ,
+                                                         const int32 CenterZ, const int32 RightZ) const
+{
+	// Get left corner heights
+	const auto LeftHeights = CalculateOuterCornerHeights(Tile, CenterZ, LeftZ);
+	const auto Lh0 = LeftHeights[0];
+	const auto Lh1 = LeftHeights[1];
+	const auto Lh2 = LeftHeights[2];
+	const auto Lh3 = LeftHeights[3];
+	// Generate left corner mesh data
+	AddTriangle(MeshData, Tile, Direction, 11, Lh0, 18, Lh2, 27, Lh1);
+	AddTriangle(MeshData, Tile, Direction, 18, Lh2, 26, Lh3, 27, Lh1);
+
+	// Get right corner heights
+	const auto RightHeights = CalculateOuterCornerHeights(Tile, CenterZ, RightZ);
+	const auto Rh0 = RightHeights[0];
+	const auto Rh1 = RightHeights[1];
+	const auto Rh2 = RightHeights[2];
+	const auto Rh3 = RightHeights[3];
+	// Generate right corner mesh data
+	AddTriangle(MeshData, Tile, Direction, 17, Rh0, 33, Rh1, 25, Rh2);
+	AddTriangle(MeshData, Tile, Direction, 25, Rh2, 33, Rh1, 34, Rh3);
+}
+
+/**
+ * Generates the mesh data for the center wall in the specified direction for the specified tile.
+ * 
+ * @param MeshData The mesh data struct. 
+ * @param Tile The tile the mesh data is generated for.
+ * @param Direction The direction of the center wall.
+ * @param CenterZ The height of the neighbour in the specified direction.
+ */
+void FHexTerrainBuilder::GenerateTerrainTileCenterWall(FMeshData& MeshData, const FTile& Tile,
+                                                       const ETileDirection Direction, const int32 CenterZ) const
+{
+	// Calculate the difference between the tile height and the height of the center neighbour
+	const auto Diff = Tile.Position.Z - CenterZ;
+	// If the height are greater than one, we need a wall.
+	if (Diff > 1)
+	{
+		// Iterate for every level of the differnce that is greater than one
+		for (auto Level = 0; Level < Diff - 1; Level++)
+		{
+			// Calculate heights
+			const auto H0 = Level * -4.0;
+			const auto H1 = H0 - Settings.WallEdgeHeight;
+			const auto H2 = H0 - 2.0;
+			const auto H3 = H0 - (4.0 - Settings.WallEdgeHeight);
+			const auto H4 = H0 - 4.0;
+			// Iterate over all columns of the wall.
+			for (auto Col = 0; Col < 6; Col++)
+			{
+				// Calculate local vertex indices
+				const auto I0 = Col + 11;
+				const auto I1 = Col + 12;
+				// Add upper edge
+				AddTriangle(MeshData, Tile, Direction, I1, H0, I0, H0, I0, H1);
+				AddTriangle(MeshData, Tile, Direction, I1, H0, I0, H1, I1, H1);
+				// Add upper wall
+				AddTriangle(MeshData, Tile, Direction, I1, H1, I0, H1, I0, H2);
+				AddTriangle(MeshData, Tile, Direction, I1, H1, I0, H2, I1, H2);
+				// Add lower wall
+				AddTriangle(MeshData, Tile, Direction, I1, H2, I0, H2, I0, H3);
+				AddTriangle(MeshData, Tile, Direction, I1, H2, I0, H3, I1, H3);
+				// Add lower edge
+				AddTriangle(MeshData, Tile, Direction, I1, H3, I0, H3, I0, H4);
+				AddTriangle(MeshData, Tile, Direction, I1, H3, I0, H4, I1, H4);
+			}
+		}
+	}
+}
+
+/**
+ * Generates the mesh data for the left or right side wall in the specified direction for the specified tile.
+ * 
+ * @param MeshData The mesh data struct. 
+ * @param Tile The tile the mesh data is generated for.
+ * @param Direction The direction of the side wall.
+ * @param CenterZ The height of the neighbour in the specified direction.
+ * @param SideZ The height of the neighbour of the specified side of the specified direction.
+ * @param Index0 The index of the upper vertex. 
+ * @param Index1 The index of the lower vertex.
+ */
+void FHexTerrainBuilder::GenerateTerrainTileSideWall(FMeshData& MeshData, const FTile& Tile,
+                                                     const ETileDirection Direction, const int32 CenterZ,
+                                                     const int32 SideZ, const int32 Index0, const int32 Index1) const
+{
+	// Calculate the rows needed
+	const auto Rows = FMath::Min(Tile.Position.Z, CenterZ) - SideZ - 1;
+	// Iterate over every row
+	for (auto Row = 0; Row < Rows; Row++)
+	{
+		// Calculate vertex heights
+		const auto H0 = (Tile.Position.Z > CenterZ ? (CenterZ - Tile.Position.Z) * 4.0 : 0) - Row * 4.0;
+		const auto H1 = H0 - Settings.WallEdgeHeight;
+		const auto H2 = H0 - 2.0;
+		const auto H3 = H0 - (4.0 - Settings.WallEdgeHeight);
+		const auto H4 = H0 - 4.0;
+
+		// Add upper edge
+		AddTriangle(MeshData, Tile, Direction, Index0, H0, Index1, H0, Index1, H1);
+		AddTriangle(MeshData, Tile, Direction, Index0, H0, Index1, H1, Index0, H1);
+		// Add upper wall
+		AddTriangle(MeshData, Tile, Direction, Index0, H1, Index1, H1, Index1, H2);
+		AddTriangle(MeshData, Tile, Direction, Index0, H1, Index1, H2, Index0, H2);
+		// Add lower wall
+		AddTriangle(MeshData, Tile, Direction, Index0, H2, Index1, H2, Index1, H3);
+		AddTriangle(MeshData, Tile, Direction, Index0, H2, Index1, H3, Index0, H3);
+		// Add lower edge
+		AddTriangle(MeshData, Tile, Direction, Index0, H3, Index1, H3, Index1, H4);
+		AddTriangle(MeshData, Tile, Direction, Index0, H3, Index1, H4, Index0, H4);
+	}
+}
+
+/**
+ * Generates the mesh data for the left side corner wall in the specified direction for the specified tile.
+ * 
+ * @param MeshData The mesh data struct. 
+ * @param Tile The tile the mesh data is generated for.
+ * @param Direction The direction of the left side corner wall.
+ * @param CenterZ The height of the neighbour in the specified direction.
+ * @param LeftZ The height of the neighbour of the left side of the specified direction.
+ */
+void FHexTerrainBuilder::GenerateTerrainTileLeftCornerWall(FMeshData& MeshData, const FTile& Tile,
+                                                           const ETileDirection Direction, const int32 CenterZ,
+                                                           const int32 LeftZ) const
+{
+	// Check, if there are a gap between tile and left neightbour that needs to be filled
+	if (Tile.Position.Z > CenterZ && Tile.Position.Z - 1 > LeftZ && CenterZ > LeftZ)
+	{
+		// Calculate heights
+		const auto H0 = (Tile.Position.Z - CenterZ - 1) * -4.0;
+		const auto H1 = H0 - Settings.WallEdgeHeight;
+		const auto H2 = H0 - 1.0;
+		const auto H3 = H0 - 2.0;
+		const auto H4 = H0 - (4.0 - Settings.WallEdgeHeight);
+		const auto H5 = H0 - 4.0;
+
+		// Add necessary triangles
+		AddTriangle(MeshData, Tile, Direction, 11, H0, 11, H1, 27, H2);
+		AddTriangle(MeshData, Tile, Direction, 11, H1, 27, H3, 27, H2);
+		AddTriangle(MeshData, Tile, Direction, 11, H1, 11, H3, 27, H3);
+		AddTriangle(MeshData, Tile, Direction, 11, H3, 27, H4, 27, H3);
+		AddTriangle(MeshData, Tile, Direction, 11, H3, 11, H4, 27, H4);
+		AddTriangle(MeshData, Tile, Direction, 11, H4, 27, H5, 27, H4);
+		AddTriangle(MeshData, Tile, Direction, 11, H4, 11, H5, 27, H5);
+	}
+
+	// Check, if there is a little corner to be filled when the one neighbour is lower and the other is higher.
+	if (Tile.Position.Z < CenterZ && Tile.Position.Z > LeftZ)
+	{
+		// Add necessary triangles
+		AddTriangle(MeshData, Tile, Direction, 0, 1.0, 5, 0.5, 5, 1.5);
+		AddTriangle(MeshData, Tile, Direction, 11, 2.0, 5, 1.5, 11, 0.5);
+		AddTriangle(MeshData, Tile, Direction, 11, 0.5, 5, 1.5, 5, 0.5);
+		AddTriangle(MeshData, Tile, Direction, 11, 0.5, 5, 0.5, 11, 0.0);
+		AddTriangle(MeshData, Tile, Direction, 27, 3.0, 11, 2.0, 27, 2.0);
+		AddTriangle(MeshData, Tile, Direction, 27, 2.0, 11, 2.0, 11, 0.5);
+		AddTriangle(MeshData, Tile, Direction, 27, 2.0, 11, 0.5, 27, Settings.WallEdgeHeight);
+		AddTriangle(MeshData, Tile, Direction, 27, Settings.WallEdgeHeight, 11, 0.5, 11, 0.0);
+		AddTriangle(MeshData, Tile, Direction, 27, Settings.WallEdgeHeight, 11, 0.0, 27, 0.0);
+	}
+}
+
+/**
+ * Generates the mesh data for the right side corner wall in the specified direction for the specified tile.
+ * 
+ * @param MeshData The mesh data struct. 
+ * @param Tile The tile the mesh data is generated for.
+ * @param Direction The direction of the right side corner wall.
+ * @param CenterZ The height of the neighbour in the specified direction.
+ * @param RightZ The height of the neighbour of the right side of the specified direction.
+ */
+void FHexTerrainBuilder::GenerateTerrainTileRightCornerWall(FMeshData& MeshData, const FTile& Tile,
+                                                            const ETileDirection Direction, const int32 CenterZ,
+                                                            const int32 RightZ) const
+{
+	// Check, if there are a gap between tile and right neightbour that needs to be filled
+	if (Tile.Position.Z > CenterZ && Tile.Position.Z - 1 > RightZ && CenterZ > RightZ)
+	{
+		// Calculate heights
+		const auto H0 = (Tile.Position.Z - CenterZ - 1) * -4.0;
+		const auto H1 = H0 - Settings.WallEdgeHeight;
+		const auto H2 = H0 - 1.0;
+		const auto H3 = H0 - 2.0;
+		const auto H4 = H0 - (4.0 - Settings.WallEdgeHeight);
+		const auto H5 = H0 - 4.0;
+
+		// Add necessary triangles
+		AddTriangle(MeshData, Tile, Direction, 17, H0, 33, H2, 17, H1);
+		AddTriangle(MeshData, Tile, Direction, 17, H1, 33, H2, 33, H3);
+		AddTriangle(MeshData, Tile, Direction, 17, H1, 33, H3, 17, H3);
+		AddTriangle(MeshData, Tile, Direction, 17, H3, 33, H3, 33, H4);
+		AddTriangle(MeshData, Tile, Direction, 17, H3, 33, H4, 17, H4);
+		AddTriangle(MeshData, Tile, Direction, 17, H4, 33, H4, 33, H5);
+		AddTriangle(MeshData, Tile, Direction, 17, H4, 33, H5, 17, H5);
+	}
+
+	// Check, if there is a little corner to be filled when the one neighbour is lower and the other is higher.
+	if (Tile.Position.Z < CenterZ && Tile.Position.Z > RightZ)
+	{
+		// Add necessary triangles
+		AddTriangle(MeshData, Tile, Direction, 4, 1.0, 10, 1.5, 10, 0.5);
+		AddTriangle(MeshData, Tile, Direction, 17, 2.0, 17, 0.5, 10, 1.5);
+		AddTriangle(MeshData, Tile, Direction, 10, 1.5, 17, 0.5, 10, 0.5);
+		AddTriangle(MeshData, Tile, Direction, 10, 0.5, 17, 0.5, 17, 0.0);
+		AddTriangle(MeshData, Tile, Direction, 17, 2.0, 33, 3.0, 33, 2.0);
+		AddTriangle(MeshData, Tile, Direction, 17, 2.0, 33, 2.0, 33, Settings.WallEdgeHeight);
+		AddTriangle(MeshData, Tile, Direction, 17, 2.0, 33, Settings.WallEdgeHeight, 17, 0.5);
+		AddTriangle(MeshData, Tile, Direction, 17, 0.5, 33, Settings.WallEdgeHeight, 33, 0.0);
+		AddTriangle(MeshData, Tile, Direction, 17, 0.5, 33, 0.0, 17, 0.0);
+	}
+}
+
+/**
+ * Calculates the undistorted position of a vertex.
+ * 
+ * @param Tile The tile the vertex is calculated for.
+ * @param Index The index of the vertex position within a tile.
+ * @param Height The height of the vertex in height units. If <i>Absolute</i> is <b>true</b>,
+ *               the height is used as specified and not in height units.
+ * @param Absolute If <b>true</b>, the height is used as is and is not multiplied with the height unit.
+ *
+ * @return The vertex position.
+ */
+FVector FHexTerrainBuilder::CalculateVertex(const FTile& Tile, const int32 Index, const double Height,
+                                           const bool Absolute) const
+{
+	// Get the coordinates of the position vector of the tile.
+	const auto Px = Tile.Position.X * TILE_WIDTH
+		+ ((Tile.Position.Y & 1) == 0 ? 0.0 : TILE_WIDTH / 2.0)
+		- TILE_WIDTH / 2.0;
+	const auto Py = Tile.Position.Y * 0.75 - 0.5;
+	const auto Pz = Tile.Position.Z * Settings.HeightUnit * 4.0;
+	// Vertex grid cooridinates
+	const auto Vy = Index / 33;
+	const auto Vx = Index - Vy * 33;
+	// Create the vertex vector
+	return FVector(
+		(Px + TILE_WIDTH / 32.0 * Vx) * Settings.Scale,
+		(Py + 0.015625 * Vy) * Settings.Scale,
+		Absolute ? Height * Settings.Scale : (Pz + Height * Settings.HeightUnit) * Settings.Scale
+	);
+}
+
+/**
+ * Adds a new vertex to the current or a new triangle in the mesh data.
+ * 
+ * @param MeshData The mesh data struct. 
+ * @param Tile The tile the vertex is generated for.
+ * @param Index The index of the vertex position within a tile.
+ * @param Height The height of the vertex in height units. If <i>Absolute</i> is <b>true</b>,
+ *               the height is used as specified and not in height units.
+ * @param Absolute If <b>true</b>, the height is used as is and is not multiplied with the height unit.  
+ * @param NoDistortion If <b>true</b>, the vertext will be distorted, otherwise not.
+ */
+void FHexTerrainBuilder::AddVertex(FMeshData& MeshData, const FTile& Tile, const int32 Index, const double Height,
+                                   const bool Absolute, const bool NoDistortion) const
+{
+	// Create the vertex vector
+	const auto Vertex = CalculateVertex(Tile, Index, Height, Absolute);
+	// Create vertex key
+	const auto Key = UE::Geometry::FVector3i(
+		FMath::RoundToInt32(Vertex.X * KEY_FACTOR / Settings.Scale),
+		FMath::RoundToInt32(Vertex.Y * KEY_FACTOR / Settings.Scale),
+		FMath::RoundToInt32(Vertex.Z * KEY_FACTOR / Settings.Scale)
+	);
+	// If the vertex don't exist, add it to the map and the array
+	if (!MeshData.VertexMap.Contains(Key))
+	{
+		// Calculation distortion
+		const auto N = NoDistortion ? FVector::Zero() : Distort(Vertex);
+		// Add to map and array
+		MeshData.VertexMap.Add(Key, MeshData.VertexArray.Num());
+		MeshData.RawVertexArray.Add(Vertex);
+		MeshData.VertexArray.Add(Vertex + N);
+		// Update bounds
+		MeshData.TerrainSize.MinimalX = FMath::Min(MeshData.TerrainSize.MinimalX, Vertex.X);
+		MeshData.TerrainSize.MaximalX = FMath::Max(MeshData.TerrainSize.MaximalX, Vertex.X);
+		MeshData.TerrainSize.MinimalY = FMath::Min(MeshData.TerrainSize.MinimalY, Vertex.Y);
+		MeshData.TerrainSize.MaximalY = FMath::Max(MeshData.TerrainSize.MaximalY, Vertex.Y);
+	}
+	// Add new triangle index
+	MeshData.TriangleArray.Add(MeshData.VertexMap[Key]);
+}
+
+/**
+ * Adds a new triangle to the mesh data struct. The vertices are calculated by the specified direction and the
+ * local vertex indicies and heights of all threee vertices of the triangle.
+ * 
+ * @param MeshData The mesh data struct. 
+ * @param Tile The tile the triangle is generated for.
+ * @param Direction The direction of the part of the tile mesh.
+ * @param Index0 The first local vertex index.
+ * @param Height0 The height of the first local vertex.
+ * @param Index1 The second local vertex index.
+ * @param Height1 The height of the second local vertex.
+ * @param Index2 The third local vertex index.
+ * @param Height2 The height of the third local vertex.
+ */
+void FHexTerrainBuilder::AddTriangle(FMeshData& MeshData, const FTile& Tile, const ETileDirection Direction,
+                                     const int32 Index0, const double Height0, const int32 Index1,
+                                     const double Height1, const int32 Index2, const double Height2) const
+{
+	// Add the three vertices of the triangle
+	AddVertex(MeshData, Tile, EdgeVertices[Direction][Index0], Height0);
+	AddVertex(MeshData, Tile, EdgeVertices[Direction][Index1], Height1);
+	AddVertex(MeshData, Tile, EdgeVertices[Direction][Index2], Height2);
+}
+
+/**
+ * Returns an array with three items that are the heights (Z coordinates) of the neighbour tiles.
+ * Index 0 : The height of the neighbour of the left side of the specified direction.
+ * Index 1 : The height of the neighbour of the specified direction.
+ * Index 2 : The height of the neighbour of the right side of the specified direction.
+ * 
+ * @param Tile The tile for which the neighbour heights are determined. 
+ * @param Direction The direction in which the neighbours are.
+ * 
+ * @return Array with three integer values for the heights of the neighbour tiles. 
+ */
+TStaticArray<int32, 3> FHexTerrainBuilder::GetNeighbourHeights(const FTile& Tile, const ETileDirection Direction) const
+{
+	// Get direction of left and right neighbour
+	const auto LeftDirection = static_cast<ETileDirection>(Direction > TopRight ? Direction - 1 : TopLeft);
+	const auto RightDirection = static_cast<ETileDirection>(Direction < TopLeft ? Direction + 1 : TopRight);
+
+	// Create result array
+	auto Heights = TStaticArray<int32, 3>();
+
+	if (HasGhostBorder(Tile))
+	{
+		// Read the neighbours through the ghost border, a missing neighbour gets the height of the tile
+		const auto X = Tile.Position.X;
+		const auto Y = Tile.Position.Y;
+		const auto LeftZ = HeightGrid.GetNeighbourHeight(X, Y, LeftDirection);
+		const auto CenterZ = HeightGrid.GetNeighbourHeight(X, Y, Direction);
+		const auto RightZ = HeightGrid.GetNeighbourHeight(X, Y, RightDirection);
+		Heights[0] = LeftZ != HEX_HEIGHT_NONE ? LeftZ : Tile.Position.Z;
+		Heights[1] = CenterZ != HEX_HEIGHT_NONE ? CenterZ : Tile.Position.Z;
+		Heights[2] = RightZ != HEX_HEIGHT_NONE ? RightZ : Tile.Position.Z;
+		return Heights;
+	}
+
+	// Store left neighbour height
+	const auto LeftTile = GetNeighbour(Tile, LeftDirection);
+	Heights[0] = LeftTile.IsSet() ? LeftTile->Position.Z : Tile.Position.Z;
+	// Store center neighbour height
+	const auto CenterTile = GetNeighbour(Tile, Direction);
+	Heights[1] = CenterTile.IsSet() ? CenterTile->Position.Z : Tile.Position.Z;
+	// Store right neighbour height
+	const auto RightTile = GetNeighbour(Tile, RightDirection);
+	Heights[2] = RightTile.IsSet() ? RightTile->Position.Z : Tile.Position.Z;
+
+	// Return the result array
+	return Heights;
+}
+
+/**
+ * Returns the neighbour tile in the specified direction for the specified tile. If there is no tile in that
+ * direction, an unset optional is returned.
+ * 
+ * @param Tile The tile for which the neighbour is determined.
+ * @param Direction The direction of the neighbour tile.
+ * 
+ * @return The neighbour tile or an unset optional.
+ */
+TOptional<FTile> FHexTerrainBuilder::GetNeighbour(const FTile& Tile, const ETileDirection Direction) const
+{
+	// Check the direction
+	if (Direction < TopRight || Direction > TopLeft)
+	{
+		// Invalid direction
+		return TOptional<FTile>();
+	}
+
+	// Return the neighbour, the offset depends on the parity of the row
+	const auto Offset = FHexHeightGrid::GetNeighbourOffset(Tile.Position.Y, Direction);
+	return GetTile(Tile.Position.X + Offset.X, Tile.Position.Y + Offset.Y);
+}
+
+/**
+ * Returns the tile at the specified coordinates. If the coordinates are invalid, an unset optional is returned.
+ * 
+ * @param X The X coordinate of the tile. 
+ * @param Y The Y coordinate of the tile.
+ * 
+ * @return The tile or an unset optional.
+ */
+TOptional<FTile> FHexTerrainBuilder::GetTile(const int32 X, const int32 Y) const
+{
+	// In a wrapping terrain the tile beyond the edge gets the height of the opposite tile, but keeps its position,
+	// so its vertices continue the terrain seamlessly
+	const auto SourceX = Settings.bWrapX && SizeX > 0 ? (X % SizeX + SizeX) % SizeX : X;
+	// Check validity of the specified coordinates
+	if (SourceX >= 0 && SourceX < SizeX && Y >= 0 && Y < SizeY)
+	{
+		// Return the tile with the height from the grid or the tile page store
+		const auto Z = PageStore.IsValid() ? PageStore->GetHeight(SourceX, Y) : HeightGrid.GetHeight(SourceX, Y);
+		return FTile(FTilePosition(X, Y, Z));
+	}
+
+	// Invalid coordinates, return an unset optional
+	return TOptional<FTile>();
+}
+
+/**
+ * Checks if there is water in the specified direction for the specified tile.
+ * 
+ * @param Tile The tile to be checked for having a coast.
+ * @param Direction The direction that is checked.
+ * 
+ * @return If there is water in the specified direction then <b>true</b>, otherwise <b>false</b>. 
+ */
+bool FHexTerrainBuilder::HasCoast(const FTile& Tile, const ETileDirection Direction) const
+{
+	if (HasGhostBorder(Tile))
+	{
+		// Read the neighbour through the ghost border
+		const auto Z = HeightGrid.GetNeighbourHeight(Tile.Position.X, Tile.Position.Y, Direction);
+		return Z != HEX_HEIGHT_NONE && Z <= 0;
+	}
+	// Get the neighbour tile
+	const auto Neighbour = GetNeighbour(Tile, Direction);
+	// Check, if the neighbour is water
+	return Neighbour.IsSet() ? Neighbour->Position.Z <= 0 : false;
+}
+
+/**
+ * Checks if there is water in any direction of the specified tile.
+ * 
+ * @param Tile The tile to be checked for having a coast.
+ * 
+ * @return If there is water in at least one direction then <b>true</b>, otherwise <b>false</b>. 
+ */
+bool FHexTerrainBuilder::HasCoast(const FTile& Tile) const
+{
+	if (HasGhostBorder(Tile) && Tile.Position.Z > 0)
+	{
+		// The coast of the land tiles is known from the coast mask
+		return CoastMask.Get(Tile.Position.X, Tile.Position.Y);
+	}
+	if (HasGhostBorder(Tile))
+	{
+		// Read all six neighbours through the ghost border without any bounds check
+		const auto X = Tile.Position.X;
+		const auto Y = Tile.Position.Y;
+		auto bCoast = false;
+		for (const auto Direction : TEnumRange<ETileDirection>())
+		{
+			const auto Z = HeightGrid.GetNeighbourHeight(X, Y, Direction);
+			bCoast |= Z != HEX_HEIGHT_NONE && Z <= 0;
+		}
+		return bCoast;
+	}
+
+	// Iterate over all directions
+	for (const auto Direction : TEnumRange<ETileDirection>())
+	{
+		// Check for coast
+		if (HasCoast(Tile, Direction))
+		{
+			// At least one coast was found, thats enough
+			return true;
+		}
+	}
+	// No coast found
+	return false;
+}
+
+/**
+ * Checks if the neighbours of the specified tile can be read from the ghost border of the height grid. This is not
+ * possible, if the heights are read from the tile page store, the terrain wraps or the tile is not within the grid.
+ *
+ * @param Tile The tile whose neighbours are read.
+ *
+ * @return If the ghost border can be used then <b>true</b>, otherwise <b>false</b>.
+ */
+bool FHexTerrainBuilder::HasGhostBorder(const FTile& Tile) const
+{
+	return !PageStore.IsValid() && !Settings.bWrapX && HeightGrid.Contains(Tile.Position.X, Tile.Position.Y);
+}
+
+/**
+ * Calculate the heights of the vertices for the left or right inner corner of the tile mesh. An array with four
+ * items containing the heights of the four vertices is returned.
+ * 
+ * @param Tile The tile the heights are calculated for.
+ * @param CenterZ The height of the neighbour in the specified direction.
+ * @param SideZ The height of the neighbour of the specified side of the specified direction.
+ * 
+ * @return Array with four double values. 
+ */
+TArray<double> FHexTerrainBuilder::CalculateInnerCornerHeights(const FTile& Tile, const int32 CenterZ,
+                                                               const int32 SideZ)
+{
+	if (Tile.Position.Z < CenterZ)
+	{
+		// Tile is lower as the center neighbour
+		return {1.0, 2.0, 1.5, 2.0};
+	}
+	if (Tile.Position.Z == CenterZ && Tile.Position.Z < SideZ)
+	{
+		// Tile is on the same height as the center neighbour but lower as the side neighbour
+		return {1.0, 1.0, 1.5, 2.0};
+	}
+	if (Tile.Position.Z == CenterZ && Tile.Position.Z > SideZ)
+	{
+		// Tile is on the same height as the center neighbour and higher as the side neighbour
+		return {1.0, 1.0, 0.5, 0.0};
+	}
+	if (Tile.Position.Z > CenterZ)
+	{
+		// Tile is higher as the center neighbour
+		return {1.0, 0.0, 0.5, 0.0};
+	}
+	// Return the default array
+	return {1.0, 1.0, 1.0, 1.0};
+}
+
+/**
+ * Calculate the heights of the vertices for the left or right outer corner of the tile mesh. An array with four
+ * items containing the heights of the four vertices is returned.
+ * 
+ * @param Tile The tile the heights are calculated for.
+ * @param CenterZ The height of the neighbour in the specified direction.
+ * @param SideZ The height of the neighbour of the specified side of the specified direction.
+ * 
+ * @return Array with four double values. 
+ */
+TArray<double> FHexTerrainBuilder::CalculateOuterCornerHeights(const FTile& Tile, const int32 CenterZ,
+                                                               const int32 SideZ)
+{
+	// Calculate center and side height difference
+	const auto CenterDiff = (CenterZ - Tile.Position.Z) * 4.0;
+	const auto SideDiff = (SideZ - Tile.Position.Z) * 4.0;
+
+	if (Tile.Position.Z < CenterZ && Tile.Position.Z <= SideZ)
+	{
+		// Tile is lower than the center neighbour and lower or equal to the side neighbour.
+		return {2.0, 3.0, 2.5, 3.0};
+	}
+	if (Tile.Position.Z == CenterZ && Tile.Position.Z < SideZ)
+	{
+		// Tile is on the same height as the center neighbour but lower as the side neighbour
+		return {2.0, 2.0, 2.5, 3.0};
+	}
+	if (Tile.Position.Z > SideZ && CenterZ > SideZ)
+	{
+		// Tile and center neighbour are both higher than the side neighbour
+		return {SideDiff + 4.0, SideDiff + 4.0, SideDiff + 3.5, SideDiff + 3.0};
+	}
+	if (Tile.Position.Z > CenterZ && CenterZ <= SideZ)
+	{
+		// Tile is higher than the center neighbour and center neighbour is lower or equal to the side neighbour
+		return {CenterDiff + 4.0, CenterDiff + 3.0, CenterDiff + 3.5, CenterDiff + 3.0};
+	}
+	// Return the default array
+	return {1.0, 1.0, 1.0, 1.0};
+}
+
+/**
+ * Calculates the array of the UV coordinates for the specified mesh data.
+ * 
+ * @param MeshData The mesh data struct.
+ * @param Size The size of the entire terrain.
+ * 
+ * @return Array of 2D vectors. 
+ */
+TArray<FVector2D> FHexTerrainBuilder::CalculateUVArray(const FMeshData& MeshData, const FTerrainSize& Size)
+{
+	// Create the UV array
+	auto UVs = TArray<FVector2D>();
+	UVs.Reserve(MeshData.RawVertexArray.Num());
+
+	// Get width and length of the entire terrain
+	const auto DiffX = Size.MaximalX - Size.MinimalX;
+	const auto DiffY = Size.MaximalY - Size.MinimalY;
+
+	// Iterate over all vertices
+	for (const auto Vertex : MeshData.RawVertexArray)
+	{
+		// Calculate the UV coordinates and add the vector to the array
+		const auto U = Vertex.X / DiffX;
+		const auto V = Vertex.Y / DiffY;
+		UVs.Add(FVector2D(U, V));
+	}
+
+	// Return the array
+	return UVs;
+}
+
+/**
+ * Calculates the array of the normal vectors for the specified mesh data.
+ * 
+ * @param MeshData The mesh data struct.
+ * 
+ * @return Array of vectors. 
+ */
+TArray<FVector> FHexTerrainBuilder::CalculateNormalArray(const FMeshData& MeshData)
+{
+	// Create the array for the normals
+	auto Normals = TArray<FVector>();
+	// Initialize the array with zero vectors
+	Normals.Init(FVector::Zero(), MeshData.VertexArray.Num());
+
+	// Get the count of triangles
+	const auto TriangleCount = MeshData.TriangleArray.Num() / 3;
+	// Iterate over every triangle
+	for (auto I = 0; I < TriangleCount; I++)
+	{
+		// Get the indices of the vertices of the triangle
+		const auto I0 = MeshData.TriangleArray[I * 3];
+		const auto I1 = MeshData.TriangleArray[I * 3 + 1];
+		const auto I2 = MeshData.TriangleArray[I * 3 + 2];
+		// Get the vertices of the triangle
+		const auto V0 = MeshData.VertexArray[I0];
+		const auto V1 = MeshData.VertexArray[I1];
+		const auto V2 = MeshData.VertexArray[I2];
+		// Calculate the normal vector
+		const auto NV = FVector::CrossProduct(V1 - V0, V2 - V0) * -1.0;
+		// Add the new normal vector to the normal vectors in the array
+		Normals[I0] += NV;
+		Normals[I1] += NV;
+		Normals[I2] += NV;
+	}
+
+	// Normalize all normal vectors
+	for (auto I = 0; I < Normals.Num(); I++)
+	{
+		Normals[I].Normalize(1.0);
+	}
+
+	// Return the array
+	return Normals;
+}
+
+/**
+ * Calculates a noise value for the specified coordinates and the noise parameter.
+ * 
+ * @param Px X coordinate. 
+ * @param Py Y coordinate.
+ * @param Params Noise parameter.
+ * 
+ * @return The noise value. 
+ */
+double FHexTerrainBuilder::Noise(const double Px, const double Py, const FNoiseParameter& Params)
+{
+	// Normalize coordinates
+	const auto Nx = Px / Params.Size.X + Params.Offset.X;
+	const auto Ny = Py / Params.Size.Y + Params.Offset.Y;
+
+	// Cumulative noise value
+	auto E = 0.0;
+	// Cumulative frequency value
+	auto F = 0.0;
+	// Iterate over all octaves
+	for (auto Oct = 0; Oct < Params.Octaves; Oct++)
+	{
+		const auto Fv = Params.Frequency * FMath::Pow(2.0, Oct);
+		E += FMath::PerlinNoise2D(FVector2D(Nx * Fv, Ny * Fv));
+		F += 1.0 / Fv;
+	}
+	// Normalize result noise value
+	E = FMath::Pow(E / F, Params.Redistribution);
+	// Apply amplitude and return the noise value
+	return E * Params.Amplitude;
+}
+
+/**
+ * Calculates a noise vector based on the specified vertex and the noise parameter for each axis.
+ * 
+ * @param Vertex Original vertex.
+ * @param ParamsX Noise parameter for X axis.
+ * @param ParamsY Noise parameter for Y axis.
+ * @param ParamsZ Noise parameter for Z axis.
+ * 
+ * @return The noise vector. 
+ */
+FVector FHexTerrainBuilder::Noise(const FVector& Vertex, const FNoiseParameter& ParamsX,
+                                  const FNoiseParameter& ParamsY, const FNoiseParameter& ParamsZ)
+{
+	const auto X = Noise(Vertex.Y, Vertex.Z, ParamsX);
+	const auto Y = Noise(Vertex.X, Vertex.Z, ParamsY);
+	const auto Z = Noise(Vertex.X, Vertex.Y, ParamsZ);
+	return FVector(X, Y, Z);
+}
+
+/**
+ * Calculates the distortion vector for the specified vertex. If the noise lattices exist, the noise is
+ * interpolated from them, otherwise it is calculated from the noise parameter.
+ *
+ * @param Vertex Original vertex.
+ *
+ * @return The distortion vector.
+ */
+FVector FHexTerrainBuilder::Distort(const FVector& Vertex) const
+{
+	if (!Settings.bWrapX)
+	{
+		return SampleDistortion(Vertex);
+	}
+
+	// A wrapping terrain needs the same distortion for a vertex and its copy one wrap width away. Within a band
+	// around the seam, the noise of the vertex is blended into the noise of its copy on the other side.
+	const auto WrapWidth = TerrainSize.WrapWidth;
+	const auto SeamX = TerrainSize.MinimalX;
+	const auto Band = TILE_WIDTH * Settings.Scale;
+	const auto Offset = FVector(WrapWidth, 0.0, 0.0);
+	if (Vertex.X >= SeamX + WrapWidth - Band)
+	{
+		// Right side of the seam, fading into the noise of the left side
+		const auto Alpha = FMath::SmoothStep(SeamX + WrapWidth - Band, SeamX + WrapWidth + Band, Vertex.X);
+		return FMath::Lerp(SampleDistortion(Vertex), SampleDistortion(Vertex - Offset), Alpha);
+	}
+	if (Vertex.X <= SeamX + Band)
+	{
+		// Left side of the seam, mirroring the blend of the right side
+		const auto Alpha = FMath::SmoothStep(SeamX + WrapWidth - Band, SeamX + WrapWidth + Band, Vertex.X + WrapWidth);
+		return FMath::Lerp(SampleDistortion(Vertex + Offset), SampleDistortion(Vertex), Alpha);
+	}
+	return SampleDistortion(Vertex);
+}
+
+/**
+ * Samples the distortion noise for the specified vertex, from the noise lattices if they exist.
+ *
+ * @param Vertex Original vertex.
+ *
+ * @return The distortion vector.
+ */
+FVector FHexTerrainBuilder::SampleDistortion(const FVector& Vertex) const
+{
+	// Interpolate the noise from the lattices
+	if (NoiseLatticeX.IsValid() && NoiseLatticeY.IsValid() && NoiseLatticeZ.IsValid())
+	{
+		const auto X = NoiseLatticeX->Sample(Vertex.Y, Vertex.Z);
+		const auto Y = NoiseLatticeY->Sample(Vertex.X, Vertex.Z);
+		const auto Z = NoiseLatticeZ->Sample(Vertex.X, Vertex.Y);
+		return FVector(X, Y, Z);
+	}
+	// Calculate the noise
+	return Noise(Vertex, Settings.NoiseParameterX, Settings.NoiseParameterY, Settings.NoiseParameterZ);
+}
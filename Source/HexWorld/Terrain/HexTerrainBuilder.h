@@ -0,0 +1,713 @@
+//
+// (C) Copyright 2024 Dirk Michael
+// dirkmichaelnm@gmail.com
+//
+
+#pragma once
+
+#include <atomic>
+
+#include "CoreMinimal.h"
+#include "Containers/StaticArray.h"
+#include "HexGridMask.h"
+#include "HexHeightGrid.h"
+#include "HexTilePageStore.h"
+#include "HexTerrainChunkData.h"
+#include "HexTerrainSettings.h"
+#include "MeshData.h"
+#include "MeshSectionData.h"
+#include "NoiseLattice.h"
+#include "NoiseParameter.h"
+#include "TerrainSize.h"
+#include "Tile.h"
+#include "TileDirection.h"
+
+// Defines the log category of this class.
+DECLARE_LOG_CATEGORY_EXTERN(HexTerrainBuilder, Log, All);
+
+// The section mask selecting all section types
+#define ALL_SECTION_TYPES ((1 << SectionTypeCount) - 1)
+
+/**
+ * This class generates the mesh sections of a hexagon terrain from a settings struct and a height grid. It does not
+ * depend on the object system and has no mutable state besides thread-safe statistics, so a builder can generate
+ * several chunks in parallel and several builders can run at the same time, e.g. in worker threads, commandlets or
+ * automation tests.
+ */
+class HEXWORLD_API FHexTerrainBuilder
+{
+public:
+	/**
+	 * Creates a new builder. The chunk layout, the terrain size and the noise lattices are calculated immediately.
+	 *
+	 * @param InSettings The parameters of the mesh generation.
+	 * @param InHeightGrid The heights of all tiles.
+	 */
+	FHexTerrainBuilder(const FHexTerrainSettings& InSettings, FHexHeightGrid InHeightGrid);
+
+	/**
+	 * Creates a new builder reading the heights from a tile page store. The pages of the tiles of a chunk and its
+	 * border have to be prefetched before the chunk is generated.
+	 *
+	 * @param InSettings The parameters of the mesh generation.
+	 * @param InPageStore The tile page store.
+	 */
+	FHexTerrainBuilder(const FHexTerrainSettings& InSettings, const TSharedPtr<const FHexTilePageStore>& InPageStore);
+
+	/**
+	 * Returns the parameters of the mesh generation.
+	 *
+	 * @return The settings struct.
+	 */
+	FORCEINLINE const FHexTerrainSettings& GetSettings() const { return Settings; }
+
+	/**
+	 * Returns the heights of all tiles.
+	 *
+	 * @return The height grid.
+	 */
+	FORCEINLINE const FHexHeightGrid& GetHeightGrid() const { return HeightGrid; }
+
+	/**
+	 * Returns the mask of the water tiles, i.e. the tiles with a height of zero or below. It is empty, if the heights
+	 * are read from a tile page store.
+	 *
+	 * @return The water mask.
+	 */
+	FORCEINLINE const FHexGridMask& GetWaterMask() const { return WaterMask; }
+
+	/**
+	 * Returns the mask of the land tiles with a water neighbour, the edges of a wrapping terrain are not connected.
+	 * It is empty, if the heights are read from a tile page store.
+	 *
+	 * @return The coast mask.
+	 */
+	FORCEINLINE const FHexGridMask& GetCoastMask() const { return CoastMask; }
+
+	/**
+	 * Returns the width of the terrain counted in tiles.
+	 *
+	 * @return The width.
+	 */
+	FORCEINLINE int32 GetSizeX() const { return SizeX; }
+
+	/**
+	 * Returns the length of the terrain counted in tiles.
+	 *
+	 * @return The length.
+	 */
+	FORCEINLINE int32 GetSizeY() const { return SizeY; }
+
+	/**
+	 * Returns the tile whose center is the nearest to the specified position.
+	 *
+	 * @param Position The position relative to the terrain.
+	 *
+	 * @return The tile coordinates, they may be outside of the terrain.
+	 */
+	FIntPoint GetTileAt(const FVector2D& Position) const;
+
+	/**
+	 * Returns the size of the entire terrain.
+	 *
+	 * @return The terrain size struct.
+	 */
+	FORCEINLINE const FTerrainSize& GetTerrainSize() const { return TerrainSize; }
+
+	/**
+	 * Returns the chunk size used by this builder. It is the chunk size of the settings limited by the mesh memory
+	 * budget.
+	 *
+	 * @return The chunk size counted in tiles.
+	 */
+	FORCEINLINE int32 GetChunkSize() const { return ChunkSize; }
+
+	/**
+	 * Returns the number of chunks along the X axis.
+	 *
+	 * @return The chunk count.
+	 */
+	FORCEINLINE int32 GetChunkCountX() const { return ChunkCountX; }
+
+	/**
+	 * Returns the number of chunks along the Y axis.
+	 *
+	 * @return The chunk count.
+	 */
+	FORCEINLINE int32 GetChunkCountY() const { return ChunkCountY; }
+
+	/**
+	 * Returns the number of chunks.
+	 *
+	 * @return The chunk count.
+	 */
+	FORCEINLINE int32 GetChunkCount() const { return ChunkCountX * ChunkCountY; }
+
+	/**
+	 * Returns the peak of the memory used for generating a single chunk so far.
+	 *
+	 * @return The peak memory in bytes.
+	 */
+	FORCEINLINE SIZE_T GetPeakScratchBytes() const { return PeakScratchBytes.load(std::memory_order_relaxed); }
+
+	/**
+	 * Returns the number of chunks that may be generated at the same time without exceeding the mesh memory budget.
+	 *
+	 * @return The chunk count, at least one.
+	 */
+	int32 GetParallelChunkLimit() const;
+
+	/**
+	 * Calculates the effective chunk size, it is reduced so that a chunk including its border stays within the mesh
+	 * memory budget.
+	 *
+	 * @param InSettings The parameters of the mesh generation.
+	 *
+	 * @return The chunk size counted in tiles.
+	 */
+	static int32 CalculateChunkSize(const FHexTerrainSettings& InSettings);
+
+	/**
+	 * Calculates the size of the terrain from the number of tiles.
+	 *
+	 * @param InSettings The parameters of the mesh generation.
+	 * @param InSizeX The width of the terrain counted in tiles.
+	 * @param InSizeY The length of the terrain counted in tiles.
+	 *
+	 * @return The terrain size struct.
+	 */
+	static FTerrainSize CalculateTerrainSize(const FHexTerrainSettings& InSettings, const int32 InSizeX,
+	                                         const int32 InSizeY);
+
+	/**
+	 * Returns the rectangle of tile coordinates covered by the specified chunk. The maximum is exclusive.
+	 *
+	 * @param Chunk The index of the chunk.
+	 *
+	 * @return The tile rectangle.
+	 */
+	FIntRect GetChunkRect(const int32 Chunk) const;
+
+	/**
+	 * Returns the chunks whose mesh sections depend on the heights of the specified tiles. Besides the chunks
+	 * containing the tiles, these are the chunks containing their neighbours or using them for the border normals.
+	 *
+	 * @param Tiles The coordinates of the tiles.
+	 *
+	 * @return The sorted indices of the chunks.
+	 */
+	TArray<int32> GetAffectedChunks(const TArray<FIntPoint>& Tiles) const;
+
+	/**
+	 * Returns the undistorted center of the top face of the tile at the specified coordinates, which must be within
+	 * the height grid.
+	 *
+	 * @param X The X coordinate of the tile.
+	 * @param Y The Y coordinate of the tile.
+	 *
+	 * @return The center vector.
+	 */
+	FVector GetTileCenter(const int32 X, const int32 Y) const;
+
+	/**
+	 * Calculates a hash over the settings and the height grid.
+	 *
+	 * @return The hash value.
+	 */
+	uint64 CalculateHash() const;
+
+	/**
+	 * Generates the mesh section data for the terrain of the specified chunk.
+	 *
+	 * @param Chunk The index of the chunk.
+	 *
+	 * @return Mesh section data struct.
+	 */
+	FMeshSectionData GenerateTerrainSectionData(const int32 Chunk) const;
+
+	/**
+	 * Generates the mesh section data for the water of the specified chunk.
+	 *
+	 * @param Chunk The index of the chunk.
+	 *
+	 * @return Mesh section data struct.
+	 */
+	FMeshSectionData GenerateWaterSectionData(const int32 Chunk) const;
+
+	/**
+	 * Generates the mesh section data for the collision of the specified chunk. Every tile gets a flat hexagon cap at
+	 * the height of its center and a wall quad towards every lower neighbour.
+	 *
+	 * @param Chunk The index of the chunk.
+	 *
+	 * @return Mesh section data struct without normals and UV coordinates.
+	 */
+	FMeshSectionData GenerateCollisionSectionData(const int32 Chunk) const;
+
+	/**
+	 * Generates the mesh section data for the specified chunk.
+	 *
+	 * @param Chunk The index of the chunk.
+	 * @param SectionMask The section types to be generated, bit N stands for section type N. The sections of the
+	 *                    other types stay empty.
+	 *
+	 * @return The chunk data struct.
+	 */
+	FHexTerrainChunkData GenerateChunk(const int32 Chunk, const int32 SectionMask = ALL_SECTION_TYPES) const;
+
+	/**
+	 * Generates the specified chunks in parallel.
+	 *
+	 * @param Chunks The indices of the chunks.
+	 * @param SectionMask The section types to be generated, bit N stands for section type N. The sections of the
+	 *                    other types stay empty.
+	 *
+	 * @return The chunk data structs in the order of the specified indices.
+	 */
+	TArray<FHexTerrainChunkData> GenerateChunks(const TArray<int32>& Chunks,
+	                                            const int32 SectionMask = ALL_SECTION_TYPES) const;
+
+	/**
+	 * Calculates a noise value for the specified coordinates and the noise parameter.
+	 * 
+	 * @param Px X coordinate. 
+	 * @param Py Y coordinate.
+	 * @param Params Noise parameter.
+	 * 
+	 * @return The noise value. 
+	 */
+	static double Noise(const double Px, const double Py, const FNoiseParameter& Params);
+
+private:
+	/**
+	 * The parameters of the mesh generation.
+	 */
+	FHexTerrainSettings Settings;
+
+	/**
+	 * The heights of all tiles, empty if the heights are read from a tile page store.
+	 */
+	FHexHeightGrid HeightGrid;
+
+	/**
+	 * The mask of the water tiles.
+	 */
+	FHexGridMask WaterMask;
+
+	/**
+	 * The mask of the land tiles with a water neighbour.
+	 */
+	FHexGridMask CoastMask;
+
+	/**
+	 * The tile page store the heights are read from, if the terrain is too large to be kept in memory.
+	 */
+	TSharedPtr<const FHexTilePageStore> PageStore;
+
+	/**
+	 * The width of the terrain counted in tiles.
+	 */
+	int32 SizeX;
+
+	/**
+	 * The length of the terrain counted in tiles.
+	 */
+	int32 SizeY;
+
+	/**
+	 * The size of the entire terrain.
+	 */
+	FTerrainSize TerrainSize;
+
+	/**
+	 * The chunk size limited by the mesh memory budget.
+	 */
+	int32 ChunkSize;
+
+	/**
+	 * The number of chunks along the X axis.
+	 */
+	int32 ChunkCountX;
+
+	/**
+	 * The number of chunks along the Y axis.
+	 */
+	int32 ChunkCountY;
+
+	/**
+	 * The peak of the memory used for generating a single chunk.
+	 */
+	mutable std::atomic<SIZE_T> PeakScratchBytes;
+
+	/**
+	 * The lattice caching the distortion noise for the X axis.
+	 */
+	TSharedPtr<FNoiseLattice> NoiseLatticeX;
+
+	/**
+	 * The lattice caching the distortion noise for the Y axis.
+	 */
+	TSharedPtr<FNoiseLattice> NoiseLatticeY;
+
+	/**
+	 * The lattice caching the distortion noise for the Z axis.
+	 */
+	TSharedPtr<FNoiseLattice> NoiseLatticeZ;
+
+	/**
+	 * Calculates the chunk layout, the terrain size and the noise lattices.
+	 */
+	void Init();
+
+	/**
+	 * Creates the lattices caching the distortion noise for all three axes, if the noise lattice is enabled.
+	 */
+	void CreateNoiseLattices();
+
+	/**
+	 * Creates a lattice caching the distortion noise for the specified noise parameter.
+	 *
+	 * @param Params The noise parameter.
+	 * @param Region The region of the noise function covered by the vertices of the terrain.
+	 *
+	 * @return The shared pointer to the lattice.
+	 */
+	TSharedPtr<FNoiseLattice> CreateNoiseLattice(const FNoiseParameter& Params, const FBox2D& Region) const;
+
+	/**
+	 * Calculates the final mesh buffers from the specified mesh data. Vertices and triangles beyond the specified
+	 * counts were only generated to calculate seamless normals at the border of the chunk and are removed.
+	 *
+	 * @param MeshData The mesh data struct. Its arrays are moved into the result.
+	 * @param VertexCount The number of vertices that belong to the chunk.
+	 * @param IndexCount The number of triangle indices that belong to the chunk.
+	 *
+	 * @return Mesh section data struct.
+	 */
+	FMeshSectionData CreateMeshSectionData(FMeshData& MeshData, const int32 VertexCount,
+	                                       const int32 IndexCount) const;
+
+	/**
+	 * Generates the mesh data for the water of all tiles within the specified rectangle.
+	 * 
+	 * @param MeshData The mesh data struct. 
+	 * @param Rect The rectangle of tile coordinates. The maximum is exclusive.
+	 */
+	void GenerateWaterMeshData(FMeshData& MeshData, const FIntRect& Rect) const;
+
+	/**
+	 * Generates the mesh data for the terrain of all tiles within the specified rectangle.
+	 * 
+	 * @param MeshData The mesh data struct. 
+	 * @param Rect The rectangle of tile coordinates. The maximum is exclusive.
+	 */
+	void GenerateTerrainMeshData(FMeshData& MeshData, const FIntRect& Rect) const;
+
+	/**
+	 * Generates the mesh data for the water of the specified tile.
+	 * 
+	 * @param MeshData The mesh data struct. 
+	 * @param Tile The tile the mesh data is generated for.
+	 */
+	void GenerateWaterTile(FMeshData& MeshData, const FTile& Tile) const;
+
+	/**
+	 * Generates the mesh data for the terrain of the specified tile.
+	 * 
+	 * @param MeshData The mesh data struct. 
+	 * @param Tile The tile the mesh data is generated for.
+	 */
+	void GenerateTerrainTile(FMeshData& MeshData, const FTile& Tile) const;
+
+	/**
+	 * Generates the mesh data for the center part of the tile mesh.
+	 * 
+	 * @param MeshData The mesh data struct. 
+	 * @param Tile The tile the mesh data is generated for.
+	 */
+	void GenerateTerrainTileCenter(FMeshData& MeshData, const FTile& Tile) const;
+
+	/**
+	 * Generates the mesh data for the inner edge in the specified direction for the specified tile.
+	 * 
+	 * @param MeshData The mesh data struct. 
+	 * @param Tile The tile the mesh data is generated for.
+	 * @param Direction The direction of the inner edge.
+	 * @param CenterZ The height of the neighbour in the specified direction.
+	 */
+	void GenerateTerrainTileInnerEdge(FMeshData& MeshData, const FTile& Tile, const ETileDirection Direction,
+	                                  const int32 CenterZ) const;
+
+	/**
+	 * Generates the mesh data for the outer edge in the specified direction for the specified tile.
+	 * 
+	 * @param MeshData The mesh data struct. 
+	 * @param Tile The tile the mesh data is generated for.
+	 * @param Direction The direction of the outer edge.
+	 * @param LeftZ The height of the neighbour of the left side of the specified direction.
+	 * @param CenterZ The height of the neighbour in the specified direction.
+	 * @param RightZ The height of the neighbour of the right side of the specified direction.
+	 */
+	void GenerateTerrainTileOuterEdge(FMeshData& MeshData, const FTile& Tile, const ETileDirection Direction,
+	                                  const int32 LeftZ, const int32 CenterZ, const int32 RightZ) const;
+
+	/**
+	 * Generates the mesh data for the left and right inner corner in the specified direction for the specified tile.
+	 * 
+	 * @param MeshData The mesh data struct. 
+	 * @param Tile The tile the mesh data is generated for.
+	 * @param Direction The direction of the inner corner.
+	 * @param LeftZ The height of the neighbour of the left side of the specified direction.
+	 * @param CenterZ The height of the neighbour in the specified direction.
+	 * @param RightZ The height of the neighbour of the right side of the specified direction.
+	 */
+	void GenerateTerrainTileInnerCorners(FMeshData& MeshData, const FTile& Tile, const ETileDirection Direction,
+	                                     const int32 LeftZ, const int32 CenterZ, const int32 RightZ) const;
+
+	/**
+	 * Generates the mesh data for the left and right outer corner in the specified direction for the specified tile.
+	 * 
+	 * @param MeshData The mesh data struct. 
+	 * @param Tile The tile the mesh data is generated for.
+	 * @param Direction The direction of the outer corner.
+	 * @param LeftZ The height of the neighbour of the left side of the specified direction.
+	 * @param CenterZ The height of the neighbour in the specified direction.
+	 * @param RightZ The height of the neighbour of the right side of the specified direction.
+	 */
+	void GenerateTerrainTileOuterCorners(FMeshData& MeshData, const FTile& Tile, const ETileDirection Direction,
+	                                     const int32 LeftZ, const int32 CenterZ, const int32 RightZ) const;
+
+	/**
+	 * Generates the mesh data for the center wall in the specified direction for the specified tile.
+	 * 
+	 * @param MeshData The mesh data struct. 
+	 * @param Tile The tile the mesh data is generated for.
+	 * @param Direction The direction of the center wall.
+	 * @param CenterZ The height of the neighbour in the specified direction.
+	 */
+	void GenerateTerrainTileCenterWall(FMeshData& MeshData, const FTile& Tile, const ETileDirection Direction,
+	                                   const int32 CenterZ) const;
+
+	/**
+	 * Generates the mesh data for the left or right side wall in the specified direction for the specified tile.
+	 * 
+	 * @param MeshData The mesh data struct. 
+	 * @param Tile The tile the mesh data is generated for.
+	 * @param Direction The direction of the side wall.
+	 * @param CenterZ The height of the neighbour in the specified direction.
+	 * @param SideZ The height of the neighbour of the specified side of the specified direction.
+	 * @param Index0 The index of the upper vertex. 
+	 * @param Index1 The index of the lower vertex.
+	 */
+	void GenerateTerrainTileSideWall(FMeshData& MeshData, const FTile& Tile, const ETileDirection Direction,
+	                                 const int32 CenterZ, const int32 SideZ, const int32 Index0,
+	                                 const int32 Index1) const;
+
+	/**
+	 * Generates the mesh data for the left side corner wall in the specified direction for the specified tile.
+	 * 
+	 * @param MeshData The mesh data struct. 
+	 * @param Tile The tile the mesh data is generated for.
+	 * @param Direction The direction of the left side corner wall.
+	 * @param CenterZ The height of the neighbour in the specified direction.
+	 * @param LeftZ The height of the neighbour of the left side of the specified direction.
+	 */
+	void GenerateTerrainTileLeftCornerWall(FMeshData& MeshData, const FTile& Tile, const ETileDirection Direction,
+	                                       const int32 CenterZ, const int32 LeftZ) const;
+
+	/**
+	 * Generates the mesh data for the right side corner wall in the specified direction for the specified tile.
+	 * 
+	 * @param MeshData The mesh data struct. 
+	 * @param Tile The tile the mesh data is generated for.
+	 * @param Direction The direction of the right side corner wall.
+	 * @param CenterZ The height of the neighbour in the specified direction.
+	 * @param RightZ The height of the neighbour of the right side of the specified direction.
+	 */
+	void GenerateTerrainTileRightCornerWall(FMeshData& MeshData, const FTile& Tile, const ETileDirection Direction,
+	                                        const int32 CenterZ, const int32 RightZ) const;
+
+	/**
+	 * Calculates the undistorted position of a vertex.
+	 * 
+	 * @param Tile The tile the vertex is calculated for.
+	 * @param Index The index of the vertex position within a tile.
+	 * @param Height The height of the vertex in height units. If <i>Absolute</i> is <b>true</b>,
+	 *               the height is used as specified and not in height units.
+	 * @param Absolute If <b>true</b>, the height is used as is and is not multiplied with the height unit.
+	 *
+	 * @return The vertex position.
+	 */
+	FVector CalculateVertex(const FTile& Tile, const int32 Index, const double Height,
+	                        const bool Absolute = false) const;
+
+	/**
+	 * Adds a new vertex to the current or a new triangle in the mesh data.
+	 * 
+	 * @param MeshData The mesh data struct. 
+	 * @param Tile The tile the vertex is generated for.
+	 * @param Index The index of the vertex position within a tile.
+	 * @param Height The height of the vertex in height units. If <i>Absolute</i> is <b>true</b>,
+	 *               the height is used as specified and not in height units.
+	 * @param Absolute If <b>true</b>, the height is used as is and is not multiplied with the height unit.
+	 * @param NoDistortion If <b>true</b>, the vertext will be distorted, otherwise not.
+	 */
+	void AddVertex(FMeshData& MeshData, const FTile& Tile, const int32 Index, const double Height,
+	               const bool Absolute = false, const bool NoDistortion = false) const;
+
+	/**
+	 * Adds a new triangle to the mesh data struct. The vertices are calculated by the specified direction and the
+	 * local vertex indicies and heights of all threee vertices of the triangle.
+	 * 
+	 * @param MeshData The mesh data struct. 
+	 * @param Tile The tile the triangle is generated for.
+	 * @param Direction The direction of the part of the tile mesh.
+	 * @param Index0 The first local vertex index.
+	 * @param Height0 The height of the first local vertex.
+	 * @param Index1 The second local vertex index.
+	 * @param Height1 The height of the second local vertex.
+	 * @param Index2 The third local vertex index.
+	 * @param Height2 The height of the third local vertex.
+	 */
+	void AddTriangle(FMeshData& MeshData, const FTile& Tile, const ETileDirection Direction, const int32 Index0,
+	                 const double Height0, const int32 Index1, const double Height1, const int32 Index2,
+	                 const double Height2) const;
+
+	/**
+	 * Returns an array with three items that are the heights (Z coordinates) of the neighbour tiles.
+	 * Index 0 : The height of the neighbour of the left side of the specified direction.
+	 * Index 1 : The height of the neighbour of the specified direction.
+	 * Index 2 : The height of the neighbour of the right side of the specified direction.
+	 * 
+	 * @param Tile The tile for which the neighbour heights are determined. 
+	 * @param Direction The direction in which the neighbours are.
+	 * 
+	 * @return Array with three integer values for the heights of the neighbour tiles. 
+	 */
+	TStaticArray<int32, 3> GetNeighbourHeights(const FTile& Tile, const ETileDirection Direction) const;
+
+	/**
+	 * Returns the neighbour tile in the specified direction for the specified tile. If there is no tile in that
+	 * direction, an unset optional is returned.
+	 * 
+	 * @param Tile The tile for which the neighbour is determined.
+	 * @param Direction The direction of the neighbour tile.
+	 * 
+	 * @return The neighbour tile or an unset optional.
+	 */
+	TOptional<FTile> GetNeighbour(const FTile& Tile, const ETileDirection Direction) const;
+
+	/**
+	 * Returns the tile at the specified coordinates. If the coordinates are invalid, an unset optional is returned.
+	 * 
+	 * @param X The X coordinate of the tile. 
+	 * @param Y The Y coordinate of the tile.
+	 * 
+	 * @return The tile or an unset optional.
+	 */
+	TOptional<FTile> GetTile(const int32 X, const int32 Y) const;
+
+	/**
+	 * Checks if there is water in the specified direction for the specified tile.
+	 * 
+	 * @param Tile The tile to be checked for having a coast.
+	 * @param Direction The direction that is checked.
+	 * 
+	 * @return If there is water in the specified direction then <b>true</b>, otherwise <b>false</b>. 
+	 */
+	bool HasCoast(const FTile& Tile, const ETileDirection Direction) const;
+
+	/**
+	 * Checks if there is water in any direction of the specified tile.
+	 * 
+	 * @param Tile The tile to be checked for having a coast.
+	 * 
+	 * @return If there is water in at least one direction then <b>true</b>, otherwise <b>false</b>. 
+	 */
+	bool HasCoast(const FTile& Tile) const;
+
+	/**
+	 * Checks if the neighbours of the specified tile can be read from the ghost border of the height grid. This is not
+	 * possible, if the heights are read from the tile page store, the terrain wraps or the tile is not within the grid.
+	 *
+	 * @param Tile The tile whose neighbours are read.
+	 *
+	 * @return If the ghost border can be used then <b>true</b>, otherwise <b>false</b>.
+	 */
+	bool HasGhostBorder(const FTile& Tile) const;
+
+	/**
+	 * Calculate the heights of the vertices for the left or right inner corner of the tile mesh. An array with four
+	 * items containing the heights of the four vertices is returned.
+	 * 
+	 * @param Tile The tile the heights are calculated for.
+	 * @param CenterZ The height of the neighbour in the specified direction.
+	 * @param SideZ The height of the neighbour of the specified side of the specified direction.
+	 * 
+	 * @return Array with four double values. 
+	 */
+	static TArray<double> CalculateInnerCornerHeights(const FTile& Tile, const int32 CenterZ, const int32 SideZ);
+
+	/**
+	 * Calculate the heights of the vertices for the left or right outer corner of the tile mesh. An array with four
+	 * items containing the heights of the four vertices is returned.
+	 * 
+	 * @param Tile The tile the heights are calculated for.
+	 * @param CenterZ The height of the neighbour in the specified direction.
+	 * @param SideZ The height of the neighbour of the specified side of the specified direction.
+	 * 
+	 * @return Array with four double values. 
+	 */
+	static TArray<double> CalculateOuterCornerHeights(const FTile& Tile, const int32 CenterZ, const int32 SideZ);
+
+	/**
+	 * Calculates the array of the UV coordinates for the specified mesh data.
+	 * 
+	 * @param MeshData The mesh data struct.
+	 * @param Size The size of the entire terrain.
+	 * 
+	 * @return Array of 2D vectors. 
+	 */
+	static TArray<FVector2D> CalculateUVArray(const FMeshData& MeshData, const FTerrainSize& Size);
+
+	/**
+	 * Calculates the array of the normal vectors for the specified mesh data.
+	 * 
+	 * @param MeshData The mesh data struct.
+	 * 
+	 * @return Array of vectors. 
+	 */
+	static TArray<FVector> CalculateNormalArray(const FMeshData& MeshData);
+
+	/**
+	 * Calculates a noise vector based on the specified vertex and the noise parameter for each axis.
+	 * 
+	 * @param Vertex Original vertex.
+	 * @param ParamsX Noise parameter for X axis.
+	 * @param ParamsY Noise parameter for Y axis.
+	 * @param ParamsZ Noise parameter for Z axis.
+	 * 
+	 * @return The noise vector. 
+	 */
+	static FVector Noise(const FVector& Vertex, const FNoiseParameter& ParamsX, const FNoiseParameter& ParamsY,
+	                     const FNoiseParameter& ParamsZ);
+
+	/**
+	 * Calculates the distortion vector for the specified vertex. If the noise lattices exist, the noise is
+	 * interpolated from them, otherwise it is calculated from the noise parameter.
+	 *
+	 * @param Vertex Original vertex.
+	 *
+	 * @return The distortion vector.
+	 */
+	FVector Distort(const FVector& Vertex) const;
+
+	/**
+	 * Samples the distortion noise for the specified vertex, from the noise lattices if they exist.
+	 *
+	 * @param Vertex Original vertex.
+	 *
+	 * @return The distortion vector.
+	 */
+	FVector SampleDistortion(const FVector& Vertex) const;
+};
@@ -0,0 +1,34 @@
+//
+// (C) Copyright 2024 Dirk Michael
+// dirkmichaelnm@gmail.com
+//
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MeshSectionData.h"
+#include "TerrainSectionType.h"
+
+/**
+ * This struct contains the mesh section data of all section types of a single chunk.
+ */
+struct FHexTerrainChunkData
+{
+	/**
+	 * Default constructor.
+	 */
+	FHexTerrainChunkData()
+	{
+		Chunk = INDEX_NONE;
+	}
+
+	/**
+	 * The index of the chunk.
+	 */
+	int32 Chunk;
+
+	/**
+	 * The mesh section data, indexed by the section type.
+	 */
+	FMeshSectionData Sections[SectionTypeCount];
+};
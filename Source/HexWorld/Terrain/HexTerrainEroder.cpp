@@ -0,0 +1,347 @@
+//
+// (C) Copyright 2024 Dirk Michael
+// dirkmichaelnm@gmail.com
+//
+
+#include "HexTerrainEroder.h"
+
+#include "HexRandom.h"
+#include "Async/ParallelFor.h"
+
+// Defines the log category of this class.
+DEFINE_LOG_CATEGORY(HexTerrainEroder)
+
+// The number of sample rows processed by a task
+#define ROWS_PER_TASK 16
+// The random stream of the rain
+#define RAIN_STREAM 2
+// The fraction of the level difference to the neighbours the water flows out per step
+#define FLOW_RATE 0.5f
+
+/**
+ * Creates a new eroder.
+ *
+ * @param InSettings The parameters of the erosion.
+ * @param bInWrapX If <b>true</b>, the terrain wraps around along the X axis.
+ */
+FHexTerrainEroder::FHexTerrainEroder(const FTerrainErosionSettings& InSettings, const bool bInWrapX)
+{
+	Settings = InSettings;
+	bWrapX = bInWrapX;
+	Resolution = FMath::Clamp(Settings.Resolution, 1, 16);
+	Width = 0;
+	Length = 0;
+}
+
+/**
+ * Erodes the heights of the specified grid.
+ *
+ * @param HeightGrid The height grid.
+ */
+void FHexTerrainEroder::Erode(FHexHeightGrid& HeightGrid)
+{
+	if (HeightGrid.IsEmpty())
+	{
+		return;
+	}
+	const auto StartTime = FPlatformTime::Seconds();
+	const auto Iterations = FitWorkBudget(HeightGrid.GetSizeX(), HeightGrid.GetSizeY());
+	ReadSamples(HeightGrid);
+
+	// The end of every parallel pass is the barrier, after which the neighbouring blocks see the new values
+	const auto TaskCount = FMath::DivideAndRoundUp(Length, ROWS_PER_TASK);
+	for (auto Iteration = 0; Iteration < Iterations; Iteration++)
+	{
+		ParallelFor(TaskCount, [&](const int32 Task)
+		{
+			CalculateFlux(Task * ROWS_PER_TASK, FMath::Min((Task + 1) * ROWS_PER_TASK, Length));
+		});
+		ParallelFor(TaskCount, [&](const int32 Task)
+		{
+			UpdateSamples(Task * ROWS_PER_TASK, FMath::Min((Task + 1) * ROWS_PER_TASK, Length), Iteration);
+		});
+	}
+	WriteSamples(HeightGrid);
+
+	// Free the samples
+	Heights.Empty();
+	Water.Empty();
+	Sediment.Empty();
+	Sea.Empty();
+	Flux.Empty();
+	Concentration.Empty();
+	ThermalDelta.Empty();
+
+	// Log
+	UE_LOG(HexTerrainEroder, Display, TEXT("Terrain eroded (%.1f ms, %d x %d samples, %d iterations)."),
+	       (FPlatformTime::Seconds() - StartTime) * 1000.0, Width, Length, Iterations);
+}
+
+/**
+ * Determines the resolution and the number of iterations that fit into the work budget.
+ *
+ * @param SizeX The number of tiles of a row.
+ * @param SizeY The number of tile rows.
+ *
+ * @return The number of iterations.
+ */
+int32 FHexTerrainEroder::FitWorkBudget(const int32 SizeX, const int32 SizeY)
+{
+	const auto Budget = FMath::Max<int64>(Settings.WorkBudget, 1) * 1000000;
+	// Every erosion starts from the configured values, so the eroder can be used again
+	const auto MaxResolution = FMath::Clamp(Settings.Resolution, 1, 16);
+	const auto MaxIterations = FMath::Max(Settings.Iterations, 1);
+	Resolution = MaxResolution;
+	// The odd rows of a terrain that does not wrap around stick out by half a tile
+	const auto CountSamples = [&]
+	{
+		return static_cast<int64>(SizeX * Resolution + (bWrapX ? 0 : Resolution / 2)) * SizeY * Resolution;
+	};
+
+	// Reduce the resolution first, then the number of iterations
+	while (Resolution > 1 && CountSamples() * MaxIterations > Budget)
+	{
+		Resolution--;
+	}
+	const auto Iterations = static_cast<int32>(FMath::Clamp<int64>(Budget / CountSamples(), 1, MaxIterations));
+	Width = SizeX * Resolution + (bWrapX ? 0 : Resolution / 2);
+	Length = SizeY * Resolution;
+
+	// Log
+	if (Resolution != MaxResolution || Iterations != MaxIterations)
+	{
+		UE_LOG(HexTerrainEroder, Display, TEXT("Erosion reduced to resolution %d and %d iterations (budget: %d)."),
+		       Resolution, Iterations, Settings.WorkBudget);
+	}
+	return Iterations;
+}
+
+/**
+ * Initializes the samples from the heights of the tiles.
+ *
+ * @param HeightGrid The height grid.
+ */
+void FHexTerrainEroder::ReadSamples(const FHexHeightGrid& HeightGrid)
+{
+	const auto Count = Width * Length;
+	Heights.SetNumUninitialized(Count);
+	Water.SetNumZeroed(Count);
+	Sediment.SetNumZeroed(Count);
+	Sea.SetNumUninitialized(Count);
+	Flux.SetNumZeroed(Count * 4);
+	Concentration.SetNumZeroed(Count);
+	ThermalDelta.SetNumZeroed(Count);
+
+	// Every sample starts with the height of its tile
+	ParallelFor(FMath::DivideAndRoundUp(Length, ROWS_PER_TASK), [&](const int32 Task)
+	{
+		for (auto Sy = Task * ROWS_PER_TASK; Sy < FMath::Min((Task + 1) * ROWS_PER_TASK, Length); Sy++)
+		{
+			for (auto Sx = 0; Sx < Width; Sx++)
+			{
+				const auto Tile = GetTile(Sx, Sy, HeightGrid.GetSizeX());
+				const auto Z = HeightGrid.GetHeight(Tile.X, Tile.Y);
+				Heights[Sx + Sy * Width] = static_cast<float>(Z);
+				Sea[Sx + Sy * Width] = Z <= 0;
+			}
+		}
+	});
+}
+
+/**
+ * Calculates the water flows, the sediment concentrations and the sliding material of the current step.
+ *
+ * @param FirstRow The first sample row.
+ * @param LastRow The sample row after the last one.
+ */
+void FHexTerrainEroder::CalculateFlux(const int32 FirstRow, const int32 LastRow)
+{
+	const auto Talus = static_cast<float>(Settings.Talus);
+	const auto ThermalRate = static_cast<float>(Settings.ThermalRate) / 4.0f;
+	for (auto Sy = FirstRow; Sy < LastRow; Sy++)
+	{
+		for (auto Sx = 0; Sx < Width; Sx++)
+		{
+			const auto Index = Sx + Sy * Width;
+			// The neighbours in the order +X, -X, +Y, -Y, missing neighbours are skipped
+			int32 Neighbours[4];
+			GetNeighbours(Sx, Sy, Neighbours);
+			const auto Height = Heights[Index];
+			const auto Level = Height + Water[Index];
+
+			// The water flows to the lower neighbours in proportion to the level differences
+			float Differences[4];
+			auto DifferenceSum = 0.0f;
+			auto Delta = 0.0f;
+			for (auto Direction = 0; Direction < 4; Direction++)
+			{
+				const auto Neighbour = Neighbours[Direction];
+				if (Neighbour == INDEX_NONE)
+				{
+					Differences[Direction] = 0.0f;
+					continue;
+				}
+				Differences[Direction] = FMath::Max(Level - Heights[Neighbour] - Water[Neighbour], 0.0f);
+				DifferenceSum += Differences[Direction];
+				// The material slides down the steep slopes in both directions
+				Delta += ThermalRate * (FMath::Max(Heights[Neighbour] - Height - Talus, 0.0f)
+					- FMath::Max(Height - Heights[Neighbour] - Talus, 0.0f));
+			}
+			const auto Outflow = FMath::Min(Water[Index], DifferenceSum * FLOW_RATE);
+			for (auto Direction = 0; Direction < 4; Direction++)
+			{
+				Flux[Index * 4 + Direction] = DifferenceSum > 0.0f
+					                              ? Outflow * Differences[Direction] / DifferenceSum
+					                              : 0.0f;
+			}
+			Concentration[Index] = Water[Index] > 0.0f ? Sediment[Index] / Water[Index] : 0.0f;
+			ThermalDelta[Index] = Delta;
+		}
+	}
+}
+
+/**
+ * Moves the water and the sediment, erodes or deposits and adds the rain of the current step.
+ *
+ * @param FirstRow The first sample row.
+ * @param LastRow The sample row after the last one.
+ * @param Iteration The number of the current step.
+ */
+void FHexTerrainEroder::UpdateSamples(const int32 FirstRow, const int32 LastRow, const int32 Iteration)
+{
+	const auto Random = FHexRandom(Settings.Seed, RAIN_STREAM);
+	const auto RainAmount = static_cast<float>(Settings.RainAmount) * 2.0f;
+	const auto Evaporation = 1.0f - static_cast<float>(Settings.Evaporation);
+	const auto SedimentCapacity = static_cast<float>(Settings.SedimentCapacity);
+	const auto ErosionRate = static_cast<float>(Settings.ErosionRate);
+	const auto DepositionRate = static_cast<float>(Settings.DepositionRate);
+	for (auto Sy = FirstRow; Sy < LastRow; Sy++)
+	{
+		for (auto Sx = 0; Sx < Width; Sx++)
+		{
+			const auto Index = Sx + Sy * Width;
+			// The neighbours in the order +X, -X, +Y, -Y, a neighbour sends its flux in the opposite direction
+			int32 Neighbours[4];
+			GetNeighbours(Sx, Sy, Neighbours);
+
+			// Gather the water and the sediment, only the values of this sample are written
+			auto Outflow = 0.0f;
+			auto Inflow = 0.0f;
+			auto SedimentInflow = 0.0f;
+			for (auto Direction = 0; Direction < 4; Direction++)
+			{
+				Outflow += Flux[Index * 4 + Direction];
+				const auto Neighbour = Neighbours[Direction];
+				if (Neighbour != INDEX_NONE)
+				{
+					const auto NeighbourFlux = Flux[Neighbour * 4 + (Direction ^ 1)];
+					Inflow += NeighbourFlux;
+					SedimentInflow += NeighbourFlux * Concentration[Neighbour];
+				}
+			}
+			auto Height = Heights[Index] + ThermalDelta[Index];
+			auto NewWater = Water[Index] - Outflow + Inflow;
+			auto NewSediment = FMath::Max(Sediment[Index] - Outflow * Concentration[Index] + SedimentInflow, 0.0f);
+
+			if (Sea[Index])
+			{
+				// The sea swallows the water and the sediment settles on its ground
+				Height += NewSediment;
+				NewWater = 0.0f;
+				NewSediment = 0.0f;
+			}
+			else
+			{
+				// Fast flowing water dissolves the ground, slow water deposits its sediment
+				const auto Capacity = SedimentCapacity * Outflow;
+				if (NewSediment > Capacity)
+				{
+					const auto Deposit = DepositionRate * (NewSediment - Capacity);
+					Height += Deposit;
+					NewSediment -= Deposit;
+				}
+				else
+				{
+					const auto Dissolved = ErosionRate * (Capacity - NewSediment);
+					Height -= Dissolved;
+					NewSediment += Dissolved;
+				}
+				// The rain only depends on the seed, the sample and the step
+				const auto Rain = RainAmount * Random.GetFraction(FHexRandom::MakeCounter(Index, Iteration));
+				NewWater = FMath::Max(NewWater, 0.0f) * Evaporation + Rain;
+			}
+			Heights[Index] = Height;
+			Water[Index] = NewWater;
+			Sediment[Index] = NewSediment;
+		}
+	}
+}
+
+/**
+ * Returns the indices of the neighbours of the specified sample in the order +X, -X, +Y, -Y. Missing neighbours are
+ * INDEX_NONE, on a wrapping terrain the neighbours along the X axis continue on the other side.
+ *
+ * @param Sx The X coordinate of the sample.
+ * @param Sy The Y coordinate of the sample.
+ * @param Neighbours Receives the indices of the neighbours.
+ */
+void FHexTerrainEroder::GetNeighbours(const int32 Sx, const int32 Sy, int32 (&Neighbours)[4]) const
+{
+	const auto Index = Sx + Sy * Width;
+	Neighbours[0] = Sx < Width - 1 ? Index + 1 : bWrapX ? Index + 1 - Width : INDEX_NONE;
+	Neighbours[1] = Sx > 0 ? Index - 1 : bWrapX ? Index - 1 + Width : INDEX_NONE;
+	Neighbours[2] = Sy < Length - 1 ? Index + Width : INDEX_NONE;
+	Neighbours[3] = Sy > 0 ? Index - Width : INDEX_NONE;
+}
+
+/**
+ * Writes the averaged samples back to the heights of the tiles.
+ *
+ * @param HeightGrid The height grid.
+ */
+void FHexTerrainEroder::WriteSamples(FHexHeightGrid& HeightGrid) const
+{
+	const auto SizeX = HeightGrid.GetSizeX();
+	const auto SizeY = HeightGrid.GetSizeY();
+	ParallelFor(SizeY, [&](const int32 Y)
+	{
+		// Odd rows are shifted by half a tile, on a wrapping terrain the last tile continues on the other side
+		const auto Shift = (Y & 1) != 0 ? Resolution / 2 : 0;
+		for (auto X = 0; X < SizeX; X++)
+		{
+			auto Sum = 0.0f;
+			for (auto Sy = Y * Resolution; Sy < (Y + 1) * Resolution; Sy++)
+			{
+				for (auto Sx = X * Resolution + Shift; Sx < (X + 1) * Resolution + Shift; Sx++)
+				{
+					Sum += Heights[Sx % Width + Sy * Width];
+				}
+			}
+			const auto Z = FMath::RoundToInt32(Sum / (Resolution * Resolution));
+			// Land stays land and water stays water, so the coast line is preserved
+			HeightGrid.SetHeight(X, Y, HeightGrid.GetHeight(X, Y) > 0 ? FMath::Max(Z, 1) : FMath::Min(Z, 0));
+		}
+	});
+}
+
+/**
+ * Returns the coordinates of the tile the specified sample belongs to.
+ *
+ * @param Sx The X coordinate of the sample.
+ * @param Sy The Y coordinate of the sample.
+ * @param SizeX The number of tiles of a row.
+ *
+ * @return The coordinates of the tile.
+ */
+FIntPoint FHexTerrainEroder::GetTile(const int32 Sx, const int32 Sy, const int32 SizeX) const
+{
+	// Odd rows are shifted by half a tile, the samples outside of a row belong to its first or last tile
+	const auto Y = Sy / Resolution;
+	const auto Shift = (Y & 1) != 0 ? Resolution / 2 : 0;
+	if (bWrapX)
+	{
+		// The samples before the first tile of an odd row belong to the last tile, which continues across the seam
+		return FIntPoint((Sx - Shift + Width) / Resolution % SizeX, Y);
+	}
+	return FIntPoint(FMath::Clamp((Sx - Shift) / Resolution, 0, SizeX - 1), Y);
+}
@@ -0,0 +1,164 @@
+//
+// (C) Copyright 2024 Dirk Michael
+// dirkmichaelnm@gmail.com
+//
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HexHeightGrid.h"
+#include "TerrainErosionSettings.h"
+
+// Defines the log category of this class.
+DECLARE_LOG_CATEGORY_EXTERN(HexTerrainEroder, Log, All);
+
+/**
+ * This class weathers the heights of the tiles with a grid-based hydraulic and thermal erosion. Every tile is
+ * sampled into a block of float heights, odd rows are shifted by half a tile like the hex grid. A step consists of
+ * two passes over blocks of rows: the first one calculates the outflows of every sample from the state of the
+ * previous step, the second one gathers the inflows of the neighbours and only writes its own samples. The passes
+ * are separated by a barrier, so no sample is read while it is written and the result does not depend on the
+ * thread count. Finally the samples are averaged and rounded back to tile heights, the coast line is preserved. On a
+ * wrapping terrain the sample rows wrap around, so the seam erodes like any other place.
+ */
+class HEXWORLD_API FHexTerrainEroder
+{
+public:
+	/**
+	 * Creates a new eroder.
+	 *
+	 * @param InSettings The parameters of the erosion.
+	 * @param bInWrapX If <b>true</b>, the terrain wraps around along the X axis.
+	 */
+	FHexTerrainEroder(const FTerrainErosionSettings& InSettings, const bool bInWrapX);
+
+	/**
+	 * Erodes the heights of the specified grid.
+	 *
+	 * @param HeightGrid The height grid.
+	 */
+	void Erode(FHexHeightGrid& HeightGrid);
+
+private:
+	/**
+	 * The parameters of the erosion.
+	 */
+	FTerrainErosionSettings Settings;
+
+	/**
+	 * If <b>true</b>, the samples wrap around along the X axis, so the water flows across the seam.
+	 */
+	bool bWrapX;
+
+	/**
+	 * The number of samples along each side of a tile.
+	 */
+	int32 Resolution;
+
+	/**
+	 * The number of samples of a row.
+	 */
+	int32 Width;
+
+	/**
+	 * The number of sample rows.
+	 */
+	int32 Length;
+
+	/**
+	 * The heights of the ground.
+	 */
+	TArray<float> Heights;
+
+	/**
+	 * The amounts of water above the ground.
+	 */
+	TArray<float> Water;
+
+	/**
+	 * The amounts of sediment carried by the water.
+	 */
+	TArray<float> Sediment;
+
+	/**
+	 * The flags of the samples that belong to water tiles, the sea swallows all water and sediment.
+	 */
+	TArray<bool> Sea;
+
+	/**
+	 * The water flowing from every sample to its four neighbours (+X, -X, +Y, -Y) during the current step.
+	 */
+	TArray<float> Flux;
+
+	/**
+	 * The amount of sediment per amount of water of every sample during the current step.
+	 */
+	TArray<float> Concentration;
+
+	/**
+	 * The height change of every sample caused by sliding material during the current step.
+	 */
+	TArray<float> ThermalDelta;
+
+	/**
+	 * Determines the resolution and the number of iterations that fit into the work budget.
+	 *
+	 * @param SizeX The number of tiles of a row.
+	 * @param SizeY The number of tile rows.
+	 *
+	 * @return The number of iterations.
+	 */
+	int32 FitWorkBudget(const int32 SizeX, const int32 SizeY);
+
+	/**
+	 * Initializes the samples from the heights of the tiles.
+	 *
+	 * @param HeightGrid The height grid.
+	 */
+	void ReadSamples(const FHexHeightGrid& HeightGrid);
+
+	/**
+	 * Calculates the water flows, the sediment concentrations and the sliding material of the current step.
+	 *
+	 * @param FirstRow The first sample row.
+	 * @param LastRow The sample row after the last one.
+	 */
+	void CalculateFlux(const int32 FirstRow, const int32 LastRow);
+
+	/**
+	 * Moves the water and the sediment, erodes or deposits and adds the rain of the current step.
+	 *
+	 * @param FirstRow The first sample row.
+	 * @param LastRow The sample row after the last one.
+	 * @param Iteration The number of the current step.
+	 */
+	void UpdateSamples(const int32 FirstRow, const int32 LastRow, const int32 Iteration);
+
+	/**
+	 * Returns the indices of the neighbours of the specified sample in the order +X, -X, +Y, -Y. Missing neighbours
+	 * are INDEX_NONE, on a wrapping terrain the neighbours along the X axis continue on the other side.
+	 *
+	 * @param Sx The X coordinate of the sample.
+	 * @param Sy The Y coordinate of the sample.
+	 * @param Neighbours Receives the indices of the neighbours.
+	 */
+	void GetNeighbours(const int32 Sx, const int32 Sy, int32 (&Neighbours)[4]) const;
+
+	/**
+	 * Writes the averaged samples back to the heights of the tiles.
+	 *
+	 * @param HeightGrid The height grid.
+	 */
+	void WriteSamples(FHexHeightGrid& HeightGrid) const;
+
+	/**
+	 * Returns the coordinates of the tile the specified sample belongs to.
+	 *
+	 * @param Sx The X coordinate of the sample.
+	 * @param Sy The Y coordinate of the sample.
+	 * @param SizeX The number of tiles of a row.
+	 *
+	 * @return The coordinates of the tile.
+	 */
+	FIntPoint GetTile(const int32 Sx, const int32 Sy, const int32 SizeX) const;
+};
@@ -0,0 +1,121 @@
+//
+// (C) Copyright 2024 Dirk Michael
+// dirkmichaelnm@gmail.com
+//
+
+#include "HexTerrainGenerator.h"
+
+#include "HexRandom.h"
+#include "Async/ParallelFor.h"
+
+// Defines the log category of this class.
+DEFINE_LOG_CATEGORY(HexTerrainGenerator)
+
+// The number of rows generated by a task
+#define ROWS_PER_TASK 16
+// The distance between two rows relative to the distance between two tiles of a row
+#define ROW_DISTANCE 0.8660254037844386
+// The random stream of the noise offset
+#define NOISE_STREAM 0
+// The random stream of the continents
+#define CONTINENT_STREAM 1
+
+/**
+ * Creates a new generator and places the continents.
+ *
+ * @param InSettings The parameters of the generation.
+ */
+FHexTerrainGenerator::FHexTerrainGenerator(const FTerrainGeneratorSettings& InSettings)
+{
+	Settings = InSettings;
+	Settings.SizeX = FMath::Max(Settings.SizeX, 1);
+	Settings.SizeY = FMath::Max(Settings.SizeY, 1);
+
+	// Derive all random values from the seed, every value has its own counter
+	const auto NoiseRandom = FHexRandom(Settings.Seed, NOISE_STREAM);
+	NoiseOffset = FVector2D(NoiseRandom.GetRange(0, -1000.0, 1000.0), NoiseRandom.GetRange(1, -1000.0, 1000.0));
+	const auto ContinentRandom = FHexRandom(Settings.Seed, CONTINENT_STREAM);
+	const auto Width = Settings.SizeX;
+	const auto Length = Settings.SizeY * ROW_DISTANCE;
+	const auto Radius = FMath::Min(Width, Length) * Settings.ContinentRadius;
+	for (auto Continent = 0; Continent < Settings.ContinentCount; Continent++)
+	{
+		// Keep the centers away from the edges, so the map is surrounded by sea
+		const auto Cx = ContinentRandom.GetRange(FHexRandom::MakeCounter(Continent, 0), 0.2, 0.8) * Width;
+		const auto Cy = ContinentRandom.GetRange(FHexRandom::MakeCounter(Continent, 1), 0.2, 0.8) * Length;
+		ContinentCenters.Add(FVector2D(Cx, Cy));
+		ContinentRadii.Add(Radius * ContinentRandom.GetRange(FHexRandom::MakeCounter(Continent, 2), 0.7, 1.3));
+	}
+}
+
+/**
+ * Generates the heights of all tiles.
+ *
+ * @return The height grid.
+ */
+FHexHeightGrid FHexTerrainGenerator::Generate() const
+{
+	const auto StartTime = FPlatformTime::Seconds();
+	auto HeightGrid = FHexHeightGrid(Settings.SizeX, Settings.SizeY);
+
+	// Every task writes its own rows
+	ParallelFor(FMath::DivideAndRoundUp(Settings.SizeY, ROWS_PER_TASK), [&](const int32 Task)
+	{
+		for (auto Y = Task * ROWS_PER_TASK; Y < FMath::Min((Task + 1) * ROWS_PER_TASK, Settings.SizeY); Y++)
+		{
+			for (auto X = 0; X < Settings.SizeX; X++)
+			{
+				HeightGrid.SetHeight(X, Y, CalculateHeight(X, Y));
+			}
+		}
+	});
+
+	// Log
+	UE_LOG(HexTerrainGenerator, Display, TEXT("Terrain generated (%.1f ms, %d x %d tiles, Seed: %d)."),
+	       (FPlatformTime::Seconds() - StartTime) * 1000.0, Settings.SizeX, Settings.SizeY, Settings.Seed);
+	return HeightGrid;
+}
+
+/**
+ * Calculates the height of the tile at the specified coordinates.
+ *
+ * @param X The X coordinate of the tile.
+ * @param Y The Y coordinate of the tile.
+ *
+ * @return The height of the tile relative to the sea level.
+ */
+int32 FHexTerrainGenerator::CalculateHeight(const int32 X, const int32 Y) const
+{
+	// The center of the tile, odd rows are shifted by half a tile
+	const auto Px = X + ((Y & 1) != 0 ? 0.5 : 0.0);
+	const auto Py = Y * ROW_DISTANCE;
+
+	// Sum up the noise layers, the result is normalized to about -1 to 1
+	auto Noise = 0.0;
+	auto Amplitude = 1.0;
+	auto AmplitudeSum = 0.0;
+	auto Frequency = 1.0 / Settings.FeatureSize;
+	for (auto Octave = 0; Octave < Settings.Octaves; Octave++)
+	{
+		Noise += FMath::PerlinNoise2D(FVector2D(Px * Frequency, Py * Frequency) + NoiseOffset) * Amplitude;
+		AmplitudeSum += Amplitude;
+		Amplitude *= Settings.Persistence;
+		Frequency *= 2.0;
+	}
+	Noise /= FMath::Max(AmplitudeSum, UE_SMALL_NUMBER);
+
+	// The continent mask is 1 at the center of a continent and falls off smoothly to 0 at its radius
+	auto Mask = 0.0;
+	for (auto Continent = 0; Continent < ContinentCenters.Num(); Continent++)
+	{
+		const auto Distance = FVector2D::Distance(FVector2D(Px, Py), ContinentCenters[Continent]);
+		Mask = FMath::Max(Mask, 1.0 - FMath::SmoothStep(0.0, 1.0, Distance / ContinentRadii[Continent]));
+	}
+
+	// Combine the mask and the noise, positive values are land
+	const auto Value = Mask * 2.0 - 1.0 + Noise * Settings.Roughness;
+	const auto Z = Value > 0.0
+		               ? FMath::CeilToInt32(Value * Settings.MaximalHeight)
+		               : FMath::RoundToInt32(Value * Settings.MaximalDepth);
+	return FMath::Clamp(Z, -Settings.MaximalDepth, Settings.MaximalHeight);
+}
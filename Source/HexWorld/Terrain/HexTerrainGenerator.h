@@ -0,0 +1,67 @@
+//
+// (C) Copyright 2024 Dirk Michael
+// dirkmichaelnm@gmail.com
+//
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HexHeightGrid.h"
+#include "TerrainGeneratorSettings.h"
+
+// Defines the log category of this class.
+DECLARE_LOG_CATEGORY_EXTERN(HexTerrainGenerator, Log, All);
+
+/**
+ * This class generates the heights of the tiles from layered noise and a mask of randomly placed continents. All
+ * random values are derived from the seed before the generation starts and the height of every tile only depends on
+ * its coordinates, so the rows can be generated in parallel and the result does not depend on the thread count.
+ */
+class HEXWORLD_API FHexTerrainGenerator
+{
+public:
+	/**
+	 * Creates a new generator and places the continents.
+	 *
+	 * @param InSettings The parameters of the generation.
+	 */
+	explicit FHexTerrainGenerator(const FTerrainGeneratorSettings& InSettings);
+
+	/**
+	 * Generates the heights of all tiles.
+	 *
+	 * @return The height grid.
+	 */
+	FHexHeightGrid Generate() const;
+
+private:
+	/**
+	 * The parameters of the generation.
+	 */
+	FTerrainGeneratorSettings Settings;
+
+	/**
+	 * The offset of the noise, it moves every seed to another region of the noise.
+	 */
+	FVector2D NoiseOffset;
+
+	/**
+	 * The centers of the continents in tile space.
+	 */
+	TArray<FVector2D> ContinentCenters;
+
+	/**
+	 * The radii of the continents in tile space.
+	 */
+	TArray<double> ContinentRadii;
+
+	/**
+	 * Calculates the height of the tile at the specified coordinates.
+	 *
+	 * @param X The X coordinate of the tile.
+	 * @param Y The Y coordinate of the tile.
+	 *
+	 * @return The height of the tile relative to the sea level.
+	 */
+	int32 CalculateHeight(const int32 X, const int32 Y) const;
+};
@@ -0,0 +1,96 @@
+//
+// (C) Copyright 2024 Dirk Michael
+// dirkmichaelnm@gmail.com
+//
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "NoiseParameter.h"
+
+/**
+ * This struct contains all parameters of the terrain mesh generation. It is a plain copy of the properties of the
+ * terrain actor, so a builder never reads from an actor while it generates.
+ */
+struct FHexTerrainSettings
+{
+	/**
+	 * Default constructor.
+	 */
+	FHexTerrainSettings()
+	{
+		HeightUnit = 0.025;
+		WallEdgeHeight = 0.5;
+		WaterOffset = 0.0;
+		Scale = 100.0;
+		ChunkSize = 16;
+		MeshMemoryBudget = 0;
+		NoiseParameterX = FNoiseParameter();
+		NoiseParameterY = FNoiseParameter();
+		NoiseParameterZ = FNoiseParameter();
+		bUseNoiseLattice = false;
+		NoiseLatticeMaxError = 0.01;
+		bWrapX = false;
+	}
+
+	/**
+	 * The amount of the height unit.
+	 */
+	double HeightUnit;
+
+	/**
+	 * The height of the upper and lower edge of a wall (specified in part in height units).
+	 */
+	double WallEdgeHeight;
+
+	/**
+	 * The offset height of the water mesh.
+	 */
+	double WaterOffset;
+
+	/**
+	 * The scale amount for the mesh vertices.
+	 */
+	double Scale;
+
+	/**
+	 * The width and length of a chunk counted in tiles.
+	 */
+	int32 ChunkSize;
+
+	/**
+	 * The maximal memory in megabytes used for generating chunks. Zero means no limit.
+	 */
+	int32 MeshMemoryBudget;
+
+	/**
+	 * Noise parameter for the X axis.
+	 */
+	FNoiseParameter NoiseParameterX;
+
+	/**
+	 * Noise parameter for the Y axis.
+	 */
+	FNoiseParameter NoiseParameterY;
+
+	/**
+	 * Noise parameter for the Z axis.
+	 */
+	FNoiseParameter NoiseParameterZ;
+
+	/**
+	 * If <b>true</b>, the distortion noise is interpolated from a coarse lattice.
+	 */
+	bool bUseNoiseLattice;
+
+	/**
+	 * The maximal error allowed when interpolating the distortion noise from the lattice.
+	 */
+	double NoiseLatticeMaxError;
+
+	/**
+	 * If <b>true</b>, the terrain wraps around along the X axis, so the last column of tiles is the neighbour of the
+	 * first one.
+	 */
+	bool bWrapX;
+};
@@ -0,0 +1,70 @@
+//
+// (C) Copyright 2024 Dirk Michael
+// dirkmichaelnm@gmail.com
+//
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// The magic number at the beginning of a tile page file ("HXTP")
+#define HEX_TILE_PAGE_MAGIC 0x50545848
+// The version of the tile page file format
+#define HEX_TILE_PAGE_VERSION 1
+// The binary logarithm of the number of tiles along each side of a page
+#define HEX_TILE_PAGE_SHIFT 6
+// The number of tiles along each side of a page
+#define HEX_TILE_PAGE_SIZE (1 << HEX_TILE_PAGE_SHIFT)
+
+/**
+ * The header at the beginning of a tile page file. It is followed by the pages in row-major order, every page
+ * containing the heights of HEX_TILE_PAGE_SIZE x HEX_TILE_PAGE_SIZE tiles as 16 bit integers. The pages at the right
+ * and the bottom edge are padded with zeros.
+ */
+struct FHexTilePageHeader
+{
+	/**
+	 * The magic number.
+	 */
+	uint32 Magic;
+
+	/**
+	 * The version of the file format.
+	 */
+	uint32 Version;
+
+	/**
+	 * The hash of all heights.
+	 */
+	uint64 Hash;
+
+	/**
+	 * The width of the map counted in tiles.
+	 */
+	int32 SizeX;
+
+	/**
+	 * The length of the map counted in tiles.
+	 */
+	int32 SizeY;
+
+	/**
+	 * The number of tiles along each side of a page.
+	 */
+	int32 PageSize;
+
+	/**
+	 * The height of the lowest tile.
+	 */
+	int32 MinimalZ;
+
+	/**
+	 * The height of the highest tile.
+	 */
+	int32 MaximalZ;
+
+	/**
+	 * Padding to keep the pages aligned.
+	 */
+	int32 Padding;
+};
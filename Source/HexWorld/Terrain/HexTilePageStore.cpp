@@ -0,0 +1,208 @@
+//
+// (C) Copyright 2024 Dirk Michael
+// dirkmichaelnm@gmail.com
+//
+
+#include "HexTilePageStore.h"
+
+#include "Hash/xxhash.h"
+#include "HAL/PlatformFileManager.h"
+
+// Defines the log category of this class.
+DEFINE_LOG_CATEGORY(HexTilePageStore)
+
+/**
+ * Opens the specified tile page file and validates its header. No page is loaded yet.
+ *
+ * @param Filename The name of the tile page file.
+ * @param InBudgetBytes The memory the resident pages may use, the least recently used pages beyond it are evicted.
+ */
+FHexTilePageStore::FHexTilePageStore(const FString& Filename, const int64 InBudgetBytes)
+{
+	FMemory::Memzero(Header);
+	PageCountX = 0;
+	PageCountY = 0;
+	PageBytes = HEX_TILE_PAGE_SIZE * HEX_TILE_PAGE_SIZE * sizeof(int16);
+	BudgetBytes = InBudgetBytes;
+	Stamp = 0;
+
+	// Open the file and validate the header
+	auto Handle = TUniquePtr<IFileHandle>(FPlatformFileManager::Get().GetPlatformFile().OpenRead(*Filename));
+	if (!Handle.IsValid() || !Handle->Read(reinterpret_cast<uint8*>(&Header), sizeof(Header)))
+	{
+		UE_LOG(HexTilePageStore, Warning, TEXT("Tile page file %s could not be opened."), *Filename);
+		return;
+	}
+	if (Header.Magic != HEX_TILE_PAGE_MAGIC || Header.Version != HEX_TILE_PAGE_VERSION
+		|| Header.PageSize != HEX_TILE_PAGE_SIZE)
+	{
+		UE_LOG(HexTilePageStore, Warning, TEXT("Tile page file %s has an unknown format."), *Filename);
+		return;
+	}
+	PageCountX = FMath::DivideAndRoundUp(Header.SizeX, HEX_TILE_PAGE_SIZE);
+	PageCountY = FMath::DivideAndRoundUp(Header.SizeY, HEX_TILE_PAGE_SIZE);
+	const auto PageCount = static_cast<int64>(PageCountX) * PageCountY;
+	if (Header.SizeX <= 0 || Header.SizeY <= 0 || Handle->Size() != sizeof(Header) + PageCount * PageBytes)
+	{
+		UE_LOG(HexTilePageStore, Warning, TEXT("Tile page file %s is corrupt."), *Filename);
+		return;
+	}
+
+	// The page table has an entry for every page, but no page is resident yet
+	Pages.SetNum(PageCount);
+	PageStamps.SetNumZeroed(PageCount);
+	FileHandle = MoveTemp(Handle);
+
+	// Log
+	UE_LOG(HexTilePageStore, Display, TEXT("Tile page file %s opened (%d x %d tiles, %d x %d pages, Budget: %lld MB)."),
+	       *Filename, Header.SizeX, Header.SizeY, PageCountX, PageCountY, BudgetBytes / (1024 * 1024));
+}
+
+/**
+ * Writes the specified height grid into a tile page file.
+ *
+ * @param Filename The name of the tile page file.
+ * @param HeightGrid The height grid.
+ *
+ * @return <b>true</b>, if the file was written.
+ */
+bool FHexTilePageStore::Write(const FString& Filename, const FHexHeightGrid& HeightGrid)
+{
+	if (HeightGrid.IsEmpty())
+	{
+		return false;
+	}
+	const auto Writer = TUniquePtr<FArchive>(IFileManager::Get().CreateFileWriter(*Filename));
+	if (!Writer.IsValid())
+	{
+		UE_LOG(HexTilePageStore, Warning, TEXT("Tile page file %s could not be created."), *Filename);
+		return false;
+	}
+
+	// Initialize the header, the hash is patched after all pages were written
+	auto Header = FHexTilePageHeader();
+	FMemory::Memzero(Header);
+	Header.Magic = HEX_TILE_PAGE_MAGIC;
+	Header.Version = HEX_TILE_PAGE_VERSION;
+	Header.SizeX = HeightGrid.GetSizeX();
+	Header.SizeY = HeightGrid.GetSizeY();
+	Header.PageSize = HEX_TILE_PAGE_SIZE;
+	Header.MinimalZ = HeightGrid.GetMinimalHeight();
+	Header.MaximalZ = HeightGrid.GetMaximalHeight();
+	Writer->Serialize(&Header, sizeof(Header));
+
+	// Write the pages in row-major order
+	auto HashBuilder = FXxHash64Builder();
+	auto Page = TArray<int16>();
+	Page.SetNumUninitialized(HEX_TILE_PAGE_SIZE * HEX_TILE_PAGE_SIZE);
+	for (auto PageY = 0; PageY < FMath::DivideAndRoundUp(Header.SizeY, HEX_TILE_PAGE_SIZE); PageY++)
+	{
+		for (auto PageX = 0; PageX < FMath::DivideAndRoundUp(Header.SizeX, HEX_TILE_PAGE_SIZE); PageX++)
+		{
+			for (auto Y = 0; Y < HEX_TILE_PAGE_SIZE; Y++)
+			{
+				for (auto X = 0; X < HEX_TILE_PAGE_SIZE; X++)
+				{
+					const auto TileX = PageX * HEX_TILE_PAGE_SIZE + X;
+					const auto TileY = PageY * HEX_TILE_PAGE_SIZE + Y;
+					Page[X + Y * HEX_TILE_PAGE_SIZE] = HeightGrid.Contains(TileX, TileY)
+						                                   ? FMath::Clamp(HeightGrid.GetHeight(TileX, TileY),
+						                                                  MIN_int16, MAX_int16)
+						                                   : 0;
+				}
+			}
+			HashBuilder.Update(Page.GetData(), Page.Num() * sizeof(int16));
+			Writer->Serialize(Page.GetData(), Page.Num() * sizeof(int16));
+		}
+	}
+
+	// Patch the hash
+	Header.Hash = HashBuilder.Finalize().Hash;
+	Writer->Seek(0);
+	Writer->Serialize(&Header, sizeof(Header));
+	if (!Writer->Close())
+	{
+		UE_LOG(HexTilePageStore, Warning, TEXT("Tile page file %s could not be written."), *Filename);
+		return false;
+	}
+
+	// Log
+	UE_LOG(HexTilePageStore, Display, TEXT("Tile page file %s written (%d x %d tiles)."), *Filename, Header.SizeX,
+	       Header.SizeY);
+	return true;
+}
+
+/**
+ * Loads all pages overlapping the specified tile rectangles and evicts the least recently used other pages until
+ * the resident pages fit into the budget. Must not be called while chunks are generated.
+ *
+ * @param Rects The tile rectangles, the maximum is exclusive.
+ *
+ * @return The number of loaded pages.
+ */
+int32 FHexTilePageStore::Prefetch(const TArray<FIntRect>& Rects)
+{
+	if (!IsValid())
+	{
+		return 0;
+	}
+	// Mark the pages of this pass, they are not evicted
+	Stamp++;
+	auto LoadedPages = 0;
+	for (const auto& Rect : Rects)
+	{
+		const auto MinX = FMath::Clamp(Rect.Min.X, 0, Header.SizeX - 1) >> HEX_TILE_PAGE_SHIFT;
+		const auto MinY = FMath::Clamp(Rect.Min.Y, 0, Header.SizeY - 1) >> HEX_TILE_PAGE_SHIFT;
+		const auto MaxX = FMath::Clamp(Rect.Max.X - 1, 0, Header.SizeX - 1) >> HEX_TILE_PAGE_SHIFT;
+		const auto MaxY = FMath::Clamp(Rect.Max.Y - 1, 0, Header.SizeY - 1) >> HEX_TILE_PAGE_SHIFT;
+		for (auto PageY = MinY; PageY <= MaxY; PageY++)
+		{
+			for (auto PageX = MinX; PageX <= MaxX; PageX++)
+			{
+				const auto Page = PageX + PageY * PageCountX;
+				PageStamps[Page] = Stamp;
+				if (Pages[Page].IsEmpty() && LoadPage(Page))
+				{
+					ResidentPages.Add(Page);
+					LoadedPages++;
+				}
+			}
+		}
+	}
+
+	// Evict the least recently used pages of earlier passes
+	if (GetResidentBytes() > BudgetBytes)
+	{
+		ResidentPages.Sort([this](const int32 A, const int32 B) { return PageStamps[A] < PageStamps[B]; });
+		auto Evicted = 0;
+		while (Evicted < ResidentPages.Num() && GetResidentBytes() - Evicted * PageBytes > BudgetBytes
+			&& PageStamps[ResidentPages[Evicted]] != Stamp)
+		{
+			Pages[ResidentPages[Evicted]].Empty();
+			Evicted++;
+		}
+		ResidentPages.RemoveAt(0, Evicted);
+	}
+	return LoadedPages;
+}
+
+/**
+ * Reads the specified page from the file.
+ *
+ * @param Page The index of the page.
+ *
+ * @return <b>true</b>, if the page was read.
+ */
+bool FHexTilePageStore::LoadPage(const int32 Page)
+{
+	auto& Heights = Pages[Page];
+	Heights.SetNumUninitialized(HEX_TILE_PAGE_SIZE * HEX_TILE_PAGE_SIZE);
+	if (!FileHandle->Seek(sizeof(Header) + Page * PageBytes)
+		|| !FileHandle->Read(reinterpret_cast<uint8*>(Heights.GetData()), PageBytes))
+	{
+		UE_LOG(HexTilePageStore, Warning, TEXT("Tile page %d could not be read."), Page);
+		Heights.Empty();
+		return false;
+	}
+	return true;
+}
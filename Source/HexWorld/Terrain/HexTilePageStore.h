@@ -0,0 +1,177 @@
+//
+// (C) Copyright 2024 Dirk Michael
+// dirkmichaelnm@gmail.com
+//
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HexHeightGrid.h"
+#include "HexTilePageFormat.h"
+
+// Defines the log category of this class.
+DECLARE_LOG_CATEGORY_EXTERN(HexTilePageStore, Log, All);
+
+/**
+ * This class provides the heights of a map that is too large to be kept in memory. The heights are stored in fixed
+ * size pages in a tile page file, only the pages around the generated chunks are resident. Pages are loaded and
+ * evicted by Prefetch on the game thread, so the heights of resident pages can be read from any thread while chunks
+ * are generated.
+ */
+class HEXWORLD_API FHexTilePageStore
+{
+public:
+	/**
+	 * Opens the specified tile page file and validates its header. No page is loaded yet.
+	 *
+	 * @param Filename The name of the tile page file.
+	 * @param InBudgetBytes The memory the resident pages may use, the least recently used pages beyond it are evicted.
+	 */
+	FHexTilePageStore(const FString& Filename, const int64 InBudgetBytes);
+
+	/**
+	 * Writes the specified height grid into a tile page file.
+	 *
+	 * @param Filename The name of the tile page file.
+	 * @param HeightGrid The height grid.
+	 *
+	 * @return <b>true</b>, if the file was written.
+	 */
+	static bool Write(const FString& Filename, const FHexHeightGrid& HeightGrid);
+
+	/**
+	 * Returns <b>true</b>, if the file exists and has a valid header.
+	 *
+	 * @return The validity flag.
+	 */
+	FORCEINLINE bool IsValid() const { return FileHandle.IsValid(); }
+
+	/**
+	 * Returns the width of the map counted in tiles.
+	 *
+	 * @return The width.
+	 */
+	FORCEINLINE int32 GetSizeX() const { return Header.SizeX; }
+
+	/**
+	 * Returns the length of the map counted in tiles.
+	 *
+	 * @return The length.
+	 */
+	FORCEINLINE int32 GetSizeY() const { return Header.SizeY; }
+
+	/**
+	 * Returns the height of the lowest tile.
+	 *
+	 * @return The minimal height.
+	 */
+	FORCEINLINE int32 GetMinimalZ() const { return Header.MinimalZ; }
+
+	/**
+	 * Returns the height of the highest tile.
+	 *
+	 * @return The maximal height.
+	 */
+	FORCEINLINE int32 GetMaximalZ() const { return Header.MaximalZ; }
+
+	/**
+	 * Returns the hash of all heights.
+	 *
+	 * @return The hash value.
+	 */
+	FORCEINLINE uint64 GetHash() const { return Header.Hash; }
+
+	/**
+	 * Returns the height of the tile at the specified coordinates, which must be within the map. The page of the tile
+	 * has to be prefetched, otherwise zero is returned.
+	 *
+	 * @param X The X coordinate of the tile.
+	 * @param Y The Y coordinate of the tile.
+	 *
+	 * @return The height of the tile.
+	 */
+	FORCEINLINE int32 GetHeight(const int32 X, const int32 Y) const
+	{
+		const auto& Page = Pages[(X >> HEX_TILE_PAGE_SHIFT) + (Y >> HEX_TILE_PAGE_SHIFT) * PageCountX];
+		return Page.IsEmpty()
+			       ? 0
+			       : Page[(X & (HEX_TILE_PAGE_SIZE - 1)) + (Y & (HEX_TILE_PAGE_SIZE - 1)) * HEX_TILE_PAGE_SIZE];
+	}
+
+	/**
+	 * Loads all pages overlapping the specified tile rectangles and evicts the least recently used other pages until
+	 * the resident pages fit into the budget. Must not be called while chunks are generated.
+	 *
+	 * @param Rects The tile rectangles, the maximum is exclusive.
+	 *
+	 * @return The number of loaded pages.
+	 */
+	int32 Prefetch(const TArray<FIntRect>& Rects);
+
+	/**
+	 * Returns the memory used by the resident pages.
+	 *
+	 * @return The resident memory in bytes.
+	 */
+	FORCEINLINE int64 GetResidentBytes() const { return ResidentPages.Num() * PageBytes; }
+
+private:
+	/**
+	 * The handle of the open file.
+	 */
+	TUniquePtr<IFileHandle> FileHandle;
+
+	/**
+	 * The header of the file.
+	 */
+	FHexTilePageHeader Header;
+
+	/**
+	 * The number of pages along the X axis.
+	 */
+	int32 PageCountX;
+
+	/**
+	 * The number of pages along the Y axis.
+	 */
+	int32 PageCountY;
+
+	/**
+	 * The size of a page in bytes.
+	 */
+	int64 PageBytes;
+
+	/**
+	 * The memory the resident pages may use.
+	 */
+	int64 BudgetBytes;
+
+	/**
+	 * The heights of all pages, empty for pages that are not resident.
+	 */
+	TArray<TArray<int16>> Pages;
+
+	/**
+	 * The prefetch pass that used a page the last time, per page.
+	 */
+	TArray<uint64> PageStamps;
+
+	/**
+	 * The indices of the resident pages.
+	 */
+	TArray<int32> ResidentPages;
+
+	/**
+	 * The counter of the prefetch passes.
+	 */
+	uint64 Stamp;
+
+	/**
+	 * Reads the specified page from the file.
+	 *
+	 * @param Page The index of the page.
+	 *
+	 * @return <b>true</b>, if the page was read.
+	 */
+	bool LoadPage(const int32 Page);
+};
@@ -0,0 +1,154 @@
+//
+// (C) Copyright 2024 Dirk Michael
+// dirkmichaelnm@gmail.com
+//
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * This class is an immutable version of the heights of all tiles. The heights are split into square chunks that are
+ * shared between versions, a new version only copies the chunks that changed. A pinned snapshot can be read from any
+ * thread without locks while the game thread publishes newer versions.
+ */
+class HEXWORLD_API FHexTileSnapshot
+{
+	friend class FHexTileSnapshotStore;
+
+public:
+	/**
+	 * Creates an empty snapshot.
+	 */
+	FHexTileSnapshot()
+	{
+		Version = 0;
+		SizeX = 0;
+		SizeY = 0;
+		ChunkSize = 1;
+		ChunkCountX = 0;
+	}
+
+	/**
+	 * The heights of a chunk of tiles.
+	 */
+	struct FChunk
+	{
+		/**
+		 * The version of the snapshot the chunk was changed in.
+		 */
+		uint64 Version;
+
+		/**
+		 * The heights of the tiles, Index = X + Y * ChunkSize, the tiles beyond the edge are zero.
+		 */
+		TArray<int16> Heights;
+	};
+
+	/**
+	 * Returns the version of the snapshot, it increases with every published snapshot.
+	 *
+	 * @return The version.
+	 */
+	FORCEINLINE uint64 GetVersion() const { return Version; }
+
+	/**
+	 * Returns the width of the grid counted in tiles.
+	 *
+	 * @return The width.
+	 */
+	FORCEINLINE int32 GetSizeX() const { return SizeX; }
+
+	/**
+	 * Returns the length of the grid counted in tiles.
+	 *
+	 * @return The length.
+	 */
+	FORCEINLINE int32 GetSizeY() const { return SizeY; }
+
+	/**
+	 * Returns the number of tiles along each side of a chunk.
+	 *
+	 * @return The chunk size.
+	 */
+	FORCEINLINE int32 GetChunkSize() const { return ChunkSize; }
+
+	/**
+	 * Checks if the specified coordinates are within the grid.
+	 *
+	 * @param X The X coordinate of the tile.
+	 * @param Y The Y coordinate of the tile.
+	 *
+	 * @return If the coordinates are valid then <b>true</b>, otherwise <b>false</b>.
+	 */
+	FORCEINLINE bool Contains(const int32 X, const int32 Y) const { return X >= 0 && X < SizeX && Y >= 0 && Y < SizeY; }
+
+	/**
+	 * Returns the height of the tile at the specified coordinates, which must be within the grid.
+	 *
+	 * @param X The X coordinate of the tile.
+	 * @param Y The Y coordinate of the tile.
+	 *
+	 * @return The height of the tile.
+	 */
+	FORCEINLINE int32 GetHeight(const int32 X, const int32 Y) const
+	{
+		const auto& Chunk = *Chunks[X / ChunkSize + Y / ChunkSize * ChunkCountX];
+		return Chunk.Heights[X % ChunkSize + Y % ChunkSize * ChunkSize];
+	}
+
+	/**
+	 * Returns the chunks that differ from the specified older snapshot of the same grid, e.g. to update only the
+	 * data derived from the changed chunks.
+	 *
+	 * @param Older The older snapshot.
+	 *
+	 * @return The indices of the changed chunks, Index = ChunkX + ChunkY * ChunkCountX. All chunks, if the snapshots
+	 *         have different sizes.
+	 */
+	TArray<int32> FindChangedChunks(const FHexTileSnapshot& Older) const
+	{
+		auto ChangedChunks = TArray<int32>();
+		const auto bSameLayout = SizeX == Older.SizeX && SizeY == Older.SizeY && ChunkSize == Older.ChunkSize;
+		for (auto Chunk = 0; Chunk < Chunks.Num(); Chunk++)
+		{
+			// Unchanged chunks are shared, so comparing the pointers is enough
+			if (!bSameLayout || Chunks[Chunk] != Older.Chunks[Chunk])
+			{
+				ChangedChunks.Add(Chunk);
+			}
+		}
+		return ChangedChunks;
+	}
+
+private:
+	/**
+	 * The version of the snapshot.
+	 */
+	uint64 Version;
+
+	/**
+	 * The width of the grid counted in tiles.
+	 */
+	int32 SizeX;
+
+	/**
+	 * The length of the grid counted in tiles.
+	 */
+	int32 SizeY;
+
+	/**
+	 * The number of tiles along each side of a chunk.
+	 */
+	int32 ChunkSize;
+
+	/**
+	 * The number of chunks along the X axis.
+	 */
+	int32 ChunkCountX;
+
+	/**
+	 * The chunks, Index = ChunkX + ChunkY * ChunkCountX. They are shared with other snapshots.
+	 */
+	TArray<TSharedRef<const FChunk>> Chunks;
+};
@@ -0,0 +1,137 @@
+//
+// (C) Copyright 2024 Dirk Michael
+// dirkmichaelnm@gmail.com
+//
+
+#include "HexTileSnapshotStore.h"
+
+// Defines the log category of this class.
+DEFINE_LOG_CATEGORY(HexTileSnapshotStore)
+
+/**
+ * Creates a store with an empty snapshot.
+ */
+FHexTileSnapshotStore::FHexTileSnapshotStore()
+	: Current(MakeShared<const FHexTileSnapshot>())
+{
+}
+
+/**
+ * Publishes a snapshot of the whole height grid, e.g. after a new build.
+ *
+ * @param HeightGrid The height grid.
+ * @param ChunkSize The number of tiles along each side of a chunk.
+ */
+void FHexTileSnapshotStore::Publish(const FHexHeightGrid& HeightGrid, const int32 ChunkSize)
+{
+	// Create the layout of the new snapshot
+	const auto Snapshot = MakeShared<FHexTileSnapshot>();
+	Snapshot->Version = Pin()->GetVersion() + 1;
+	Snapshot->SizeX = HeightGrid.GetSizeX();
+	Snapshot->SizeY = HeightGrid.GetSizeY();
+	Snapshot->ChunkSize = FMath::Max(ChunkSize, 1);
+	Snapshot->ChunkCountX = FMath::DivideAndRoundUp(Snapshot->SizeX, Snapshot->ChunkSize);
+	const auto ChunkCount = Snapshot->ChunkCountX * FMath::DivideAndRoundUp(Snapshot->SizeY, Snapshot->ChunkSize);
+
+	// Copy all chunks
+	Snapshot->Chunks.Reserve(ChunkCount);
+	for (auto Chunk = 0; Chunk < ChunkCount; Chunk++)
+	{
+		Snapshot->Chunks.Add(CopyChunk(HeightGrid, *Snapshot, Chunk));
+	}
+
+	// Exchange the current snapshot, readers still holding the previous one are not affected
+	{
+		FWriteScopeLock WriteLock(CurrentLock);
+		Current = Snapshot;
+	}
+
+	// Log
+	UE_LOG(HexTileSnapshotStore, Verbose, TEXT("Snapshot %llu published (Chunks: %d)."), Snapshot->Version,
+	       ChunkCount);
+}
+
+/**
+ * Publishes a snapshot that copies the chunks of the specified tiles from the height grid and shares all other
+ * chunks with the current snapshot. If the grid has another size, the whole grid is published.
+ *
+ * @param HeightGrid The height grid.
+ * @param ChangedTiles The coordinates of the tiles changed since the current snapshot.
+ */
+void FHexTileSnapshotStore::Publish(const FHexHeightGrid& HeightGrid, const TArray<FIntPoint>& ChangedTiles)
+{
+	const auto Previous = Pin();
+	if (Previous->SizeX != HeightGrid.GetSizeX() || Previous->SizeY != HeightGrid.GetSizeY())
+	{
+		Publish(HeightGrid, Previous->ChunkSize);
+		return;
+	}
+
+	// Share all chunks of the previous snapshot and replace the changed ones
+	const auto Snapshot = MakeShared<FHexTileSnapshot>(*Previous);
+	Snapshot->Version = Previous->Version + 1;
+	auto CopiedChunks = TSet<int32>();
+	for (const auto& Tile : ChangedTiles)
+	{
+		if (!HeightGrid.Contains(Tile.X, Tile.Y))
+		{
+			continue;
+		}
+		const auto Chunk = Tile.X / Snapshot->ChunkSize + Tile.Y / Snapshot->ChunkSize * Snapshot->ChunkCountX;
+		if (!CopiedChunks.Contains(Chunk))
+		{
+			CopiedChunks.Add(Chunk);
+			Snapshot->Chunks[Chunk] = CopyChunk(HeightGrid, *Snapshot, Chunk);
+		}
+	}
+
+	// Exchange the current snapshot, readers still holding the previous one are not affected
+	{
+		FWriteScopeLock WriteLock(CurrentLock);
+		Current = Snapshot;
+	}
+
+	// Log
+	UE_LOG(HexTileSnapshotStore, Verbose, TEXT("Snapshot %llu published (Changed Chunks: %d)."), Snapshot->Version,
+	       CopiedChunks.Num());
+}
+
+/**
+ * Returns the current snapshot. It stays valid and unchanged as long as the reader holds it.
+ *
+ * @return The pinned snapshot.
+ */
+TSharedRef<const FHexTileSnapshot> FHexTileSnapshotStore::Pin() const
+{
+	FReadScopeLock ReadLock(CurrentLock);
+	return Current;
+}
+
+/**
+ * Copies the heights of a chunk from the height grid.
+ *
+ * @param HeightGrid The height grid.
+ * @param Snapshot The snapshot the chunk belongs to.
+ * @param Chunk The index of the chunk.
+ *
+ * @return The new chunk.
+ */
+TSharedRef<const FHexTileSnapshot::FChunk> FHexTileSnapshotStore::CopyChunk(const FHexHeightGrid& HeightGrid,
+                                                                           const FHexTileSnapshot& Snapshot,
+                                                                           const int32 Chunk)
+{
+	const auto ChunkSize = Snapshot.ChunkSize;
+	const auto MinX = Chunk % Snapshot.ChunkCountX * ChunkSize;
+	const auto MinY = Chunk / Snapshot.ChunkCountX * ChunkSize;
+	const auto NewChunk = MakeShared<FHexTileSnapshot::FChunk>();
+	NewChunk->Version = Snapshot.Version;
+	NewChunk->Heights.SetNumZeroed(ChunkSize * ChunkSize);
+	for (auto Y = 0; Y < FMath::Min(ChunkSize, Snapshot.SizeY - MinY); Y++)
+	{
+		for (auto X = 0; X < FMath::Min(ChunkSize, Snapshot.SizeX - MinX); X++)
+		{
+			NewChunk->Heights[X + Y * ChunkSize] = HeightGrid.GetHeight(MinX + X, MinY + Y);
+		}
+	}
+	return NewChunk;
+}
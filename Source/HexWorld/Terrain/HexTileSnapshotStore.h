@@ -0,0 +1,75 @@
+//
+// (C) Copyright 2024 Dirk Michael
+// dirkmichaelnm@gmail.com
+//
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HexHeightGrid.h"
+#include "HexTileSnapshot.h"
+
+// Defines the log category of this class.
+DECLARE_LOG_CATEGORY_EXTERN(HexTileSnapshotStore, Log, All);
+
+/**
+ * This class publishes versions of the tile heights for readers on other threads, e.g. AI, pathfinding or mesh
+ * generation. The game thread publishes a new snapshot after every change, only the changed chunks are copied and
+ * the others are shared with the previous version. Readers pin the current snapshot and keep a consistent view as
+ * long as they hold it, the lock only guards the exchange of the pointer.
+ */
+class HEXWORLD_API FHexTileSnapshotStore
+{
+public:
+	/**
+	 * Creates a store with an empty snapshot.
+	 */
+	FHexTileSnapshotStore();
+
+	/**
+	 * Publishes a snapshot of the whole height grid, e.g. after a new build.
+	 *
+	 * @param HeightGrid The height grid.
+	 * @param ChunkSize The number of tiles along each side of a chunk.
+	 */
+	void Publish(const FHexHeightGrid& HeightGrid, const int32 ChunkSize);
+
+	/**
+	 * Publishes a snapshot that copies the chunks of the specified tiles from the height grid and shares all other
+	 * chunks with the current snapshot. If the grid has another size, the whole grid is published.
+	 *
+	 * @param HeightGrid The height grid.
+	 * @param ChangedTiles The coordinates of the tiles changed since the current snapshot.
+	 */
+	void Publish(const FHexHeightGrid& HeightGrid, const TArray<FIntPoint>& ChangedTiles);
+
+	/**
+	 * Returns the current snapshot. It stays valid and unchanged as long as the reader holds it.
+	 *
+	 * @return The pinned snapshot.
+	 */
+	TSharedRef<const FHexTileSnapshot> Pin() const;
+
+private:
+	/**
+	 * The current snapshot.
+	 */
+	TSharedRef<const FHexTileSnapshot> Current;
+
+	/**
+	 * The lock guarding the exchange of the current snapshot.
+	 */
+	mutable FRWLock CurrentLock;
+
+	/**
+	 * Copies the heights of a chunk from the height grid.
+	 *
+	 * @param HeightGrid The height grid.
+	 * @param Snapshot The snapshot the chunk belongs to.
+	 * @param Chunk The index of the chunk.
+	 *
+	 * @return The new chunk.
+	 */
+	static TSharedRef<const FHexTileSnapshot::FChunk> CopyChunk(const FHexHeightGrid& HeightGrid,
+	                                                           const FHexTileSnapshot& Snapshot, const int32 Chunk);
+};
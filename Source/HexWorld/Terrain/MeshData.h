@@ -42,4 +42,15 @@ struct FMeshData
 	 * Struct with information about the size of the terrain.
 	 */
 	FTerrainSize TerrainSize;
+
+	/**
+	 * Returns the number of bytes allocated by the map and the arrays.
+	 *
+	 * @return The allocated size in bytes.
+	 */
+	SIZE_T GetAllocatedSize() const
+	{
+		return VertexMap.GetAllocatedSize() + RawVertexArray.GetAllocatedSize() + VertexArray.GetAllocatedSize()
+			+ TriangleArray.GetAllocatedSize();
+	}
 };
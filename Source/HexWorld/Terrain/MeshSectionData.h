@@ -0,0 +1,38 @@
+//
+// (C) Copyright 2024 Dirk Michael
+// dirkmichaelnm@gmail.com
+//
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MeshSectionData.generated.h"
+
+/**
+ * This struct contains the final buffers of a mesh section that are handed over to the mesh components.
+ */
+USTRUCT()
+struct FMeshSectionData
+{
+	GENERATED_BODY()
+
+	/**
+	 * Array containing the vertices of the mesh section.
+	 */
+	TArray<FVector> Vertices;
+
+	/**
+	 * Array containing the vertex indicies defining the triangles of the mesh section.
+	 */
+	TArray<int32> Triangles;
+
+	/**
+	 * Array containing the normal vectors of the vertices.
+	 */
+	TArray<FVector> Normals;
+
+	/**
+	 * Array containing the UV coordinates of the vertices.
+	 */
+	TArray<FVector2D> UVs;
+};
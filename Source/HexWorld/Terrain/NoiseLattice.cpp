@@ -0,0 +1,254 @@
+//
+// (C) Copyright 2024 Dirk Michael
+// dirkmichaelnm@gmail.com
+//
+
+#include "NoiseLattice.h"
+
+// Defines the log category of this class.
+DEFINE_LOG_CATEGORY(NoiseLattice)
+
+// The number of lattice nodes along each side of a block
+#define BLOCK_SIZE 32
+// The number of sample points used for estimating the interpolation error
+#define ERROR_SAMPLES 256
+
+/**
+ * Divides the specified dividend by the block size and rounds down, also for negative values.
+ *
+ * @param Value The dividend.
+ *
+ * @return The block coordinate.
+ */
+static int32 ToBlockCoordinate(const int32 Value)
+{
+	return Value >= 0 ? Value / BLOCK_SIZE : (Value - BLOCK_SIZE + 1) / BLOCK_SIZE;
+}
+
+/**
+ * Creates a new lattice.
+ *
+ * @param InSampler The noise function that is sampled at the lattice nodes.
+ * @param InSpacing The distance between two lattice nodes.
+ */
+FNoiseLattice::FNoiseLattice(const TFunction<double(double, double)>& InSampler, const double InSpacing)
+{
+	Sampler = InSampler;
+	Spacing = InSpacing;
+	MeasuredError = 0.0;
+}
+
+/**
+ * Creates a new lattice whose spacing is refined until the interpolation error within the specified region is
+ * below the maximal error or the minimal spacing is reached.
+ *
+ * @param Sampler The noise function that is sampled at the lattice nodes.
+ * @param InitialSpacing The spacing the refinement starts with.
+ * @param MinimalSpacing The spacing the refinement stops at.
+ * @param MaximalError The maximal allowed interpolation error.
+ * @param Region The region of the noise function that is used for estimating the error.
+ *
+ * @return The shared pointer to the new lattice.
+ */
+TSharedPtr<FNoiseLattice> FNoiseLattice::Create(const TFunction<double(double, double)>& Sampler,
+                                                const double InitialSpacing, const double MinimalSpacing,
+                                                const double MaximalError, const FBox2D& Region)
+{
+	// Start with the coarsest lattice
+	auto Spacing = FMath::Max(InitialSpacing, MinimalSpacing);
+	auto Lattice = MakeShared<FNoiseLattice>(Sampler, Spacing);
+	auto Error = Lattice->EstimateError(Region, ERROR_SAMPLES);
+	// Halve the spacing as long as the error is too big
+	while (Error > MaximalError && Spacing * 0.5 >= MinimalSpacing)
+	{
+		Spacing *= 0.5;
+		Lattice = MakeShared<FNoiseLattice>(Sampler, Spacing);
+		Error = Lattice->EstimateError(Region, ERROR_SAMPLES);
+	}
+	// Store the measured error
+	Lattice->MeasuredError = Error;
+
+	// Log
+	if (Error > MaximalError)
+	{
+		UE_LOG(NoiseLattice, Warning, TEXT("Lattice error %f exceeds maximal error %f at minimal spacing %f."), Error,
+		       MaximalError, Spacing);
+	}
+	else
+	{
+		UE_LOG(NoiseLattice, Display, TEXT("Lattice created (Spacing: %f, Error: %f, Maximal Error: %f)."), Spacing,
+		       Error, MaximalError);
+	}
+
+	// Return the lattice
+	return Lattice;
+}
+
+/**
+ * Returns the interpolated noise value at the specified coordinates.
+ *
+ * @param Px X coordinate.
+ * @param Py Y coordinate.
+ *
+ * @return The interpolated noise value.
+ */
+double FNoiseLattice::Sample(const double Px, const double Py) const
+{
+	// Calculate the lattice cell and the position within the cell
+	const auto Lx = Px / Spacing;
+	const auto Ly = Py / Spacing;
+	const auto I = FMath::FloorToInt32(Lx);
+	const auto J = FMath::FloorToInt32(Ly);
+	const auto Tx = Lx - I;
+	const auto Ty = Ly - J;
+
+	// Collect the 4 x 4 nodes around the cell
+	double Nodes[4][4];
+	const auto BlockX = ToBlockCoordinate(I - 1);
+	const auto BlockY = ToBlockCoordinate(J - 1);
+	if (BlockX == ToBlockCoordinate(I + 2) && BlockY == ToBlockCoordinate(J + 2))
+	{
+		// All nodes are within one block, so the block is looked up only once
+		const auto& Block = GetBlock(FIntPoint(BlockX, BlockY));
+		const auto Bi = I - 1 - BlockX * BLOCK_SIZE;
+		const auto Bj = J - 1 - BlockY * BLOCK_SIZE;
+		for (auto Row = 0; Row < 4; Row++)
+		{
+			for (auto Col = 0; Col < 4; Col++)
+			{
+				Nodes[Row][Col] = Block.Values[Bi + Col + (Bj + Row) * BLOCK_SIZE];
+			}
+		}
+	}
+	else
+	{
+		// The nodes are spread over several blocks
+		for (auto Row = 0; Row < 4; Row++)
+		{
+			for (auto Col = 0; Col < 4; Col++)
+			{
+				Nodes[Row][Col] = GetNode(I - 1 + Col, J - 1 + Row);
+			}
+		}
+	}
+
+	// Interpolate the rows and then the resulting column
+	double Rows[4];
+	for (auto Row = 0; Row < 4; Row++)
+	{
+		Rows[Row] = CatmullRom(Nodes[Row][0], Nodes[Row][1], Nodes[Row][2], Nodes[Row][3], Tx);
+	}
+	return CatmullRom(Rows[0], Rows[1], Rows[2], Rows[3], Ty);
+}
+
+/**
+ * Estimates the maximal interpolation error within the specified region by comparing interpolated and exact
+ * values at a fixed set of sample points.
+ *
+ * @param Region The region to be checked.
+ * @param SampleCount The number of sample points.
+ *
+ * @return The maximal absolute error found.
+ */
+double FNoiseLattice::EstimateError(const FBox2D& Region, const int32 SampleCount) const
+{
+	// The size of the region
+	const auto Size = Region.GetSize();
+	// The maximal error found
+	auto Error = 0.0;
+	// Iterate over a low discrepancy sequence of sample points
+	for (auto I = 0; I < SampleCount; I++)
+	{
+		const auto Px = Region.Min.X + FMath::Frac(0.5 + I * 0.7548776662466927) * Size.X;
+		const auto Py = Region.Min.Y + FMath::Frac(0.5 + I * 0.5698402909980532) * Size.Y;
+		Error = FMath::Max(Error, FMath::Abs(Sample(Px, Py) - Sampler(Px, Py)));
+	}
+	// Return the maximal error
+	return Error;
+}
+
+/**
+ * Returns the number of cached blocks.
+ *
+ * @return The block count.
+ */
+int32 FNoiseLattice::GetBlockCount() const
+{
+	FReadScopeLock ReadLock(BlocksLock);
+	return Blocks.Num();
+}
+
+/**
+ * Returns the block with the specified block coordinates. If the block is not cached yet, it is sampled.
+ *
+ * @param Key The block coordinates.
+ *
+ * @return The block.
+ */
+const FNoiseLattice::FBlock& FNoiseLattice::GetBlock(const FIntPoint& Key) const
+{
+	// Look for a cached block first
+	{
+		FReadScopeLock ReadLock(BlocksLock);
+		if (const auto Block = Blocks.Find(Key))
+		{
+			return **Block;
+		}
+	}
+
+	// Sample the block outside of the lock
+	auto NewBlock = MakeUnique<FBlock>();
+	NewBlock->Values.SetNumUninitialized(BLOCK_SIZE * BLOCK_SIZE);
+	for (auto J = 0; J < BLOCK_SIZE; J++)
+	{
+		for (auto I = 0; I < BLOCK_SIZE; I++)
+		{
+			const auto Px = (Key.X * BLOCK_SIZE + I) * Spacing;
+			const auto Py = (Key.Y * BLOCK_SIZE + J) * Spacing;
+			NewBlock->Values[I + J * BLOCK_SIZE] = Sampler(Px, Py);
+		}
+	}
+
+	// Add the block, unless another thread was faster
+	FWriteScopeLock WriteLock(BlocksLock);
+	if (const auto Block = Blocks.Find(Key))
+	{
+		return **Block;
+	}
+	return *Blocks.Add(Key, MoveTemp(NewBlock));
+}
+
+/**
+ * Returns the value of the lattice node with the specified node coordinates.
+ *
+ * @param I The node coordinate along the X axis.
+ * @param J The node coordinate along the Y axis.
+ *
+ * @return The node value.
+ */
+double FNoiseLattice::GetNode(const int32 I, const int32 J) const
+{
+	const auto BlockX = ToBlockCoordinate(I);
+	const auto BlockY = ToBlockCoordinate(J);
+	const auto& Block = GetBlock(FIntPoint(BlockX, BlockY));
+	return Block.Values[I - BlockX * BLOCK_SIZE + (J - BlockY * BLOCK_SIZE) * BLOCK_SIZE];
+}
+
+/**
+ * Interpolates between P1 and P2 with a Catmull-Rom spline.
+ *
+ * @param P0 The value before P1.
+ * @param P1 The value at T = 0.
+ * @param P2 The value at T = 1.
+ * @param P3 The value after P2.
+ * @param T The interpolation factor.
+ *
+ * @return The interpolated value.
+ */
+double FNoiseLattice::CatmullRom(const double P0, const double P1, const double P2, const double P3, const double T)
+{
+	return 0.5 * (2.0 * P1
+		+ (P2 - P0) * T
+		+ (2.0 * P0 - 5.0 * P1 + 4.0 * P2 - P3) * T * T
+		+ (3.0 * (P1 - P2) + P3 - P0) * T * T * T);
+}
@@ -0,0 +1,157 @@
+//
+// (C) Copyright 2024 Dirk Michael
+// dirkmichaelnm@gmail.com
+//
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Misc/ScopeRWLock.h"
+
+// Defines the log category of this class.
+DECLARE_LOG_CATEGORY_EXTERN(NoiseLattice, Log, All);
+
+/**
+ * This class caches the values of a two dimensional noise function on a coarse lattice and interpolates them with
+ * Catmull-Rom splines. The lattice is aligned to the origin and stored in square blocks that are sampled lazily, so
+ * neighbouring chunks of the terrain share the same nodes and their borders stay seamless. The cache may be read and
+ * filled from several threads at the same time.
+ */
+class HEXWORLD_API FNoiseLattice
+{
+public:
+	/**
+	 * Creates a new lattice.
+	 *
+	 * @param InSampler The noise function that is sampled at the lattice nodes.
+	 * @param InSpacing The distance between two lattice nodes.
+	 */
+	FNoiseLattice(const TFunction<double(double, double)>& InSampler, const double InSpacing);
+
+	/**
+	 * Creates a new lattice whose spacing is refined until the interpolation error within the specified region is
+	 * below the maximal error or the minimal spacing is reached.
+	 *
+	 * @param Sampler The noise function that is sampled at the lattice nodes.
+	 * @param InitialSpacing The spacing the refinement starts with.
+	 * @param MinimalSpacing The spacing the refinement stops at.
+	 * @param MaximalError The maximal allowed interpolation error.
+	 * @param Region The region of the noise function that is used for estimating the error.
+	 *
+	 * @return The shared pointer to the new lattice.
+	 */
+	static TSharedPtr<FNoiseLattice> Create(const TFunction<double(double, double)>& Sampler,
+	                                        const double InitialSpacing, const double MinimalSpacing,
+	                                        const double MaximalError, const FBox2D& Region);
+
+	/**
+	 * Returns the interpolated noise value at the specified coordinates.
+	 *
+	 * @param Px X coordinate.
+	 * @param Py Y coordinate.
+	 *
+	 * @return The interpolated noise value.
+	 */
+	double Sample(const double Px, const double Py) const;
+
+	/**
+	 * Estimates the maximal interpolation error within the specified region by comparing interpolated and exact
+	 * values at a fixed set of sample points.
+	 *
+	 * @param Region The region to be checked.
+	 * @param SampleCount The number of sample points.
+	 *
+	 * @return The maximal absolute error found.
+	 */
+	double EstimateError(const FBox2D& Region, const int32 SampleCount) const;
+
+	/**
+	 * Returns the distance between two lattice nodes.
+	 *
+	 * @return The lattice spacing.
+	 */
+	FORCEINLINE double GetSpacing() const { return Spacing; }
+
+	/**
+	 * Returns the maximal interpolation error measured when the lattice was created.
+	 *
+	 * @return The measured error.
+	 */
+	FORCEINLINE double GetMeasuredError() const { return MeasuredError; }
+
+	/**
+	 * Returns the number of cached blocks.
+	 *
+	 * @return The block count.
+	 */
+	int32 GetBlockCount() const;
+
+private:
+	/**
+	 * A square block of sampled lattice nodes.
+	 */
+	struct FBlock
+	{
+		/**
+		 * The node values, Index = I + J * BlockSize.
+		 */
+		TArray<double> Values;
+	};
+
+	/**
+	 * The noise function.
+	 */
+	TFunction<double(double, double)> Sampler;
+
+	/**
+	 * The distance between two lattice nodes.
+	 */
+	double Spacing;
+
+	/**
+	 * The error measured when the lattice was created.
+	 */
+	double MeasuredError;
+
+	/**
+	 * The cached blocks, mapped by their block coordinates.
+	 */
+	mutable TMap<FIntPoint, TUniquePtr<FBlock>> Blocks;
+
+	/**
+	 * Lock guarding the block map.
+	 */
+	mutable FRWLock BlocksLock;
+
+	/**
+	 * Returns the block with the specified block coordinates. If the block is not cached yet, it is sampled.
+	 *
+	 * @param Key The block coordinates.
+	 *
+	 * @return The block.
+	 */
+	const FBlock& GetBlock(const FIntPoint& Key) const;
+
+	/**
+	 * Returns the value of the lattice node with the specified node coordinates.
+	 *
+	 * @param I The node coordinate along the X axis.
+	 * @param J The node coordinate along the Y axis.
+	 *
+	 * @return The node value.
+	 */
+	double GetNode(const int32 I, const int32 J) const;
+
+	/**
+	 * Interpolates between P1 and P2 with a Catmull-Rom spline.
+	 *
+	 * @param P0 The value before P1.
+	 * @param P1 The value at T = 0.
+	 * @param P2 The value at T = 1.
+	 * @param P3 The value after P2.
+	 * @param T The interpolation factor.
+	 *
+	 * @return The interpolated value.
+	 */
+	static double CatmullRom(const double P0, const double P1, const double P2, const double P3, const double T);
+};
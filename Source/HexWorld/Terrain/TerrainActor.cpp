@@ -5,72 +5,32 @@
 
 #include "TerrainActor.h"
 
-#include "IntVectorTypes.h"
-#include "TileDirection.h"
+#include "HeightmapFileReader.h"
+#include "HexTerrainEroder.h"
+#include "HexTerrainGenerator.h"
+#include "TerrainMeshBaker.h"
+#include "TerrainMeshCacheReader.h"
+#include "TerrainMeshCacheWriter.h"
+#include "TerrainMeshExporter.h"
+#include "TerrainSaveFile.h"
+#include "Async/Async.h"
+#include "Engine/AssetManager.h"
+#include "Hash/xxhash.h"
+
+#if WITH_EDITOR
+#include "Editor.h"
+#include "Subsystems/ImportSubsystem.h"
+#endif
 
 // Defines the log category of this class.
 DEFINE_LOG_CATEGORY(TerrainActor)
-// Define the enum range for tile directions.
-ENUM_RANGE_BY_FIRST_AND_LAST(ETileDirection, ETileDirection::TopRight, ETileDirection::TopLeft)
-
-// The width of a tile
-#define TILE_WIDTH sqrt(3.0) / 2.0
-// The factor for creating a vertex key
-#define KEY_FACTOR 1000000.0
-
-/**
- * Defines the indicies of the vertices for each of the six parts of a hexagon tile.
- */
-const int32 EdgeVertices[6][35] = {
-	// Top Right
-	{
-		1600, 1536, 1472, 1408, 1344,
-		1732, 1668, 1604, 1540, 1476, 1412,
-		1864, 1800, 1736, 1672, 1608, 1544, 1480,
-		1996, 1932, 1868, 1804, 1740, 1676, 1612, 1548,
-		2128, 2064, 2000, 1936, 1872, 1808, 1744, 1680, 1616
-	},
-	// Right
-	{
-		1344, 1212, 1080, 948, 816,
-		1412, 1280, 1148, 1016, 884, 752,
-		1480, 1348, 1216, 1084, 952, 820, 688,
-		1548, 1416, 1284, 1152, 1020, 888, 756, 624,
-		1616, 1484, 1352, 1220, 1088, 956, 824, 692, 560
-	},
-	// Bottom Right
-	{
-		816, 748, 680, 612, 544,
-		752, 684, 616, 548, 480, 412,
-		688, 620, 552, 484, 416, 348, 280,
-		624, 556, 488, 420, 352, 284, 216, 148,
-		560, 492, 424, 356, 288, 220, 152, 84, 16
-	},
-	// Bottom Left
-	{
-		544, 608, 672, 736, 800,
-		412, 476, 540, 604, 668, 732,
-		280, 344, 408, 472, 536, 600, 664,
-		148, 212, 276, 340, 404, 468, 532, 596,
-		16, 80, 144, 208, 272, 336, 400, 464, 528
-	},
-	// Left
-	{
-		800, 932, 1064, 1196, 1328,
-		732, 864, 996, 1128, 1260, 1392,
-		664, 796, 928, 1060, 1192, 1324, 1456,
-		596, 728, 860, 992, 1124, 1256, 1388, 1520,
-		528, 660, 792, 924, 1056, 1188, 1320, 1452, 1584
-	},
-	// Top Left
-	{
-		1328, 1396, 1464, 1532, 1600,
-		1392, 1460, 1528, 1596, 1664, 1732,
-		1456, 1524, 1592, 1660, 1728, 1796, 1864,
-		1520, 1588, 1656, 1724, 1792, 1860, 1928, 1996,
-		1584, 1652, 1720, 1788, 1856, 1924, 1992, 2060, 2128
-	}
-};
+
+// The number of custom data floats of a tile instance
+#define TILE_INSTANCE_CUSTOM_DATA 3
+// The depth of the tile mesh in units
+#define TILE_MESH_DEPTH 100.0
+// The number of tiles around a chunk whose heights are needed for generating it
+#define STREAMING_TILE_MARGIN 2
 
 /**
  * Default constructor.
@@ -82,8 +42,25 @@ ATerrainActor::ATerrainActor()
 
 	// Create procedural mesh component and set it as root component.
 	MeshComponent = CreateDefaultSubobject<UProceduralMeshComponent>(TEXT("Procedural Mesh Component"));
+	MeshComponent->bUseAsyncCooking = true;
 	SetRootComponent(MeshComponent);
 
+	// Create the instanced static mesh component for the instanced mode, it is hidden until the mode is entered.
+	TileInstanceComponent = CreateDefaultSubobject<UHierarchicalInstancedStaticMeshComponent>(
+		TEXT("Tile Instance Component"));
+	TileInstanceComponent->SetupAttachment(MeshComponent);
+	TileInstanceComponent->NumCustomDataFloats = TILE_INSTANCE_CUSTOM_DATA;
+	TileInstanceComponent->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	TileInstanceComponent->SetVisibility(false);
+
+	// Create the procedural mesh components repeating the edge chunks of a wrapping terrain.
+	WrapEastComponent = CreateDefaultSubobject<UProceduralMeshComponent>(TEXT("Wrap East Component"));
+	WrapEastComponent->SetupAttachment(MeshComponent);
+	WrapEastComponent->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	WrapWestComponent = CreateDefaultSubobject<UProceduralMeshComponent>(TEXT("Wrap West Component"));
+	WrapWestComponent->SetupAttachment(MeshComponent);
+	WrapWestComponent->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+
 	// Initialize default values.
 	SeaLevel = 0;
 	HeightFactor = 8;
@@ -91,6 +68,79 @@ ATerrainActor::ATerrainActor()
 	WallEdgeHeight = 0.5;
 	WaterOffset = 0.0;
 	Scale = 100.0;
+	ChunkSize = 16;
+	MeshMemoryBudget = 0;
+	bUseNoiseLattice = false;
+	NoiseLatticeMaxError = 0.01;
+	bUseMeshCache = true;
+	bEnableInstancedMode = false;
+	TileMesh = nullptr;
+	TileMaterial = nullptr;
+	InstancedZoomLength = 350.0;
+	HeightmapFormat = AutoFormat;
+	HeightmapWidth = 0;
+	bWrapX = false;
+	WrapChunkColumns = 1;
+	bEnableStreaming = false;
+	TilePageFile.FilePath = TEXT("Saved/Terrain/Terrain.hxtp");
+	StreamingRadius = 4;
+	PrefetchTime = 0.5;
+	StreamingChunksPerFrame = 2;
+	TilePageBudget = 64;
+	MeshSectionBudget = 256;
+	SaveCompressionFormat = NAME_LZ4;
+	ExportFilename.FilePath = FPaths::ProjectSavedDir() / TEXT("TerrainExport/Terrain.glb");
+	ExportFormat = GltfBinary;
+	bExportWater = false;
+#if WITH_EDITORONLY_DATA
+	BakedMeshDirectory.Path = TEXT("/Game/Terrain/Baked");
+	bLivePreview = true;
+	PreviewDelay = 0.3;
+	PreviewTerrainMaterial = nullptr;
+#endif
+#if WITH_EDITOR
+	PendingChange = NoChange;
+	RunningChange = NoChange;
+	PreviewGeneration = MakeShared<FThreadSafeCounter>();
+#endif
+	SizeX = 0;
+	SizeY = 0;
+	TileDataTexture = nullptr;
+	TerrainMaterialInstance = nullptr;
+	bBuildOnMapDataLoaded = false;
+	StreamedBytes = 0;
+	StreamingTerrainMaterial = nullptr;
+	bInstancedMode = false;
+	bInstancesOutdated = true;
+	InstanceBaseZ = 0.0;
+}
+
+/**
+ * Called after the components were initialized. Starts the async load of the map data, so it overlaps the rest
+ * of the level load.
+ */
+void ATerrainActor::PostInitializeComponents()
+{
+	Super::PostInitializeComponents();
+
+	// The size of a baked terrain is not saved, it is calculated before the camera asks for it
+	if (!BakedTerrainComponents.IsEmpty())
+	{
+		TerrainSize = FHexTerrainBuilder::CalculateTerrainSize(CreateBuilderSettings(), SizeX, SizeY);
+	}
+
+	// Only a generated terrain in a game needs the map data
+	const auto World = GetWorld();
+	if (MapData.IsNull() || !BakedTerrainComponents.IsEmpty() || World == nullptr || !World->IsGameWorld())
+	{
+		return;
+	}
+	MapDataHandle = UAssetManager::GetStreamableManager().RequestAsyncLoad(
+		MapData.ToSoftObjectPath(), FStreamableDelegate::CreateUObject(this, &ATerrainActor::OnMapDataLoaded),
+		FStreamableManager::AsyncLoadHighPriority);
+
+	// Log
+	UE_LOG(TerrainActor, Display, TEXT("Loading map data %s..."), *MapData.ToString());
 }
 
 /**
@@ -102,25 +152,153 @@ void ATerrainActor::BeginPlay()
 
 	UE_LOG(TerrainActor, Display, TEXT("BeginPlay"));
 
+	// Baked meshes replace the generation at runtime
+	if (!BakedTerrainComponents.IsEmpty())
+	{
+		// Apply the dynamic terrain material to the baked terrain chunks
+		TileDataTexture = TileData.Init(SizeX, SizeY, this);
+		// The dirty and changed chunks have to match the chunks the terrain was baked with
+		const auto BakedChunkSize = FHexTerrainBuilder::CalculateChunkSize(CreateBuilderSettings());
+		TileAttributes.Init(SizeX, SizeY, BakedChunkSize);
+		TileChanges.Init(SizeX, SizeY, BakedChunkSize);
+		const auto DynamicTerrainMaterial = CreateTerrainMaterial();
+		for (const auto Component : BakedTerrainComponents)
+		{
+			if (IsValid(Component))
+			{
+				Component->SetMaterial(0, DynamicTerrainMaterial);
+			}
+		}
+
+		// Log
+		UE_LOG(TerrainActor, Display, TEXT("Using baked terrain (%d chunks)."), BakedTerrainComponents.Num());
+		return;
+	}
+
+	// The chunks around the camera are streamed from the tile page file
+	if (bEnableStreaming && PrepareStreaming())
+	{
+		return;
+	}
+
+	// The terrain is built as soon as the map data is loaded
+	if (MapDataHandle.IsValid() && MapDataHandle->IsLoadingInProgress())
+	{
+		bBuildOnMapDataLoaded = true;
+		UE_LOG(TerrainActor, Display, TEXT("Waiting for map data..."));
+		return;
+	}
+
 	Clear();
 	Build();
 }
 
+/**
+ * Called when the async load of the map data completed. Builds the terrain, if the game has already started.
+ */
+void ATerrainActor::OnMapDataLoaded()
+{
+	// Log
+	UE_LOG(TerrainActor, Display, TEXT("Map data %s loaded."), *MapData.ToString());
+
+	if (bBuildOnMapDataLoaded)
+	{
+		bBuildOnMapDataLoaded = false;
+		Clear();
+		Build();
+		// The camera has read the empty bounds when the game started
+		TerrainBuilt.Broadcast();
+	}
+}
+
 /**
  * Called every frame
  */
 void ATerrainActor::Tick(const float DeltaTime)
 {
 	Super::Tick(DeltaTime);
+
+	// Upload the tile data changes of this frame at once
+	TileData.Flush();
+	// Notify the subscribers of the tile changes of this frame at once
+	if (TileChanges.HasChanges())
+	{
+		OnTilesChanged.Broadcast(TileChanges.Dispatch());
+	}
+}
+
+/**
+ * Returns <b>true</b>, so the actor ticks in the editor too. The tile data changes and the tile change batches of
+ * the editor are flushed every frame like in a game.
+ *
+ * @return The editor tick flag.
+ */
+bool ATerrainActor::ShouldTickIfViewportsOnly() const
+{
+	return true;
 }
 
+#if WITH_EDITOR
+/**
+ * Called when a property was changed in the editor. The change is classified and a preview rebuild is scheduled.
+ *
+ * @param PropertyChangedEvent The event describing the changed property.
+ */
+void ATerrainActor::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+
+	// Changes of nested properties, e.g. of a noise parameter, are classified by the member property of this actor
+	const auto Change = ClassifyChange(PropertyChangedEvent.GetMemberPropertyName());
+	if (Change != NoChange)
+	{
+		SchedulePreview(Change);
+	}
+}
+
+/**
+ * Called after the actor was loaded. Subscribes to the reimport of the topography texture.
+ */
+void ATerrainActor::PostLoad()
+{
+	Super::PostLoad();
+	RegisterAssetReimport();
+}
+
+/**
+ * Called after the actor was created. Subscribes to the reimport of the topography texture.
+ */
+void ATerrainActor::PostActorCreated()
+{
+	Super::PostActorCreated();
+	RegisterAssetReimport();
+}
+
+/**
+ * Called before the actor is destroyed. Unsubscribes from the reimport of the topography texture.
+ */
+void ATerrainActor::BeginDestroy()
+{
+	if (AssetReimportHandle.IsValid() && GEditor != nullptr)
+	{
+		if (const auto ImportSubsystem = GEditor->GetEditorSubsystem<UImportSubsystem>())
+		{
+			ImportSubsystem->OnAssetReimport.Remove(AssetReimportHandle);
+		}
+		AssetReimportHandle.Reset();
+	}
+	Super::BeginDestroy();
+}
+#endif
+
 /**
  * Removes all generated meshes.
  */
 void ATerrainActor::Clear() const
 {
-	MeshComponent->ClearMeshSection(0);
-	MeshComponent->ClearMeshSection(1);
+	MeshComponent->ClearAllMeshSections();
+	WrapEastComponent->ClearAllMeshSections();
+	WrapWestComponent->ClearAllMeshSections();
 }
 
 /**
@@ -130,39 +308,1107 @@ void ATerrainActor::Build()
 {
 	// Log
 	UE_LOG(TerrainActor, Display, TEXT("Start building terrain..."));
+	const auto StartTime = FPlatformTime::Seconds();
 
-	// Clear the tiles array
-	Tiles.Empty();
-	// Check, if a topography texture is set
-	if (IsValid(Topography))
+	// Initialize tiles, chunks and distortion
+	PrepareBuild();
+	// Generate dynamic terrain material, the rebuilds of edited chunks reuse it
+	const auto DynamicTerrainMaterial = CreateTerrainMaterial();
+	TerrainMaterialInstance = DynamicTerrainMaterial;
+
+	// Try to load the mesh sections from the cache
+	const auto Hash = CalculateBuildHash();
+	if (bUseMeshCache && LoadMeshCache(Hash, DynamicTerrainMaterial))
+	{
+		UpdateWrapComponents();
+		UE_LOG(TerrainActor, Display, TEXT("Terrain loaded from cache (%.1f ms)."),
+		       (FPlatformTime::Seconds() - StartTime) * 1000.0);
+		return;
+	}
+
+	// The generated mesh sections are written to the cache as soon as they are created
+	const auto CacheWriter = bUseMeshCache
+		                         ? MakeUnique<FTerrainMeshCacheWriter>(GetMeshCacheFilename(), Hash)
+		                         : TUniquePtr<FTerrainMeshCacheWriter>();
+	// Count the triangles of the render and the collision sections
+	auto RenderTriangles = 0;
+	auto CollisionTriangles = 0;
+	// The chunks are generated in parallel batches that fit into the memory budget
+	const auto ChunkCount = Builder->GetChunkCount();
+	const auto BatchSize = Builder->GetParallelChunkLimit();
+	auto Chunks = TArray<int32>();
+	for (auto First = 0; First < ChunkCount; First += BatchSize)
+	{
+		// Generate the chunks of the batch
+		Chunks.Reset();
+		for (auto Chunk = First; Chunk < FMath::Min(First + BatchSize, ChunkCount); Chunk++)
+		{
+			Chunks.Add(Chunk);
+		}
+		// Build the mesh sections of the batch, the component is only touched on the game thread
+		for (const auto& ChunkData : Builder->GenerateChunks(Chunks))
+		{
+			for (auto Type = 0; Type < SectionTypeCount; Type++)
+			{
+				const auto Section = GetSectionIndex(ChunkData.Chunk, static_cast<ETerrainSectionType>(Type));
+				BuildSection(Section, ChunkData.Sections[Type], DynamicTerrainMaterial);
+				// Write the section to the cache
+				if (CacheWriter.IsValid())
+				{
+					CacheWriter->AddSection(Section, ChunkData.Sections[Type]);
+				}
+			}
+			// Update the triangle counts
+			RenderTriangles += ChunkData.Sections[TerrainSection].Triangles.Num() / 3;
+			CollisionTriangles += ChunkData.Sections[CollisionSection].Triangles.Num() / 3;
+		}
+	}
+	// Finish the cache file
+	if (CacheWriter.IsValid())
+	{
+		CacheWriter->Close();
+	}
+	// Repeat the edge chunks of a wrapping terrain
+	UpdateWrapComponents();
+
+	// Log
+	UE_LOG(TerrainActor, Display, TEXT("Terrain generated (%.1f ms, Triangles: %d, Collision Triangles: %d)."),
+	       (FPlatformTime::Seconds() - StartTime) * 1000.0, RenderTriangles, CollisionTriangles);
+	const auto PeakScratchBytes = Builder->GetPeakScratchBytes();
+	UE_LOG(TerrainActor, Display, TEXT("Peak chunk memory %.1f MB (Chunk Size: %d, Batch: %d, Budget: %d MB)."),
+	       PeakScratchBytes / (1024.0 * 1024.0), Builder->GetChunkSize(), BatchSize, MeshMemoryBudget);
+	if (MeshMemoryBudget > 0 && PeakScratchBytes * BatchSize > MeshMemoryBudget * 1024ull * 1024ull)
+	{
+		UE_LOG(TerrainActor, Warning, TEXT("Peak chunk memory exceeds the mesh memory budget."));
+	}
+}
+
+/**
+ * Opens an edit transaction. All height changes until the transaction is ended, e.g. the dabs of a brush stroke,
+ * are rebuilt and undone together.
+ */
+void ATerrainActor::BeginTerrainEdit()
+{
+	EditJournal.BeginTransaction();
+}
+
+/**
+ * Closes an edit transaction. When the outermost transaction is closed, the chunks affected by its changes are
+ * rebuilt.
+ */
+void ATerrainActor::EndTerrainEdit()
+{
+	if (!EditJournal.IsTransactionOpen())
+	{
+		UE_LOG(TerrainActor, Warning, TEXT("EndTerrainEdit called without an open transaction."));
+		return;
+	}
+	// Apply the changes to a copy of the heights, the current builder may still be used by a preview
+	auto HeightGrid = Builder.IsValid() ? Builder->GetHeightGrid() : FHexHeightGrid();
+	// Nested transactions and transactions without changes return no tiles
+	const auto ChangedTiles = EditJournal.EndTransaction(HeightGrid);
+	if (!ChangedTiles.IsEmpty())
+	{
+		UpdateHeights(MoveTemp(HeightGrid), ChangedTiles);
+	}
+}
+
+/**
+ * Returns the height of the tile at the specified coordinates relative to the sea level, including the changes of
+ * an open transaction.
+ *
+ * @param X The X coordinate of the tile.
+ * @param Y The Y coordinate of the tile.
+ *
+ * @return The height of the tile, zero for coordinates outside of the terrain.
+ */
+int32 ATerrainActor::GetTileHeight(const int32 X, const int32 Y) const
+{
+	if (!Builder.IsValid() || !Builder->GetHeightGrid().Contains(X, Y))
+	{
+		return 0;
+	}
+	const auto& HeightGrid = Builder->GetHeightGrid();
+	return EditJournal.GetPendingHeight(X + Y * HeightGrid.GetSizeX()).Get(HeightGrid.GetHeight(X, Y));
+}
+
+/**
+ * Sets the height of the tile at the specified coordinates relative to the sea level. Outside of a transaction
+ * the change is a transaction of its own and rebuilt immediately.
+ *
+ * @param X The X coordinate of the tile.
+ * @param Y The Y coordinate of the tile.
+ * @param Z The new height of the tile.
+ */
+void ATerrainActor::SetTileHeight(const int32 X, const int32 Y, const int32 Z)
+{
+	if (!Builder.IsValid() || !Builder->GetHeightGrid().Contains(X, Y))
+	{
+		return;
+	}
+	// Record the change, the tiles are rebuilt when the outermost transaction is closed
+	BeginTerrainEdit();
+	EditJournal.RecordEdit(X + Y * Builder->GetHeightGrid().GetSizeX(), GetTileHeight(X, Y), Z);
+	EndTerrainEdit();
+}
+
+/**
+ * Reverts the last edit transaction and rebuilds the affected chunks.
+ *
+ * @return <b>true</b>, if a transaction was undone.
+ */
+bool ATerrainActor::UndoTerrainEdit()
+{
+	if (!Builder.IsValid() || !EditJournal.CanUndo() || EditJournal.IsTransactionOpen())
+	{
+		return false;
+	}
+	auto HeightGrid = Builder->GetHeightGrid();
+	const auto ChangedTiles = EditJournal.Undo(HeightGrid);
+	UpdateHeights(MoveTemp(HeightGrid), ChangedTiles);
+	return true;
+}
+
+/**
+ * Applies the last undone edit transaction again and rebuilds the affected chunks.
+ *
+ * @return <b>true</b>, if a transaction was redone.
+ */
+bool ATerrainActor::RedoTerrainEdit()
+{
+	if (!Builder.IsValid() || !EditJournal.CanRedo() || EditJournal.IsTransactionOpen())
+	{
+		return false;
+	}
+	auto HeightGrid = Builder->GetHeightGrid();
+	const auto ChangedTiles = EditJournal.Redo(HeightGrid);
+	UpdateHeights(MoveTemp(HeightGrid), ChangedTiles);
+	return true;
+}
+
+/**
+ * Saves the heights of all tiles, including the edits, the tile data and the tile attributes with one byte per
+ * tile into a terrain save file.
+ *
+ * @param Filename The name of the save file, relative to the saved directory of the project.
+ *
+ * @return <b>true</b>, if the file was written.
+ */
+bool ATerrainActor::SaveTerrainState(const FString& Filename) const
+{
+	if (!Builder.IsValid() || IsStreaming() || EditJournal.IsTransactionOpen())
+	{
+		UE_LOG(TerrainActor, Warning, TEXT("Terrain state can only be saved for a complete build without open edits."));
+		return false;
+	}
+
+	// Every channel of the tile data is a layer named after the channel
+	const auto Enum = StaticEnum<ETileDataChannel>();
+	auto LayerNames = TArray<FName>();
+	auto Layers = TArray<TArray<uint8>>();
+	for (auto Index = 0; Index < Enum->NumEnums() - 1; Index++)
+	{
+		LayerNames.Add(Enum->GetNameByIndex(Index));
+		Layers.Add(TileData.ReadChannel(static_cast<ETileDataChannel>(Enum->GetValueByIndex(Index))));
+	}
+	// Every attribute with one byte per tile is a layer named after the attribute, the channels take precedence
+	for (auto Attribute = 0; Attribute < TileAttributes.GetAttributeCount(); Attribute++)
+	{
+		const auto& Name = TileAttributes.GetAttributeName(Attribute);
+		if (TileAttributes.GetElementSize(Attribute) == sizeof(uint8) && Enum->GetValueByName(Name) == INDEX_NONE)
+		{
+			const auto Column = TileAttributes.GetColumn<uint8>(Attribute);
+			LayerNames.Add(Name);
+			Layers.Emplace(Column.GetData(), Column.Num());
+		}
+	}
+
+	// Write the file
+	return FTerrainSaveFile::Write(FPaths::ConvertRelativePathToFull(FPaths::ProjectSavedDir(), Filename),
+	                               Builder->GetHeightGrid(), LayerNames, Layers, SaveCompressionFormat);
+}
+
+/**
+ * Loads the heights and the tile data of all tiles from a terrain save file and rebuilds the changed chunks. The
+ * file must have the size of the current terrain.
+ *
+ * @param Filename The name of the save file, relative to the saved directory of the project.
+ *
+ * @return <b>true</b>, if the file was loaded.
+ */
+bool ATerrainActor::LoadTerrainState(const FString& Filename)
+{
+	return LoadTerrainRegion(Filename, FIntPoint::ZeroValue, FIntPoint(SizeX, SizeY));
+}
+
+/**
+ * Loads the heights and the tile data of the tiles within the specified region from a terrain save file and
+ * rebuilds the changed chunks. Only the chunks of the file overlapping the region are decompressed.
+ *
+ * @param Filename The name of the save file, relative to the saved directory of the project.
+ * @param Min The minimal tile coordinates of the region.
+ * @param Max The maximal tile coordinates of the region, exclusive.
+ *
+ * @return <b>true</b>, if the region was loaded.
+ */
+bool ATerrainActor::LoadTerrainRegion(const FString& Filename, const FIntPoint& Min, const FIntPoint& Max)
+{
+	if (!Builder.IsValid() || IsStreaming() || EditJournal.IsTransactionOpen())
+	{
+		UE_LOG(TerrainActor, Warning,
+		       TEXT("Terrain state can only be loaded into a complete build without open edits."));
+		return false;
+	}
+	const auto StartTime = FPlatformTime::Seconds();
+	const auto SaveFile = FTerrainSaveFile(FPaths::ConvertRelativePathToFull(FPaths::ProjectSavedDir(), Filename));
+	if (!SaveFile.IsValid())
+	{
+		return false;
+	}
+	const auto& OldHeightGrid = Builder->GetHeightGrid();
+	if (SaveFile.GetSizeX() != OldHeightGrid.GetSizeX() || SaveFile.GetSizeY() != OldHeightGrid.GetSizeY())
+	{
+		UE_LOG(TerrainActor, Warning, TEXT("Save file size %d x %d does not match the terrain size %d x %d."),
+		       SaveFile.GetSizeX(), SaveFile.GetSizeY(), OldHeightGrid.GetSizeX(), OldHeightGrid.GetSizeY());
+		return false;
+	}
+
+	// Read the region into copies of the current state, so the tiles outside of it are kept
+	const auto Enum = StaticEnum<ETileDataChannel>();
+	const auto& LayerNames = SaveFile.GetLayerNames();
+	auto HeightGrid = OldHeightGrid;
+	auto Layers = TArray<TArray<uint8>>();
+	for (const auto& LayerName : LayerNames)
+	{
+		const auto Channel = Enum->GetValueByName(LayerName);
+		const auto Attribute = TileAttributes.FindAttribute(LayerName);
+		if (Channel != INDEX_NONE)
+		{
+			Layers.Add(TileData.ReadChannel(static_cast<ETileDataChannel>(Channel)));
+		}
+		else if (Attribute != INDEX_NONE && TileAttributes.GetElementSize(Attribute) == sizeof(uint8))
+		{
+			const auto Column = TileAttributes.GetColumn<uint8>(Attribute);
+			Layers.Emplace(Column.GetData(), Column.Num());
+		}
+		else
+		{
+			Layers.Add(TArray<uint8>());
+		}
+	}
+	const auto Region = FIntRect(Min, Max);
+	if (!SaveFile.Read(Region, HeightGrid, Layers))
+	{
+		return false;
+	}
+
+	// Apply the layers of the known channels and attributes, the others are ignored
+	auto AttributeRegion = Region;
+	AttributeRegion.Clip(FIntRect(0, 0, SaveFile.GetSizeX(), SaveFile.GetSizeY()));
+	for (auto Layer = 0; Layer < LayerNames.Num(); Layer++)
+	{
+		const auto Channel = Enum->GetValueByName(LayerNames[Layer]);
+		const auto Attribute = TileAttributes.FindAttribute(LayerNames[Layer]);
+		if (Channel != INDEX_NONE)
+		{
+			const auto ChangedData = TileData.WriteChannel(static_cast<ETileDataChannel>(Channel), Layers[Layer],
+			                                               Region);
+			TileChanges.AddChanges(ChangedData, false);
+		}
+		else if (Attribute != INDEX_NONE && TileAttributes.GetElementSize(Attribute) == sizeof(uint8))
+		{
+			// Only the changed values mark their chunks as dirty for the consumers
+			for (auto Y = AttributeRegion.Min.Y; Y < AttributeRegion.Max.Y; Y++)
+			{
+				for (auto X = AttributeRegion.Min.X; X < AttributeRegion.Max.X; X++)
+				{
+					TileAttributes.Set<uint8>(Attribute, X, Y, Layers[Layer][X + Y * SaveFile.GetSizeX()]);
+				}
+			}
+		}
+	}
+
+	// Rebuild the chunks of the changed tiles, the recorded edits refer to the replaced heights
+	const auto ChangedTiles = HeightGrid.FindChangedTiles(OldHeightGrid);
+	if (!ChangedTiles.IsEmpty())
+	{
+		EditJournal.Reset();
+		UpdateHeights(MoveTemp(HeightGrid), ChangedTiles);
+	}
+
+	// Log
+	UE_LOG(TerrainActor, Display, TEXT("Terrain state loaded (%.1f ms, Changed Tiles: %d)."),
+	       (FPlatformTime::Seconds() - StartTime) * 1000.0, ChangedTiles.Num());
+	return true;
+}
+
+/**
+ * Switches between the detailed and the instanced rendering of the tiles depending on the zoom of the camera.
+ *
+ * @param ZoomLength The current zoom length of the camera.
+ */
+void ATerrainActor::UpdateRenderMode(const double ZoomLength)
+{
+	// The instanced mode needs a tile mesh and a generated terrain
+	const auto bInstanced = bEnableInstancedMode && IsValid(TileMesh) && Builder.IsValid() && !IsStreaming()
+		&& BakedTerrainComponents.IsEmpty() && ZoomLength >= InstancedZoomLength;
+	if (bInstanced == bInstancedMode)
+	{
+		return;
+	}
+	bInstancedMode = bInstanced;
+
+	// Prepare the instances before they become visible
+	if (bInstancedMode)
+	{
+		TileInstanceComponent->SetStaticMesh(TileMesh);
+		if (IsValid(TileMaterial))
+		{
+			TileInstanceComponent->SetMaterial(0, TileMaterial);
+		}
+		if (bInstancesOutdated)
+		{
+			UpdateTileInstances();
+		}
+	}
+	// Swap the visible components, the collision of the procedural mesh stays active
+	MeshComponent->SetVisibility(!bInstancedMode);
+	WrapEastComponent->SetVisibility(!bInstancedMode);
+	WrapWestComponent->SetVisibility(!bInstancedMode);
+	TileInstanceComponent->SetVisibility(bInstancedMode);
+
+	// Log
+	UE_LOG(TerrainActor, Display, TEXT("Render mode switched to %s (Zoom Length: %f)."),
+	       bInstancedMode ? TEXT("instanced") : TEXT("detailed"), ZoomLength);
+}
+
+/**
+ * Generates the missing chunks within the streaming ring around the camera, the nearest chunks ahead of the
+ * camera first, and removes the least recently used chunks beyond the mesh section budget.
+ *
+ * @param Location The location of the camera.
+ * @param Velocity The velocity of the camera.
+ * @param ViewDirection The direction the camera looks at.
+ */
+void ATerrainActor::UpdateStreaming(const FVector& Location, const FVector& Velocity, const FVector& ViewDirection)
+{
+	if (!IsStreaming() || !Builder.IsValid() || Builder->GetChunkCount() == 0)
+	{
+		return;
+	}
+	const auto Now = FPlatformTime::Seconds();
+	const auto ChunkSizeTiles = Builder->GetChunkSize();
+	const auto ChunkCountX = Builder->GetChunkCountX();
+	const auto ChunkCountY = Builder->GetChunkCountY();
+	const auto bWrapX = Builder->GetSettings().bWrapX;
+
+	// The ring is centered at the location the camera will have reached after the prefetch time
+	const auto LocalLocation = FVector2D(Location - GetActorLocation());
+	const auto CameraTile = Builder->GetTileAt(LocalLocation);
+	const auto CenterTile = Builder->GetTileAt(LocalLocation + FVector2D(Velocity) * PrefetchTime);
+	// A wrapping terrain continues beyond its edges, so the ring is not clamped along the X axis
+	const auto CenterChunkX = FMath::FloorToInt32(static_cast<double>(CenterTile.X) / ChunkSizeTiles);
+	const auto CenterX = bWrapX ? CenterChunkX : FMath::Clamp(CenterChunkX, 0, ChunkCountX - 1);
+	const auto CenterY = FMath::Clamp(CenterTile.Y / ChunkSizeTiles, 0, ChunkCountY - 1);
+	// The chunks in the direction of the movement, or of the view while standing still, are preferred
+	const auto Direction = FVector2D(Velocity.SizeSquared2D() > 1.0 ? Velocity : ViewDirection).GetSafeNormal();
+
+	// Collect the missing chunks of the ring and keep the present ones
+	auto Missing = TArray<TPair<double, FIntPoint>>();
+	for (auto ChunkY = CenterY - StreamingRadius; ChunkY <= CenterY + StreamingRadius; ChunkY++)
+	{
+		for (auto ChunkX = CenterX - StreamingRadius; ChunkX <= CenterX + StreamingRadius; ChunkX++)
+		{
+			// The chunks beyond the seam of a wrapping terrain are shifted copies, each column is taken once
+			const auto bOutsideX = bWrapX
+				                       ? ChunkX - (CenterX - StreamingRadius) >= ChunkCountX
+				                       : ChunkX < 0 || ChunkX >= ChunkCountX;
+			if (bOutsideX || ChunkY < 0 || ChunkY >= ChunkCountY
+				|| FMath::Square(ChunkX - CenterX) + FMath::Square(ChunkY - CenterY) > FMath::Square(StreamingRadius))
+			{
+				continue;
+			}
+			const auto Chunk = FIntPoint(ChunkX, ChunkY);
+			if (const auto Slot = StreamedChunks.Find(Chunk))
+			{
+				StreamingSlots[*Slot].LastUsed = Now;
+				continue;
+			}
+			// The distance to the camera counted in tiles, reduced by up to half ahead of the camera
+			const auto Offset = FVector2D((ChunkX + 0.5) * ChunkSizeTiles - CameraTile.X,
+			                              ((ChunkY + 0.5) * ChunkSizeTiles - CameraTile.Y) * 0.75);
+			const auto Priority = Offset.Size() * (1.5 - 0.5 * FVector2D::DotProduct(Offset.GetSafeNormal(), Direction));
+			Missing.Add(TPair<double, FIntPoint>(Priority, Chunk));
+		}
+	}
+
+	// Generate the most important missing chunks
+	if (!Missing.IsEmpty())
+	{
+		Missing.Sort([](const TPair<double, FIntPoint>& A, const TPair<double, FIntPoint>& B)
+		{
+			return A.Key < B.Key;
+		});
+		auto Chunks = TArray<FIntPoint>();
+		for (auto I = 0; I < FMath::Min(Missing.Num(), StreamingChunksPerFrame); I++)
+		{
+			Chunks.Add(Missing[I].Value);
+		}
+		StreamChunks(Chunks, Now);
+	}
+
+	// Remove the least recently used chunks outside of the ring beyond the budget
+	const auto BudgetBytes = MeshSectionBudget * 1024ll * 1024ll;
+	while (StreamedBytes > BudgetBytes)
+	{
+		auto Oldest = INDEX_NONE;
+		for (auto Slot = 0; Slot < StreamingSlots.Num(); Slot++)
+		{
+			const auto& StreamingSlot = StreamingSlots[Slot];
+			if (StreamingSlot.Chunk != INDEX_NONE && StreamingSlot.LastUsed < Now
+				&& (Oldest == INDEX_NONE || StreamingSlot.LastUsed < StreamingSlots[Oldest].LastUsed))
+			{
+				Oldest = Slot;
+			}
+		}
+		if (Oldest == INDEX_NONE)
+		{
+			break;
+		}
+		EvictStreamingSlot(Oldest);
+	}
+}
+
+/**
+ * Returns the value of a channel of the tile data, e.g. the highlight or the owner of the tile.
+ *
+ * @param X The X coordinate of the tile.
+ * @param Y The Y coordinate of the tile.
+ * @param Channel The data channel.
+ *
+ * @return The value, zero for coordinates outside of the terrain.
+ */
+uint8 ATerrainActor::GetTileData(const int32 X, const int32 Y, const TEnumAsByte<ETileDataChannel> Channel) const
+{
+	return TileData.GetTileData(X, Y, Channel);
+}
+
+/**
+ * Sets the value of a channel of the tile data. The changes of a frame are uploaded together into the tile data
+ * texture sampled by the terrain material, the mesh is not rebuilt.
+ *
+ * @param X The X coordinate of the tile.
+ * @param Y The Y coordinate of the tile.
+ * @param Channel The data channel.
+ * @param Value The new value.
+ */
+void ATerrainActor::SetTileData(const int32 X, const int32 Y, const TEnumAsByte<ETileDataChannel> Channel,
+                                const uint8 Value)
+{
+	if (TileData.SetTileData(X, Y, Channel, Value))
+	{
+		TileChanges.AddChange(X, Y, false);
+	}
+}
+
+/**
+ * Exports the terrain mesh into the export file. The mesh is generated and written chunk by chunk, so the whole
+ * mesh is never held in memory.
+ */
+void ATerrainActor::Export()
+{
+	// Log
+	UE_LOG(TerrainActor, Display, TEXT("Start exporting terrain to %s..."), *ExportFilename.FilePath);
+	const auto StartTime = FPlatformTime::Seconds();
+
+	// Initialize tiles, chunks and distortion
+	PrepareBuild();
+	// Open the export file
+	FTerrainMeshExporter Exporter(ExportFilename.FilePath, ExportFormat);
+	// Write every chunk, the section data is released before the next chunk is generated
+	for (auto Chunk = 0; Chunk < Builder->GetChunkCount() && Exporter.IsValid(); Chunk++)
+	{
+		Exporter.AddSection(Builder->GenerateTerrainSectionData(Chunk));
+		if (bExportWater)
+		{
+			Exporter.AddSection(Builder->GenerateWaterSectionData(Chunk));
+		}
+	}
+	// Finish the export file
+	if (!Exporter.Close())
 	{
-		// Load the topography of the terrain from the texture
-		ReadTopography();
+		UE_LOG(TerrainActor, Error, TEXT("Terrain could not be exported to %s."), *ExportFilename.FilePath);
+		return;
 	}
+
+	// Log
+	UE_LOG(TerrainActor, Display, TEXT("Terrain exported in %.1f ms (Triangles: %lld, Peak chunk memory: %.1f MB)."),
+	       (FPlatformTime::Seconds() - StartTime) * 1000.0, Exporter.GetTriangleCount(),
+	       Builder->GetPeakScratchBytes() / (1024.0 * 1024.0));
+}
+
+#if WITH_EDITOR
+/**
+ * Bakes the terrain and the water into static mesh assets, one per chunk, and replaces the generated meshes by
+ * static mesh components using these assets.
+ */
+void ATerrainActor::Bake()
+{
+	// Log
+	UE_LOG(TerrainActor, Display, TEXT("Start baking terrain..."));
+
+	// Remove the components of a previous bake
+	ClearBaked();
+	// Initialize tiles, chunks and distortion
+	PrepareBuild();
+	// Bake every chunk
+	for (auto Chunk = 0; Chunk < Builder->GetChunkCount(); Chunk++)
+	{
+		// The suffix of the asset names contains the chunk coordinates
+		const auto ChunkCountX = Builder->GetChunkCountX();
+		const auto Suffix = FString::Printf(TEXT("%s_%d_%d"), *GetName(), Chunk % ChunkCountX, Chunk / ChunkCountX);
+		// Bake the terrain with Nanite enabled
+		const auto TerrainMesh = FTerrainMeshBaker::CreateStaticMesh(
+			BakedMeshDirectory.Path, TEXT("SM_Terrain_") + Suffix, Builder->GenerateTerrainSectionData(Chunk),
+			TerrainMaterial, true);
+		if (IsValid(TerrainMesh))
+		{
+			BakedTerrainComponents.Add(AddBakedComponent(TerrainMesh, TEXT("Baked Terrain ") + Suffix));
+		}
+		// Bake the water without Nanite, as it uses a translucent material
+		const auto WaterSectionData = Builder->GenerateWaterSectionData(Chunk);
+		if (!WaterSectionData.Vertices.IsEmpty())
+		{
+			const auto WaterMesh = FTerrainMeshBaker::CreateStaticMesh(
+				BakedMeshDirectory.Path, TEXT("SM_Water_") + Suffix, WaterSectionData, WaterMaterial, false);
+			if (IsValid(WaterMesh))
+			{
+				BakedWaterComponents.Add(AddBakedComponent(WaterMesh, TEXT("Baked Water ") + Suffix));
+			}
+		}
+	}
+	// The generated meshes are replaced by the baked ones
+	Clear();
+
+	// Log
+	UE_LOG(TerrainActor, Display, TEXT("Terrain baked (Terrain: %d, Water: %d static meshes)."),
+	       BakedTerrainComponents.Num(), BakedWaterComponents.Num());
+}
+
+/**
+ * Removes the static mesh components of the baked terrain. The assets are kept.
+ */
+void ATerrainActor::ClearBaked()
+{
+	Modify();
+	// Destroy all baked components
+	for (const auto Components : {&BakedTerrainComponents, &BakedWaterComponents})
+	{
+		for (const auto Component : *Components)
+		{
+			if (IsValid(Component))
+			{
+				RemoveInstanceComponent(Component);
+				Component->DestroyComponent();
+			}
+		}
+		Components->Empty();
+	}
+}
+
+/**
+ * Saves the heights of the current build, including the edits, into a map data asset in the baked mesh directory
+ * and uses it as the source of the heights.
+ */
+void ATerrainActor::SaveMapData()
+{
+	// The current build contains the edits, otherwise the heights are read from the source
+	const auto HeightGrid = Builder.IsValid() ? Builder->GetHeightGrid() : ReadHeights();
+	if (HeightGrid.IsEmpty())
+	{
+		UE_LOG(TerrainActor, Warning, TEXT("There are no heights to be saved."));
+		return;
+	}
+	// The saved heights are marked as eroded, so they are not eroded again when they are read
+	const auto NewMapData = UHexMapData::CreateAsset(BakedMeshDirectory.Path, TEXT("MD_") + GetName(), HeightGrid,
+	                                                 SeaLevel, Erosion.bEnabled || IsSourceEroded());
+	if (IsValid(NewMapData))
+	{
+		Modify();
+		MapData = NewMapData;
+	}
+}
+
+/**
+ * Writes the heights of the current source into the tile page file used for streaming.
+ */
+void ATerrainActor::WriteTilePages()
+{
+	const auto HeightGrid = Builder.IsValid() && !IsStreaming() ? Builder->GetHeightGrid() : ReadHeights();
+	const auto Filename = FPaths::ConvertRelativePathToFull(FPaths::ProjectDir(), TilePageFile.FilePath);
+	FHexTilePageStore::Write(Filename, HeightGrid);
+}
+
+/**
+ * Creates a static mesh component for the specified baked static mesh and attaches it to this actor.
+ *
+ * @param StaticMesh The static mesh.
+ * @param Name The name of the component.
+ *
+ * @return The static mesh component.
+ */
+UStaticMeshComponent* ATerrainActor::AddBakedComponent(UStaticMesh* StaticMesh, const FString& Name)
+{
+	const auto Component = NewObject<UStaticMeshComponent>(this, *Name);
+	Component->SetStaticMesh(StaticMesh);
+	Component->SetupAttachment(RootComponent);
+	Component->RegisterComponent();
+	AddInstanceComponent(Component);
+	return Component;
+}
+
+/**
+ * Subscribes to the reimport of assets, unless already subscribed.
+ */
+void ATerrainActor::RegisterAssetReimport()
+{
+	// Templates and actors outside of the editor do not follow reimports
+	if (AssetReimportHandle.IsValid() || HasAnyFlags(RF_ClassDefaultObject | RF_ArchetypeObject) || GEditor == nullptr)
+	{
+		return;
+	}
+	if (const auto ImportSubsystem = GEditor->GetEditorSubsystem<UImportSubsystem>())
+	{
+		AssetReimportHandle = ImportSubsystem->OnAssetReimport.AddUObject(this, &ATerrainActor::OnAssetReimported);
+	}
+}
+
+/**
+ * Called when an asset was reimported. If it is the topography texture, the heights are read again and only the
+ * chunks affected by changed tiles are rebuilt.
+ *
+ * @param Asset The reimported asset.
+ */
+void ATerrainActor::OnAssetReimported(UObject* Asset)
+{
+	// Only the topography of a generated terrain in the level editor is of interest
+	const auto World = GetWorld();
+	if (Asset != Topography || !IsValid(Topography) || !Builder.IsValid() || !BakedTerrainComponents.IsEmpty()
+		|| World == nullptr || World->WorldType != EWorldType::Editor)
+	{
+		return;
+	}
+	// The map data and the heightmap file replace the topography
+	if (!MapData.IsNull() || !HeightmapFile.FilePath.IsEmpty())
+	{
+		return;
+	}
+
+	// Log
+	UE_LOG(TerrainActor, Display, TEXT("Topography reimported, start updating terrain..."));
+	const auto StartTime = FPlatformTime::Seconds();
+
+	// Read the heights again and erode them like every build does
+	auto HeightGrid = CompleteHeights(ReadTopography(), false, true, bWrapX, Generator, Erosion);
+	const auto& OldHeightGrid = Builder->GetHeightGrid();
+	if (HeightGrid.GetSizeX() != OldHeightGrid.GetSizeX() || HeightGrid.GetSizeY() != OldHeightGrid.GetSizeY())
+	{
+		// The chunks do not match anymore, so everything is rebuilt
+		UE_LOG(TerrainActor, Display, TEXT("Topography size changed from %d x %d to %d x %d."),
+		       OldHeightGrid.GetSizeX(), OldHeightGrid.GetSizeY(), HeightGrid.GetSizeX(), HeightGrid.GetSizeY());
+		// The full build adopts all settings, so a running preview is only stopped
+		PreviewGeneration->Increment();
+		RunningChange = NoChange;
+		Clear();
+		Build();
+		return;
+	}
+
+	// Compare the heights of the tiles
+	const auto ChangedTiles = HeightGrid.FindChangedTiles(OldHeightGrid);
+	if (ChangedTiles.IsEmpty())
+	{
+		UE_LOG(TerrainActor, Display, TEXT("Topography unchanged, nothing to update."));
+		return;
+	}
+
+	// The recorded edits refer to the replaced heights
+	EditJournal.Reset();
+	// Replace the builder and rebuild the chunks affected by the changed tiles
+	UpdateHeights(MoveTemp(HeightGrid), ChangedTiles);
+
+	// Log
+	UE_LOG(TerrainActor, Display, TEXT("Topography update finished (%.1f ms)."),
+	       (FPlatformTime::Seconds() - StartTime) * 1000.0);
+}
+
+/**
+ * Returns the cheapest kind of rebuild that makes a change of the specified property visible.
+ *
+ * @param PropertyName The name of the changed member property.
+ *
+ * @return The change type.
+ */
+ETerrainChangeType ATerrainActor::ClassifyChange(const FName& PropertyName)
+{
+	// The heights of the tiles have to be read again, the erosion depends on the wrapping too
+	if (PropertyName == GET_MEMBER_NAME_CHECKED(ATerrainActor, SeaLevel)
+		|| PropertyName == GET_MEMBER_NAME_CHECKED(ATerrainActor, Topography)
+		|| PropertyName == GET_MEMBER_NAME_CHECKED(ATerrainActor, MapData)
+		|| PropertyName == GET_MEMBER_NAME_CHECKED(ATerrainActor, HeightmapFile)
+		|| PropertyName == GET_MEMBER_NAME_CHECKED(ATerrainActor, HeightmapFormat)
+		|| PropertyName == GET_MEMBER_NAME_CHECKED(ATerrainActor, HeightmapWidth)
+		|| PropertyName == GET_MEMBER_NAME_CHECKED(ATerrainActor, Generator)
+		|| PropertyName == GET_MEMBER_NAME_CHECKED(ATerrainActor, Erosion)
+		|| PropertyName == GET_MEMBER_NAME_CHECKED(ATerrainActor, bWrapX)
+		|| PropertyName == GET_MEMBER_NAME_CHECKED(ATerrainActor, HeightFactor))
+	{
+		return TopologyChange;
+	}
+	// All mesh sections have to be generated again
+	if (PropertyName == GET_MEMBER_NAME_CHECKED(ATerrainActor, HeightUnit)
+		|| PropertyName == GET_MEMBER_NAME_CHECKED(ATerrainActor, WallEdgeHeight)
+		|| PropertyName == GET_MEMBER_NAME_CHECKED(ATerrainActor, Scale)
+		|| PropertyName == GET_MEMBER_NAME_CHECKED(ATerrainActor, ChunkSize)
+		|| PropertyName == GET_MEMBER_NAME_CHECKED(ATerrainActor, MeshMemoryBudget)
+		|| PropertyName == GET_MEMBER_NAME_CHECKED(ATerrainActor, WrapChunkColumns))
+	{
+		return MeshChange;
+	}
+	// Only the distorted sections, the water is not distorted
+	if (PropertyName == GET_MEMBER_NAME_CHECKED(ATerrainActor, NoiseParameterX)
+		|| PropertyName == GET_MEMBER_NAME_CHECKED(ATerrainActor, NoiseParameterY)
+		|| PropertyName == GET_MEMBER_NAME_CHECKED(ATerrainActor, NoiseParameterZ)
+		|| PropertyName == GET_MEMBER_NAME_CHECKED(ATerrainActor, bUseNoiseLattice)
+		|| PropertyName == GET_MEMBER_NAME_CHECKED(ATerrainActor, NoiseLatticeMaxError))
+	{
+		return DistortionChange;
+	}
+	// Only the water sections
+	if (PropertyName == GET_MEMBER_NAME_CHECKED(ATerrainActor, WaterOffset))
+	{
+		return WaterChange;
+	}
+	// No mesh section has to be generated again
+	if (PropertyName == GET_MEMBER_NAME_CHECKED(ATerrainActor, TerrainMaterial)
+		|| PropertyName == GET_MEMBER_NAME_CHECKED(ATerrainActor, WaterMaterial))
+	{
+		return MaterialChange;
+	}
+	return NoChange;
+}
+
+/**
+ * Combines two changes into the cheapest change covering both.
+ *
+ * @param ChangeA The first change.
+ * @param ChangeB The second change.
+ *
+ * @return The combined change type.
+ */
+ETerrainChangeType ATerrainActor::MergeChanges(const ETerrainChangeType ChangeA, const ETerrainChangeType ChangeB)
+{
+	// Water and distortion changes affect disjoint sections, together they affect all of them
+	if ((ChangeA == WaterChange && ChangeB == DistortionChange)
+		|| (ChangeA == DistortionChange && ChangeB == WaterChange))
+	{
+		return MeshChange;
+	}
+	// Otherwise the bigger change includes the smaller one
+	return FMath::Max(ChangeA, ChangeB);
+}
+
+/**
+ * Returns the section types that have to be generated again for the specified change.
+ *
+ * @param Change The change type.
+ *
+ * @return The section mask, bit N stands for section type N.
+ */
+int32 ATerrainActor::GetSectionMask(const ETerrainChangeType Change)
+{
+	switch (Change)
+	{
+	case NoChange:
+	case MaterialChange:
+		return 0;
+	case WaterChange:
+		return 1 << WaterSection;
+	case DistortionChange:
+		return (1 << TerrainSection) | (1 << CollisionSection);
+	default:
+		return ALL_SECTION_TYPES;
+	}
+}
+
+/**
+ * Adds the specified change to the pending change and restarts the delay of the preview rebuild.
+ *
+ * @param Change The change type.
+ */
+void ATerrainActor::SchedulePreview(const ETerrainChangeType Change)
+{
+	// Only generated meshes in the level editor are previewed
+	const auto World = GetWorld();
+	if (!bLivePreview || !BakedTerrainComponents.IsEmpty() || World == nullptr || World->WorldType != EWorldType::Editor)
+	{
+		return;
+	}
+
+	// Collect the change and restart the delay, so a slider that is dragged causes only one rebuild
+	PendingChange = MergeChanges(PendingChange, Change);
+	FTSTicker::GetCoreTicker().RemoveTicker(PreviewTickerHandle);
+	PreviewTickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateWeakLambda(this, [this](float)
+	{
+		PreviewTickerHandle.Reset();
+		RunPreview();
+		// Do not tick again
+		return false;
+	}), PreviewDelay);
+}
+
+/**
+ * Stops the running preview rebuild, so it does not overwrite newer chunks. Its change is scheduled again, as its
+ * batches are only partly applied.
+ */
+void ATerrainActor::CancelPreview()
+{
+	PreviewGeneration->Increment();
+	if (RunningChange != NoChange)
+	{
+		const auto Change = RunningChange;
+		RunningChange = NoChange;
+		SchedulePreview(Change);
+	}
+}
+
+/**
+ * Starts the preview rebuild for the pending change. The sources of the heights are read on the game thread, the
+ * generation, the erosion and the mesh sections run in a background task and the batches are applied on the game
+ * thread.
+ */
+void ATerrainActor::RunPreview()
+{
+	// Take the pending change and the change of a stopped rebuild, without a previous build everything has to be built
+	const auto Change = Builder.IsValid() ? MergeChanges(PendingChange, RunningChange) : TopologyChange;
+	PendingChange = NoChange;
+	RunningChange = NoChange;
+	// Materials are applied directly
+	if (Change == MaterialChange)
+	{
+		PreviewTerrainMaterial = CreateTerrainMaterial();
+		TerrainMaterialInstance = PreviewTerrainMaterial;
+		ApplyPreviewMaterials();
+		UE_LOG(TerrainActor, Display, TEXT("Preview materials updated."));
+		return;
+	}
+
+	// Only the asset and texture access requires the game thread, the heights are reused if they did not change
+	const auto bReadHeights = Change == TopologyChange;
+	const auto bGenerate = bReadHeights && !HasHeightSource();
+	auto HeightGrid = FHexHeightGrid();
+	if (bReadHeights)
+	{
+		// The recorded edits refer to the replaced heights
+		EditJournal.Reset();
+		if (!bGenerate)
+		{
+			HeightGrid = ReadSourceHeights();
+		}
+	}
+	// Map data saved from an eroded build is not eroded again
+	const auto bErode = !IsSourceEroded();
 	else
 	{
-		// TODO Procedural terrain generation 		
+		HeightGrid = Builder->GetHeightGrid();
+	}
+
+	// A new rebuild makes all running rebuilds obsolete
+	const auto Generation = PreviewGeneration->Increment();
+	RunningChange = Change;
+	const auto SectionMask = GetSectionMask(Change);
+	const auto BuildSettings = CreateBuilderSettings();
+	auto Settings = BuildSettings;
+	// The water is not distorted, so the noise lattices are not needed for it
+	const auto bWaterOnly = Change == WaterChange;
+	if (bWaterOnly)
+	{
+		Settings.bUseNoiseLattice = false;
+	}
+
+	// Log
+	UE_LOG(TerrainActor, Display, TEXT("Start preview rebuild (Change: %d, Section Mask: %d)..."),
+	       static_cast<int32>(Change), SectionMask);
+	const auto StartTime = FPlatformTime::Seconds();
+
+	// Generate the mesh sections in the background
+	const auto WeakThis = TWeakObjectPtr<ATerrainActor>(this);
+	const auto GenerationCounter = PreviewGeneration;
+	const auto GeneratorSettings = Generator;
+	const auto ErosionSettings = Erosion;
+	Async(EAsyncExecution::ThreadPool, [=, HeightGrid = MoveTemp(HeightGrid)]() mutable
+	{
+		// Generate and erode the new heights
+		if (bReadHeights)
+		{
+			HeightGrid = CompleteHeights(MoveTemp(HeightGrid), bGenerate, bErode, BuildSettings.bWrapX,
+			                             GeneratorSettings, ErosionSettings);
+		}
+		if (GenerationCounter->GetValue() != Generation)
+		{
+			return;
+		}
+		// The material and the tile data texture depend on the size of the terrain, they are created before the
+		// first batch is applied
+		const auto NewSizeX = HeightGrid.GetSizeX();
+		const auto NewSizeY = HeightGrid.GetSizeY();
+		AsyncTask(ENamedThreads::GameThread, [=]()
+		{
+			if (WeakThis.IsValid() && GenerationCounter->GetValue() == Generation)
+			{
+				WeakThis->PreparePreviewMaterial(NewSizeX, NewSizeY);
+			}
+		});
+
+		// Create the builder, the noise lattices are created in the background too
+		const auto NewBuilder = MakeShared<FHexTerrainBuilder>(Settings, MoveTemp(HeightGrid));
+		const auto ChunkCount = NewBuilder->GetChunkCount();
+		const auto BatchSize = NewBuilder->GetParallelChunkLimit();
+		auto Chunks = TArray<int32>();
+		for (auto First = 0; First < ChunkCount; First += BatchSize)
+		{
+			// Stop, if a newer rebuild was started
+			if (GenerationCounter->GetValue() != Generation)
+			{
+				return;
+			}
+			// Generate the chunks of the batch
+			Chunks.Reset();
+			for (auto Chunk = First; Chunk < FMath::Min(First + BatchSize, ChunkCount); Chunk++)
+			{
+				Chunks.Add(Chunk);
+			}
+			auto Batch = NewBuilder->GenerateChunks(Chunks, SectionMask);
+			// Apply the batch on the game thread, the component is only touched there
+			AsyncTask(ENamedThreads::GameThread, [=, Batch = MoveTemp(Batch)]()
+			{
+				if (WeakThis.IsValid() && GenerationCounter->GetValue() == Generation)
+				{
+					WeakThis->ApplyPreviewBatch(Batch, SectionMask);
+				}
+			});
+		}
+
+		// The kept builder needs the noise lattices, later edits rebuild their chunks with its settings
+		const auto FinalBuilder = bWaterOnly
+			                          ? MakeShared<FHexTerrainBuilder>(BuildSettings, NewBuilder->GetHeightGrid())
+			                          : NewBuilder;
+
+		// Finish the rebuild on the game thread
+		AsyncTask(ENamedThreads::GameThread, [=]()
+		{
+			if (!WeakThis.IsValid() || GenerationCounter->GetValue() != Generation)
+			{
+				return;
+			}
+			WeakThis->FinishPreview(FinalBuilder, bWaterOnly);
+
+			// Log
+			UE_LOG(TerrainActor, Display, TEXT("Preview rebuilt (%.1f ms)."),
+			       (FPlatformTime::Seconds() - StartTime) * 1000.0);
+		});
+	});
+}
+
+/**
+ * Sets the size of the terrain and creates the tile data texture and the terrain material of a preview.
+ *
+ * @param NewSizeX The width of the terrain counted in tiles.
+ * @param NewSizeY The length of the terrain counted in tiles.
+ */
+void ATerrainActor::PreparePreviewMaterial(const int32 NewSizeX, const int32 NewSizeY)
+{
+	SizeX = NewSizeX;
+	SizeY = NewSizeY;
+	TileDataTexture = TileData.Init(SizeX, SizeY, this);
+	PreviewTerrainMaterial = CreateTerrainMaterial();
+	TerrainMaterialInstance = PreviewTerrainMaterial;
+}
+
+/**
+ * Completes a preview rebuild after all its batches were applied.
+ *
+ * @param NewBuilder The builder with the new settings, it replaces the current builder.
+ * @param bWaterOnly If <b>true</b>, only the water was generated and the heights and tile instances are kept.
+ */
+void ATerrainActor::FinishPreview(const TSharedPtr<FHexTerrainBuilder>& NewBuilder, const bool bWaterOnly)
+{
+	// Adopt the new settings, the heights did not change with the water
+	RunningChange = NoChange;
+	Builder = NewBuilder;
+	if (!bWaterOnly)
+	{
+		TerrainSize = Builder->GetTerrainSize();
+		// The dirty and changed chunks have to match the mesh chunks, the budget may reduce their size
+		TileAttributes.Init(SizeX, SizeY, Builder->GetChunkSize());
+		TileChanges.Init(SizeX, SizeY, Builder->GetChunkSize());
+		InvalidateTileInstances();
+		TileSnapshots.Publish(Builder->GetHeightGrid(), Builder->GetChunkSize());
+	}
+	// Remove the sections of chunks that do not exist anymore
+	for (auto Section = NewBuilder->GetChunkCount() * SectionTypeCount; Section < MeshComponent->GetNumSections();
+	     Section++)
+	{
+		MeshComponent->ClearMeshSection(Section);
+	}
+	// The material parameters depend on the size of the terrain
+	ApplyPreviewMaterials();
+	// Repeat the edge chunks with their new materials
+	UpdateWrapComponents();
+}
+
+/**
+ * Applies the terrain and the water material to all existing mesh sections.
+ */
+void ATerrainActor::ApplyPreviewMaterials()
+{
+	for (auto Section = 0; Section < MeshComponent->GetNumSections(); Section++)
+	{
+		switch (Section % SectionTypeCount)
+		{
+		case TerrainSection:
+			MeshComponent->SetMaterial(Section, PreviewTerrainMaterial);
+			break;
+		case WaterSection:
+			MeshComponent->SetMaterial(Section, WaterMaterial);
+			break;
+		default:
+			break;
+		}
+	}
+}
+
+/**
+ * Creates the mesh sections of a batch generated by a preview rebuild.
+ *
+ * @param Batch The generated chunks.
+ * @param SectionMask The section types that were generated.
+ */
+void ATerrainActor::ApplyPreviewBatch(const TArray<FHexTerrainChunkData>& Batch, const int32 SectionMask) const
+{
+	for (const auto& ChunkData : Batch)
+	{
+		for (auto Type = 0; Type < SectionTypeCount; Type++)
+		{
+			if (SectionMask & (1 << Type))
+			{
+				const auto Section = GetSectionIndex(ChunkData.Chunk, static_cast<ETerrainSectionType>(Type));
+				BuildSection(Section, ChunkData.Sections[Type], PreviewTerrainMaterial);
+			}
+		}
 	}
-
-	// Generate terrain mesh data.
-	const auto TerrainMeshData = GenerateTerrainMeshData();
-	// Store terrain size infos
-	TerrainSize = TerrainMeshData.TerrainSize;
-	// Generate dynamic terrain material
-	const auto DynamicTerrainMaterial = UMaterialInstanceDynamic::Create(
-		TerrainMaterial, nullptr, TEXT("Dynamic Terrain Material"));
-	// Set scale parameter
-	DynamicTerrainMaterial->SetScalarParameterValue(TEXT("Scale"), Scale);
-	// Set grid tiling parameter
-	DynamicTerrainMaterial->SetScalarParameterValue(TEXT("Grid Tile X"), SizeX + 0.5);
-	DynamicTerrainMaterial->SetScalarParameterValue(TEXT("Grid Tile Y"), (SizeY * 0.75 + 0.25) / 1.5);
-	// Build the terrain mesh
-	BuildMesh(0, TerrainMeshData, DynamicTerrainMaterial);
-	// Generate water mesh data
-	const auto WaterMeshData = GenerateWaterMeshData();
-	// Build the water mesh
-	BuildMesh(1, WaterMeshData, WaterMaterial);
 }
+#endif
 
 /**
  * Returns a struct containing information about the size of the terrain.
@@ -174,11 +1420,45 @@ FTerrainSize ATerrainActor::GetBounds() const
 	return TerrainSize;
 }
 
+/**
+ * Reads the heights of the tiles and creates the builder, so that the mesh sections of the chunks can be
+ * generated.
+ */
+void ATerrainActor::PrepareBuild()
+{
+	// Load the topography of the terrain from the map data, the file or the texture, otherwise it is generated
+	auto HeightGrid = ReadHeights();
+	SizeX = HeightGrid.GetSizeX();
+	SizeY = HeightGrid.GetSizeY();
+	// Create the tile data texture for the size of the terrain
+	TileDataTexture = TileData.Init(SizeX, SizeY, this);
+
+	// The recorded edits refer to the heights of the previous build
+	EditJournal.Reset();
+	// Create the builder, it calculates the chunks, the terrain size and the noise lattices
+	Builder = MakeShared<FHexTerrainBuilder>(CreateBuilderSettings(), MoveTemp(HeightGrid));
+	// The dirty and changed chunks have to match the mesh chunks, the budget may reduce their size
+	TileAttributes.Init(SizeX, SizeY, Builder->GetChunkSize());
+	TileChanges.Init(SizeX, SizeY, Builder->GetChunkSize());
+	// Store terrain size infos
+	TerrainSize = Builder->GetTerrainSize();
+	// The tile instances belong to the previous build
+	InvalidateTileInstances();
+	// Publish the heights for readers on other threads
+	TileSnapshots.Publish(Builder->GetHeightGrid(), Builder->GetChunkSize());
+
+	// Log
+	UE_LOG(TerrainActor, Display, TEXT("Build prepared (%d x %d chunks, Size: %f x %f)."), Builder->GetChunkCountX(),
+	       Builder->GetChunkCountY(), TerrainSize.MaximalX - TerrainSize.MinimalX,
+	       TerrainSize.MaximalY - TerrainSize.MinimalY);
+}
 
 /**
- * Reads the terrain data from the topography texture and initializes the tiles array.
+ * Reads the terrain data from the topography texture.
+ *
+ * @return The height grid.
  */
-void ATerrainActor::ReadTopography()
+FHexHeightGrid ATerrainActor::ReadTopography() const
 {
 	// Apply properties to the topography texture.
 	Topography->CompressionSettings = TC_VectorDisplacementmap;
@@ -191,949 +1471,772 @@ void ATerrainActor::ReadTopography()
 	Topography->SRGB = false;
 	Topography->UpdateResource();
 	// Get dimensions of the topography texture
-	SizeX = Topography->GetSizeX();
-	SizeY = Topography->GetSizeY();
+	const auto Width = Topography->GetSizeX();
+	const auto Length = Topography->GetSizeY();
+	auto HeightGrid = FHexHeightGrid(Width, Length);
 	// Get and lock image data
 	const auto Mip = &Topography->GetPlatformData()->Mips[0];
 	auto RawImageData = Mip->BulkData;
 	const auto ColorImageData = static_cast<FColor*>(RawImageData.Lock(LOCK_READ_ONLY));
-	// Read the pixels of the texture and initialize the tiles array
-	for (auto Y = 0; Y < SizeY; Y++)
+	// Read the pixels of the texture and initialize the height grid
+	for (auto Y = 0; Y < Length; Y++)
 	{
-		for (auto X = 0; X < SizeX; X++)
+		for (auto X = 0; X < Width; X++)
 		{
 			// Get the color of the pixel
-			const auto Color = ColorImageData[X + Y * SizeX];
+			const auto Color = ColorImageData[X + Y * Width];
 			// The height of the tile is encoded in the red part of the color.
 			const auto Z = Color.R / HeightFactor;
-			// Add new tile to the tiles array
-			Tiles.Add(FTile(FTilePosition(X, Y, Z - SeaLevel)));
+			// Store the height of the tile
+			HeightGrid.SetHeight(X, Y, Z - SeaLevel);
 		}
 	}
 	// Unlock the image data
 	RawImageData.Unlock();
 
 	// Log
-	UE_LOG(TerrainActor, Display, TEXT("Topography read (%d x %d, %d tiles)."), SizeX, SizeY, Tiles.Num());
+	UE_LOG(TerrainActor, Display, TEXT("Topography read (%d x %d, %d tiles)."), Width, Length, HeightGrid.Num());
+	return HeightGrid;
 }
 
 /**
- * Creates a mesh based on the specified mesh data.
+ * Reads the terrain data from the heightmap file.
  *
- * @param Section The index of the mesh section.
- * @param MeshData The mesh data struct.
- * @param Material The material to be applied to the mesh.
+ * @return The height grid, empty if the file could not be read.
  */
-void ATerrainActor::BuildMesh(const int32 Section, const FMeshData& MeshData, UMaterialInterface* Material) const
+FHexHeightGrid ATerrainActor::ReadHeightmapFile() const
 {
-	// Get the vertex array
-	const auto Vertices = MeshData.VertexArray;
-	// Get the triangle array
-	const auto Triangles = MeshData.TriangleArray;
-	// Get the UV array
-	const auto UVs = CalculateUVArray(MeshData);
-	// Get the normal array
-	const auto Normals = CalculateNormalArray(MeshData);
-
-	// Create the mesh
-	MeshComponent->CreateMeshSection(Section, Vertices, Triangles, Normals, UVs, TArray<FColor>(),
-	                                 TArray<FProcMeshTangent>(), true);
-	// Apply the material
-	MeshComponent->SetMaterial(Section, Material);
+	const auto StartTime = FPlatformTime::Seconds();
+	// The file path is relative to the project directory
+	const auto Filename = FPaths::ConvertRelativePathToFull(FPaths::ProjectDir(), HeightmapFile.FilePath);
+	const auto Reader = FHeightmapFileReader(Filename, HeightmapFormat, HeightmapWidth);
+	auto HeightGrid = Reader.ReadHeights(HeightFactor, SeaLevel);
 
 	// Log
-	UE_LOG(TerrainActor, Display, TEXT("Mesh section %d created (Vertices: %d, Triangles: %d)"), Section,
-	       Vertices.Num(), Triangles.Num());
+	UE_LOG(TerrainActor, Display, TEXT("Heightmap file read (%.1f ms, %d x %d, %d tiles)."),
+	       (FPlatformTime::Seconds() - StartTime) * 1000.0, HeightGrid.GetSizeX(), HeightGrid.GetSizeY(),
+	       HeightGrid.Num());
+	return HeightGrid;
 }
 
 /**
- * Generates the mesh data for the water mesh.
- * 
- * @return Mesh data struct. 
+ * Reads the terrain data from the map data asset. If the asset is not loaded yet, it is loaded synchronously.
+ *
+ * @return The height grid, empty if the asset could not be loaded.
  */
-FMeshData ATerrainActor::GenerateWaterMeshData() const
+FHexHeightGrid ATerrainActor::ReadMapData() const
 {
-	// The mesh data struct
-	auto MeshData = FMeshData();
-
-	// Calculate the height of the vertices
-	const auto Height = HeightUnit * 3.0 - WaterOffset;
-
-	// Iterate over all tiles
-	for (const auto& Tile : Tiles)
+	// At runtime the asset was loaded asynchronously before, in the editor it is loaded on demand
+	const auto LoadedMapData = MapData.LoadSynchronous();
+	if (!IsValid(LoadedMapData))
 	{
-		if (Tile.Position.Z <= 0 || HasCoast(Tile))
-		{
-			for (auto Row = 0; Row < 8; Row++)
-			{
-				for (auto Col = 0; Col < 9 + Row; Col++)
-				{
-					const auto Offset = Col * 68 + Row * 64;
-
-					AddVertex(MeshData, Tile, 16 + Offset, Height, true, true);
-					AddVertex(MeshData, Tile, 80 + Offset, Height, true, true);
-					AddVertex(MeshData, Tile, 148 + Offset, Height, true, true);
-
-					AddVertex(MeshData, Tile, 1996 - Offset, Height, true, true);
-					AddVertex(MeshData, Tile, 2128 - Offset, Height, true, true);
-					AddVertex(MeshData, Tile, 2064 - Offset, Height, true, true);
-
-					if (Col < 8 + Row)
-					{
-						AddVertex(MeshData, Tile, 16 + Offset, Height, true, true);
-						AddVertex(MeshData, Tile, 148 + Offset, Height, true, true);
-						AddVertex(MeshData, Tile, 84 + Offset, Height, true, true);
-
-						AddVertex(MeshData, Tile, 1996 - Offset, Height, true, true);
-						AddVertex(MeshData, Tile, 2060 - Offset, Height, true, true);
-						AddVertex(MeshData, Tile, 2128 - Offset, Height, true, true);
-					}
-				}
-			}
-		}
+		UE_LOG(TerrainActor, Warning, TEXT("Map data %s could not be loaded."), *MapData.ToString());
+		return FHexHeightGrid();
 	}
+	auto HeightGrid = LoadedMapData->ReadHeightGrid(SeaLevel);
 
-	// Return the mesh data struct
-	return MeshData;
+	// Log
+	UE_LOG(TerrainActor, Display, TEXT("Map data read (%d x %d, %d tiles)."), HeightGrid.GetSizeX(),
+	       HeightGrid.GetSizeY(), HeightGrid.Num());
+	return HeightGrid;
 }
 
 /**
- * Generates the mesh data for the terrain mesh.
- * 
- * @return Mesh data struct. 
+ * Returns <b>true</b>, if the map data, the heightmap file or the topography texture is set.
+ *
+ * @return The source flag.
  */
-FMeshData ATerrainActor::GenerateTerrainMeshData() const
+bool ATerrainActor::HasHeightSource() const
 {
-	// The mesh data struct
-	auto MeshData = FMeshData();
+	return !MapData.IsNull() || !HeightmapFile.FilePath.IsEmpty() || IsValid(Topography);
+}
 
-	// Iterate over all tiles
-	for (const auto& Tile : Tiles)
+/**
+ * Reads the terrain data from the map data if it is set, otherwise from the heightmap file or the topography
+ * texture. Without any source the grid is empty and the heights have to be generated.
+ *
+ * @return The height grid.
+ */
+FHexHeightGrid ATerrainActor::ReadSourceHeights() const
+{
+	if (!MapData.IsNull())
 	{
-		// Generate the center part of the tile mesh
-		GenerateTerrainTileCenter(MeshData, Tile);
-		// Iterate over all directions of the tile
-		for (const auto Direction : TEnumRange<ETileDirection>())
-		{
-			// Get neighbour heights
-			const auto Heights = GetNeighbourHeights(Tile, Direction);
-			const auto LeftZ = Heights[0];
-			const auto CenterZ = Heights[1];
-			const auto RightZ = Heights[2];
-			// Generate the inner edge
-			GenerateTerrainTileInnerEdge(MeshData, Tile, Direction, CenterZ);
-			// Generate the outer edge
-			GenerateTerrainTileOuterEdge(MeshData, Tile, Direction, LeftZ, CenterZ, RightZ);
-			// Generate the inner corners
-			GenerateTerrainTileInnerCorners(MeshData, Tile, Direction, LeftZ, CenterZ, RightZ);
-			// Generate the outer corners
-			GenerateTerrainTileOuterCorners(MeshData, Tile, Direction, LeftZ, CenterZ, RightZ);
-			// Generate the center wall
-			GenerateTerrainTileCenterWall(MeshData, Tile, Direction, CenterZ);
-			// Generate left side wall
-			GenerateTerrainTileSideWall(MeshData, Tile, Direction, CenterZ, LeftZ, 27, 11);
-			// Generate right side wall
-			GenerateTerrainTileSideWall(MeshData, Tile, Direction, CenterZ, RightZ, 17, 33);
-			// Generate left side corner wall
-			GenerateTerrainTileLeftCornerWall(MeshData, Tile, Direction, CenterZ, LeftZ);
-			// Generate right side corner wall
-			GenerateTerrainTileRightCornerWall(MeshData, Tile, Direction, CenterZ, RightZ);
-		}
+		return ReadMapData();
+	}
+	if (!HeightmapFile.FilePath.IsEmpty())
+	{
+		return ReadHeightmapFile();
+	}
+	if (IsValid(Topography))
+	{
+		return ReadTopography();
 	}
+	return FHexHeightGrid();
+}
 
-	// Return the mesh data struct
-	return MeshData;
+/**
+ * Returns <b>true</b>, if the heights of the source were already eroded, e.g. map data saved from an eroded build.
+ *
+ * @return The eroded flag.
+ */
+bool ATerrainActor::IsSourceEroded() const
+{
+	// Only the map data is saved from a build, it is loaded as soon as its heights were read
+	const auto LoadedMapData = MapData.Get();
+	return IsValid(LoadedMapData) && LoadedMapData->IsEroded();
 }
 
 /**
- * Generates the mesh data for the center part of the tile mesh.
- * 
- * @param MeshData The mesh data struct. 
- * @param Tile The tile the mesh data is generated for.
+ * Generates the heights, if there is no source, and erodes them, if the erosion is enabled. It only uses its
+ * parameters, so it can run on any thread.
+ *
+ * @param HeightGrid The height grid read from the source.
+ * @param bGenerate If <b>true</b>, the heights are generated.
+ * @param bErode If <b>false</b>, the heights are already eroded and the erosion is skipped.
+ * @param bErodeWrapX If <b>true</b>, the terrain wraps around along the X axis and is eroded across the seam.
+ * @param GeneratorSettings The parameters of the generation.
+ * @param ErosionSettings The parameters of the erosion.
+ *
+ * @return The height grid.
  */
-void ATerrainActor::GenerateTerrainTileCenter(FMeshData& MeshData, const FTile& Tile) const
+FHexHeightGrid ATerrainActor::CompleteHeights(FHexHeightGrid HeightGrid, const bool bGenerate, const bool bErode,
+                                              const bool bErodeWrapX,
+                                              const FTerrainGeneratorSettings& GeneratorSettings,
+                                              const FTerrainErosionSettings& ErosionSettings)
 {
-	// Rows of the mesh
-	for (auto Row = 0; Row < 4; Row++)
+	// Without any source the heights are generated procedurally
+	if (bGenerate)
 	{
-		// Columns of the mesh
-		for (auto Col = 0; Col < Row + 5; Col++)
-		{
-			// Calculate offset of vertex position index
-			const auto Offset = Col * 68 + Row * 64;
-			// Add triangle part 1
-			AddVertex(MeshData, Tile, 544 + Offset, 1.0);
-			AddVertex(MeshData, Tile, 608 + Offset, 1.0);
-			AddVertex(MeshData, Tile, 676 + Offset, 1.0);
-			// Add triangle part 2
-			AddVertex(MeshData, Tile, 1600 - Offset, 1.0);
-			AddVertex(MeshData, Tile, 1536 - Offset, 1.0);
-			AddVertex(MeshData, Tile, 1468 - Offset, 1.0);
-			if (Col < Row + 4)
-			{
-				// Add triangle part 3
-				AddVertex(MeshData, Tile, 544 + Offset, 1.0);
-				AddVertex(MeshData, Tile, 676 + Offset, 1.0);
-				AddVertex(MeshData, Tile, 612 + Offset, 1.0);
-				// Add triangle part 4
-				AddVertex(MeshData, Tile, 1600 - Offset, 1.0);
-				AddVertex(MeshData, Tile, 1468 - Offset, 1.0);
-				AddVertex(MeshData, Tile, 1532 - Offset, 1.0);
-			}
-		}
+		HeightGrid = FHexTerrainGenerator(GeneratorSettings).Generate();
+	}
+	if (bErode && ErosionSettings.bEnabled)
+	{
+		auto Eroder = FHexTerrainEroder(ErosionSettings, bErodeWrapX);
+		Eroder.Erode(HeightGrid);
 	}
+	return HeightGrid;
 }
 
 /**
- * Generates the mesh data for the inner edge in the specified direction for the specified tile.
- * 
- * @param MeshData The mesh data struct. 
- * @param Tile The tile the mesh data is generated for.
- * @param Direction The direction of the inner edge.
- * @param CenterZ The height of the neighbour in the specified direction.
+ * Reads the heights of the tiles from their source or generates them and erodes them, if the erosion is enabled.
+ *
+ * @return The height grid.
  */
-void ATerrainActor::GenerateTerrainTileInnerEdge(FMeshData& MeshData, const FTile& Tile, const ETileDirection Direction,
-                                                 const int32 CenterZ) const
+FHexHeightGrid ATerrainActor::ReadHeights() const
 {
-	// Calculate additional heights
-	const auto H1 = Tile.Position.Z > CenterZ ? 0.5 : Tile.Position.Z < CenterZ ? 1.5 : 1.0;
-	const auto H2 = Tile.Position.Z > CenterZ ? 0.0 : Tile.Position.Z < CenterZ ? 2.0 : 1.0;
-	// Calculate mesh data
-	for (auto Col = 0; Col < 4; Col++)
-	{
-		AddTriangle(MeshData, Tile, Direction, Col, 1.0, Col + 6, H1, Col + 1, 1.0);
-		AddTriangle(MeshData, Tile, Direction, Col, 1.0, Col + 12, H2, Col + 6, H1);
-		AddTriangle(MeshData, Tile, Direction, Col + 1, 1.0, Col + 6, H1, Col + 13, H2);
-		AddTriangle(MeshData, Tile, Direction, Col + 6, H1, Col + 12, H2, Col + 13, H2);
-	}
+	const auto bGenerate = !HasHeightSource();
+	auto HeightGrid = bGenerate ? FHexHeightGrid() : ReadSourceHeights();
+	return CompleteHeights(MoveTemp(HeightGrid), bGenerate, !IsSourceEroded(), bWrapX, Generator, Erosion);
 }
 
 /**
- * Generates the mesh data for the outer edge in the specified direction for the specified tile.
- * 
- * @param MeshData The mesh data struct. 
- * @param Tile The tile the mesh data is generated for.
- * @param Direction The direction of the outer edge.
- * @param LeftZ The height of the neighbour of the left side of the specified direction.
- * @param CenterZ The height of the neighbour in the specified direction.
- * @param RightZ The height of the neighbour of the right side of the specified direction.
+ * Creates the settings for the builder from the properties of this actor.
+ *
+ * @return The settings struct.
  */
-void ATerrainActor::GenerateTerrainTileOuterEdge(FMeshData& MeshData, const FTile& Tile, const ETileDirection Direction,
-                                                 const int32 LeftZ, const int32 CenterZ, const int32 RightZ) const
+FHexTerrainSettings ATerrainActor::CreateBuilderSettings() const
 {
-	const auto TileZ = Tile.Position.Z;
+	auto Settings = FHexTerrainSettings();
+	Settings.HeightUnit = HeightUnit;
+	Settings.WallEdgeHeight = WallEdgeHeight;
+	Settings.WaterOffset = WaterOffset;
+	Settings.Scale = Scale;
+	Settings.ChunkSize = ChunkSize;
+	Settings.MeshMemoryBudget = MeshMemoryBudget;
+	Settings.NoiseParameterX = NoiseParameterX;
+	Settings.NoiseParameterY = NoiseParameterY;
+	Settings.NoiseParameterZ = NoiseParameterZ;
+	Settings.bUseNoiseLattice = bUseNoiseLattice;
+	Settings.NoiseLatticeMaxError = NoiseLatticeMaxError;
+	Settings.bWrapX = bWrapX;
+	return Settings;
+}
 
-	const auto Hc0 = TileZ > CenterZ ? (CenterZ - TileZ) * 4.0 + 4.0 : TileZ < CenterZ ? 2.0 : 1.0;
-	const auto Hc1 = TileZ > CenterZ ? (CenterZ - TileZ) * 4.0 + 3.5 : TileZ < CenterZ ? 2.5 : 1.0;
-	const auto Hc2 = TileZ > CenterZ ? (CenterZ - TileZ) * 4.0 + 3.0 : TileZ < CenterZ ? 3.0 : 1.0;
+/**
+ * Calculates a hash over all inputs of the mesh generation. 
+ *
+ * @return The hash value.
+ */
+uint64 ATerrainActor::CalculateBuildHash() const
+{
+	auto HashBuilder = FXxHash64Builder();
+	// The cache format
+	const auto Version = TERRAIN_MESH_CACHE_VERSION;
+	HashBuilder.Update(&Version, sizeof(Version));
+	// The settings and the height grid, the heights contain the topography, the height factor and the sea level
+	const auto InputHash = Builder->CalculateHash();
+	HashBuilder.Update(&InputHash, sizeof(InputHash));
+	// Return the hash
+	return HashBuilder.Finalize().Hash;
+}
 
-	const auto Hl0 = TileZ != CenterZ ? Hc0 : TileZ > LeftZ ? 0.0 : TileZ < LeftZ ? 2.0 : Hc0;
-	const auto Hl1 = TileZ != CenterZ ? Hc1 : TileZ > LeftZ ? 0.5 : TileZ < LeftZ ? 1.5 : Hc1;
-	const auto Hl2 = TileZ != CenterZ ? Hc2 : Hl0;
+/**
+ * Returns the name of the mesh cache file of this terrain.
+ *
+ * @return The file name.
+ */
+FString ATerrainActor::GetMeshCacheFilename() const
+{
+	return FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("TerrainCache"), GetName() + TEXT(".hxmc"));
+}
 
-	const auto Hr0 = TileZ != CenterZ ? Hc0 : TileZ > RightZ ? 0.0 : TileZ < RightZ ? 2.0 : Hc0;
-	const auto Hr1 = TileZ != CenterZ ? Hc1 : TileZ > RightZ ? 0.5 : TileZ < RightZ ? 1.5 : Hc1;
-	const auto Hr2 = TileZ != CenterZ ? Hc2 : Hr0;
+/**
+ * Creates the mesh sections from the mesh cache file, if it exists and matches the specified hash.
+ *
+ * @param Hash The hash of the build inputs.
+ * @param DynamicTerrainMaterial The material to be applied to the terrain sections.
+ *
+ * @return <b>true</b>, if the mesh sections were loaded from the cache.
+ */
+bool ATerrainActor::LoadMeshCache(const uint64 Hash, UMaterialInterface* DynamicTerrainMaterial) const
+{
+	// Map the cache file
+	const auto Reader = FTerrainMeshCacheReader(GetMeshCacheFilename(), Hash);
+	if (!Reader.IsValid())
+	{
+		return false;
+	}
 
-	AddTriangle(MeshData, Tile, Direction, 11, Hl0, 19, Hl1, 12, Hc0);
-	AddTriangle(MeshData, Tile, Direction, 11, Hl0, 27, Hl2, 19, Hl1);
-	AddTriangle(MeshData, Tile, Direction, 12, Hc0, 19, Hl1, 28, Hc2);
-	AddTriangle(MeshData, Tile, Direction, 19, Hl1, 27, Hl2, 28, Hc2);
+	// Create the mesh sections
+	auto MeshSectionData = FMeshSectionData();
+	for (auto Entry = 0; Entry < Reader.GetSectionCount(); Entry++)
+	{
+		auto Section = 0;
+		Reader.ReadSection(Entry, Section, MeshSectionData);
+		BuildSection(Section, MeshSectionData, DynamicTerrainMaterial);
+	}
+	return true;
+}
 
-	for (auto Col = 1; Col < 5; Col++)
+/**
+ * Creates the dynamic material for the terrain mesh.
+ *
+ * @return The dynamic material instance.
+ */
+UMaterialInstanceDynamic* ATerrainActor::CreateTerrainMaterial() const
+{
+	// Generate dynamic terrain material
+	const auto DynamicTerrainMaterial = UMaterialInstanceDynamic::Create(
+		TerrainMaterial, nullptr, TEXT("Dynamic Terrain Material"));
+	// Set scale parameter
+	DynamicTerrainMaterial->SetScalarParameterValue(TEXT("Scale"), Scale);
+	// Set grid tiling parameter
+	DynamicTerrainMaterial->SetScalarParameterValue(TEXT("Grid Tile X"), SizeX + 0.5);
+	DynamicTerrainMaterial->SetScalarParameterValue(TEXT("Grid Tile Y"), (SizeY * 0.75 + 0.25) / 1.5);
+	// Set tile data texture
+	if (IsValid(TileDataTexture))
 	{
-		AddTriangle(MeshData, Tile, Direction, Col + 11, Hc0, Col + 19, Hc1, Col + 12, Hc0);
-		AddTriangle(MeshData, Tile, Direction, Col + 11, Hc0, Col + 27, Hc2, Col + 19, Hc1);
-		AddTriangle(MeshData, Tile, Direction, Col + 12, Hc0, Col + 19, Hc1, Col + 28, Hc2);
-		AddTriangle(MeshData, Tile, Direction, Col + 19, Hc1, Col + 27, Hc2, Col + 28, Hc2);
+		DynamicTerrainMaterial->SetTextureParameterValue(TEXT("Tile Data"), TileDataTexture);
 	}
+	return DynamicTerrainMaterial;
+}
 
-	AddTriangle(MeshData, Tile, Direction, 16, Hc0, 24, Hr1, 17, Hr0);
-	AddTriangle(MeshData, Tile, Direction, 16, Hc0, 32, Hc2, 24, Hr1);
-	AddTriangle(MeshData, Tile, Direction, 17, Hr0, 24, Hr1, 33, Hr2);
-	AddTriangle(MeshData, Tile, Direction, 24, Hr1, 32, Hc2, 33, Hr2);
+/**
+ * Returns the index of the mesh section of the specified type for the specified chunk.
+ *
+ * @param Chunk The index of the chunk.
+ * @param Type The type of the mesh section.
+ *
+ * @return The index of the mesh section.
+ */
+int32 ATerrainActor::GetSectionIndex(const int32 Chunk, const ETerrainSectionType Type)
+{
+	return Chunk * SectionTypeCount + Type;
 }
 
 /**
- * Generates the mesh data for the left and right inner corner in the specified direction for the specified tile.
- * 
- * @param MeshData The mesh data struct. 
- * @param Tile The tile the mesh data is generated for.
- * @param Direction The direction of the inner corner.
- * @param LeftZ The height of the neighbour of the left side of the specified direction.
- * @param CenterZ The height of the neighbour in the specified direction.
- * @param RightZ The height of the neighbour of the right side of the specified direction.
- */
-void ATerrainActor::GenerateTerrainTileInnerCorners(FMeshData& MeshData, const FTile& Tile,
-                                                    const ETileDirection Direction, const int32 LeftZ,
-                                                    const int32 CenterZ, const int32 RightZ) const
-{
-	// Get left corner heights
-	const auto LeftHeights = CalculateInnerCornerHeights(Tile, CenterZ, LeftZ);
-	const auto Lh0 = LeftHeights[0];
-	const auto Lh1 = LeftHeights[1];
-	const auto Lh2 = LeftHeights[2];
-	const auto Lh3 = LeftHeights[3];
-	// Generate left corner mesh data
-	AddTriangle(MeshData, Tile, Direction, 0, Lh0, 5, Lh2, 12, Lh1);
-	AddTriangle(MeshData, Tile, Direction, 5, Lh2, 11, Lh3, 12, Lh1);
-
-	// Get right corner heights
-	const auto RightHeights = CalculateInnerCornerHeights(Tile, CenterZ, RightZ);
-	const auto Rh0 = RightHeights[0];
-	const auto Rh1 = RightHeights[1];
-	const auto Rh2 = RightHeights[2];
-	const auto Rh3 = RightHeights[3];
-	// Generate right corner mesh data
-	AddTriangle(MeshData, Tile, Direction, 4, Rh0, 16, Rh1, 10, Rh2);
-	AddTriangle(MeshData, Tile, Direction, 10, Rh2, 16, Rh1, 17, Rh3);
-}
-
-/**
- * Generates the mesh data for the left and right outer corner in the specified direction for the specified tile.
- * 
- * @param MeshData The mesh data struct. 
- * @param Tile The tile the mesh data is generated for.
- * @param Direction The direction of the outer corner.
- * @param LeftZ The height of the neighbour of the left side of the specified direction.
- * @param CenterZ The height of the neighbour in the specified direction.
- * @param RightZ The height of the neighbour of the right side of the specified direction.
- */
-void ATerrainActor::GenerateTerrainTileOuterCorners(FMeshData& MeshData, const FTile& Tile,
-                                                    const ETileDirection Direction, const int32 LeftZ,
-                                                    const int32 CenterZ, const int32 RightZ) const
-{
-	// Get left corner heights
-	const auto LeftHeights = CalculateOuterCornerHeights(Tile, CenterZ, LeftZ);
-	const auto Lh0 = LeftHeights[0];
-	const auto Lh1 = LeftHeights[1];
-	const auto Lh2 = LeftHeights[2];
-	const auto Lh3 = LeftHeights[3];
-	// Generate left corner mesh data
-	AddTriangle(MeshData, Tile, Direction, 11, Lh0, 18, Lh2, 27, Lh1);
-	AddTriangle(MeshData, Tile, Direction, 18, Lh2, 26, Lh3, 27, Lh1);
-
-	// Get right corner heights
-	const auto RightHeights = CalculateOuterCornerHeights(Tile, CenterZ, RightZ);
-	const auto Rh0 = RightHeights[0];
-	const auto Rh1 = RightHeights[1];
-	const auto Rh2 = RightHeights[2];
-	const auto Rh3 = RightHeights[3];
-	// Generate right corner mesh data
-	AddTriangle(MeshData, Tile, Direction, 17, Rh0, 33, Rh1, 25, Rh2);
-	AddTriangle(MeshData, Tile, Direction, 25, Rh2, 33, Rh1, 34, Rh3);
-}
-
-/**
- * Generates the mesh data for the center wall in the specified direction for the specified tile.
- * 
- * @param MeshData The mesh data struct. 
- * @param Tile The tile the mesh data is generated for.
- * @param Direction The direction of the center wall.
- * @param CenterZ The height of the neighbour in the specified direction.
+ * Generates the mesh sections of the specified chunks again and replaces the existing ones. The chunks are
+ * generated in parallel batches that fit into the memory budget.
+ *
+ * @param Chunks The indices of the chunks.
+ * @param DynamicTerrainMaterial The material to be applied to the terrain sections.
  */
-void ATerrainActor::GenerateTerrainTileCenterWall(FMeshData& MeshData, const FTile& Tile,
-                                                  const ETileDirection Direction, const int32 CenterZ) const
+void ATerrainActor::RebuildChunks(const TArray<int32>& Chunks, UMaterialInterface* DynamicTerrainMaterial) const
 {
-	// Calculate the difference between the tile height and the height of the center neighbour
-	const auto Diff = Tile.Position.Z - CenterZ;
-	// If the height are greater than one, we need a wall.
-	if (Diff > 1)
+	const auto BatchSize = Builder->GetParallelChunkLimit();
+	for (auto First = 0; First < Chunks.Num(); First += BatchSize)
 	{
-		// Iterate for every level of the differnce that is greater than one
-		for (auto Level = 0; Level < Diff - 1; Level++)
+		// Generate the chunks of the batch
+		const auto Batch = TArray<int32>(Chunks.GetData() + First, FMath::Min(BatchSize, Chunks.Num() - First));
+		// Replace the mesh sections, the component is only touched on the game thread
+		for (const auto& ChunkData : Builder->GenerateChunks(Batch))
 		{
-			// Calculate heights
-			const auto H0 = Level * -4.0;
-			const auto H1 = H0 - WallEdgeHeight;
-			const auto H2 = H0 - 2.0;
-			const auto H3 = H0 - (4.0 - WallEdgeHeight);
-			const auto H4 = H0 - 4.0;
-			// Iterate over all columns of the wall.
-			for (auto Col = 0; Col < 6; Col++)
+			for (auto Type = 0; Type < SectionTypeCount; Type++)
 			{
-				// Calculate local vertex indices
-				const auto I0 = Col + 11;
-				const auto I1 = Col + 12;
-				// Add upper edge
-				AddTriangle(MeshData, Tile, Direction, I1, H0, I0, H0, I0, H1);
-				AddTriangle(MeshData, Tile, Direction, I1, H0, I0, H1, I1, H1);
-				// Add upper wall
-				AddTriangle(MeshData, Tile, Direction, I1, H1, I0, H1, I0, H2);
-				AddTriangle(MeshData, Tile, Direction, I1, H1, I0, H2, I1, H2);
-				// Add lower wall
-				AddTriangle(MeshData, Tile, Direction, I1, H2, I0, H2, I0, H3);
-				AddTriangle(MeshData, Tile, Direction, I1, H2, I0, H3, I1, H3);
-				// Add lower edge
-				AddTriangle(MeshData, Tile, Direction, I1, H3, I0, H3, I0, H4);
-				AddTriangle(MeshData, Tile, Direction, I1, H3, I0, H4, I1, H4);
+				const auto Section = GetSectionIndex(ChunkData.Chunk, static_cast<ETerrainSectionType>(Type));
+				BuildSection(Section, ChunkData.Sections[Type], DynamicTerrainMaterial);
 			}
 		}
 	}
+	// Repeat the rebuilt edge chunks of a wrapping terrain
+	UpdateWrapComponents(Chunks);
 }
 
 /**
- * Generates the mesh data for the left or right side wall in the specified direction for the specified tile.
- * 
- * @param MeshData The mesh data struct. 
- * @param Tile The tile the mesh data is generated for.
- * @param Direction The direction of the side wall.
- * @param CenterZ The height of the neighbour in the specified direction.
- * @param SideZ The height of the neighbour of the specified side of the specified direction.
- * @param Index0 The index of the upper vertex. 
- * @param Index1 The index of the lower vertex.
- */
-void ATerrainActor::GenerateTerrainTileSideWall(FMeshData& MeshData, const FTile& Tile, const ETileDirection Direction,
-                                                const int32 CenterZ, const int32 SideZ, const int32 Index0,
-                                                const int32 Index1) const
-{
-	// Calculate the rows needed
-	const auto Rows = FMath::Min(Tile.Position.Z, CenterZ) - SideZ - 1;
-	// Iterate over every row
-	for (auto Row = 0; Row < Rows; Row++)
-	{
-		// Calculate vertex heights
-		const auto H0 = (Tile.Position.Z > CenterZ ? (CenterZ - Tile.Position.Z) * 4.0 : 0) - Row * 4.0;
-		const auto H1 = H0 - WallEdgeHeight;
-		const auto H2 = H0 - 2.0;
-		const auto H3 = H0 - (4.0 - WallEdgeHeight);
-		const auto H4 = H0 - 4.0;
-
-		// Add upper edge
-		AddTriangle(MeshData, Tile, Direction, Index0, H0, Index1, H0, Index1, H1);
-		AddTriangle(MeshData, Tile, Direction, Index0, H0, Index1, H1, Index0, H1);
-		// Add upper wall
-		AddTriangle(MeshData, Tile, Direction, Index0, H1, Index1, H1, Index1, H2);
-		AddTriangle(MeshData, Tile, Direction, Index0, H1, Index1, H2, Index0, H2);
-		// Add lower wall
-		AddTriangle(MeshData, Tile, Direction, Index0, H2, Index1, H2, Index1, H3);
-		AddTriangle(MeshData, Tile, Direction, Index0, H2, Index1, H3, Index0, H3);
-		// Add lower edge
-		AddTriangle(MeshData, Tile, Direction, Index0, H3, Index1, H3, Index1, H4);
-		AddTriangle(MeshData, Tile, Direction, Index0, H3, Index1, H4, Index0, H4);
-	}
-}
-
-/**
- * Generates the mesh data for the left side corner wall in the specified direction for the specified tile.
- * 
- * @param MeshData The mesh data struct. 
- * @param Tile The tile the mesh data is generated for.
- * @param Direction The direction of the left side corner wall.
- * @param CenterZ The height of the neighbour in the specified direction.
- * @param LeftZ The height of the neighbour of the left side of the specified direction.
- */
-void ATerrainActor::GenerateTerrainTileLeftCornerWall(FMeshData& MeshData, const FTile& Tile,
-                                                      const ETileDirection Direction, const int32 CenterZ,
-                                                      const int32 LeftZ) const
-{
-	// Check, if there are a gap between tile and left neightbour that needs to be filled
-	if (Tile.Position.Z > CenterZ && Tile.Position.Z - 1 > LeftZ && CenterZ > LeftZ)
-	{
-		// Calculate heights
-		const auto H0 = (Tile.Position.Z - CenterZ - 1) * -4.0;
-		const auto H1 = H0 - WallEdgeHeight;
-		const auto H2 = H0 - 1.0;
-		const auto H3 = H0 - 2.0;
-		const auto H4 = H0 - (4.0 - WallEdgeHeight);
-		const auto H5 = H0 - 4.0;
-
-		// Add necessary triangles
-		AddTriangle(MeshData, Tile, Direction, 11, H0, 11, H1, 27, H2);
-		AddTriangle(MeshData, Tile, Direction, 11, H1, 27, H3, 27, H2);
-		AddTriangle(MeshData, Tile, Direction, 11, H1, 11, H3, 27, H3);
-		AddTriangle(MeshData, Tile, Direction, 11, H3, 27, H4, 27, H3);
-		AddTriangle(MeshData, Tile, Direction, 11, H3, 11, H4, 27, H4);
-		AddTriangle(MeshData, Tile, Direction, 11, H4, 27, H5, 27, H4);
-		AddTriangle(MeshData, Tile, Direction, 11, H4, 11, H5, 27, H5);
-	}
-
-	// Check, if there is a little corner to be filled when the one neighbour is lower and the other is higher.
-	if (Tile.Position.Z < CenterZ && Tile.Position.Z > LeftZ)
-	{
-		// Add necessary triangles
-		AddTriangle(MeshData, Tile, Direction, 0, 1.0, 5, 0.5, 5, 1.5);
-		AddTriangle(MeshData, Tile, Direction, 11, 2.0, 5, 1.5, 11, 0.5);
-		AddTriangle(MeshData, Tile, Direction, 11, 0.5, 5, 1.5, 5, 0.5);
-		AddTriangle(MeshData, Tile, Direction, 11, 0.5, 5, 0.5, 11, 0.0);
-		AddTriangle(MeshData, Tile, Direction, 27, 3.0, 11, 2.0, 27, 2.0);
-		AddTriangle(MeshData, Tile, Direction, 27, 2.0, 11, 2.0, 11, 0.5);
-		AddTriangle(MeshData, Tile, Direction, 27, 2.0, 11, 0.5, 27, WallEdgeHeight);
-		AddTriangle(MeshData, Tile, Direction, 27, WallEdgeHeight, 11, 0.5, 11, 0.0);
-		AddTriangle(MeshData, Tile, Direction, 27, WallEdgeHeight, 11, 0.0, 27, 0.0);
-	}
-}
-
-/**
- * Generates the mesh data for the right side corner wall in the specified direction for the specified tile.
- * 
- * @param MeshData The mesh data struct. 
- * @param Tile The tile the mesh data is generated for.
- * @param Direction The direction of the right side corner wall.
- * @param CenterZ The height of the neighbour in the specified direction.
- * @param RightZ The height of the neighbour of the right side of the specified direction.
- */
-void ATerrainActor::GenerateTerrainTileRightCornerWall(FMeshData& MeshData, const FTile& Tile,
-                                                       const ETileDirection Direction, const int32 CenterZ,
-                                                       const int32 RightZ) const
-{
-	// Check, if there are a gap between tile and right neightbour that needs to be filled
-	if (Tile.Position.Z > CenterZ && Tile.Position.Z - 1 > RightZ && CenterZ > RightZ)
-	{
-		// Calculate heights
-		const auto H0 = (Tile.Position.Z - CenterZ - 1) * -4.0;
-		const auto H1 = H0 - WallEdgeHeight;
-		const auto H2 = H0 - 1.0;
-		const auto H3 = H0 - 2.0;
-		const auto H4 = H0 - (4.0 - WallEdgeHeight);
-		const auto H5 = H0 - 4.0;
-
-		// Add necessary triangles
-		AddTriangle(MeshData, Tile, Direction, 17, H0, 33, H2, 17, H1);
-		AddTriangle(MeshData, Tile, Direction, 17, H1, 33, H2, 33, H3);
-		AddTriangle(MeshData, Tile, Direction, 17, H1, 33, H3, 17, H3);
-		AddTriangle(MeshData, Tile, Direction, 17, H3, 33, H3, 33, H4);
-		AddTriangle(MeshData, Tile, Direction, 17, H3, 33, H4, 17, H4);
-		AddTriangle(MeshData, Tile, Direction, 17, H4, 33, H4, 33, H5);
-		AddTriangle(MeshData, Tile, Direction, 17, H4, 33, H5, 17, H5);
-	}
-
-	// Check, if there is a little corner to be filled when the one neighbour is lower and the other is higher.
-	if (Tile.Position.Z < CenterZ && Tile.Position.Z > RightZ)
-	{
-		// Add necessary triangles
-		AddTriangle(MeshData, Tile, Direction, 4, 1.0, 10, 1.5, 10, 0.5);
-		AddTriangle(MeshData, Tile, Direction, 17, 2.0, 17, 0.5, 10, 1.5);
-		AddTriangle(MeshData, Tile, Direction, 10, 1.5, 17, 0.5, 10, 0.5);
-		AddTriangle(MeshData, Tile, Direction, 10, 0.5, 17, 0.5, 17, 0.0);
-		AddTriangle(MeshData, Tile, Direction, 17, 2.0, 33, 3.0, 33, 2.0);
-		AddTriangle(MeshData, Tile, Direction, 17, 2.0, 33, 2.0, 33, WallEdgeHeight);
-		AddTriangle(MeshData, Tile, Direction, 17, 2.0, 33, WallEdgeHeight, 17, 0.5);
-		AddTriangle(MeshData, Tile, Direction, 17, 0.5, 33, WallEdgeHeight, 33, 0.0);
-		AddTriangle(MeshData, Tile, Direction, 17, 0.5, 33, 0.0, 17, 0.0);
-	}
-}
-
-/**
- * Adds a new vertex to the current or a new triangle in the mesh data.
- * 
- * @param MeshData The mesh data struct. 
- * @param Tile The tile the vertex is generated for.
- * @param Index The index of the vertex position within a tile.
- * @param Height The height of the vertex in height units. If <i>Absolute</i> is <b>true</b>,
- *               the height is used as specified and not in height units.
- * @param Absolute If <b>true</b>, the height is used as is and is not multiplied with the height unit.  
- * @param NoDistortion If <b>true</b>, the vertext will be distorted, otherwise not.
- */
-void ATerrainActor::AddVertex(FMeshData& MeshData, const FTile& Tile, const int32 Index, const double Height,
-                              const bool Absolute, const bool NoDistortion) const
-{
-	// Get the coordinates of the position vector of the tile.
-	const auto Px = Tile.Position.X * TILE_WIDTH
-		+ ((Tile.Position.Y & 1) == 0 ? 0.0 : TILE_WIDTH / 2.0)
-		- TILE_WIDTH / 2.0;
-	const auto Py = Tile.Position.Y * 0.75 - 0.5;
-	const auto Pz = Tile.Position.Z * HeightUnit * 4.0;
-	// Vertex grid cooridinates
-	const auto Vy = Index / 33;
-	const auto Vx = Index - Vy * 33;
-	// Create the vertex vector
-	const auto Vertex = FVector(
-		(Px + TILE_WIDTH / 32.0 * Vx) * Scale,
-		(Py + 0.015625 * Vy) * Scale,
-		Absolute ? Height * Scale : (Pz + Height * HeightUnit) * Scale
-	);
-	// Create vertex key
-	const auto Key = UE::Geometry::FVector3i(
-		FMath::RoundToInt32(Vertex.X * KEY_FACTOR / Scale),
-		FMath::RoundToInt32(Vertex.Y * KEY_FACTOR / Scale),
-		FMath::RoundToInt32(Vertex.Z * KEY_FACTOR / Scale)
-	);
-	// If the vertex don't exist, add it to the map and the array
-	if (!MeshData.VertexMap.Contains(Key))
-	{
-		// Calculation distortion
-		const auto N = NoDistortion
-			               ? FVector::Zero()
-			               : Noise(Vertex, NoiseParameterX, NoiseParameterY, NoiseParameterZ);
-		// Add to map and array
-		MeshData.VertexMap.Add(Key, MeshData.VertexArray.Num());
-		MeshData.RawVertexArray.Add(Vertex);
-		MeshData.VertexArray.Add(Vertex + N);
-		// Update bounds
-		MeshData.TerrainSize.MinimalX = FMath::Min(MeshData.TerrainSize.MinimalX, Vertex.X);
-		MeshData.TerrainSize.MaximalX = FMath::Max(MeshData.TerrainSize.MaximalX, Vertex.X);
-		MeshData.TerrainSize.MinimalY = FMath::Min(MeshData.TerrainSize.MinimalY, Vertex.Y);
-		MeshData.TerrainSize.MaximalY = FMath::Max(MeshData.TerrainSize.MaximalY, Vertex.Y);
-	}
-	// Add new triangle index
-	MeshData.TriangleArray.Add(MeshData.VertexMap[Key]);
-}
-
-/**
- * Adds a new triangle to the mesh data struct. The vertices are calculated by the specified direction and the
- * local vertex indicies and heights of all threee vertices of the triangle.
- * 
- * @param MeshData The mesh data struct. 
- * @param Tile The tile the triangle is generated for.
- * @param Direction The direction of the part of the tile mesh.
- * @param Index0 The first local vertex index.
- * @param Height0 The height of the first local vertex.
- * @param Index1 The second local vertex index.
- * @param Height1 The height of the second local vertex.
- * @param Index2 The third local vertex index.
- * @param Height2 The height of the third local vertex.
- */
-void ATerrainActor::AddTriangle(FMeshData& MeshData, const FTile& Tile, const ETileDirection Direction,
-                                const int32 Index0, const double Height0, const int32 Index1, const double Height1,
-                                const int32 Index2, const double Height2) const
-{
-	// Add the three vertices of the triangle
-	AddVertex(MeshData, Tile, EdgeVertices[Direction][Index0], Height0);
-	AddVertex(MeshData, Tile, EdgeVertices[Direction][Index1], Height1);
-	AddVertex(MeshData, Tile, EdgeVertices[Direction][Index2], Height2);
-}
-
-/**
- * Returns an array with three items that are the heights (Z coordinates) of the neighbour tiles.
- * Index 0 : The height of the neighbour of the left side of the specified direction.
- * Index 1 : The height of the neighbour of the specified direction.
- * Index 2 : The height of the neighbour of the right side of the specified direction.
- * 
- * @param Tile The tile for which the neighbour heights are determined. 
- * @param Direction The direction in which the neighbours are.
- * 
- * @return Array with three integer values for the heights of the neighbour tiles. 
+ * Replaces the heights of the current build and rebuilds the chunks affected by the specified tiles.
+ *
+ * @param HeightGrid The new height grid, it must have the size of the current one.
+ * @param ChangedTiles The coordinates of the tiles whose height differs from the current build.
  */
-TArray<int32> ATerrainActor::GetNeighbourHeights(const FTile& Tile, const ETileDirection Direction) const
+void ATerrainActor::UpdateHeights(FHexHeightGrid HeightGrid, const TArray<FIntPoint>& ChangedTiles)
 {
-	// Get direction of left and right neighbour
-	const auto LeftDirection = static_cast<ETileDirection>(Direction > TopRight ? Direction - 1 : TopLeft);
-	const auto RightDirection = static_cast<ETileDirection>(Direction < TopLeft ? Direction + 1 : TopRight);
+	const auto StartTime = FPlatformTime::Seconds();
+#if WITH_EDITOR
+	// A running preview would overwrite the updated chunks with the old heights, it is started again afterwards
+	CancelPreview();
+#endif
+	// Replace the builder, the settings of the current build are kept
+	Builder = MakeShared<FHexTerrainBuilder>(Builder->GetSettings(), MoveTemp(HeightGrid));
+	// Publish the changed chunks for readers on other threads
+	TileSnapshots.Publish(Builder->GetHeightGrid(), ChangedTiles);
+	// Notify the subscribers with the next tick
+	TileChanges.AddChanges(ChangedTiles, true);
+	// Rebuild the chunks affected by the changed tiles with the material of the current build
+	const auto Chunks = Builder->GetAffectedChunks(ChangedTiles);
+	if (!IsValid(TerrainMaterialInstance))
+	{
+		TerrainMaterialInstance = CreateTerrainMaterial();
+	}
+	RebuildChunks(Chunks, TerrainMaterialInstance);
+	// Update the instances of the changed tiles
+	UpdateTileInstances(ChangedTiles);
+
+	// Log
+	UE_LOG(TerrainActor, Display, TEXT("Terrain updated (%.1f ms, Changed Tiles: %d, Rebuilt Chunks: %d of %d)."),
+	       (FPlatformTime::Seconds() - StartTime) * 1000.0, ChangedTiles.Num(), Chunks.Num(),
+	       Builder->GetChunkCount());
+}
 
-	// Create result array
-	auto Heights = TArray<int32>();
+/**
+ * Opens the tile page file and creates the builder reading from it. No chunk is generated until the camera
+ * updates the streaming.
+ *
+ * @return <b>true</b>, if the tile page file could be opened.
+ */
+bool ATerrainActor::PrepareStreaming()
+{
+	// Open the tile page file
+	const auto Filename = FPaths::ConvertRelativePathToFull(FPaths::ProjectDir(), TilePageFile.FilePath);
+	const auto NewPageStore = MakeShared<FHexTilePageStore>(Filename, TilePageBudget * 1024ll * 1024ll);
+	if (!NewPageStore->IsValid())
+	{
+		UE_LOG(TerrainActor, Warning, TEXT("Streaming disabled, the tile page file %s could not be opened."),
+		       *Filename);
+		return false;
+	}
 
-	// Store left neighbour height
-	const auto LeftTile = GetNeighbour(Tile, LeftDirection);
-	Heights.Add(LeftTile != nullptr ? LeftTile->Position.Z : Tile.Position.Z);
-	// Store center neighbour height
-	const auto CenterTile = GetNeighbour(Tile, Direction);
-	Heights.Add(CenterTile != nullptr ? CenterTile->Position.Z : Tile.Position.Z);
-	// Store right neighbour height
-	const auto RightTile = GetNeighbour(Tile, RightDirection);
-	Heights.Add(RightTile != nullptr ? RightTile->Position.Z : Tile.Position.Z);
+	// Remove a previous build, the streamed chunks use their own mesh sections
+	Clear();
+	PageStore = NewPageStore;
+	StreamingSlots.Empty();
+	StreamedChunks.Empty();
+	StreamedBytes = 0;
+	SizeX = PageStore->GetSizeX();
+	SizeY = PageStore->GetSizeY();
+	// The tile data texture of a map of this size would not fit into memory either
+	TileDataTexture = nullptr;
+	EditJournal.Reset();
+	// Create the builder reading from the tile page store
+	Builder = MakeShared<FHexTerrainBuilder>(CreateBuilderSettings(), PageStore);
+	TerrainSize = Builder->GetTerrainSize();
+	// The dirty chunks of the attributes match the streamed chunks
+	TileAttributes.Init(SizeX, SizeY, Builder->GetChunkSize());
+	StreamingTerrainMaterial = CreateTerrainMaterial();
 
-	// Return the result array
-	return Heights;
+	// Log
+	UE_LOG(TerrainActor, Display, TEXT("Streaming prepared (%d x %d chunks, Radius: %d, Mesh Budget: %d MB)."),
+	       Builder->GetChunkCountX(), Builder->GetChunkCountY(), StreamingRadius, MeshSectionBudget);
+	return true;
 }
 
 /**
- * Returns a pointer to the neighbour tile in the specified direction for the specified tile. If there is no tile
- * in that direction, a <i>nullptr</i> is returned.
- * 
- * @param Tile The tile for which the neighbour is determined.
- * @param Direction The direction of the neighbour tile.
- * 
- * @return A pointer to the neighbour tile or <i>nullptr</i>. 
- */
-const FTile* ATerrainActor::GetNeighbour(const FTile& Tile, const ETileDirection Direction) const
-{
-	// Get coordinates of the tile
-	const auto X = Tile.Position.X;
-	const auto Y = Tile.Position.Y;
-
-	// Return the neighbour for the specified direction
-	switch (Direction)
-	{
-	case TopRight:
-		// Return top right neighbour
-		return GetTile((Y & 1) == 0 ? X : X + 1, Y + 1);
-	case Right:
-		// Return right neighbour
-		return GetTile(X + 1, Y);
-	case BottomRight:
-		// Return bottom right neighbour
-		return GetTile((Y & 1) == 0 ? X : X + 1, Y - 1);
-	case BottomLeft:
-		// Return bottom left neighbour
-		return GetTile((Y & 1) == 0 ? X - 1 : X, Y - 1);
-	case Left:
-		// Return right neighbour
-		return GetTile(X - 1, Y);
-	case TopLeft:
-		// Return bottom left neighbour
-		return GetTile((Y & 1) == 0 ? X - 1 : X, Y + 1);
-	default:
-		// Invalid direction
-		return nullptr;
+ * Generates the specified chunks and puts them into free or evicted slots. The chunks beyond the seam of a
+ * wrapping terrain are generated from the other side and shifted by the wrap width.
+ *
+ * @param Chunks The coordinates of the chunks in the streaming ring.
+ * @param Now The current time.
+ */
+void ATerrainActor::StreamChunks(const TArray<FIntPoint>& Chunks, const double Now)
+{
+	const auto StartTime = FPlatformTime::Seconds();
+	const auto ChunkCountX = Builder->GetChunkCountX();
+	// The chunks beyond the seam are the chunks of the other side
+	auto Wraps = TArray<int32>();
+	auto NativeChunks = TArray<int32>();
+	for (const auto& Chunk : Chunks)
+	{
+		const auto Wrap = FMath::FloorToInt32(static_cast<double>(Chunk.X) / ChunkCountX);
+		Wraps.Add(Wrap);
+		NativeChunks.Add(Chunk.X - Wrap * ChunkCountX + Chunk.Y * ChunkCountX);
+	}
+
+	// Load the pages of the chunks and their borders, the border of a wrapping terrain continues on the other side
+	auto Rects = TArray<FIntRect>();
+	for (const auto Chunk : NativeChunks)
+	{
+		auto Rect = Builder->GetChunkRect(Chunk);
+		Rect.InflateRect(STREAMING_TILE_MARGIN);
+		Rects.Add(Rect);
+		if (Builder->GetSettings().bWrapX && Rect.Min.X < 0)
+		{
+			Rects.Add(Rect + FIntPoint(SizeX, 0));
+		}
+		if (Builder->GetSettings().bWrapX && Rect.Max.X > SizeX)
+		{
+			Rects.Add(Rect - FIntPoint(SizeX, 0));
+		}
+	}
+	const auto LoadedPages = PageStore->Prefetch(Rects);
+
+	// Generate the chunks in parallel and put them into slots
+	auto Generated = Builder->GenerateChunks(NativeChunks);
+	for (auto I = 0; I < Generated.Num(); I++)
+	{
+		auto& ChunkData = Generated[I];
+		// Shift the copies beyond the seam by the wrap width, the collision moves with them
+		if (Wraps[I] != 0)
+		{
+			const auto Offset = FVector(Wraps[I] * TerrainSize.WrapWidth, 0.0, 0.0);
+			for (auto& Section : ChunkData.Sections)
+			{
+				for (auto& Vertex : Section.Vertices)
+				{
+					Vertex += Offset;
+				}
+			}
+		}
+		// Reuse a free slot or add a new one
+		auto Slot = StreamingSlots.IndexOfByPredicate([](const FTerrainStreamingSlot& StreamingSlot)
+		{
+			return StreamingSlot.Chunk == INDEX_NONE;
+		});
+		if (Slot == INDEX_NONE)
+		{
+			Slot = StreamingSlots.AddDefaulted();
+		}
+		auto& StreamingSlot = StreamingSlots[Slot];
+		StreamingSlot.Chunk = ChunkData.Chunk;
+		StreamingSlot.Coordinates = Chunks[I];
+		StreamingSlot.LastUsed = Now;
+		StreamingSlot.Bytes = 0;
+		for (auto Type = 0; Type < SectionTypeCount; Type++)
+		{
+			const auto& Data = ChunkData.Sections[Type];
+			BuildSection(GetSectionIndex(Slot, static_cast<ETerrainSectionType>(Type)), Data,
+			             StreamingTerrainMaterial);
+			StreamingSlot.Bytes += Data.Vertices.Num() * (sizeof(FVector) * 2 + sizeof(FVector2D))
+				+ Data.Triangles.Num() * sizeof(int32);
+		}
+		StreamedBytes += StreamingSlot.Bytes;
+		StreamedChunks.Add(Chunks[I], Slot);
 	}
+
+	// Log
+	UE_LOG(TerrainActor, Display,
+	       TEXT("Chunks streamed (%.1f ms, Chunks: %d, Loaded Pages: %d, Meshes: %.1f MB, Pages: %.1f MB)."),
+	       (FPlatformTime::Seconds() - StartTime) * 1000.0, Chunks.Num(), LoadedPages,
+	       StreamedBytes / (1024.0 * 1024.0), PageStore->GetResidentBytes() / (1024.0 * 1024.0));
 }
 
 /**
- * Returns a pointer to the tile at the specified coordinates. If the coordinates are invalid, a <i>nullptr</i> is
- * returned.
- * 
- * @param X The X coordinate of the tile. 
- * @param Y The Y coordinate of the tile.
- * 
- * @return A pointer to the tile or a <i>nullptr</i>. 
+ * Removes the chunk of the specified slot and frees the slot.
+ *
+ * @param Slot The index of the slot.
  */
-const FTile* ATerrainActor::GetTile(const int32 X, const int32 Y) const
+void ATerrainActor::EvictStreamingSlot(const int32 Slot)
 {
-	// Check validity of the specified coordinates
-	if (X >= 0 && X < SizeX && Y >= 0 && Y < SizeY)
+	auto& StreamingSlot = StreamingSlots[Slot];
+	for (auto Type = 0; Type < SectionTypeCount; Type++)
 	{
-		// Return a pointer to the tile
-		return &Tiles[X + Y * SizeX];
+		MeshComponent->ClearMeshSection(GetSectionIndex(Slot, static_cast<ETerrainSectionType>(Type)));
 	}
-
-	// Invalid coordinates, return null pointer
-	return nullptr;
+	StreamedChunks.Remove(StreamingSlot.Coordinates);
+	StreamedBytes -= StreamingSlot.Bytes;
+	StreamingSlot = FTerrainStreamingSlot();
 }
 
 /**
- * Checks if there is water in the specified direction for the specified tile.
- * 
- * @param Tile The tile to be checked for having a coast.
- * @param Direction The direction that is checked.
- * 
- * @return If there is water in the specified direction then <b>true</b>, otherwise <b>false</b>. 
+ * Marks the tile instances as outdated after the heights were replaced. In instanced mode they are updated
+ * immediately.
  */
-bool ATerrainActor::HasCoast(const FTile& Tile, const ETileDirection Direction) const
+void ATerrainActor::InvalidateTileInstances()
 {
-	// Get the neighbour tile
-	const auto Neighbour = GetNeighbour(Tile, Direction);
-	// Check, if the neighbour is water
-	return Neighbour != nullptr ? Neighbour->Position.Z <= 0 : false;
+	bInstancesOutdated = true;
+	if (bInstancedMode)
+	{
+		UpdateTileInstances();
+	}
 }
 
 /**
- * Checks if there is water in any direction of the specified tile.
- * 
- * @param Tile The tile to be checked for having a coast.
- * 
- * @return If there is water in at least one direction then <b>true</b>, otherwise <b>false</b>. 
+ * Updates all tile instances. Instances are only added or removed if the number of tiles changed.
  */
-bool ATerrainActor::HasCoast(const FTile& Tile) const
+void ATerrainActor::UpdateTileInstances()
 {
-	// Iterate over all directions
-	for (const auto Direction : TEnumRange<ETileDirection>())
+	const auto StartTime = FPlatformTime::Seconds();
+	const auto& HeightGrid = Builder->GetHeightGrid();
+	const auto TileCount = HeightGrid.Num();
+
+	// Adjust the number of instances, the instance index is the tile index
+	const auto InstanceCount = TileInstanceComponent->GetInstanceCount();
+	if (InstanceCount > TileCount)
 	{
-		// Check for coast
-		if (HasCoast(Tile, Direction))
+		auto RemovedInstances = TArray<int32>();
+		for (auto Index = InstanceCount - 1; Index >= TileCount; Index--)
 		{
-			// At least one coast was found, thats enough
-			return true;
+			RemovedInstances.Add(Index);
 		}
+		TileInstanceComponent->RemoveInstances(RemovedInstances);
+	}
+	else if (InstanceCount < TileCount)
+	{
+		auto AddedInstances = TArray<FTransform>();
+		AddedInstances.Init(FTransform::Identity, TileCount - InstanceCount);
+		TileInstanceComponent->AddInstances(AddedInstances, false);
+	}
+
+	// The bottom of all instances is aligned one height step below the lowest tile
+	const auto MinimalZ = HeightGrid.GetMinimalHeight();
+	const auto& Settings = Builder->GetSettings();
+	InstanceBaseZ = (MinimalZ - 1) * Settings.HeightUnit * 4.0 * Settings.Scale;
+
+	// Update the transforms and the custom data of all instances
+	auto Transforms = TArray<FTransform>();
+	Transforms.SetNum(TileCount);
+	float CustomData[TILE_INSTANCE_CUSTOM_DATA];
+	for (auto Index = 0; Index < TileCount; Index++)
+	{
+		CalculateTileInstance(Index % HeightGrid.GetSizeX(), Index / HeightGrid.GetSizeX(), Transforms[Index],
+		                      CustomData);
+		TileInstanceComponent->SetCustomData(Index, CustomData, false);
+	}
+	if (TileCount > 0)
+	{
+		TileInstanceComponent->BatchUpdateInstancesTransforms(0, Transforms, false, true);
 	}
-	// No coast found
-	return false;
+	bInstancesOutdated = false;
+
+	// Log
+	UE_LOG(TerrainActor, Display, TEXT("Tile instances updated (%.1f ms, Instances: %d, Previous: %d)."),
+	       (FPlatformTime::Seconds() - StartTime) * 1000.0, TileCount, InstanceCount);
 }
 
 /**
- * Calculate the heights of the vertices for the left or right inner corner of the tile mesh. An array with four
- * items containing the heights of the four vertices is returned.
- * 
- * @param Tile The tile the heights are calculated for.
- * @param CenterZ The height of the neighbour in the specified direction.
- * @param SideZ The height of the neighbour of the specified side of the specified direction.
- * 
- * @return Array with four double values. 
+ * Updates the instances of the specified tiles. Outside of the instanced mode the instances are only marked as
+ * outdated.
+ *
+ * @param Tiles The coordinates of the changed tiles.
  */
-TArray<double> ATerrainActor::CalculateInnerCornerHeights(const FTile& Tile, const int32 CenterZ, const int32 SideZ)
+void ATerrainActor::UpdateTileInstances(const TArray<FIntPoint>& Tiles)
 {
-	if (Tile.Position.Z < CenterZ)
+	if (!bInstancedMode || bInstancesOutdated)
 	{
-		// Tile is lower as the center neighbour
-		return {1.0, 2.0, 1.5, 2.0};
+		InvalidateTileInstances();
+		return;
 	}
-	if (Tile.Position.Z == CenterZ && Tile.Position.Z < SideZ)
-	{
-		// Tile is on the same height as the center neighbour but lower as the side neighbour
-		return {1.0, 1.0, 1.5, 2.0};
-	}
-	if (Tile.Position.Z == CenterZ && Tile.Position.Z > SideZ)
+
+	// A tile at or below the aligned bottom changes all instances
+	const auto& HeightGrid = Builder->GetHeightGrid();
+	const auto& Settings = Builder->GetSettings();
+	for (const auto& Tile : Tiles)
 	{
-		// Tile is on the same height as the center neighbour and higher as the side neighbour
-		return {1.0, 1.0, 0.5, 0.0};
+		if (HeightGrid.GetHeight(Tile.X, Tile.Y) * Settings.HeightUnit * 4.0 * Settings.Scale <= InstanceBaseZ)
+		{
+			UpdateTileInstances();
+			return;
+		}
 	}
-	if (Tile.Position.Z > CenterZ)
+
+	// Update only the changed instances
+	auto Transform = FTransform();
+	float CustomData[TILE_INSTANCE_CUSTOM_DATA];
+	for (const auto& Tile : Tiles)
 	{
-		// Tile is higher as the center neighbour
-		return {1.0, 0.0, 0.5, 0.0};
+		const auto Index = Tile.X + Tile.Y * HeightGrid.GetSizeX();
+		CalculateTileInstance(Tile.X, Tile.Y, Transform, CustomData);
+		TileInstanceComponent->UpdateInstanceTransform(Index, Transform, false, false, true);
+		TileInstanceComponent->SetCustomData(Index, CustomData, false);
 	}
-	// Return the default array
-	return {1.0, 1.0, 1.0, 1.0};
+	TileInstanceComponent->MarkRenderStateDirty();
 }
 
 /**
- * Calculate the heights of the vertices for the left or right outer corner of the tile mesh. An array with four
- * items containing the heights of the four vertices is returned.
- * 
- * @param Tile The tile the heights are calculated for.
- * @param CenterZ The height of the neighbour in the specified direction.
- * @param SideZ The height of the neighbour of the specified side of the specified direction.
- * 
- * @return Array with four double values. 
+ * Sets the transform and the custom data of the instance of the specified tile.
+ *
+ * @param X The X coordinate of the tile.
+ * @param Y The Y coordinate of the tile.
+ * @param Transform Receives the transform of the instance.
+ * @param CustomData Receives the custom data of the instance, the height and the coordinates of the tile.
  */
-TArray<double> ATerrainActor::CalculateOuterCornerHeights(const FTile& Tile, const int32 CenterZ, const int32 SideZ)
+void ATerrainActor::CalculateTileInstance(const int32 X, const int32 Y, FTransform& Transform,
+                                          TArrayView<float> CustomData) const
 {
-	// Calculate center and side height difference
-	const auto CenterDiff = (CenterZ - Tile.Position.Z) * 4.0;
-	const auto SideDiff = (SideZ - Tile.Position.Z) * 4.0;
+	// The pivot of the tile mesh is the center of its top face
+	const auto Center = Builder->GetTileCenter(X, Y);
+	// The tile mesh is scaled to the tile size and stretched down to the aligned bottom
+	const auto ScaleXY = Builder->GetSettings().Scale / 100.0;
+	const auto ScaleZ = FMath::Max(Center.Z - InstanceBaseZ, 1.0) / TILE_MESH_DEPTH;
+	Transform = FTransform(FQuat::Identity, Center, FVector(ScaleXY, ScaleXY, ScaleZ));
+	// The material reads the height and the coordinates of the tile
+	CustomData[0] = Builder->GetHeightGrid().GetHeight(X, Y);
+	CustomData[1] = X;
+	CustomData[2] = Y;
+}
 
-	if (Tile.Position.Z < CenterZ && Tile.Position.Z <= SideZ)
+/**
+ * Repeats the render sections of all edge chunks beyond the opposite edge, or removes the repeated sections if the
+ * terrain does not wrap around.
+ */
+void ATerrainActor::UpdateWrapComponents() const
+{
+	// Without a wrapping terrain there is nothing to repeat
+	if (!Builder.IsValid() || !Builder->GetSettings().bWrapX)
 	{
-		// Tile is lower than the center neighbour and lower or equal to the side neighbour.
-		return {2.0, 3.0, 2.5, 3.0};
+		WrapEastComponent->ClearAllMeshSections();
+		WrapWestComponent->ClearAllMeshSections();
+		return;
 	}
-	if (Tile.Position.Z == CenterZ && Tile.Position.Z < SideZ)
+	// Place the wrap components one wrap width beside the terrain
+	const auto WrapWidth = Builder->GetTerrainSize().WrapWidth;
+	WrapEastComponent->SetRelativeLocation(FVector(WrapWidth, 0.0, 0.0));
+	WrapWestComponent->SetRelativeLocation(FVector(-WrapWidth, 0.0, 0.0));
+	// Remove the sections of chunks that do not exist anymore
+	const auto SectionCount = Builder->GetChunkCount() * SectionTypeCount;
+	for (auto Section = SectionCount; Section < WrapEastComponent->GetNumSections(); Section++)
 	{
-		// Tile is on the same height as the center neighbour but lower as the side neighbour
-		return {2.0, 2.0, 2.5, 3.0};
+		WrapEastComponent->ClearMeshSection(Section);
 	}
-	if (Tile.Position.Z > SideZ && CenterZ > SideZ)
+	for (auto Section = SectionCount; Section < WrapWestComponent->GetNumSections(); Section++)
 	{
-		// Tile and center neighbour are both higher than the side neighbour
-		return {SideDiff + 4.0, SideDiff + 4.0, SideDiff + 3.5, SideDiff + 3.0};
+		WrapWestComponent->ClearMeshSection(Section);
 	}
-	if (Tile.Position.Z > CenterZ && CenterZ <= SideZ)
+	// Repeat all chunks, the inner ones are skipped
+	auto Chunks = TArray<int32>();
+	Chunks.Reserve(Builder->GetChunkCount());
+	for (auto Chunk = 0; Chunk < Builder->GetChunkCount(); Chunk++)
 	{
-		// Tile is higher than the center neighbour and center neighbour is lower or equal to the side neighbour
-		return {CenterDiff + 4.0, CenterDiff + 3.0, CenterDiff + 3.5, CenterDiff + 3.0};
+		Chunks.Add(Chunk);
 	}
-	// Return the default array
-	return {1.0, 1.0, 1.0, 1.0};
+	UpdateWrapComponents(Chunks);
 }
 
 /**
- * Calculates the array of the UV coordinates for the specified mesh data.
- * 
- * @param MeshData The mesh data struct.
- * 
- * @return Array of 2D vectors. 
+ * Repeats the render sections of the specified chunks beyond the opposite edge, if they are edge chunks. The
+ * sections are copied from the terrain mesh, they are not generated again.
+ *
+ * @param Chunks The indices of the chunks.
  */
-TArray<FVector2D> ATerrainActor::CalculateUVArray(const FMeshData& MeshData)
+void ATerrainActor::UpdateWrapComponents(const TArray<int32>& Chunks) const
 {
-	// Create the UV array
-	auto UVs = TArray<FVector2D>();
-
-	// Get width and length of the entire mesh
-	const auto DiffX = MeshData.TerrainSize.MaximalX - MeshData.TerrainSize.MinimalX;
-	const auto DiffY = MeshData.TerrainSize.MaximalY - MeshData.TerrainSize.MinimalY;
-
-	// Iterate over all vertices
-	for (const auto Vertex : MeshData.RawVertexArray)
+	if (!Builder.IsValid() || !Builder->GetSettings().bWrapX)
 	{
-		// Calculate the UV coordinates and add the vector to the array
-		const auto U = Vertex.X / DiffX;
-		const auto V = Vertex.Y / DiffY;
-		UVs.Add(FVector2D(U, V));
+		return;
+	}
+	// The number of tile columns repeated at each edge
+	const auto GridSizeX = Builder->GetHeightGrid().GetSizeX();
+	const auto Columns = FMath::Min(WrapChunkColumns * Builder->GetChunkSize(), GridSizeX);
+	auto CopiedSections = 0;
+	for (const auto Chunk : Chunks)
+	{
+		// The west edge is repeated in the east and the east edge in the west
+		const auto Rect = Builder->GetChunkRect(Chunk);
+		const auto bWestEdge = Rect.Min.X < Columns;
+		const auto bEastEdge = Rect.Max.X > GridSizeX - Columns;
+		// Only the render sections are repeated, the collision ends at the terrain
+		for (const auto Type : {TerrainSection, WaterSection})
+		{
+			const auto Section = GetSectionIndex(Chunk, Type);
+			CopyWrapSection(WrapEastComponent, Section, bWestEdge);
+			CopyWrapSection(WrapWestComponent, Section, bEastEdge);
+			CopiedSections += bWestEdge + bEastEdge;
+		}
 	}
 
-	//Log
-	UE_LOG(TerrainActor, Display, TEXT("UV coordinates calculates (%f x %f)"), DiffX, DiffY);
-
-	// Return the array
-	return UVs;
+	// Log
+	UE_LOG(TerrainActor, Display, TEXT("Wrap sections updated (Chunks: %d, Copied Sections: %d)."), Chunks.Num(),
+	       CopiedSections);
 }
 
 /**
- * Calculates the array of the normal vectors for the specified mesh data.
- * 
- * @param MeshData The mesh data struct.
- * 
- * @return Array of vectors. 
+ * Copies a mesh section of the terrain mesh into the specified wrap component, or clears the section there.
+ *
+ * @param WrapComponent The wrap component.
+ * @param Section The index of the mesh section.
+ * @param bCopy If <b>true</b>, the section is copied, otherwise it is cleared.
  */
-TArray<FVector> ATerrainActor::CalculateNormalArray(const FMeshData& MeshData)
+void ATerrainActor::CopyWrapSection(UProceduralMeshComponent* WrapComponent, const int32 Section,
+                                    const bool bCopy) const
 {
-	// Create the array for the normals
-	auto Normals = TArray<FVector>();
-	// Initialize the array with zero vectors
-	for (auto I = 0; I < MeshData.VertexArray.Num(); I++)
+	const auto MeshSection = bCopy ? MeshComponent->GetProcMeshSection(Section) : nullptr;
+	if (MeshSection != nullptr)
 	{
-		Normals.Add(FVector::Zero());
+		// The vertices stay the same, the component is placed one wrap width away
+		WrapComponent->SetProcMeshSection(Section, *MeshSection);
+		WrapComponent->SetMaterial(Section, MeshComponent->GetMaterial(Section));
 	}
-
-	// Get the count of triangles
-	const auto TriangleCount = MeshData.TriangleArray.Num() / 3;
-	// Iterate over every triangle
-	for (auto I = 0; I < TriangleCount; I++)
+	else if (Section < WrapComponent->GetNumSections())
 	{
-		// Get the indices of the vertices of the triangle
-		const auto I0 = MeshData.TriangleArray[I * 3];
-		const auto I1 = MeshData.TriangleArray[I * 3 + 1];
-		const auto I2 = MeshData.TriangleArray[I * 3 + 2];
-		// Get the vertices of the triangle
-		const auto V0 = MeshData.VertexArray[I0];
-		const auto V1 = MeshData.VertexArray[I1];
-		const auto V2 = MeshData.VertexArray[I2];
-		// Calculate the normal vector
-		const auto NV = FVector::CrossProduct(V1 - V0, V2 - V0) * -1.0;
-		// Add the new normal vector to the normal vectors in the array
-		Normals[I0] += NV;
-		Normals[I1] += NV;
-		Normals[I2] += NV;
+		WrapComponent->ClearMeshSection(Section);
 	}
+}
 
-	// Normalize all normal vectors
-	for (auto I = 0; I < Normals.Num(); I++)
-	{
-		Normals[I].Normalize(1.0);
-	}
+/**
+ * Creates a mesh section based on the specified mesh section data.
+ *
+ * @param Section The index of the mesh section.
+ * @param MeshSectionData The mesh section data struct.
+ * @param Material The material to be applied to the mesh.
+ */
+void ATerrainActor::BuildMesh(const int32 Section, const FMeshSectionData& MeshSectionData,
+                              UMaterialInterface* Material) const
+{
+	// Create the mesh
+	MeshComponent->CreateMeshSection(Section, MeshSectionData.Vertices, MeshSectionData.Triangles,
+	                                 MeshSectionData.Normals, MeshSectionData.UVs, TArray<FColor>(),
+	                                 TArray<FProcMeshTangent>(), false);
+	// Apply the material
+	MeshComponent->SetMaterial(Section, Material);
 
-	// Return the array
-	return Normals;
+	// Log
+	UE_LOG(TerrainActor, Display, TEXT("Mesh section %d created (Vertices: %d, Triangles: %d)"), Section,
+	       MeshSectionData.Vertices.Num(), MeshSectionData.Triangles.Num());
 }
 
 /**
- * Calculates a noise value for the specified coordinates and the noise parameter.
- * 
- * @param Px X coordinate. 
- * @param Py Y coordinate.
- * @param Params Noise parameter.
- * 
- * @return The noise value. 
+ * Creates an invisible mesh section with collision enabled based on the specified mesh section data.
+ *
+ * @param Section The index of the mesh section.
+ * @param MeshSectionData The mesh section data struct.
  */
-double ATerrainActor::Noise(const double Px, const double Py, const FNoiseParameter& Params)
+void ATerrainActor::BuildCollisionMesh(const int32 Section, const FMeshSectionData& MeshSectionData) const
 {
-	// Normalize coordinates
-	const auto Nx = Px / Params.Size.X + Params.Offset.X;
-	const auto Ny = Py / Params.Size.Y + Params.Offset.Y;
-
-	// Cumulative noise value
-	auto E = 0.0;
-	// Cumulative frequency value
-	auto F = 0.0;
-	// Iterate over all octaves
-	for (auto Oct = 0; Oct < Params.Octaves; Oct++)
-	{
-		const auto Fv = Params.Frequency * FMath::Pow(2.0, Oct);
-		E += FMath::PerlinNoise2D(FVector2D(Nx * Fv, Ny * Fv));
-		F += 1.0 / Fv;
-	}
-	// Normalize result noise value
-	E = FMath::Pow(E / F, Params.Redistribution);
-	// Apply amplitude and return the noise value
-	return E * Params.Amplitude;
+	// Create the mesh, the collision is cooked asynchronously
+	MeshComponent->CreateMeshSection(Section, MeshSectionData.Vertices, MeshSectionData.Triangles, TArray<FVector>(),
+	                                 TArray<FVector2D>(), TArray<FColor>(), TArray<FProcMeshTangent>(), true);
+	// The section is only used for collision
+	MeshComponent->SetMeshSectionVisible(Section, false);
 }
 
 /**
- * Calculates a noise vector based on the specified vertex and the noise parameter for each axis.
- * 
- * @param Vertex Original vertex.
- * @param ParamsX Noise parameter for X axis.
- * @param ParamsY Noise parameter for Y axis.
- * @param ParamsZ Noise parameter for Z axis.
- * 
- * @return The noise vector. 
+ * Creates a mesh section of the type defined by the section index.
+ *
+ * @param Section The index of the mesh section.
+ * @param MeshSectionData The mesh section data struct.
+ * @param DynamicTerrainMaterial The material to be applied to terrain sections.
  */
-FVector ATerrainActor::Noise(const FVector& Vertex, const FNoiseParameter& ParamsX, const FNoiseParameter& ParamsY,
-                             const FNoiseParameter& ParamsZ)
+void ATerrainActor::BuildSection(const int32 Section, const FMeshSectionData& MeshSectionData,
+                                 UMaterialInterface* DynamicTerrainMaterial) const
 {
-	const auto X = Noise(Vertex.Y, Vertex.Z, ParamsX);
-	const auto Y = Noise(Vertex.X, Vertex.Z, ParamsY);
-	const auto Z = Noise(Vertex.X, Vertex.Y, ParamsZ);
-	return FVector(X, Y, Z);
+	switch (Section % SectionTypeCount)
+	{
+	case TerrainSection:
+		BuildMesh(Section, MeshSectionData, DynamicTerrainMaterial);
+		break;
+	case WaterSection:
+		BuildMesh(Section, MeshSectionData, WaterMaterial);
+		break;
+	default:
+		BuildCollisionMesh(Section, MeshSectionData);
+		break;
+	}
 }
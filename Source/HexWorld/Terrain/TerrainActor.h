@@ -6,18 +6,44 @@
 #pragma once
 
 #include "CoreMinimal.h"
-#include "MeshData.h"
+#include "HeightmapFormat.h"
+#include "HexHeightGrid.h"
+#include "HexMapData.h"
+#include "HexTerrainBuilder.h"
+#include "HexTerrainSettings.h"
+#include "TerrainErosionSettings.h"
+#include "TerrainGeneratorSettings.h"
+#include "HexTileSnapshotStore.h"
+#include "MeshSectionData.h"
 #include "NoiseParameter.h"
 #include "GameFramework/Actor.h"
 #include "ProceduralMeshComponent.h"
+#include "Components/HierarchicalInstancedStaticMeshComponent.h"
+#include "Components/StaticMeshComponent.h"
+#include "Containers/Ticker.h"
+#include "Engine/StreamableManager.h"
+#include "TerrainChangeType.h"
+#include "TerrainEditJournal.h"
+#include "TerrainExportFormat.h"
+#include "TerrainSectionType.h"
 #include "TerrainSize.h"
-#include "Tile.h"
-#include "TileDirection.h"
+#include "TerrainStreamingSlot.h"
+#include "TileAttributeStore.h"
+#include "TileChangeBatch.h"
+#include "TileChangeHub.h"
+#include "TileDataBuffer.h"
+#include "TileDataChannel.h"
 #include "TerrainActor.generated.h"
 
 // Defines the log category of this class.
 DECLARE_LOG_CATEGORY_EXTERN(TerrainActor, Log, All);
 
+// The event receiving the tile changes of a frame
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnTilesChanged, const FTileChangeBatch&, Changes);
+
+// The event notifying that a deferred build has completed
+DECLARE_MULTICAST_DELEGATE(FOnTerrainBuilt);
+
 UCLASS()
 class HEXWORLD_API ATerrainActor : public AActor
 {
@@ -30,6 +56,12 @@ public:
 	ATerrainActor();
 
 protected:
+	/**
+	 * Called after the components were initialized. Starts the async load of the map data, so it overlaps the rest
+	 * of the level load.
+	 */
+	virtual void PostInitializeComponents() override;
+
 	/**
 	 * Called when the game starts or when spawned.
 	 */
@@ -41,6 +73,38 @@ public:
 	 */
 	virtual void Tick(const float DeltaTime) override;
 
+	/**
+	 * Returns <b>true</b>, so the actor ticks in the editor too. The tile data changes and the tile change batches of
+	 * the editor are flushed every frame like in a game.
+	 *
+	 * @return The editor tick flag.
+	 */
+	virtual bool ShouldTickIfViewportsOnly() const override;
+
+#if WITH_EDITOR
+	/**
+	 * Called when a property was changed in the editor. The change is classified and a preview rebuild is scheduled.
+	 *
+	 * @param PropertyChangedEvent The event describing the changed property.
+	 */
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+
+	/**
+	 * Called after the actor was loaded. Subscribes to the reimport of the topography texture.
+	 */
+	virtual void PostLoad() override;
+
+	/**
+	 * Called after the actor was created. Subscribes to the reimport of the topography texture.
+	 */
+	virtual void PostActorCreated() override;
+
+	/**
+	 * Called before the actor is destroyed. Unsubscribes from the reimport of the topography texture.
+	 */
+	virtual void BeginDestroy() override;
+#endif
+
 protected:
 	/**
 	 * The procedural mesh component containing the terrain and water. This component will be the root component of the
@@ -49,6 +113,27 @@ protected:
 	UPROPERTY(VisibleAnywhere, Category = "Terrain")
 	UProceduralMeshComponent* MeshComponent;
 
+	/**
+	 * The instanced static mesh component rendering every tile as an instance of the tile mesh. It replaces the
+	 * procedural mesh when the camera is zoomed out far enough.
+	 */
+	UPROPERTY(VisibleAnywhere, Category = "Terrain")
+	UHierarchicalInstancedStaticMeshComponent* TileInstanceComponent;
+
+	/**
+	 * The procedural mesh component repeating the chunks of the west edge one wrap width east of the terrain, if the
+	 * terrain wraps around.
+	 */
+	UPROPERTY(VisibleAnywhere, Category = "Terrain")
+	UProceduralMeshComponent* WrapEastComponent;
+
+	/**
+	 * The procedural mesh component repeating the chunks of the east edge one wrap width west of the terrain, if the
+	 * terrain wraps around.
+	 */
+	UPROPERTY(VisibleAnywhere, Category = "Terrain")
+	UProceduralMeshComponent* WrapWestComponent;
+
 	/**
 	 * The height that defines the sea level.
 	 */
@@ -73,6 +158,46 @@ protected:
 	UPROPERTY(EditAnywhere, Category = "Terrain Properties|Topography Map")
 	UTexture2D* Topography;
 
+	/**
+	 * The map data asset containing the heights of the tiles. If it is set, it replaces the heightmap file and the
+	 * topography texture. It is loaded asynchronously before the terrain is built at runtime.
+	 */
+	UPROPERTY(EditAnywhere, Category = "Terrain Properties|Topography Map")
+	TSoftObjectPtr<UHexMapData> MapData;
+
+	/**
+	 * A raw or PNG heightmap file, relative to the project directory. If it is set, it replaces the topography
+	 * texture and is read without creating any texture.
+	 */
+	UPROPERTY(EditAnywhere, Category = "Terrain Properties|Topography Map",
+		meta = (FilePathFilter = "Heightmap files (*.png;*.r8;*.r16;*.raw)|*.png;*.r8;*.r16;*.raw", RelativeToGameDir))
+	FFilePath HeightmapFile;
+
+	/**
+	 * The format of the heightmap file.
+	 */
+	UPROPERTY(EditAnywhere, Category = "Terrain Properties|Topography Map")
+	TEnumAsByte<EHeightmapFormat> HeightmapFormat;
+
+	/**
+	 * The width of a raw heightmap file counted in pixels. If it is zero, the heightmap is assumed to be square.
+	 */
+	UPROPERTY(EditAnywhere, Category = "Terrain Properties|Topography Map", meta = (ClampMin = 0))
+	int32 HeightmapWidth;
+
+	/**
+	 * The parameters of the procedural generation, which creates the heights if neither map data, a heightmap file
+	 * nor a topography texture is set.
+	 */
+	UPROPERTY(EditAnywhere, Category = "Terrain Properties|Generation")
+	FTerrainGeneratorSettings Generator;
+
+	/**
+	 * The parameters of the erosion, which weathers the heights of every source before the terrain is built.
+	 */
+	UPROPERTY(EditAnywhere, Category = "Terrain Properties|Erosion")
+	FTerrainErosionSettings Erosion;
+
 	/**
 	 * The factor used to calculate the height of a tile from the red color value of a topograohy texture pixel.
 	 * Z = Red / HeightFactor.
@@ -105,6 +230,19 @@ protected:
 	UPROPERTY(EditAnywhere, Category = "Terrain Properties|Mesh")
 	double Scale;
 
+	/**
+	 * The width and length of a chunk counted in tiles. Every chunk of the terrain gets its own mesh sections.
+	 */
+	UPROPERTY(EditAnywhere, Category = "Terrain Properties|Mesh", meta = (ClampMin = 1))
+	int32 ChunkSize;
+
+	/**
+	 * The maximal memory in megabytes used for generating a chunk. The chunk size is reduced if a chunk would exceed
+	 * this budget, so the peak memory of a build does not depend on the size of the map. Zero means no limit.
+	 */
+	UPROPERTY(EditAnywhere, Category = "Terrain Properties|Mesh", meta = (ClampMin = 0))
+	int32 MeshMemoryBudget;
+
 	/**
 	 * Noise parameter for the X axis.
 	 */
@@ -123,6 +261,186 @@ protected:
 	UPROPERTY(EditAnywhere, Category = "Terrain Properties|Distortion")
 	FNoiseParameter NoiseParameterZ;
 
+	/**
+	 * If <b>true</b>, the distortion noise is sampled on a coarse lattice and interpolated for every vertex instead of
+	 * being calculated for every vertex.
+	 */
+	UPROPERTY(EditAnywhere, Category = "Terrain Properties|Distortion")
+	bool bUseNoiseLattice;
+
+	/**
+	 * The maximal error allowed when interpolating the distortion noise from the lattice. The lattice is refined
+	 * until the error is below this value.
+	 */
+	UPROPERTY(EditAnywhere, Category = "Terrain Properties|Distortion", meta = (EditCondition = "bUseNoiseLattice"))
+	double NoiseLatticeMaxError;
+
+	/**
+	 * If <b>true</b>, the generated mesh sections are stored in a cache file in the saved directory and loaded from
+	 * there as long as the build inputs do not change.
+	 */
+	UPROPERTY(EditAnywhere, Category = "Terrain Properties|Cache")
+	bool bUseMeshCache;
+
+	/**
+	 * If <b>true</b>, the tiles are rendered as instances of the tile mesh instead of the detailed terrain mesh as
+	 * soon as the camera is zoomed out beyond the instanced zoom length.
+	 */
+	UPROPERTY(EditAnywhere, Category = "Terrain Properties|Instancing")
+	bool bEnableInstancedMode;
+
+	/**
+	 * The hexagonal prism every tile is rendered with in instanced mode. Its pivot is the center of the top face, the
+	 * corners are 50 units away from the pivot with one corner pointing along the Y axis and the prism is 100 units
+	 * deep. The material gets the height and the coordinates of the tile as per instance custom data 0 to 2.
+	 */
+	UPROPERTY(EditAnywhere, Category = "Terrain Properties|Instancing", meta = (EditCondition = "bEnableInstancedMode"))
+	UStaticMesh* TileMesh;
+
+	/**
+	 * The material applied to the tile mesh. If not set, the material of the mesh is used.
+	 */
+	UPROPERTY(EditAnywhere, Category = "Terrain Properties|Instancing", meta = (EditCondition = "bEnableInstancedMode"))
+	UMaterialInterface* TileMaterial;
+
+	/**
+	 * The camera zoom length from which on the tiles are rendered in instanced mode.
+	 */
+	UPROPERTY(EditAnywhere, Category = "Terrain Properties|Instancing", meta = (EditCondition = "bEnableInstancedMode"))
+	double InstancedZoomLength;
+
+	/**
+	 * If <b>true</b>, the heights are read from the tile page file at runtime and only the chunks around the camera
+	 * are generated. This allows maps that are too large to be kept in memory.
+	 */
+	UPROPERTY(EditAnywhere, Category = "Terrain Properties|Streaming")
+	bool bEnableStreaming;
+
+	/**
+	 * The tile page file the heights are streamed from, relative to the project directory. It is written from the
+	 * topography with Write Tile Pages.
+	 */
+	UPROPERTY(EditAnywhere, Category = "Terrain Properties|Streaming",
+		meta = (FilePathFilter = "Tile page files (*.hxtp)|*.hxtp", RelativeToGameDir,
+			EditCondition = "bEnableStreaming"))
+	FFilePath TilePageFile;
+
+	/**
+	 * The radius of the ring of chunks around the camera that are kept generated, counted in chunks.
+	 */
+	UPROPERTY(EditAnywhere, Category = "Terrain Properties|Streaming",
+		meta = (ClampMin = 1, EditCondition = "bEnableStreaming"))
+	int32 StreamingRadius;
+
+	/**
+	 * The time in seconds the camera movement is extrapolated for, so the chunks ahead of the camera are generated
+	 * first.
+	 */
+	UPROPERTY(EditAnywhere, Category = "Terrain Properties|Streaming",
+		meta = (ClampMin = 0.0, EditCondition = "bEnableStreaming"))
+	double PrefetchTime;
+
+	/**
+	 * The maximal number of chunks generated per frame.
+	 */
+	UPROPERTY(EditAnywhere, Category = "Terrain Properties|Streaming",
+		meta = (ClampMin = 1, EditCondition = "bEnableStreaming"))
+	int32 StreamingChunksPerFrame;
+
+	/**
+	 * The memory in MB the resident tile pages may use.
+	 */
+	UPROPERTY(EditAnywhere, Category = "Terrain Properties|Streaming",
+		meta = (ClampMin = 1, EditCondition = "bEnableStreaming"))
+	int32 TilePageBudget;
+
+	/**
+	 * The memory in MB the mesh sections of the streamed chunks may use. The least recently used chunks outside of
+	 * the streaming ring are removed beyond it.
+	 */
+	UPROPERTY(EditAnywhere, Category = "Terrain Properties|Streaming",
+		meta = (ClampMin = 1, EditCondition = "bEnableStreaming"))
+	int32 MeshSectionBudget;
+
+	/**
+	 * The compression format of the chunks of a terrain save file, e.g. LZ4, Oodle or None.
+	 */
+	UPROPERTY(EditAnywhere, Category = "Terrain Properties|Persistence")
+	FName SaveCompressionFormat;
+
+	/**
+	 * If <b>true</b>, the terrain wraps around along the X axis, so the camera can travel around the world.
+	 */
+	UPROPERTY(EditAnywhere, Category = "Terrain Properties|Wrapping")
+	bool bWrapX;
+
+	/**
+	 * The number of chunk columns at each edge that are repeated beyond the opposite edge. They have to cover the
+	 * visible area of the camera at the seam.
+	 */
+	UPROPERTY(EditAnywhere, Category = "Terrain Properties|Wrapping", meta = (ClampMin = 1, EditCondition = "bWrapX"))
+	int32 WrapChunkColumns;
+
+#if WITH_EDITORONLY_DATA
+	/**
+	 * The content directory the baked static mesh assets are saved in.
+	 */
+	UPROPERTY(EditAnywhere, Category = "Terrain Properties|Baking", meta = (ContentDir))
+	FDirectoryPath BakedMeshDirectory;
+
+	/**
+	 * If <b>true</b>, the generated meshes are updated in the background whenever a property is changed in the
+	 * editor.
+	 */
+	UPROPERTY(EditAnywhere, Category = "Terrain Properties|Preview")
+	bool bLivePreview;
+
+	/**
+	 * The time in seconds a property has to stay unchanged before the preview is rebuilt, so that dragging a slider
+	 * does not start a rebuild for every step.
+	 */
+	UPROPERTY(EditAnywhere, Category = "Terrain Properties|Preview", meta = (ClampMin = 0.0, EditCondition = "bLivePreview"))
+	float PreviewDelay;
+
+	/**
+	 * The dynamic terrain material of the preview.
+	 */
+	UPROPERTY(Transient)
+	UMaterialInstanceDynamic* PreviewTerrainMaterial;
+#endif
+
+	/**
+	 * The static mesh components rendering the baked terrain chunks. If there are any, the terrain is not generated
+	 * at runtime.
+	 */
+	UPROPERTY(VisibleAnywhere, Category = "Terrain Properties|Baking")
+	TArray<UStaticMeshComponent*> BakedTerrainComponents;
+
+	/**
+	 * The static mesh components rendering the baked water chunks.
+	 */
+	UPROPERTY(VisibleAnywhere, Category = "Terrain Properties|Baking")
+	TArray<UStaticMeshComponent*> BakedWaterComponents;
+
+	/**
+	 * The file the terrain mesh is exported to.
+	 */
+	UPROPERTY(EditAnywhere, Category = "Terrain Properties|Export",
+		meta = (FilePathFilter = "Mesh files (*.obj;*.ply;*.glb;*.gltf)|*.obj;*.ply;*.glb;*.gltf"))
+	FFilePath ExportFilename;
+
+	/**
+	 * The file format the terrain mesh is exported in.
+	 */
+	UPROPERTY(EditAnywhere, Category = "Terrain Properties|Export")
+	TEnumAsByte<ETerrainExportFormat> ExportFormat;
+
+	/**
+	 * If <b>true</b>, the water is exported together with the terrain.
+	 */
+	UPROPERTY(EditAnywhere, Category = "Terrain Properties|Export")
+	bool bExportWater;
+
 public:
 	/**
 	 * Removes all generated meshes.
@@ -136,6 +454,41 @@ public:
 	UFUNCTION(CallInEditor, Category = "Terrain Properties")
 	void Build();
 
+	/**
+	 * Exports the terrain mesh into the export file. The mesh is generated and written chunk by chunk, so the whole
+	 * mesh is never held in memory.
+	 */
+	UFUNCTION(CallInEditor, Category = "Terrain Properties")
+	void Export();
+
+#if WITH_EDITOR
+	/**
+	 * Bakes the terrain and the water into static mesh assets, one per chunk, and replaces the generated meshes by
+	 * static mesh components using these assets.
+	 */
+	UFUNCTION(CallInEditor, Category = "Terrain Properties")
+	void Bake();
+
+	/**
+	 * Removes the static mesh components of the baked terrain. The assets are kept.
+	 */
+	UFUNCTION(CallInEditor, Category = "Terrain Properties")
+	void ClearBaked();
+
+	/**
+	 * Saves the heights of the current build, including the edits, into a map data asset in the baked mesh directory
+	 * and uses it as the source of the heights.
+	 */
+	UFUNCTION(CallInEditor, Category = "Terrain Properties")
+	void SaveMapData();
+
+	/**
+	 * Writes the heights of the current source into the tile page file used for streaming.
+	 */
+	UFUNCTION(CallInEditor, Category = "Terrain Properties")
+	void WriteTilePages();
+#endif
+
 	/**
 	 * Returns a struct containing information about the size of the terrain.
 	 * 
@@ -143,317 +496,680 @@ public:
 	 */
 	virtual FTerrainSize GetBounds() const;
 
+	/**
+	 * Opens an edit transaction. All height changes until the transaction is ended, e.g. the dabs of a brush stroke,
+	 * are rebuilt and undone together.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Terrain Properties|Editing")
+	void BeginTerrainEdit();
+
+	/**
+	 * Closes an edit transaction. When the outermost transaction is closed, the chunks affected by its changes are
+	 * rebuilt.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Terrain Properties|Editing")
+	void EndTerrainEdit();
+
+	/**
+	 * Returns the height of the tile at the specified coordinates relative to the sea level, including the changes of
+	 * an open transaction.
+	 *
+	 * @param X The X coordinate of the tile.
+	 * @param Y The Y coordinate of the tile.
+	 *
+	 * @return The height of the tile, zero for coordinates outside of the terrain.
+	 */
+	UFUNCTION(BlueprintPure, Category = "Terrain Properties|Editing")
+	int32 GetTileHeight(const int32 X, const int32 Y) const;
+
+	/**
+	 * Sets the height of the tile at the specified coordinates relative to the sea level. Outside of a transaction
+	 * the change is a transaction of its own and rebuilt immediately.
+	 *
+	 * @param X The X coordinate of the tile.
+	 * @param Y The Y coordinate of the tile.
+	 * @param Z The new height of the tile.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Terrain Properties|Editing")
+	void SetTileHeight(const int32 X, const int32 Y, const int32 Z);
+
+	/**
+	 * Reverts the last edit transaction and rebuilds the affected chunks.
+	 *
+	 * @return <b>true</b>, if a transaction was undone.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Terrain Properties|Editing")
+	bool UndoTerrainEdit();
+
+	/**
+	 * Applies the last undone edit transaction again and rebuilds the affected chunks.
+	 *
+	 * @return <b>true</b>, if a transaction was redone.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Terrain Properties|Editing")
+	bool RedoTerrainEdit();
+
+	/**
+	 * Saves the heights of all tiles, including the edits, the tile data and the tile attributes with one byte per
+	 * tile into a terrain save file.
+	 *
+	 * @param Filename The name of the save file, relative to the saved directory of the project.
+	 *
+	 * @return <b>true</b>, if the file was written.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Terrain Properties|Persistence")
+	bool SaveTerrainState(const FString& Filename) const;
+
+	/**
+	 * Loads the heights and the tile data of all tiles from a terrain save file and rebuilds the changed chunks. The
+	 * file must have the size of the current terrain.
+	 *
+	 * @param Filename The name of the save file, relative to the saved directory of the project.
+	 *
+	 * @return <b>true</b>, if the file was loaded.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Terrain Properties|Persistence")
+	bool LoadTerrainState(const FString& Filename);
+
+	/**
+	 * Loads the heights and the tile data of the tiles within the specified region from a terrain save file and
+	 * rebuilds the changed chunks. Only the chunks of the file overlapping the region are decompressed.
+	 *
+	 * @param Filename The name of the save file, relative to the saved directory of the project.
+	 * @param Min The minimal tile coordinates of the region.
+	 * @param Max The maximal tile coordinates of the region, exclusive.
+	 *
+	 * @return <b>true</b>, if the region was loaded.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Terrain Properties|Persistence")
+	bool LoadTerrainRegion(const FString& Filename, const FIntPoint& Min, const FIntPoint& Max);
+
+	/**
+	 * Switches between the detailed and the instanced rendering of the tiles depending on the zoom of the camera.
+	 *
+	 * @param ZoomLength The current zoom length of the camera.
+	 */
+	void UpdateRenderMode(const double ZoomLength);
+
+	/**
+	 * Returns <b>true</b>, if the tiles are currently rendered as instances of the tile mesh.
+	 *
+	 * @return The instanced mode flag.
+	 */
+	FORCEINLINE bool IsInstancedMode() const { return bInstancedMode; }
+
+	/**
+	 * Generates the missing chunks within the streaming ring around the camera, the nearest chunks ahead of the
+	 * camera first, and removes the least recently used chunks beyond the mesh section budget.
+	 *
+	 * @param Location The location of the camera.
+	 * @param Velocity The velocity of the camera.
+	 * @param ViewDirection The direction the camera looks at.
+	 */
+	void UpdateStreaming(const FVector& Location, const FVector& Velocity, const FVector& ViewDirection);
+
+	/**
+	 * Returns <b>true</b>, if the chunks are streamed around the camera.
+	 *
+	 * @return The streaming flag.
+	 */
+	FORCEINLINE bool IsStreaming() const { return PageStore.IsValid(); }
+
+	/**
+	 * Returns the value of a channel of the tile data, e.g. the highlight or the owner of the tile.
+	 *
+	 * @param X The X coordinate of the tile.
+	 * @param Y The Y coordinate of the tile.
+	 * @param Channel The data channel.
+	 *
+	 * @return The value, zero for coordinates outside of the terrain.
+	 */
+	UFUNCTION(BlueprintPure, Category = "Terrain Properties|Tile Data")
+	uint8 GetTileData(const int32 X, const int32 Y, const TEnumAsByte<ETileDataChannel> Channel) const;
+
+	/**
+	 * Sets the value of a channel of the tile data. The changes of a frame are uploaded together into the tile data
+	 * texture sampled by the terrain material, the mesh is not rebuilt.
+	 *
+	 * @param X The X coordinate of the tile.
+	 * @param Y The Y coordinate of the tile.
+	 * @param Channel The data channel.
+	 * @param Value The new value.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Terrain Properties|Tile Data")
+	void SetTileData(const int32 X, const int32 Y, const TEnumAsByte<ETileDataChannel> Channel, const uint8 Value);
+
+	/**
+	 * Returns the gameplay attributes of the tiles. The dirty chunks of the store match the chunks of the terrain.
+	 * The attributes with one byte per tile are saved and loaded together with the terrain state.
+	 *
+	 * @return The attribute store.
+	 */
+	FORCEINLINE FTileAttributeStore& GetTileAttributes() { return TileAttributes; }
+
+	/**
+	 * Returns the current version of the tile heights including the edits. The snapshot can be read from any thread
+	 * and does not change while the game thread continues editing.
+	 *
+	 * @return The pinned snapshot.
+	 */
+	FORCEINLINE TSharedRef<const FHexTileSnapshot> PinTileSnapshot() const { return TileSnapshots.Pin(); }
+
+	/**
+	 * Returns the delegate receiving the changed tiles of a frame as one batch.
+	 *
+	 * @return The delegate.
+	 */
+	FORCEINLINE FOnTileChangeBatch& OnTileChanges() { return TileChanges.OnTileChanges(); }
+
+	/**
+	 * Returns the delegate notified when the terrain was built after the map data was loaded. Until then the bounds
+	 * of the terrain are empty.
+	 *
+	 * @return The delegate.
+	 */
+	FORCEINLINE FOnTerrainBuilt& OnTerrainBuilt() { return TerrainBuilt; }
+
+	/**
+	 * The event receiving the changed tiles of a frame as one batch, e.g. for updating a minimap or the UI.
+	 */
+	UPROPERTY(BlueprintAssignable, Category = "Terrain Properties|Tile Changes")
+	FOnTilesChanged OnTilesChanged;
+
 private:
 	// Attributes
 
 	/**
 	 * The width of the terrain counted in tiles. 
 	 */
+	UPROPERTY()
 	int32 SizeX;
 
 	/**
 	 * The length of the terrain counted in tiles. 
 	 */
+	UPROPERTY()
 	int32 SizeY;
 
 	/**
-	 * Array of terrain tiles. The index of the tile defines the position in the map.
-	 * Index = X + Y * SizeX
+	 * Terrain size struct.
 	 */
-	TArray<FTile> Tiles;
+	UPROPERTY()
+	FTerrainSize TerrainSize;
 
 	/**
-	 * Terrain size struct.
+	 * The builder generating the mesh sections of the current build.
 	 */
-	FTerrainSize TerrainSize;
+	TSharedPtr<FHexTerrainBuilder> Builder;
+
+	/**
+	 * The journal of the height changes for undo and redo.
+	 */
+	FTerrainEditJournal EditJournal;
+
+	/**
+	 * The visual state of the tiles that is uploaded into the tile data texture.
+	 */
+	FTileDataBuffer TileData;
+
+	/**
+	 * The gameplay attributes of the tiles.
+	 */
+	FTileAttributeStore TileAttributes;
+
+	/**
+	 * The published versions of the tile heights for readers on other threads.
+	 */
+	FHexTileSnapshotStore TileSnapshots;
+
+	/**
+	 * The collected tile changes of the current frame.
+	 */
+	FTileChangeHub TileChanges;
+
+	/**
+	 * The texture with one pixel per tile containing the tile data. The terrain material samples it as parameter
+	 * "Tile Data".
+	 */
+	UPROPERTY(Transient)
+	UTexture2D* TileDataTexture;
+
+	/**
+	 * The dynamic terrain material of the current build. The rebuilds of edited chunks reuse it.
+	 */
+	UPROPERTY(Transient)
+	UMaterialInstanceDynamic* TerrainMaterialInstance;
+
+	/**
+	 * The handle of the async load of the map data.
+	 */
+	TSharedPtr<FStreamableHandle> MapDataHandle;
+
+	/**
+	 * If <b>true</b>, the game has started while the map data was still loading, so the terrain is built as soon as
+	 * the load completes.
+	 */
+	bool bBuildOnMapDataLoaded;
+
+	/**
+	 * The delegate notified when the terrain was built after the map data was loaded.
+	 */
+	FOnTerrainBuilt TerrainBuilt;
+
+	/**
+	 * The tile page store the heights are streamed from, if streaming is enabled.
+	 */
+	TSharedPtr<FHexTilePageStore> PageStore;
+
+	/**
+	 * The slots of mesh sections holding the streamed chunks.
+	 */
+	TArray<FTerrainStreamingSlot> StreamingSlots;
+
+	/**
+	 * The slot of every streamed chunk, keyed by the coordinates of the chunk in the streaming ring.
+	 */
+	TMap<FIntPoint, int32> StreamedChunks;
+
+	/**
+	 * The estimated memory of the mesh sections of all streamed chunks.
+	 */
+	int64 StreamedBytes;
+
+	/**
+	 * The terrain material of the streamed chunks.
+	 */
+	UPROPERTY(Transient)
+	UMaterialInstanceDynamic* StreamingTerrainMaterial;
+
+	/**
+	 * If <b>true</b>, the tiles are currently rendered as instances of the tile mesh.
+	 */
+	bool bInstancedMode;
+
+	/**
+	 * If <b>true</b>, the tile instances do not match the heights of the current build anymore.
+	 */
+	bool bInstancesOutdated;
+
+	/**
+	 * The height the bottom of all tile instances is aligned to.
+	 */
+	double InstanceBaseZ;
 
 	// Methods
 
 	/**
-	 * Reads the terrain data from the topography texture and initializes the tiles array.
+	 * Reads the heights of the tiles and creates the builder, so that the mesh sections of the chunks can be
+	 * generated.
 	 */
-	void ReadTopography();
+	void PrepareBuild();
 
 	/**
-	 * Creates a mesh based on the specified mesh data.
+	 * Opens the tile page file and creates the builder reading from it. No chunk is generated until the camera
+	 * updates the streaming.
 	 *
-	 * @param Section The index of the mesh section.
-	 * @param MeshData The mesh data struct.
-	 * @param Material The material to be applied to the mesh.
+	 * @return <b>true</b>, if the tile page file could be opened.
 	 */
-	void BuildMesh(const int32 Section, const FMeshData& MeshData, UMaterialInterface* Material) const;
+	bool PrepareStreaming();
 
 	/**
-	 * Generates the mesh data for the water mesh.
-	 * 
-	 * @return Mesh data struct. 
+	 * Generates the specified chunks and puts them into free or evicted slots. The chunks beyond the seam of a
+	 * wrapping terrain are generated from the other side and shifted by the wrap width.
+	 *
+	 * @param Chunks The coordinates of the chunks in the streaming ring.
+	 * @param Now The current time.
 	 */
-	FMeshData GenerateWaterMeshData() const;
+	void StreamChunks(const TArray<FIntPoint>& Chunks, const double Now);
 
 	/**
-	 * Generates the mesh data for the terrain mesh.
-	 * 
-	 * @return Mesh data struct. 
+	 * Removes the chunk of the specified slot and frees the slot.
+	 *
+	 * @param Slot The index of the slot.
 	 */
-	FMeshData GenerateTerrainMeshData() const;
+	void EvictStreamingSlot(const int32 Slot);
 
 	/**
-	 * Generates the mesh data for the center part of the tile mesh.
-	 * 
-	 * @param MeshData The mesh data struct. 
-	 * @param Tile The tile the mesh data is generated for.
+	 * Reads the terrain data from the topography texture.
+	 *
+	 * @return The height grid.
 	 */
-	void GenerateTerrainTileCenter(FMeshData& MeshData, const FTile& Tile) const;
+	FHexHeightGrid ReadTopography() const;
 
 	/**
-	 * Generates the mesh data for the inner edge in the specified direction for the specified tile.
-	 * 
-	 * @param MeshData The mesh data struct. 
-	 * @param Tile The tile the mesh data is generated for.
-	 * @param Direction The direction of the inner edge.
-	 * @param CenterZ The height of the neighbour in the specified direction.
+	 * Reads the terrain data from the heightmap file.
+	 *
+	 * @return The height grid, empty if the file could not be read.
 	 */
-	void GenerateTerrainTileInnerEdge(FMeshData& MeshData, const FTile& Tile, const ETileDirection Direction,
-	                                  const int32 CenterZ) const;
+	FHexHeightGrid ReadHeightmapFile() const;
 
 	/**
-	 * Generates the mesh data for the outer edge in the specified direction for the specified tile.
-	 * 
-	 * @param MeshData The mesh data struct. 
-	 * @param Tile The tile the mesh data is generated for.
-	 * @param Direction The direction of the outer edge.
-	 * @param LeftZ The height of the neighbour of the left side of the specified direction.
-	 * @param CenterZ The height of the neighbour in the specified direction.
-	 * @param RightZ The height of the neighbour of the right side of the specified direction.
+	 * Reads the terrain data from the map data asset. If the asset is not loaded yet, it is loaded synchronously.
+	 *
+	 * @return The height grid, empty if the asset could not be loaded.
 	 */
-	void GenerateTerrainTileOuterEdge(FMeshData& MeshData, const FTile& Tile, const ETileDirection Direction,
-	                                  const int32 LeftZ, const int32 CenterZ, const int32 RightZ) const;
+	FHexHeightGrid ReadMapData() const;
 
 	/**
-	 * Generates the mesh data for the left and right inner corner in the specified direction for the specified tile.
-	 * 
-	 * @param MeshData The mesh data struct. 
-	 * @param Tile The tile the mesh data is generated for.
-	 * @param Direction The direction of the inner corner.
-	 * @param LeftZ The height of the neighbour of the left side of the specified direction.
-	 * @param CenterZ The height of the neighbour in the specified direction.
-	 * @param RightZ The height of the neighbour of the right side of the specified direction.
+	 * Called when the async load of the map data completed. Builds the terrain, if the game has already started.
 	 */
-	void GenerateTerrainTileInnerCorners(FMeshData& MeshData, const FTile& Tile, const ETileDirection Direction,
-	                                     const int32 LeftZ, const int32 CenterZ, const int32 RightZ) const;
+	void OnMapDataLoaded();
 
 	/**
-	 * Generates the mesh data for the left and right outer corner in the specified direction for the specified tile.
-	 * 
-	 * @param MeshData The mesh data struct. 
-	 * @param Tile The tile the mesh data is generated for.
-	 * @param Direction The direction of the outer corner.
-	 * @param LeftZ The height of the neighbour of the left side of the specified direction.
-	 * @param CenterZ The height of the neighbour in the specified direction.
-	 * @param RightZ The height of the neighbour of the right side of the specified direction.
+	 * Returns <b>true</b>, if the map data, the heightmap file or the topography texture is set.
+	 *
+	 * @return The source flag.
 	 */
-	void GenerateTerrainTileOuterCorners(FMeshData& MeshData, const FTile& Tile, const ETileDirection Direction,
-	                                     const int32 LeftZ, const int32 CenterZ, const int32 RightZ) const;
+	bool HasHeightSource() const;
 
 	/**
-	 * Generates the mesh data for the center wall in the specified direction for the specified tile.
-	 * 
-	 * @param MeshData The mesh data struct. 
-	 * @param Tile The tile the mesh data is generated for.
-	 * @param Direction The direction of the center wall.
-	 * @param CenterZ The height of the neighbour in the specified direction.
+	 * Reads the terrain data from the map data if it is set, otherwise from the heightmap file or the topography
+	 * texture. Without any source the grid is empty and the heights have to be generated.
+	 *
+	 * @return The height grid.
 	 */
-	void GenerateTerrainTileCenterWall(FMeshData& MeshData, const FTile& Tile, const ETileDirection Direction,
-	                                   const int32 CenterZ) const;
+	FHexHeightGrid ReadSourceHeights() const;
 
 	/**
-	 * Generates the mesh data for the left or right side wall in the specified direction for the specified tile.
-	 * 
-	 * @param MeshData The mesh data struct. 
-	 * @param Tile The tile the mesh data is generated for.
-	 * @param Direction The direction of the side wall.
-	 * @param CenterZ The height of the neighbour in the specified direction.
-	 * @param SideZ The height of the neighbour of the specified side of the specified direction.
-	 * @param Index0 The index of the upper vertex. 
-	 * @param Index1 The index of the lower vertex.
+	 * Returns <b>true</b>, if the heights of the source were already eroded, e.g. map data saved from an eroded build.
+	 *
+	 * @return The eroded flag.
 	 */
-	void GenerateTerrainTileSideWall(FMeshData& MeshData, const FTile& Tile, const ETileDirection Direction,
-	                                 const int32 CenterZ, const int32 SideZ, const int32 Index0,
-	                                 const int32 Index1) const;
+	bool IsSourceEroded() const;
 
 	/**
-	 * Generates the mesh data for the left side corner wall in the specified direction for the specified tile.
-	 * 
-	 * @param MeshData The mesh data struct. 
-	 * @param Tile The tile the mesh data is generated for.
-	 * @param Direction The direction of the left side corner wall.
-	 * @param CenterZ The height of the neighbour in the specified direction.
-	 * @param LeftZ The height of the neighbour of the left side of the specified direction.
+	 * Generates the heights, if there is no source, and erodes them, if the erosion is enabled. It only uses its
+	 * parameters, so it can run on any thread.
+	 *
+	 * @param HeightGrid The height grid read from the source.
+	 * @param bGenerate If <b>true</b>, the heights are generated.
+	 * @param bErode If <b>false</b>, the heights are already eroded and the erosion is skipped.
+	 * @param bErodeWrapX If <b>true</b>, the terrain wraps around along the X axis and is eroded across the seam.
+	 * @param GeneratorSettings The parameters of the generation.
+	 * @param ErosionSettings The parameters of the erosion.
+	 *
+	 * @return The height grid.
 	 */
-	void GenerateTerrainTileLeftCornerWall(FMeshData& MeshData, const FTile& Tile, const ETileDirection Direction,
-	                                       const int32 CenterZ, const int32 LeftZ) const;
+	static FHexHeightGrid CompleteHeights(FHexHeightGrid HeightGrid, const bool bGenerate, const bool bErode,
+	                                      const bool bErodeWrapX, const FTerrainGeneratorSettings& GeneratorSettings,
+	                                      const FTerrainErosionSettings& ErosionSettings);
 
 	/**
-	 * Generates the mesh data for the right side corner wall in the specified direction for the specified tile.
-	 * 
-	 * @param MeshData The mesh data struct. 
-	 * @param Tile The tile the mesh data is generated for.
-	 * @param Direction The direction of the right side corner wall.
-	 * @param CenterZ The height of the neighbour in the specified direction.
-	 * @param RightZ The height of the neighbour of the right side of the specified direction.
+	 * Reads the heights of the tiles from their source or generates them and erodes them, if the erosion is enabled.
+	 *
+	 * @return The height grid.
 	 */
-	void GenerateTerrainTileRightCornerWall(FMeshData& MeshData, const FTile& Tile, const ETileDirection Direction,
-	                                        const int32 CenterZ, const int32 RightZ) const;
+	FHexHeightGrid ReadHeights() const;
 
 	/**
-	 * Adds a new vertex to the current or a new triangle in the mesh data.
-	 * 
-	 * @param MeshData The mesh data struct. 
-	 * @param Tile The tile the vertex is generated for.
-	 * @param Index The index of the vertex position within a tile.
-	 * @param Height The height of the vertex in height units. If <i>Absolute</i> is <b>true</b>,
-	 *               the height is used as specified and not in height units.
-	 * @param Absolute If <b>true</b>, the height is used as is and is not multiplied with the height unit.
-	 * @param NoDistortion If <b>true</b>, the vertext will be distorted, otherwise not.
+	 * Creates the settings for the builder from the properties of this actor.
+	 *
+	 * @return The settings struct.
 	 */
-	void AddVertex(FMeshData& MeshData, const FTile& Tile, const int32 Index, const double Height,
-	               const bool Absolute = false, const bool NoDistortion = false) const;
+	FHexTerrainSettings CreateBuilderSettings() const;
 
 	/**
-	 * Adds a new triangle to the mesh data struct. The vertices are calculated by the specified direction and the
-	 * local vertex indicies and heights of all threee vertices of the triangle.
-	 * 
-	 * @param MeshData The mesh data struct. 
-	 * @param Tile The tile the triangle is generated for.
-	 * @param Direction The direction of the part of the tile mesh.
-	 * @param Index0 The first local vertex index.
-	 * @param Height0 The height of the first local vertex.
-	 * @param Index1 The second local vertex index.
-	 * @param Height1 The height of the second local vertex.
-	 * @param Index2 The third local vertex index.
-	 * @param Height2 The height of the third local vertex.
-	 */
-	void AddTriangle(FMeshData& MeshData, const FTile& Tile, const ETileDirection Direction, const int32 Index0,
-	                 const double Height0, const int32 Index1, const double Height1, const int32 Index2,
-	                 const double Height2) const;
-
-	/**
-	 * Returns an array with three items that are the heights (Z coordinates) of the neighbour tiles.
-	 * Index 0 : The height of the neighbour of the left side of the specified direction.
-	 * Index 1 : The height of the neighbour of the specified direction.
-	 * Index 2 : The height of the neighbour of the right side of the specified direction.
-	 * 
-	 * @param Tile The tile for which the neighbour heights are determined. 
-	 * @param Direction The direction in which the neighbours are.
-	 * 
-	 * @return Array with three integer values for the heights of the neighbour tiles. 
+	 * Calculates a hash over all inputs of the mesh generation. 
+	 *
+	 * @return The hash value.
 	 */
-	TArray<int32> GetNeighbourHeights(const FTile& Tile, const ETileDirection Direction) const;
+	uint64 CalculateBuildHash() const;
 
 	/**
-	 * Returns a pointer to the neighbour tile in the specified direction for the specified tile. If there is no tile
-	 * in that direction, a <i>nullptr</i> is returned.
-	 * 
-	 * @param Tile The tile for which the neighbour is determined.
-	 * @param Direction The direction of the neighbour tile.
-	 * 
-	 * @return A pointer to the neighbour tile or <i>nullptr</i>. 
+	 * Returns the name of the mesh cache file of this terrain.
+	 *
+	 * @return The file name.
 	 */
-	const FTile* GetNeighbour(const FTile& Tile, const ETileDirection Direction) const;
+	FString GetMeshCacheFilename() const;
 
 	/**
-	 * Returns a pointer to the tile at the specified coordinates. If the coordinates are invalid, a <i>nullptr</i> is
-	 * returned.
-	 * 
-	 * @param X The X coordinate of the tile. 
+	 * Creates the mesh sections from the mesh cache file, if it exists and matches the specified hash.
+	 *
+	 * @param Hash The hash of the build inputs.
+	 * @param DynamicTerrainMaterial The material to be applied to the terrain sections.
+	 *
+	 * @return <b>true</b>, if the mesh sections were loaded from the cache.
+	 */
+	bool LoadMeshCache(const uint64 Hash, UMaterialInterface* DynamicTerrainMaterial) const;
+
+	/**
+	 * Creates the dynamic material for the terrain mesh.
+	 *
+	 * @return The dynamic material instance.
+	 */
+	UMaterialInstanceDynamic* CreateTerrainMaterial() const;
+
+	/**
+	 * Returns the index of the mesh section of the specified type for the specified chunk.
+	 *
+	 * @param Chunk The index of the chunk.
+	 * @param Type The type of the mesh section.
+	 *
+	 * @return The index of the mesh section.
+	 */
+	static int32 GetSectionIndex(const int32 Chunk, const ETerrainSectionType Type);
+
+	/**
+	 * Generates the mesh sections of the specified chunks again and replaces the existing ones. The chunks are
+	 * generated in parallel batches that fit into the memory budget.
+	 *
+	 * @param Chunks The indices of the chunks.
+	 * @param DynamicTerrainMaterial The material to be applied to the terrain sections.
+	 */
+	void RebuildChunks(const TArray<int32>& Chunks, UMaterialInterface* DynamicTerrainMaterial) const;
+
+	/**
+	 * Replaces the heights of the current build and rebuilds the chunks affected by the specified tiles.
+	 *
+	 * @param HeightGrid The new height grid, it must have the size of the current one.
+	 * @param ChangedTiles The coordinates of the tiles whose height differs from the current build.
+	 */
+	void UpdateHeights(FHexHeightGrid HeightGrid, const TArray<FIntPoint>& ChangedTiles);
+
+	/**
+	 * Marks the tile instances as outdated after the heights were replaced. In instanced mode they are updated
+	 * immediately.
+	 */
+	void InvalidateTileInstances();
+
+	/**
+	 * Updates all tile instances. Instances are only added or removed if the number of tiles changed.
+	 */
+	void UpdateTileInstances();
+
+	/**
+	 * Updates the instances of the specified tiles. Outside of the instanced mode the instances are only marked as
+	 * outdated.
+	 *
+	 * @param Tiles The coordinates of the changed tiles.
+	 */
+	void UpdateTileInstances(const TArray<FIntPoint>& Tiles);
+
+	/**
+	 * Sets the transform and the custom data of the instance of the specified tile.
+	 *
+	 * @param X The X coordinate of the tile.
 	 * @param Y The Y coordinate of the tile.
-	 * 
-	 * @return A pointer to the tile or a <i>nullptr</i>. 
+	 * @param Transform Receives the transform of the instance.
+	 * @param CustomData Receives the custom data of the instance, the height and the coordinates of the tile.
 	 */
-	const FTile* GetTile(const int32 X, const int32 Y) const;
+	void CalculateTileInstance(const int32 X, const int32 Y, FTransform& Transform, TArrayView<float> CustomData) const;
 
 	/**
-	 * Checks if there is water in the specified direction for the specified tile.
-	 * 
-	 * @param Tile The tile to be checked for having a coast.
-	 * @param Direction The direction that is checked.
-	 * 
-	 * @return If there is water in the specified direction then <b>true</b>, otherwise <b>false</b>. 
+	 * Repeats the render sections of all edge chunks beyond the opposite edge, or removes the repeated sections if the
+	 * terrain does not wrap around.
 	 */
-	bool HasCoast(const FTile& Tile, const ETileDirection Direction) const;
+	void UpdateWrapComponents() const;
 
 	/**
-	 * Checks if there is water in any direction of the specified tile.
-	 * 
-	 * @param Tile The tile to be checked for having a coast.
-	 * 
-	 * @return If there is water in at least one direction then <b>true</b>, otherwise <b>false</b>. 
+	 * Repeats the render sections of the specified chunks beyond the opposite edge, if they are edge chunks. The
+	 * sections are copied from the terrain mesh, they are not generated again.
+	 *
+	 * @param Chunks The indices of the chunks.
 	 */
-	bool HasCoast(const FTile& Tile) const;
+	void UpdateWrapComponents(const TArray<int32>& Chunks) const;
 
 	/**
-	 * Calculate the heights of the vertices for the left or right inner corner of the tile mesh. An array with four
-	 * items containing the heights of the four vertices is returned.
-	 * 
-	 * @param Tile The tile the heights are calculated for.
-	 * @param CenterZ The height of the neighbour in the specified direction.
-	 * @param SideZ The height of the neighbour of the specified side of the specified direction.
-	 * 
-	 * @return Array with four double values. 
+	 * Copies a mesh section of the terrain mesh into the specified wrap component, or clears the section there.
+	 *
+	 * @param WrapComponent The wrap component.
+	 * @param Section The index of the mesh section.
+	 * @param bCopy If <b>true</b>, the section is copied, otherwise it is cleared.
 	 */
-	static TArray<double> CalculateInnerCornerHeights(const FTile& Tile, const int32 CenterZ, const int32 SideZ);
+	void CopyWrapSection(UProceduralMeshComponent* WrapComponent, const int32 Section, const bool bCopy) const;
 
+#if WITH_EDITOR
 	/**
-	 * Calculate the heights of the vertices for the left or right outer corner of the tile mesh. An array with four
-	 * items containing the heights of the four vertices is returned.
-	 * 
-	 * @param Tile The tile the heights are calculated for.
-	 * @param CenterZ The height of the neighbour in the specified direction.
-	 * @param SideZ The height of the neighbour of the specified side of the specified direction.
-	 * 
-	 * @return Array with four double values. 
+	 * The handle of the subscription to asset reimports.
 	 */
-	static TArray<double> CalculateOuterCornerHeights(const FTile& Tile, const int32 CenterZ, const int32 SideZ);
+	FDelegateHandle AssetReimportHandle;
 
 	/**
-	 * Calculates the array of the UV coordinates for the specified mesh data.
-	 * 
-	 * @param MeshData The mesh data struct.
-	 * 
-	 * @return Array of 2D vectors. 
+	 * Subscribes to the reimport of assets, unless already subscribed.
 	 */
-	static TArray<FVector2D> CalculateUVArray(const FMeshData& MeshData);
+	void RegisterAssetReimport();
 
 	/**
-	 * Calculates the array of the normal vectors for the specified mesh data.
-	 * 
-	 * @param MeshData The mesh data struct.
-	 * 
-	 * @return Array of vectors. 
+	 * Called when an asset was reimported. If it is the topography texture, the heights are read again and only the
+	 * chunks affected by changed tiles are rebuilt.
+	 *
+	 * @param Asset The reimported asset.
 	 */
-	static TArray<FVector> CalculateNormalArray(const FMeshData& MeshData);
+	void OnAssetReimported(UObject* Asset);
 
 	/**
-	 * Calculates a noise value for the specified coordinates and the noise parameter.
-	 * 
-	 * @param Px X coordinate. 
-	 * @param Py Y coordinate.
-	 * @param Params Noise parameter.
-	 * 
-	 * @return The noise value. 
+	 * Creates a static mesh component for the specified baked static mesh and attaches it to this actor.
+	 *
+	 * @param StaticMesh The static mesh.
+	 * @param Name The name of the component.
+	 *
+	 * @return The static mesh component.
 	 */
-	static double Noise(const double Px, const double Py, const FNoiseParameter& Params);
+	UStaticMeshComponent* AddBakedComponent(UStaticMesh* StaticMesh, const FString& Name);
 
 	/**
-	 * Calculates a noise vector based on the specified vertex and the noise parameter for each axis.
-	 * 
-	 * @param Vertex Original vertex.
-	 * @param ParamsX Noise parameter for X axis.
-	 * @param ParamsY Noise parameter for Y axis.
-	 * @param ParamsZ Noise parameter for Z axis.
-	 * 
-	 * @return The noise vector. 
+	 * The change that is waiting for the next preview rebuild.
+	 */
+	ETerrainChangeType PendingChange;
+
+	/**
+	 * The change of the preview rebuild that is running in the background.
+	 */
+	ETerrainChangeType RunningChange;
+
+	/**
+	 * The handle of the ticker delaying the next preview rebuild.
+	 */
+	FTSTicker::FDelegateHandle PreviewTickerHandle;
+
+	/**
+	 * The counter identifying the current preview rebuild. It is shared with the background tasks, which stop as soon
+	 * as a newer rebuild was started.
+	 */
+	TSharedPtr<FThreadSafeCounter> PreviewGeneration;
+
+	/**
+	 * Returns the cheapest kind of rebuild that makes a change of the specified property visible.
+	 *
+	 * @param PropertyName The name of the changed member property.
+	 *
+	 * @return The change type.
+	 */
+	static ETerrainChangeType ClassifyChange(const FName& PropertyName);
+
+	/**
+	 * Combines two changes into the cheapest change covering both.
+	 *
+	 * @param ChangeA The first change.
+	 * @param ChangeB The second change.
+	 *
+	 * @return The combined change type.
+	 */
+	static ETerrainChangeType MergeChanges(const ETerrainChangeType ChangeA, const ETerrainChangeType ChangeB);
+
+	/**
+	 * Returns the section types that have to be generated again for the specified change.
+	 *
+	 * @param Change The change type.
+	 *
+	 * @return The section mask, bit N stands for section type N.
+	 */
+	static int32 GetSectionMask(const ETerrainChangeType Change);
+
+	/**
+	 * Adds the specified change to the pending change and restarts the delay of the preview rebuild.
+	 *
+	 * @param Change The change type.
+	 */
+	void SchedulePreview(const ETerrainChangeType Change);
+
+	/**
+	 * Stops the running preview rebuild, so it does not overwrite newer chunks. Its change is scheduled again, as its
+	 * batches are only partly applied.
+	 */
+	void CancelPreview();
+
+	/**
+	 * Starts the preview rebuild for the pending change. The sources of the heights are read on the game thread, the
+	 * generation, the erosion and the mesh sections run in a background task and the batches are applied on the game
+	 * thread.
+	 */
+	void RunPreview();
+
+	/**
+	 * Sets the size of the terrain and creates the tile data texture and the terrain material of a preview.
+	 *
+	 * @param NewSizeX The width of the terrain counted in tiles.
+	 * @param NewSizeY The length of the terrain counted in tiles.
+	 */
+	void PreparePreviewMaterial(const int32 NewSizeX, const int32 NewSizeY);
+
+	/**
+	 * Completes a preview rebuild after all its batches were applied.
+	 *
+	 * @param NewBuilder The builder with the new settings, it replaces the current builder.
+	 * @param bWaterOnly If <b>true</b>, only the water was generated and the heights and tile instances are kept.
+	 */
+	void FinishPreview(const TSharedPtr<FHexTerrainBuilder>& NewBuilder, const bool bWaterOnly);
+
+	/**
+	 * Applies the terrain and the water material to all existing mesh sections.
+	 */
+	void ApplyPreviewMaterials();
+
+	/**
+	 * Creates the mesh sections of a batch generated by a preview rebuild.
+	 *
+	 * @param Batch The generated chunks.
+	 * @param SectionMask The section types that were generated.
+	 */
+	void ApplyPreviewBatch(const TArray<FHexTerrainChunkData>& Batch, const int32 SectionMask) const;
+#endif
+
+	/**
+	 * Creates a mesh section based on the specified mesh section data.
+	 *
+	 * @param Section The index of the mesh section.
+	 * @param MeshSectionData The mesh section data struct.
+	 * @param Material The material to be applied to the mesh.
+	 */
+	void BuildMesh(const int32 Section, const FMeshSectionData& MeshSectionData, UMaterialInterface* Material) const;
+
+	/**
+	 * Creates an invisible mesh section with collision enabled based on the specified mesh section data.
+	 *
+	 * @param Section The index of the mesh section.
+	 * @param MeshSectionData The mesh section data struct.
+	 */
+	void BuildCollisionMesh(const int32 Section, const FMeshSectionData& MeshSectionData) const;
+
+	/**
+	 * Creates a mesh section of the type defined by the section index.
+	 *
+	 * @param Section The index of the mesh section.
+	 * @param MeshSectionData The mesh section data struct.
+	 * @param DynamicTerrainMaterial The material to be applied to terrain sections.
 	 */
-	static FVector Noise(const FVector& Vertex, const FNoiseParameter& ParamsX, const FNoiseParameter& ParamsY,
-	                     const FNoiseParameter& ParamsZ);
+	void BuildSection(const int32 Section, const FMeshSectionData& MeshSectionData,
+	                  UMaterialInterface* DynamicTerrainMaterial) const;
 };
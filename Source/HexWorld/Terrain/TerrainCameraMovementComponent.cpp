@@ -144,9 +144,11 @@ void UTerrainCameraMovementComponent::BasicMovementControl(const double AxisValu
 		// Get new location
 		const auto Location = CameraOwner->GetActorLocation();
 		// Get terrain size
-		const auto [MinimalX, MinimalY, MaximalX, MaximalY] = CameraOwner->GetTerrainSize();
-		// Clamp location
-		const auto X = Location.X < MinimalX ? MinimalX : Location.X > MaximalX ? MaximalX : Location.X;
+		const auto [MinimalX, MinimalY, MaximalX, MaximalY, bWrapX, WrapWidth] = CameraOwner->GetTerrainSize();
+		// Clamp location, on a wrapping terrain the camera continues on the opposite side
+		const auto X = bWrapX && WrapWidth > 0.0
+			               ? MinimalX + FMath::Fmod(FMath::Fmod(Location.X - MinimalX, WrapWidth) + WrapWidth, WrapWidth)
+			               : Location.X < MinimalX ? MinimalX : Location.X > MaximalX ? MaximalX : Location.X;
 		const auto Y = Location.Y < MinimalY ? MinimalY : Location.Y > MaximalY ? MaximalY : Location.Y;
 		// Apply new clamped location
 		CameraOwner->SetActorLocation(FVector(X, Y, Location.Z));
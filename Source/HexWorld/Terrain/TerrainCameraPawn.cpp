@@ -55,6 +55,10 @@ ATerrainCameraPawn::ATerrainCameraPawn()
 
 	// Attach camera movement component
 	CameraMovement = CreateDefaultSubobject<UTerrainCameraMovementComponent>(TEXT("Camera Movement"));
+
+	// The terrain is searched when the game starts
+	Terrain = nullptr;
+	PreviousLocation = FVector::ZeroVector;
 }
 
 /**
@@ -66,15 +70,12 @@ void ATerrainCameraPawn::BeginPlay()
 
 	auto Actors = TArray<AActor*>();
 	UGameplayStatics::GetAllActorsOfClass(GetWorld(), ATerrainActor::StaticClass(), Actors);
-	const auto Terrain = static_cast<ATerrainActor*>(Actors[0]);
+	Terrain = Actors.IsEmpty() ? nullptr : static_cast<ATerrainActor*>(Actors[0]);
 	if (IsValid(Terrain))
 	{
-		TerrainSize = Terrain->GetBounds();
-		const auto X = TerrainSize.MinimalX + (TerrainSize.MaximalX - TerrainSize.MinimalX) / 2.0;
-		const auto Y = TerrainSize.MinimalY + (TerrainSize.MaximalY - TerrainSize.MinimalY) / 2.0;
-		UE_LOG(TerrainCameraPawn, Display, TEXT("Terrain Actor found (Location: %f:%f)."), X, Y);
-
-		SetActorLocation(FVector(X, Y, 100.0));
+		CenterOnTerrain();
+		// A terrain waiting for its map data is built later, its bounds are read again then
+		Terrain->OnTerrainBuilt().AddUObject(this, &ATerrainCameraPawn::CenterOnTerrain);
 	}
 	else
 	{
@@ -82,6 +83,23 @@ void ATerrainCameraPawn::BeginPlay()
 		UE_LOG(TerrainCameraPawn, Warning, TEXT("Terrain Actor not found."));
 	}
 	SetActorRotation(FRotator::ZeroRotator);
+	PreviousLocation = GetActorLocation();
+}
+
+/**
+ * Reads the bounds of the terrain and moves the camera to its center.
+ */
+void ATerrainCameraPawn::CenterOnTerrain()
+{
+	TerrainSize = Terrain->GetBounds();
+	const auto X = TerrainSize.MinimalX + (TerrainSize.MaximalX - TerrainSize.MinimalX) / 2.0;
+	const auto Y = TerrainSize.MinimalY + (TerrainSize.MaximalY - TerrainSize.MinimalY) / 2.0;
+	UE_LOG(TerrainCameraPawn, Display, TEXT("Terrain Actor found (Location: %f:%f)."), X, Y);
+
+	SetActorLocation(FVector(X, Y, 100.0));
+	PreviousLocation = GetActorLocation();
+	// Select the render mode for the initial zoom
+	Terrain->UpdateRenderMode(GetCurrentZoomLength());
 }
 
 /**
@@ -96,6 +114,23 @@ void ATerrainCameraPawn::Tick(float DeltaTime)
 	const auto Upper = FVector(0.0, 0.0, 1.0);
 	auto Right = FVector::CrossProduct(Forward, Upper);
 	Right.Normalize();
+
+	// Stream the chunks around the camera, ahead of its movement
+	const auto Location = GetActorLocation();
+	auto Movement = Location - PreviousLocation;
+	// Crossing the seam of a wrapping terrain moves the camera by the wrap width, which is not part of the movement
+	if (TerrainSize.bWrapX && TerrainSize.WrapWidth > 0.0)
+	{
+		const auto HalfWidth = TerrainSize.WrapWidth / 2.0;
+		Movement.X = FMath::Fmod(FMath::Fmod(Movement.X + HalfWidth, TerrainSize.WrapWidth) + TerrainSize.WrapWidth,
+		                         TerrainSize.WrapWidth) - HalfWidth;
+	}
+	const auto Velocity = DeltaTime > 0.0f ? Movement / DeltaTime : FVector::ZeroVector;
+	PreviousLocation = Location;
+	if (IsValid(Terrain) && Terrain->IsStreaming())
+	{
+		Terrain->UpdateStreaming(Location, Velocity, Forward);
+	}
 }
 
 /**
@@ -126,6 +161,11 @@ FRotator ATerrainCameraPawn::GetCurrentRotation() const
 void ATerrainCameraPawn::UpdateZoomLength(const float ChangeAmount)
 {
 	CameraArm->TargetArmLength += ChangeAmount;
+	// The terrain switches its render mode depending on the zoom
+	if (IsValid(Terrain))
+	{
+		Terrain->UpdateRenderMode(GetCurrentZoomLength());
+	}
 }
 
 /**
@@ -154,4 +194,9 @@ void ATerrainCameraPawn::SetToDefaultZoom()
 {
 	CameraArm->TargetArmLength = DefaultZoomLength;
 	CameraArm->SetRelativeRotation(DefaultRotation);
+	// The terrain switches its render mode depending on the zoom
+	if (IsValid(Terrain))
+	{
+		Terrain->UpdateRenderMode(GetCurrentZoomLength());
+	}
 }
@@ -16,6 +16,7 @@
 // Defines the log category of this class.
 DECLARE_LOG_CATEGORY_EXTERN(TerrainCameraPawn, Log, All);
 
+class ATerrainActor;
 class UTerrainCameraMovementComponent;
 
 /**
@@ -149,9 +150,25 @@ public:
 	virtual void SetToDefaultZoom();
 
 private:
+	/**
+	 * Reads the bounds of the terrain and moves the camera to its center.
+	 */
+	void CenterOnTerrain();
+
 	/**
 	 * Terrain size struct.
 	 */
 	FTerrainSize TerrainSize;
+
+	/**
+	 * The terrain the camera moves over.
+	 */
+	UPROPERTY(Transient)
+	ATerrainActor* Terrain;
+
+	/**
+	 * The location of the camera in the previous frame, used for calculating its velocity.
+	 */
+	FVector PreviousLocation;
 	
 };
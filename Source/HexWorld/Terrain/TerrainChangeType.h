@@ -0,0 +1,29 @@
+//
+// (C) Copyright 2024 Dirk Michael
+// dirkmichaelnm@gmail.com
+//
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * This enumeration classifies the changes of terrain properties by the cheapest rebuild that makes them visible. The
+ * values are ordered by the cost of that rebuild.
+ */
+UENUM()
+enum ETerrainChangeType
+{
+	// Nothing to rebuild
+	NoChange = 0,
+	// Only the materials have to be applied again
+	MaterialChange = 1,
+	// Only the water sections have to be generated again
+	WaterChange = 2,
+	// Only the distorted sections (terrain and collision) have to be generated again
+	DistortionChange = 3,
+	// All sections have to be generated again from the existing heights
+	MeshChange = 4,
+	// The heights have to be read again and all sections have to be generated again
+	TopologyChange = 5
+};
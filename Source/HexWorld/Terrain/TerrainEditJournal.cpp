@@ -0,0 +1,232 @@
+//
+// (C) Copyright 2024 Dirk Michael
+// dirkmichaelnm@gmail.com
+//
+
+#include "TerrainEditJournal.h"
+
+// Defines the log category of this class.
+DEFINE_LOG_CATEGORY(TerrainEditJournal)
+
+/**
+ * Creates an empty journal.
+ *
+ * @param InMaxTransactions The number of transactions kept for undo, the oldest ones are discarded.
+ */
+FTerrainEditJournal::FTerrainEditJournal(const int32 InMaxTransactions)
+{
+	MaxTransactions = FMath::Max(InMaxTransactions, 1);
+	Depth = 0;
+	Position = 0;
+}
+
+/**
+ * Opens a transaction. Transactions may be nested, the edits are collected until the outermost one is ended.
+ */
+void FTerrainEditJournal::BeginTransaction()
+{
+	Depth++;
+}
+
+/**
+ * Records the change of a tile height within the open transaction. If the tile was already changed within the
+ * transaction, its first old height is kept.
+ *
+ * @param Index The index of the tile, Index = X + Y * SizeX.
+ * @param OldZ The height before the change.
+ * @param NewZ The height after the change.
+ */
+void FTerrainEditJournal::RecordEdit(const int32 Index, const int32 OldZ, const int32 NewZ)
+{
+	check(Depth > 0);
+	if (auto Edit = PendingEdits.Find(Index))
+	{
+		// Keep the height from before the transaction
+		Edit->Value = NewZ;
+	}
+	else
+	{
+		PendingEdits.Add(Index, TPair<int32, int32>(OldZ, NewZ));
+	}
+}
+
+/**
+ * Closes a transaction. When the outermost transaction is closed, its edits are compressed into runs and added to
+ * the undo history, which discards the redo history, and the new heights are written into the specified grid.
+ *
+ * @param HeightGrid The height grid.
+ *
+ * @return The coordinates of the changed tiles, empty for nested transactions.
+ */
+TArray<FIntPoint> FTerrainEditJournal::EndTransaction(FHexHeightGrid& HeightGrid)
+{
+	check(Depth > 0);
+	if (--Depth > 0)
+	{
+		return TArray<FIntPoint>();
+	}
+
+	// Collect the tiles that really changed, a tile may have been painted back to its old height
+	auto Indices = TArray<int32>();
+	Indices.Reserve(PendingEdits.Num());
+	for (const auto& Edit : PendingEdits)
+	{
+		if (Edit.Value.Key != Edit.Value.Value)
+		{
+			Indices.Add(Edit.Key);
+		}
+	}
+	Indices.Sort();
+
+	// Compress the edits into runs of consecutive tiles
+	auto Transaction = FTransaction();
+	Transaction.OldHeights.Reserve(Indices.Num());
+	Transaction.NewHeights.Reserve(Indices.Num());
+	for (const auto Index : Indices)
+	{
+		const auto& Edit = PendingEdits[Index];
+		if (Transaction.Runs.IsEmpty() || Transaction.Runs.Last().StartIndex + Transaction.Runs.Last().Num != Index)
+		{
+			Transaction.Runs.Add({Index, 0, Transaction.OldHeights.Num()});
+		}
+		Transaction.Runs.Last().Num++;
+		Transaction.OldHeights.Add(Edit.Key);
+		Transaction.NewHeights.Add(Edit.Value);
+	}
+	PendingEdits.Reset();
+
+	// A transaction without changes is not worth an undo step
+	if (Indices.IsEmpty())
+	{
+		return TArray<FIntPoint>();
+	}
+
+	// The new transaction replaces the redo history
+	Transactions.SetNum(Position);
+	Transaction.Runs.Shrink();
+	Transactions.Add(MoveTemp(Transaction));
+	// Discard the oldest transactions
+	if (Transactions.Num() > MaxTransactions)
+	{
+		Transactions.RemoveAt(0, Transactions.Num() - MaxTransactions);
+	}
+	Position = Transactions.Num();
+
+	// Log
+	UE_LOG(TerrainEditJournal, Display, TEXT("Transaction recorded (Tiles: %d, Runs: %d, Journal: %.1f KB)."),
+	       Indices.Num(), Transactions.Last().Runs.Num(), GetAllocatedSize() / 1024.0);
+	// Apply the new heights
+	return Apply(Transactions.Last(), true, HeightGrid);
+}
+
+/**
+ * Returns the height recorded for the specified tile within the open transaction.
+ *
+ * @param Index The index of the tile.
+ *
+ * @return The new height, or nothing if the tile was not changed within the open transaction.
+ */
+TOptional<int32> FTerrainEditJournal::GetPendingHeight(const int32 Index) const
+{
+	if (const auto Edit = PendingEdits.Find(Index))
+	{
+		return Edit->Value;
+	}
+	return TOptional<int32>();
+}
+
+/**
+ * Restores the old heights of the last transaction in the specified grid.
+ *
+ * @param HeightGrid The height grid.
+ *
+ * @return The coordinates of the changed tiles.
+ */
+TArray<FIntPoint> FTerrainEditJournal::Undo(FHexHeightGrid& HeightGrid)
+{
+	if (!CanUndo() || IsTransactionOpen())
+	{
+		return TArray<FIntPoint>();
+	}
+	return Apply(Transactions[--Position], false, HeightGrid);
+}
+
+/**
+ * Applies the new heights of the last undone transaction to the specified grid.
+ *
+ * @param HeightGrid The height grid.
+ *
+ * @return The coordinates of the changed tiles.
+ */
+TArray<FIntPoint> FTerrainEditJournal::Redo(FHexHeightGrid& HeightGrid)
+{
+	if (!CanRedo() || IsTransactionOpen())
+	{
+		return TArray<FIntPoint>();
+	}
+	return Apply(Transactions[Position++], true, HeightGrid);
+}
+
+/**
+ * Discards all transactions, e.g. when the heights were replaced.
+ */
+void FTerrainEditJournal::Reset()
+{
+	Depth = 0;
+	PendingEdits.Reset();
+	Transactions.Empty();
+	Position = 0;
+}
+
+/**
+ * Returns the memory allocated by the recorded transactions.
+ *
+ * @return The allocated memory in bytes.
+ */
+SIZE_T FTerrainEditJournal::GetAllocatedSize() const
+{
+	auto Size = Transactions.GetAllocatedSize() + PendingEdits.GetAllocatedSize();
+	for (const auto& Transaction : Transactions)
+	{
+		Size += Transaction.Runs.GetAllocatedSize() + Transaction.OldHeights.GetAllocatedSize()
+			+ Transaction.NewHeights.GetAllocatedSize();
+	}
+	return Size;
+}
+
+/**
+ * Writes the old or the new heights of the specified transaction into the grid.
+ *
+ * @param Transaction The transaction.
+ * @param bNew If <b>true</b>, the new heights are written, otherwise the old ones.
+ * @param HeightGrid The height grid.
+ *
+ * @return The coordinates of the changed tiles.
+ */
+TArray<FIntPoint> FTerrainEditJournal::Apply(const FTransaction& Transaction, const bool bNew,
+                                             FHexHeightGrid& HeightGrid)
+{
+	auto ChangedTiles = TArray<FIntPoint>();
+	if (HeightGrid.IsEmpty())
+	{
+		return ChangedTiles;
+	}
+	const auto& Heights = bNew ? Transaction.NewHeights : Transaction.OldHeights;
+	const auto SizeX = HeightGrid.GetSizeX();
+	ChangedTiles.Reserve(Heights.Num());
+	for (const auto& Run : Transaction.Runs)
+	{
+		for (auto I = 0; I < Run.Num; I++)
+		{
+			const auto X = (Run.StartIndex + I) % SizeX;
+			const auto Y = (Run.StartIndex + I) / SizeX;
+			// Skip tiles outside of the grid, e.g. when the topography was replaced by a smaller one
+			if (HeightGrid.Contains(X, Y))
+			{
+				HeightGrid.SetHeight(X, Y, Heights[Run.Offset + I]);
+				ChangedTiles.Add(FIntPoint(X, Y));
+			}
+		}
+	}
+	return ChangedTiles;
+}
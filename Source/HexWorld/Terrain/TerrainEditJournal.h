@@ -0,0 +1,193 @@
+//
+// (C) Copyright 2024 Dirk Michael
+// dirkmichaelnm@gmail.com
+//
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HexHeightGrid.h"
+
+// Defines the log category of this class.
+DECLARE_LOG_CATEGORY_EXTERN(TerrainEditJournal, Log, All);
+
+/**
+ * This class records the height changes of tiles for undo and redo. The edits between the begin and the end of a
+ * transaction, e.g. all dabs of a brush stroke, are coalesced into a single transaction, which stores runs of
+ * consecutive tile indices with their old and new heights. So the memory grows with the number of edited tiles and
+ * not with the size of the map.
+ */
+class HEXWORLD_API FTerrainEditJournal
+{
+public:
+	/**
+	 * Creates an empty journal.
+	 *
+	 * @param InMaxTransactions The number of transactions kept for undo, the oldest ones are discarded.
+	 */
+	explicit FTerrainEditJournal(const int32 InMaxTransactions = 256);
+
+	/**
+	 * Opens a transaction. Transactions may be nested, the edits are collected until the outermost one is ended.
+	 */
+	void BeginTransaction();
+
+	/**
+	 * Records the change of a tile height within the open transaction. If the tile was already changed within the
+	 * transaction, its first old height is kept.
+	 *
+	 * @param Index The index of the tile, Index = X + Y * SizeX.
+	 * @param OldZ The height before the change.
+	 * @param NewZ The height after the change.
+	 */
+	void RecordEdit(const int32 Index, const int32 OldZ, const int32 NewZ);
+
+	/**
+	 * Closes a transaction. When the outermost transaction is closed, its edits are compressed into runs and added to
+	 * the undo history, which discards the redo history, and the new heights are written into the specified grid.
+	 *
+	 * @param HeightGrid The height grid.
+	 *
+	 * @return The coordinates of the changed tiles, empty for nested transactions.
+	 */
+	TArray<FIntPoint> EndTransaction(FHexHeightGrid& HeightGrid);
+
+	/**
+	 * Returns <b>true</b>, if a transaction is open.
+	 *
+	 * @return The open flag.
+	 */
+	FORCEINLINE bool IsTransactionOpen() const { return Depth > 0; }
+
+	/**
+	 * Returns the height recorded for the specified tile within the open transaction.
+	 *
+	 * @param Index The index of the tile.
+	 *
+	 * @return The new height, or nothing if the tile was not changed within the open transaction.
+	 */
+	TOptional<int32> GetPendingHeight(const int32 Index) const;
+
+	/**
+	 * Returns <b>true</b>, if there is a transaction to be undone.
+	 *
+	 * @return The undo flag.
+	 */
+	FORCEINLINE bool CanUndo() const { return Position > 0; }
+
+	/**
+	 * Returns <b>true</b>, if there is a transaction to be redone.
+	 *
+	 * @return The redo flag.
+	 */
+	FORCEINLINE bool CanRedo() const { return Position < Transactions.Num(); }
+
+	/**
+	 * Restores the old heights of the last transaction in the specified grid.
+	 *
+	 * @param HeightGrid The height grid.
+	 *
+	 * @return The coordinates of the changed tiles.
+	 */
+	TArray<FIntPoint> Undo(FHexHeightGrid& HeightGrid);
+
+	/**
+	 * Applies the new heights of the last undone transaction to the specified grid.
+	 *
+	 * @param HeightGrid The height grid.
+	 *
+	 * @return The coordinates of the changed tiles.
+	 */
+	TArray<FIntPoint> Redo(FHexHeightGrid& HeightGrid);
+
+	/**
+	 * Discards all transactions, e.g. when the heights were replaced.
+	 */
+	void Reset();
+
+	/**
+	 * Returns the memory allocated by the recorded transactions.
+	 *
+	 * @return The allocated memory in bytes.
+	 */
+	SIZE_T GetAllocatedSize() const;
+
+private:
+	/**
+	 * A run of consecutive tiles changed by a transaction.
+	 */
+	struct FRun
+	{
+		/**
+		 * The index of the first tile.
+		 */
+		int32 StartIndex;
+
+		/**
+		 * The number of tiles.
+		 */
+		int32 Num;
+
+		/**
+		 * The position of the heights of the first tile within the height arrays of the transaction.
+		 */
+		int32 Offset;
+	};
+
+	/**
+	 * The recorded changes of a closed transaction.
+	 */
+	struct FTransaction
+	{
+		/**
+		 * The runs of changed tiles, sorted by their start index.
+		 */
+		TArray<FRun> Runs;
+
+		/**
+		 * The heights before the transaction.
+		 */
+		TArray<int32> OldHeights;
+
+		/**
+		 * The heights after the transaction.
+		 */
+		TArray<int32> NewHeights;
+	};
+
+	/**
+	 * The number of transactions kept for undo.
+	 */
+	int32 MaxTransactions;
+
+	/**
+	 * The nesting depth of the open transactions.
+	 */
+	int32 Depth;
+
+	/**
+	 * The edits of the open transaction, mapped by tile index to the old and the new height.
+	 */
+	TMap<int32, TPair<int32, int32>> PendingEdits;
+
+	/**
+	 * The closed transactions, the oldest first.
+	 */
+	TArray<FTransaction> Transactions;
+
+	/**
+	 * The number of transactions that are currently applied. The transactions behind it can be redone.
+	 */
+	int32 Position;
+
+	/**
+	 * Writes the old or the new heights of the specified transaction into the grid.
+	 *
+	 * @param Transaction The transaction.
+	 * @param bNew If <b>true</b>, the new heights are written, otherwise the old ones.
+	 * @param HeightGrid The height grid.
+	 *
+	 * @return The coordinates of the changed tiles.
+	 */
+	static TArray<FIntPoint> Apply(const FTransaction& Transaction, const bool bNew, FHexHeightGrid& HeightGrid);
+};
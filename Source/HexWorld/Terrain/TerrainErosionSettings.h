@@ -0,0 +1,112 @@
+//
+// (C) Copyright 2024 Dirk Michael
+// dirkmichaelnm@gmail.com
+//
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "TerrainErosionSettings.generated.h"
+
+/**
+ * This struct contains the parameters of the erosion, which weathers the heights of the tiles after they are read or
+ * generated. The same parameters and heights always result in the same eroded heights.
+ */
+USTRUCT()
+struct FTerrainErosionSettings
+{
+	GENERATED_BODY()
+
+	/**
+	 * Creates the default settings.
+	 */
+	FTerrainErosionSettings()
+	{
+		bEnabled = false;
+		Seed = 1;
+		Resolution = 4;
+		Iterations = 100;
+		RainAmount = 0.01;
+		Evaporation = 0.05;
+		SedimentCapacity = 1.0;
+		ErosionRate = 0.3;
+		DepositionRate = 0.3;
+		Talus = 0.5;
+		ThermalRate = 0.2;
+		WorkBudget = 500;
+	}
+
+	/**
+	 * If <b>true</b>, the heights are eroded before the terrain is built.
+	 */
+	UPROPERTY(EditAnywhere, Category = "Terrain Properties|Erosion")
+	bool bEnabled;
+
+	/**
+	 * The seed of the rain, every seed distributes the rain differently.
+	 */
+	UPROPERTY(EditAnywhere, Category = "Terrain Properties|Erosion")
+	int32 Seed;
+
+	/**
+	 * The number of height samples along each side of a tile.
+	 */
+	UPROPERTY(EditAnywhere, Category = "Terrain Properties|Erosion", meta = (ClampMin = 1, ClampMax = 16))
+	int32 Resolution;
+
+	/**
+	 * The number of simulation steps.
+	 */
+	UPROPERTY(EditAnywhere, Category = "Terrain Properties|Erosion", meta = (ClampMin = 1))
+	int32 Iterations;
+
+	/**
+	 * The average amount of water that rains on a sample per step, measured in height units.
+	 */
+	UPROPERTY(EditAnywhere, Category = "Terrain Properties|Erosion", meta = (ClampMin = 0.0))
+	double RainAmount;
+
+	/**
+	 * The fraction of the water that evaporates per step.
+	 */
+	UPROPERTY(EditAnywhere, Category = "Terrain Properties|Erosion", meta = (ClampMin = 0.0, ClampMax = 1.0))
+	double Evaporation;
+
+	/**
+	 * The amount of sediment a unit of flowing water can carry.
+	 */
+	UPROPERTY(EditAnywhere, Category = "Terrain Properties|Erosion", meta = (ClampMin = 0.0))
+	double SedimentCapacity;
+
+	/**
+	 * The fraction of the free capacity that is dissolved from the ground per step.
+	 */
+	UPROPERTY(EditAnywhere, Category = "Terrain Properties|Erosion", meta = (ClampMin = 0.0, ClampMax = 1.0))
+	double ErosionRate;
+
+	/**
+	 * The fraction of the excess sediment that is deposited per step.
+	 */
+	UPROPERTY(EditAnywhere, Category = "Terrain Properties|Erosion", meta = (ClampMin = 0.0, ClampMax = 1.0))
+	double DepositionRate;
+
+	/**
+	 * The height difference between two neighbouring samples, above which the material slides down.
+	 */
+	UPROPERTY(EditAnywhere, Category = "Terrain Properties|Erosion", meta = (ClampMin = 0.0))
+	double Talus;
+
+	/**
+	 * The fraction of the height difference above the talus that slides down per step.
+	 */
+	UPROPERTY(EditAnywhere, Category = "Terrain Properties|Erosion", meta = (ClampMin = 0.0, ClampMax = 0.5))
+	double ThermalRate;
+
+	/**
+	 * The maximal number of sample updates in millions. On large maps the resolution and then the number of
+	 * iterations are reduced until the erosion fits into the budget. The budget does not depend on the measured time,
+	 * so the result is the same on every machine.
+	 */
+	UPROPERTY(EditAnywhere, Category = "Terrain Properties|Erosion", meta = (ClampMin = 1))
+	int32 WorkBudget;
+};
@@ -0,0 +1,21 @@
+//
+// (C) Copyright 2024 Dirk Michael
+// dirkmichaelnm@gmail.com
+//
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * This enumeration defines the file formats the terrain mesh can be exported to.
+ */
+UENUM()
+enum ETerrainExportFormat
+{
+	ObjText = 0 UMETA(DisplayName = "OBJ"),
+	PlyText = 1 UMETA(DisplayName = "PLY (ASCII)"),
+	PlyBinary = 2 UMETA(DisplayName = "PLY (Binary)"),
+	GltfBinary = 3 UMETA(DisplayName = "glTF (Binary)"),
+	GltfText = 4 UMETA(DisplayName = "glTF (JSON + BIN)")
+};
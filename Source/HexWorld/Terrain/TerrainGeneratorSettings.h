@@ -0,0 +1,103 @@
+//
+// (C) Copyright 2024 Dirk Michael
+// dirkmichaelnm@gmail.com
+//
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "TerrainGeneratorSettings.generated.h"
+
+/**
+ * This struct contains the parameters of the procedural generation of the tile heights. The same parameters always
+ * generate the same map.
+ */
+USTRUCT()
+struct FTerrainGeneratorSettings
+{
+	GENERATED_BODY()
+
+	/**
+	 * Creates the default settings.
+	 */
+	FTerrainGeneratorSettings()
+	{
+		Seed = 1;
+		SizeX = 128;
+		SizeY = 96;
+		ContinentCount = 3;
+		ContinentRadius = 0.3;
+		FeatureSize = 24.0;
+		Octaves = 5;
+		Persistence = 0.5;
+		Roughness = 0.6;
+		MaximalHeight = 8;
+		MaximalDepth = 3;
+	}
+
+	/**
+	 * The seed of the map, every seed generates another map.
+	 */
+	UPROPERTY(EditAnywhere, Category = "Terrain Properties|Generation")
+	int32 Seed;
+
+	/**
+	 * The width of the map counted in tiles.
+	 */
+	UPROPERTY(EditAnywhere, Category = "Terrain Properties|Generation", meta = (ClampMin = 1))
+	int32 SizeX;
+
+	/**
+	 * The length of the map counted in tiles.
+	 */
+	UPROPERTY(EditAnywhere, Category = "Terrain Properties|Generation", meta = (ClampMin = 1))
+	int32 SizeY;
+
+	/**
+	 * The number of continents, the land is concentrated around their centers.
+	 */
+	UPROPERTY(EditAnywhere, Category = "Terrain Properties|Generation", meta = (ClampMin = 0))
+	int32 ContinentCount;
+
+	/**
+	 * The radius of a continent relative to the shorter side of the map.
+	 */
+	UPROPERTY(EditAnywhere, Category = "Terrain Properties|Generation", meta = (ClampMin = 0.01))
+	double ContinentRadius;
+
+	/**
+	 * The size of the largest noise features counted in tiles.
+	 */
+	UPROPERTY(EditAnywhere, Category = "Terrain Properties|Generation", meta = (ClampMin = 1.0))
+	double FeatureSize;
+
+	/**
+	 * The number of noise layers, every layer has twice the frequency of the previous one.
+	 */
+	UPROPERTY(EditAnywhere, Category = "Terrain Properties|Generation", meta = (ClampMin = 1, ClampMax = 12))
+	int32 Octaves;
+
+	/**
+	 * The amplitude of a noise layer relative to the previous one.
+	 */
+	UPROPERTY(EditAnywhere, Category = "Terrain Properties|Generation", meta = (ClampMin = 0.0, ClampMax = 1.0))
+	double Persistence;
+
+	/**
+	 * The weight of the noise relative to the continent mask. Higher values create more islands and lakes.
+	 */
+	UPROPERTY(EditAnywhere, Category = "Terrain Properties|Generation", meta = (ClampMin = 0.0))
+	double Roughness;
+
+	/**
+	 * The height of the highest mountains above the sea level.
+	 */
+	UPROPERTY(EditAnywhere, Category = "Terrain Properties|Generation", meta = (ClampMin = 1))
+	int32 MaximalHeight;
+
+	/**
+	 * The depth of the deepest sea below the sea level.
+	 */
+	UPROPERTY(EditAnywhere, Category = "Terrain Properties|Generation", meta = (ClampMin = 0))
+	int32 MaximalDepth;
+};
@@ -0,0 +1,133 @@
+//
+// (C) Copyright 2024 Dirk Michael
+// dirkmichaelnm@gmail.com
+//
+
+#include "TerrainMeshBaker.h"
+
+#if WITH_EDITOR
+
+#include "MeshDescription.h"
+#include "StaticMeshAttributes.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "Engine/StaticMesh.h"
+#include "Misc/PackageName.h"
+#include "UObject/SavePackage.h"
+
+// Defines the log category of this class.
+DEFINE_LOG_CATEGORY(TerrainMeshBaker)
+
+/**
+ * Creates a static mesh asset from the specified mesh section data and saves its package. An existing asset with
+ * the same name is replaced.
+ *
+ * @param PackagePath The content path of the directory the asset is created in (e.g. /Game/Terrain).
+ * @param AssetName The name of the asset.
+ * @param MeshSectionData The mesh section data.
+ * @param Material The material to be applied to the static mesh.
+ * @param bEnableNanite If <b>true</b>, Nanite is enabled for the static mesh.
+ *
+ * @return The static mesh or <i>nullptr</i>, if the asset could not be created.
+ */
+UStaticMesh* FTerrainMeshBaker::CreateStaticMesh(const FString& PackagePath, const FString& AssetName,
+                                                 const FMeshSectionData& MeshSectionData,
+                                                 UMaterialInterface* Material, const bool bEnableNanite)
+{
+	// The name of the only material slot
+	const auto SlotName = FName(TEXT("Material"));
+
+	// Create the mesh description
+	auto MeshDescription = FMeshDescription();
+	auto Attributes = FStaticMeshAttributes(MeshDescription);
+	Attributes.Register();
+	const auto PolygonGroup = MeshDescription.CreatePolygonGroup();
+	Attributes.GetPolygonGroupMaterialSlotNames()[PolygonGroup] = SlotName;
+	// Reserve the memory for all elements
+	const auto VertexCount = MeshSectionData.Vertices.Num();
+	const auto TriangleCount = MeshSectionData.Triangles.Num() / 3;
+	MeshDescription.ReserveNewVertices(VertexCount);
+	MeshDescription.ReserveNewVertexInstances(VertexCount);
+	MeshDescription.ReserveNewTriangles(TriangleCount);
+	MeshDescription.ReserveNewPolygons(TriangleCount);
+	// Add the vertices, every vertex has exactly one vertex instance
+	auto Positions = Attributes.GetVertexPositions();
+	auto Normals = Attributes.GetVertexInstanceNormals();
+	auto UVs = Attributes.GetVertexInstanceUVs();
+	auto Instances = TArray<FVertexInstanceID>();
+	Instances.Reserve(VertexCount);
+	for (auto I = 0; I < VertexCount; I++)
+	{
+		const auto Vertex = MeshDescription.CreateVertex();
+		Positions[Vertex] = FVector3f(MeshSectionData.Vertices[I]);
+		const auto Instance = MeshDescription.CreateVertexInstance(Vertex);
+		Normals[Instance] = FVector3f(MeshSectionData.Normals[I]);
+		UVs.Set(Instance, 0, FVector2f(MeshSectionData.UVs[I]));
+		Instances.Add(Instance);
+	}
+	// Add the triangles
+	for (auto I = 0; I < TriangleCount; I++)
+	{
+		const FVertexInstanceID Corners[3] = {
+			Instances[MeshSectionData.Triangles[I * 3]],
+			Instances[MeshSectionData.Triangles[I * 3 + 1]],
+			Instances[MeshSectionData.Triangles[I * 3 + 2]]
+		};
+		MeshDescription.CreateTriangle(PolygonGroup, Corners);
+	}
+
+	// Create the package and the static mesh
+	const auto PackageName = FPaths::Combine(PackagePath, AssetName);
+	const auto Package = CreatePackage(*PackageName);
+	Package->FullyLoad();
+	// The static mesh of a previous bake may still be loaded, it is reset instead of being replaced by a new object
+	auto StaticMesh = FindObject<UStaticMesh>(Package, *AssetName);
+	const auto bCreated = StaticMesh == nullptr;
+	if (bCreated)
+	{
+		StaticMesh = NewObject<UStaticMesh>(Package, *AssetName, RF_Public | RF_Standalone);
+	}
+	else
+	{
+		StaticMesh->Modify();
+		StaticMesh->GetStaticMaterials().Empty();
+		StaticMesh->SetNumSourceModels(0);
+	}
+	StaticMesh->GetStaticMaterials().Add(FStaticMaterial(Material, SlotName, SlotName));
+	// The normals are already calculated, only the tangents are missing
+	auto& SourceModel = StaticMesh->AddSourceModel();
+	SourceModel.BuildSettings.bRecomputeNormals = false;
+	SourceModel.BuildSettings.bRecomputeTangents = true;
+	SourceModel.BuildSettings.bGenerateLightmapUVs = false;
+	StaticMesh->CreateMeshDescription(0, MoveTemp(MeshDescription));
+	StaticMesh->CommitMeshDescription(0);
+	// Enable Nanite
+	StaticMesh->NaniteSettings.bEnabled = bEnableNanite;
+	// Build the render data, the distance field and the collision
+	StaticMesh->Build(true);
+	StaticMesh->PostEditChange();
+
+	// Register a new asset and save it
+	if (bCreated)
+	{
+		FAssetRegistryModule::AssetCreated(StaticMesh);
+	}
+	Package->MarkPackageDirty();
+	const auto Filename = FPackageName::LongPackageNameToFilename(PackageName,
+	                                                              FPackageName::GetAssetPackageExtension());
+	auto SaveArgs = FSavePackageArgs();
+	SaveArgs.TopLevelFlags = RF_Public | RF_Standalone;
+	if (!UPackage::SavePackage(Package, StaticMesh, *Filename, SaveArgs))
+	{
+		UE_LOG(TerrainMeshBaker, Error, TEXT("Package %s could not be saved."), *PackageName);
+		return nullptr;
+	}
+
+	// Log
+	UE_LOG(TerrainMeshBaker, Display, TEXT("Static mesh %s created (Vertices: %d, Triangles: %d, Nanite: %d)"),
+	       *PackageName, VertexCount, TriangleCount, bEnableNanite);
+
+	// Return the static mesh
+	return StaticMesh;
+}
+
+#endif
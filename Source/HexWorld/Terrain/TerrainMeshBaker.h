@@ -0,0 +1,39 @@
+//
+// (C) Copyright 2024 Dirk Michael
+// dirkmichaelnm@gmail.com
+//
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MeshSectionData.h"
+
+#if WITH_EDITOR
+
+// Defines the log category of this class.
+DECLARE_LOG_CATEGORY_EXTERN(TerrainMeshBaker, Log, All);
+
+/**
+ * This class converts the generated mesh sections of the terrain into static mesh assets.
+ */
+class HEXWORLD_API FTerrainMeshBaker
+{
+public:
+	/**
+	 * Creates a static mesh asset from the specified mesh section data and saves its package. An existing asset with
+	 * the same name is replaced.
+	 *
+	 * @param PackagePath The content path of the directory the asset is created in (e.g. /Game/Terrain).
+	 * @param AssetName The name of the asset.
+	 * @param MeshSectionData The mesh section data.
+	 * @param Material The material to be applied to the static mesh.
+	 * @param bEnableNanite If <b>true</b>, Nanite is enabled for the static mesh.
+	 *
+	 * @return The static mesh or <i>nullptr</i>, if the asset could not be created.
+	 */
+	static UStaticMesh* CreateStaticMesh(const FString& PackagePath, const FString& AssetName,
+	                                     const FMeshSectionData& MeshSectionData, UMaterialInterface* Material,
+	                                     const bool bEnableNanite);
+};
+
+#endif
@@ -0,0 +1,77 @@
+//
+// (C) Copyright 2024 Dirk Michael
+// dirkmichaelnm@gmail.com
+//
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// The magic number at the beginning of a terrain mesh cache file ("HXMC")
+#define TERRAIN_MESH_CACHE_MAGIC 0x434D5848
+// The version of the terrain mesh cache file format
+#define TERRAIN_MESH_CACHE_VERSION 2
+
+/**
+ * The header at the beginning of a terrain mesh cache file. It is followed by the data of the mesh sections and the
+ * section table at the offset stored in the header.
+ */
+struct FTerrainMeshCacheHeader
+{
+	/**
+	 * The magic number.
+	 */
+	uint32 Magic;
+
+	/**
+	 * The version of the file format.
+	 */
+	uint32 Version;
+
+	/**
+	 * The hash of all build inputs the cached meshes were generated from.
+	 */
+	uint64 Hash;
+
+	/**
+	 * The number of mesh sections.
+	 */
+	int64 SectionCount;
+
+	/**
+	 * The offset of the section table within the file.
+	 */
+	int64 TableOffset;
+};
+
+/**
+ * An entry of the section table. The data of a section consists of the positions (3 floats per vertex), the normals
+ * (3 floats per vertex), the UV coordinates (2 floats per vertex) and the triangle indices (int32).
+ */
+struct FTerrainMeshCacheEntry
+{
+	/**
+	 * The index of the mesh section.
+	 */
+	int32 Section;
+
+	/**
+	 * The number of vertices.
+	 */
+	int32 VertexCount;
+
+	/**
+	 * The number of triangle indices.
+	 */
+	int32 IndexCount;
+
+	/**
+	 * Padding to keep the offset aligned.
+	 */
+	int32 Padding;
+
+	/**
+	 * The offset of the section data within the file.
+	 */
+	int64 DataOffset;
+};
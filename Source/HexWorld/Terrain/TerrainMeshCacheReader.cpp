@@ -0,0 +1,108 @@
+//
+// (C) Copyright 2024 Dirk Michael
+// dirkmichaelnm@gmail.com
+//
+
+#include "TerrainMeshCacheReader.h"
+
+#include "HAL/PlatformFileManager.h"
+
+// Defines the log category of this class.
+DEFINE_LOG_CATEGORY(TerrainMeshCacheReader)
+
+/**
+ * Maps the specified cache file and validates its header.
+ *
+ * @param Filename The name of the cache file.
+ * @param Hash The expected hash of all build inputs.
+ */
+FTerrainMeshCacheReader::FTerrainMeshCacheReader(const FString& Filename, const uint64 Hash)
+{
+	Data = nullptr;
+
+	// Map the whole file
+	MappedFile = TUniquePtr<IMappedFileHandle>(FPlatformFileManager::Get().GetPlatformFile().OpenMapped(*Filename));
+	if (!MappedFile.IsValid() || MappedFile->GetFileSize() < static_cast<int64>(sizeof(FTerrainMeshCacheHeader)))
+	{
+		return;
+	}
+	MappedRegion = TUniquePtr<IMappedFileRegion>(MappedFile->MapRegion(0, MappedFile->GetFileSize()));
+	if (!MappedRegion.IsValid())
+	{
+		return;
+	}
+	const auto Mapped = MappedRegion->GetMappedPtr();
+	const auto Size = MappedRegion->GetMappedSize();
+
+	// Validate the header
+	FTerrainMeshCacheHeader Header;
+	FMemory::Memcpy(&Header, Mapped, sizeof(Header));
+	if (Header.Magic != TERRAIN_MESH_CACHE_MAGIC || Header.Version != TERRAIN_MESH_CACHE_VERSION)
+	{
+		UE_LOG(TerrainMeshCacheReader, Warning, TEXT("Cache file %s has an unknown format."), *Filename);
+		return;
+	}
+	if (Header.Hash != Hash)
+	{
+		UE_LOG(TerrainMeshCacheReader, Display, TEXT("Cache file %s is outdated."), *Filename);
+		return;
+	}
+	const auto TableSize = Header.SectionCount * static_cast<int64>(sizeof(FTerrainMeshCacheEntry));
+	if (Header.SectionCount < 0 || Header.TableOffset < 0 || Header.TableOffset + TableSize > Size)
+	{
+		UE_LOG(TerrainMeshCacheReader, Warning, TEXT("Cache file %s is corrupt."), *Filename);
+		return;
+	}
+
+	// Read and validate the section table
+	Entries.SetNumUninitialized(Header.SectionCount);
+	FMemory::Memcpy(Entries.GetData(), Mapped + Header.TableOffset, TableSize);
+	for (const auto& Entry : Entries)
+	{
+		const auto DataSize = Entry.VertexCount * 8ll * sizeof(float) + Entry.IndexCount * 4ll;
+		if (Entry.VertexCount < 0 || Entry.IndexCount < 0 || Entry.DataOffset < 0
+			|| Entry.DataOffset + DataSize > Header.TableOffset)
+		{
+			UE_LOG(TerrainMeshCacheReader, Warning, TEXT("Cache file %s is corrupt."), *Filename);
+			Entries.Empty();
+			return;
+		}
+	}
+
+	// The file is valid
+	Data = Mapped;
+}
+
+/**
+ * Reads the mesh section with the specified position in the section table.
+ *
+ * @param Entry The position in the section table.
+ * @param OutSection The index of the mesh section.
+ * @param OutMeshSectionData The mesh section data.
+ */
+void FTerrainMeshCacheReader::ReadSection(const int32 Entry, int32& OutSection,
+                                          FMeshSectionData& OutMeshSectionData) const
+{
+	const auto& [Section, VertexCount, IndexCount, Padding, DataOffset] = Entries[Entry];
+	OutSection = Section;
+
+	// Get pointers to the attribute arrays within the mapped file
+	const auto Positions = reinterpret_cast<const float*>(Data + DataOffset);
+	const auto Normals = Positions + VertexCount * 3;
+	const auto UVs = Normals + VertexCount * 3;
+	const auto Indices = UVs + VertexCount * 2;
+
+	// Convert the vertex attributes
+	OutMeshSectionData.Vertices.SetNumUninitialized(VertexCount);
+	OutMeshSectionData.Normals.SetNumUninitialized(VertexCount);
+	OutMeshSectionData.UVs.SetNumUninitialized(VertexCount);
+	for (auto I = 0; I < VertexCount; I++)
+	{
+		OutMeshSectionData.Vertices[I] = FVector(Positions[I * 3], Positions[I * 3 + 1], Positions[I * 3 + 2]);
+		OutMeshSectionData.Normals[I] = FVector(Normals[I * 3], Normals[I * 3 + 1], Normals[I * 3 + 2]);
+		OutMeshSectionData.UVs[I] = FVector2D(UVs[I * 2], UVs[I * 2 + 1]);
+	}
+	// Copy the triangle indices
+	OutMeshSectionData.Triangles.SetNumUninitialized(IndexCount);
+	FMemory::Memcpy(OutMeshSectionData.Triangles.GetData(), Indices, IndexCount * sizeof(int32));
+}
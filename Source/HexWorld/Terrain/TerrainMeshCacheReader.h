@@ -0,0 +1,74 @@
+//
+// (C) Copyright 2024 Dirk Michael
+// dirkmichaelnm@gmail.com
+//
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MeshSectionData.h"
+#include "TerrainMeshCacheFormat.h"
+#include "Async/MappedFileHandle.h"
+
+// Defines the log category of this class.
+DECLARE_LOG_CATEGORY_EXTERN(TerrainMeshCacheReader, Log, All);
+
+/**
+ * This class reads the mesh sections of a terrain mesh cache file. The file is memory mapped, so the section data is
+ * copied from the mapped pages directly into the section buffers without any intermediate reads.
+ */
+class HEXWORLD_API FTerrainMeshCacheReader
+{
+public:
+	/**
+	 * Maps the specified cache file and validates its header.
+	 *
+	 * @param Filename The name of the cache file.
+	 * @param Hash The expected hash of all build inputs.
+	 */
+	FTerrainMeshCacheReader(const FString& Filename, const uint64 Hash);
+
+	/**
+	 * Returns <b>true</b>, if the file exists and was created for the expected hash.
+	 *
+	 * @return The validity flag.
+	 */
+	FORCEINLINE bool IsValid() const { return Data != nullptr; }
+
+	/**
+	 * Returns the number of mesh sections in the file.
+	 *
+	 * @return The section count.
+	 */
+	FORCEINLINE int32 GetSectionCount() const { return Entries.Num(); }
+
+	/**
+	 * Reads the mesh section with the specified position in the section table.
+	 *
+	 * @param Entry The position in the section table.
+	 * @param OutSection The index of the mesh section.
+	 * @param OutMeshSectionData The mesh section data.
+	 */
+	void ReadSection(const int32 Entry, int32& OutSection, FMeshSectionData& OutMeshSectionData) const;
+
+private:
+	/**
+	 * The handle of the mapped file.
+	 */
+	TUniquePtr<IMappedFileHandle> MappedFile;
+
+	/**
+	 * The mapped region covering the whole file.
+	 */
+	TUniquePtr<IMappedFileRegion> MappedRegion;
+
+	/**
+	 * Pointer to the mapped data or <i>nullptr</i>, if the file is invalid.
+	 */
+	const uint8* Data;
+
+	/**
+	 * The section table.
+	 */
+	TArray<FTerrainMeshCacheEntry> Entries;
+};
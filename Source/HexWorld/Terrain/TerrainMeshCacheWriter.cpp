@@ -0,0 +1,137 @@
+//
+// (C) Copyright 2024 Dirk Michael
+// dirkmichaelnm@gmail.com
+//
+
+#include "TerrainMeshCacheWriter.h"
+
+// Defines the log category of this class.
+DEFINE_LOG_CATEGORY(TerrainMeshCacheWriter)
+
+/**
+ * Opens the temporary file of a new cache file.
+ *
+ * @param InFilename The name of the cache file.
+ * @param Hash The hash of all build inputs.
+ */
+FTerrainMeshCacheWriter::FTerrainMeshCacheWriter(const FString& InFilename, const uint64 Hash)
+{
+	Filename = InFilename;
+	TempFilename = InFilename + TEXT(".tmp");
+	// Initialize the header, the section count and the table offset are patched when closing
+	Header.Magic = TERRAIN_MESH_CACHE_MAGIC;
+	Header.Version = TERRAIN_MESH_CACHE_VERSION;
+	Header.Hash = Hash;
+	Header.SectionCount = 0;
+	Header.TableOffset = 0;
+	// Open the temporary file and write the header
+	Writer = TUniquePtr<FArchive>(IFileManager::Get().CreateFileWriter(*TempFilename));
+	if (Writer.IsValid())
+	{
+		Writer->Serialize(&Header, sizeof(Header));
+	}
+	else
+	{
+		UE_LOG(TerrainMeshCacheWriter, Warning, TEXT("Cache file %s could not be created."), *TempFilename);
+	}
+}
+
+/**
+ * Discards the temporary file, if the writer was not closed.
+ */
+FTerrainMeshCacheWriter::~FTerrainMeshCacheWriter()
+{
+	if (Writer.IsValid())
+	{
+		Writer->Close();
+		Writer.Reset();
+		IFileManager::Get().Delete(*TempFilename);
+	}
+}
+
+/**
+ * Returns <b>true</b>, if the file could be opened and all writes succeeded so far.
+ *
+ * @return The validity flag.
+ */
+bool FTerrainMeshCacheWriter::IsValid() const
+{
+	return Writer.IsValid() && !Writer->IsError();
+}
+
+/**
+ * Writes the specified mesh section.
+ *
+ * @param Section The index of the mesh section.
+ * @param MeshSectionData The mesh section data.
+ */
+void FTerrainMeshCacheWriter::AddSection(const int32 Section, const FMeshSectionData& MeshSectionData)
+{
+	if (!IsValid())
+	{
+		return;
+	}
+
+	// Add the table entry
+	auto& Entry = Entries.AddZeroed_GetRef();
+	Entry.Section = Section;
+	Entry.VertexCount = MeshSectionData.Vertices.Num();
+	Entry.IndexCount = MeshSectionData.Triangles.Num();
+	Entry.DataOffset = Writer->Tell();
+
+	// Convert positions, normals and UV coordinates into one float buffer, missing attributes are written as zero
+	Scratch.Reset(Entry.VertexCount * 8);
+	for (const auto& Vertex : MeshSectionData.Vertices)
+	{
+		Scratch.Append({static_cast<float>(Vertex.X), static_cast<float>(Vertex.Y), static_cast<float>(Vertex.Z)});
+	}
+	for (auto I = 0; I < Entry.VertexCount; I++)
+	{
+		const auto Normal = MeshSectionData.Normals.IsValidIndex(I) ? MeshSectionData.Normals[I] : FVector::Zero();
+		Scratch.Append({static_cast<float>(Normal.X), static_cast<float>(Normal.Y), static_cast<float>(Normal.Z)});
+	}
+	for (auto I = 0; I < Entry.VertexCount; I++)
+	{
+		const auto UV = MeshSectionData.UVs.IsValidIndex(I) ? MeshSectionData.UVs[I] : FVector2D::Zero();
+		Scratch.Append({static_cast<float>(UV.X), static_cast<float>(UV.Y)});
+	}
+	// Write the vertex attributes and the triangle indices
+	Writer->Serialize(Scratch.GetData(), Scratch.Num() * sizeof(float));
+	Writer->Serialize(const_cast<int32*>(MeshSectionData.Triangles.GetData()), Entry.IndexCount * sizeof(int32));
+}
+
+/**
+ * Writes the section table, patches the header and moves the file to its final name.
+ *
+ * @return <b>true</b>, if the cache file was written successfully.
+ */
+bool FTerrainMeshCacheWriter::Close()
+{
+	if (!IsValid())
+	{
+		return false;
+	}
+
+	// Write the section table
+	Header.SectionCount = Entries.Num();
+	Header.TableOffset = Writer->Tell();
+	Writer->Serialize(Entries.GetData(), Entries.Num() * sizeof(FTerrainMeshCacheEntry));
+	// Patch the header
+	Writer->Seek(0);
+	Writer->Serialize(&Header, sizeof(Header));
+	// Close the file
+	const auto bSuccess = Writer->Close();
+	Writer.Reset();
+
+	// Move the file to its final name
+	if (!bSuccess || !IFileManager::Get().Move(*Filename, *TempFilename, true, true))
+	{
+		UE_LOG(TerrainMeshCacheWriter, Warning, TEXT("Cache file %s could not be written."), *Filename);
+		IFileManager::Get().Delete(*TempFilename);
+		return false;
+	}
+
+	// Log
+	UE_LOG(TerrainMeshCacheWriter, Display, TEXT("Cache file %s written (%d sections)."), *Filename, Entries.Num());
+	return true;
+}
@@ -0,0 +1,88 @@
+//
+// (C) Copyright 2024 Dirk Michael
+// dirkmichaelnm@gmail.com
+//
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MeshSectionData.h"
+#include "TerrainMeshCacheFormat.h"
+
+// Defines the log category of this class.
+DECLARE_LOG_CATEGORY_EXTERN(TerrainMeshCacheWriter, Log, All);
+
+/**
+ * This class writes mesh sections into a terrain mesh cache file. The sections are written as soon as they are
+ * added, so the sections do not have to be kept in memory. The file is written to a temporary file first and moved
+ * to its final name when the writer is closed, so a cache file is either complete or missing.
+ */
+class HEXWORLD_API FTerrainMeshCacheWriter
+{
+public:
+	/**
+	 * Opens the temporary file of a new cache file.
+	 *
+	 * @param InFilename The name of the cache file.
+	 * @param Hash The hash of all build inputs.
+	 */
+	FTerrainMeshCacheWriter(const FString& InFilename, const uint64 Hash);
+
+	/**
+	 * Discards the temporary file, if the writer was not closed.
+	 */
+	~FTerrainMeshCacheWriter();
+
+	/**
+	 * Returns <b>true</b>, if the file could be opened and all writes succeeded so far.
+	 *
+	 * @return The validity flag.
+	 */
+	bool IsValid() const;
+
+	/**
+	 * Writes the specified mesh section.
+	 *
+	 * @param Section The index of the mesh section.
+	 * @param MeshSectionData The mesh section data.
+	 */
+	void AddSection(const int32 Section, const FMeshSectionData& MeshSectionData);
+
+	/**
+	 * Writes the section table, patches the header and moves the file to its final name.
+	 *
+	 * @return <b>true</b>, if the cache file was written successfully.
+	 */
+	bool Close();
+
+private:
+	/**
+	 * The name of the cache file.
+	 */
+	FString Filename;
+
+	/**
+	 * The name of the temporary file.
+	 */
+	FString TempFilename;
+
+	/**
+	 * The archive writing the temporary file.
+	 */
+	TUniquePtr<FArchive> Writer;
+
+	/**
+	 * The header of the file.
+	 */
+	FTerrainMeshCacheHeader Header;
+
+	/**
+	 * The section table.
+	 */
+	TArray<FTerrainMeshCacheEntry> Entries;
+
+	/**
+	 * Scratch buffer for converting the vectors into floats.
+	 */
+	TArray<float> Scratch;
+};
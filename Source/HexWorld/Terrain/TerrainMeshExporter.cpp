@@ -0,0 +1,565 @@
+//
+// (C) Copyright 2024 Dirk Michael
+// dirkmichaelnm@gmail.com
+//
+
+#include "TerrainMeshExporter.h"
+
+// Defines the log category of this class.
+DEFINE_LOG_CATEGORY(TerrainMeshExporter)
+
+// The number of bytes collected before a buffer is written to its file
+#define BUFFER_SIZE (1024 * 1024)
+// The factor converting centimeters into meters
+#define METERS_PER_UNIT 0.01
+// The number of digits of the element counts in a PLY header, they are patched when closing the file
+#define PLY_COUNT_DIGITS 12
+// The magic number of a binary glTF file ("glTF")
+#define GLTF_MAGIC 0x46546C67
+// The chunk type of the JSON chunk of a binary glTF file ("JSON")
+#define GLTF_CHUNK_JSON 0x4E4F534A
+// The chunk type of the binary chunk of a binary glTF file ("BIN")
+#define GLTF_CHUNK_BIN 0x004E4942
+
+/**
+ * Creates the export file.
+ *
+ * @param InFilename The name of the export file.
+ * @param InFormat The format of the export file.
+ */
+FTerrainMeshExporter::FTerrainMeshExporter(const FString& InFilename, const ETerrainExportFormat InFormat)
+{
+	Filename = InFilename;
+	// The binary data of a text glTF file is kept next to it
+	SpoolFilename = InFormat == GltfText
+		                ? FPaths::ChangeExtension(InFilename, TEXT("bin"))
+		                : InFilename + TEXT(".spool");
+	Format = InFormat;
+	VertexCount = 0;
+	TriangleCount = 0;
+	VertexCountOffset = 0;
+	FaceCountOffset = 0;
+	Buffer.Reserve(BUFFER_SIZE);
+
+	// Open the export file
+	Writer = TUniquePtr<FArchive>(IFileManager::Get().CreateFileWriter(*Filename));
+	if (!Writer.IsValid())
+	{
+		UE_LOG(TerrainMeshExporter, Warning, TEXT("Export file %s could not be created."), *Filename);
+		return;
+	}
+	// PLY faces and the glTF binary chunk have to follow data that is not known yet, so they are spooled
+	if (Format == PlyText || Format == PlyBinary || Format == GltfBinary || Format == GltfText)
+	{
+		Spool = TUniquePtr<FArchive>(IFileManager::Get().CreateFileWriter(*SpoolFilename));
+		if (!Spool.IsValid())
+		{
+			UE_LOG(TerrainMeshExporter, Warning, TEXT("Spool file %s could not be created."), *SpoolFilename);
+			Writer->SetError();
+			return;
+		}
+		SpoolBuffer.Reserve(BUFFER_SIZE);
+	}
+	// Write the header
+	WriteHeader();
+}
+
+/**
+ * Discards the export file, if the exporter was not closed.
+ */
+FTerrainMeshExporter::~FTerrainMeshExporter()
+{
+	if (Spool.IsValid())
+	{
+		Spool->Close();
+		Spool.Reset();
+		IFileManager::Get().Delete(*SpoolFilename);
+	}
+	if (Writer.IsValid())
+	{
+		Writer->Close();
+		Writer.Reset();
+		IFileManager::Get().Delete(*Filename);
+	}
+}
+
+/**
+ * Returns <b>true</b>, if the files could be opened and all writes succeeded so far.
+ *
+ * @return The validity flag.
+ */
+bool FTerrainMeshExporter::IsValid() const
+{
+	// A spool file that could not be created or written sets the error of the export file
+	const auto bSpoolValid = !Spool.IsValid() || !Spool->IsError();
+	return Writer.IsValid() && !Writer->IsError() && bSpoolValid;
+}
+
+/**
+ * Writes the specified mesh section.
+ *
+ * @param MeshSectionData The mesh section data.
+ */
+void FTerrainMeshExporter::AddSection(const FMeshSectionData& MeshSectionData)
+{
+	if (!IsValid() || MeshSectionData.Vertices.IsEmpty() || MeshSectionData.Triangles.IsEmpty())
+	{
+		return;
+	}
+
+	// Write the section in the chosen format
+	switch (Format)
+	{
+	case ObjText:
+		AddObjSection(MeshSectionData);
+		break;
+	case PlyText:
+	case PlyBinary:
+		AddPlySection(MeshSectionData);
+		break;
+	case GltfBinary:
+	case GltfText:
+		AddGltfSection(MeshSectionData);
+		break;
+	}
+
+	// Count the written elements
+	VertexCount += MeshSectionData.Vertices.Num();
+	TriangleCount += MeshSectionData.Triangles.Num() / 3;
+}
+
+/**
+ * Writes the remaining data and closes the export file.
+ *
+ * @return <b>true</b>, if the export file was written successfully.
+ */
+bool FTerrainMeshExporter::Close()
+{
+	if (!IsValid())
+	{
+		return false;
+	}
+
+	// Write the data that depends on the whole mesh
+	if (Format == PlyText || Format == PlyBinary)
+	{
+		// Append the faces
+		AppendSpool(1);
+		// Patch the element counts in the header
+		Flush(true);
+		ANSICHAR Count[PLY_COUNT_DIGITS + 1];
+		FCStringAnsi::Snprintf(Count, sizeof(Count), "%0*lld", PLY_COUNT_DIGITS, VertexCount);
+		Writer->Seek(VertexCountOffset);
+		Writer->Serialize(Count, PLY_COUNT_DIGITS);
+		FCStringAnsi::Snprintf(Count, sizeof(Count), "%0*lld", PLY_COUNT_DIGITS, TriangleCount);
+		Writer->Seek(FaceCountOffset);
+		Writer->Serialize(Count, PLY_COUNT_DIGITS);
+	}
+	else if (Format == GltfBinary || Format == GltfText)
+	{
+		CloseGltf();
+	}
+
+	// Close the file
+	Flush(true);
+	const auto bSuccess = IsValid() && Writer->Close();
+	Writer.Reset();
+	if (!bSuccess)
+	{
+		UE_LOG(TerrainMeshExporter, Warning, TEXT("Export file %s could not be written."), *Filename);
+		IFileManager::Get().Delete(*Filename);
+		if (Format == GltfText)
+		{
+			IFileManager::Get().Delete(*SpoolFilename);
+		}
+		return false;
+	}
+
+	// Log
+	UE_LOG(TerrainMeshExporter, Display, TEXT("Export file %s written (%lld vertices, %lld triangles)."), *Filename,
+	       VertexCount, TriangleCount);
+	return true;
+}
+
+/**
+ * Writes the header of the export file.
+ */
+void FTerrainMeshExporter::WriteHeader()
+{
+	if (Format == ObjText)
+	{
+		AppendText(Buffer, "# HexWorld terrain\n");
+	}
+	else if (Format == PlyText || Format == PlyBinary)
+	{
+		// The element counts are written as fixed width placeholders that are patched when closing
+		AppendText(Buffer, "ply\n");
+		AppendText(Buffer, Format == PlyText ? "format ascii 1.0\n" : "format binary_little_endian 1.0\n");
+		AppendText(Buffer, "comment HexWorld terrain\n");
+		AppendText(Buffer, "element vertex ");
+		VertexCountOffset = Buffer.Num();
+		AppendText(Buffer, "000000000000\n");
+		AppendText(Buffer, "property float x\nproperty float y\nproperty float z\n");
+		AppendText(Buffer, "property float nx\nproperty float ny\nproperty float nz\n");
+		AppendText(Buffer, "property float s\nproperty float t\n");
+		AppendText(Buffer, "element face ");
+		FaceCountOffset = Buffer.Num();
+		AppendText(Buffer, "000000000000\n");
+		AppendText(Buffer, "property list uchar int vertex_indices\n");
+		AppendText(Buffer, "end_header\n");
+	}
+	// The header of a binary glTF file depends on the whole mesh and is written when closing
+}
+
+/**
+ * Writes a mesh section into an OBJ file.
+ *
+ * @param MeshSectionData The mesh section data.
+ */
+void FTerrainMeshExporter::AddObjSection(const FMeshSectionData& MeshSectionData)
+{
+	ANSICHAR Line[256];
+	const auto Count = MeshSectionData.Vertices.Num();
+
+	// Write positions, normals and UV coordinates
+	for (const auto& Vertex : MeshSectionData.Vertices)
+	{
+		const auto P = ConvertVector(Vertex, METERS_PER_UNIT);
+		const auto Length = FCStringAnsi::Snprintf(Line, sizeof(Line), "v %.7g %.7g %.7g\n", P.X, P.Y, P.Z);
+		AppendText(Buffer, FAnsiStringView(Line, Length));
+		Flush();
+	}
+	for (auto I = 0; I < Count; I++)
+	{
+		const auto Normal = MeshSectionData.Normals.IsValidIndex(I) ? MeshSectionData.Normals[I] : FVector::Zero();
+		const auto N = ConvertVector(Normal, 1.0);
+		const auto Length = FCStringAnsi::Snprintf(Line, sizeof(Line), "vn %.5g %.5g %.5g\n", N.X, N.Y, N.Z);
+		AppendText(Buffer, FAnsiStringView(Line, Length));
+		Flush();
+	}
+	for (auto I = 0; I < Count; I++)
+	{
+		const auto UV = MeshSectionData.UVs.IsValidIndex(I) ? MeshSectionData.UVs[I] : FVector2D::Zero();
+		const auto Length = FCStringAnsi::Snprintf(Line, sizeof(Line), "vt %.7g %.7g\n", UV.X, 1.0 - UV.Y);
+		AppendText(Buffer, FAnsiStringView(Line, Length));
+		Flush();
+	}
+
+	// Write the faces, the indices are one based and continue over all sections
+	const auto& Triangles = MeshSectionData.Triangles;
+	for (auto I = 0; I + 2 < Triangles.Num(); I += 3)
+	{
+		const auto A = VertexCount + Triangles[I] + 1;
+		const auto B = VertexCount + Triangles[I + 1] + 1;
+		const auto C = VertexCount + Triangles[I + 2] + 1;
+		const auto Length = FCStringAnsi::Snprintf(Line, sizeof(Line), "f %lld/%lld/%lld %lld/%lld/%lld %lld/%lld/%lld\n",
+		                                           A, A, A, B, B, B, C, C, C);
+		AppendText(Buffer, FAnsiStringView(Line, Length));
+		Flush();
+	}
+}
+
+/**
+ * Writes a mesh section into a PLY file.
+ *
+ * @param MeshSectionData The mesh section data.
+ */
+void FTerrainMeshExporter::AddPlySection(const FMeshSectionData& MeshSectionData)
+{
+	ANSICHAR Line[256];
+	const auto Count = MeshSectionData.Vertices.Num();
+
+	// Write the vertices into the export file
+	for (auto I = 0; I < Count; I++)
+	{
+		const auto Normal = MeshSectionData.Normals.IsValidIndex(I) ? MeshSectionData.Normals[I] : FVector::Zero();
+		const auto UV = MeshSectionData.UVs.IsValidIndex(I) ? MeshSectionData.UVs[I] : FVector2D::Zero();
+		const auto P = ConvertVector(MeshSectionData.Vertices[I], METERS_PER_UNIT);
+		const auto N = ConvertVector(Normal, 1.0);
+		if (Format == PlyText)
+		{
+			const auto Length = FCStringAnsi::Snprintf(Line, sizeof(Line), "%.7g %.7g %.7g %.5g %.5g %.5g %.7g %.7g\n",
+			                                           P.X, P.Y, P.Z, N.X, N.Y, N.Z, UV.X, 1.0 - UV.Y);
+			AppendText(Buffer, FAnsiStringView(Line, Length));
+		}
+		else
+		{
+			AppendValue(Buffer, P);
+			AppendValue(Buffer, N);
+			AppendValue(Buffer, FVector2f(UV.X, 1.0 - UV.Y));
+		}
+		Flush();
+	}
+
+	// Write the faces into the spool file, the indices continue over all sections
+	const auto& Triangles = MeshSectionData.Triangles;
+	for (auto I = 0; I + 2 < Triangles.Num(); I += 3)
+	{
+		const auto A = static_cast<int32>(VertexCount + Triangles[I]);
+		const auto B = static_cast<int32>(VertexCount + Triangles[I + 1]);
+		const auto C = static_cast<int32>(VertexCount + Triangles[I + 2]);
+		if (Format == PlyText)
+		{
+			const auto Length = FCStringAnsi::Snprintf(Line, sizeof(Line), "3 %d %d %d\n", A, B, C);
+			AppendText(SpoolBuffer, FAnsiStringView(Line, Length));
+		}
+		else
+		{
+			AppendValue(SpoolBuffer, static_cast<uint8>(3));
+			AppendValue(SpoolBuffer, A);
+			AppendValue(SpoolBuffer, B);
+			AppendValue(SpoolBuffer, C);
+		}
+		FlushSpool();
+	}
+}
+
+/**
+ * Writes a mesh section into the binary chunk of a glTF file.
+ *
+ * @param MeshSectionData The mesh section data.
+ */
+void FTerrainMeshExporter::AddGltfSection(const FMeshSectionData& MeshSectionData)
+{
+	// Every section becomes a primitive with its own index range
+	auto& Primitive = Primitives.AddZeroed_GetRef();
+	Primitive.ByteOffset = Spool->Tell() + SpoolBuffer.Num();
+	Primitive.VertexCount = MeshSectionData.Vertices.Num();
+	Primitive.IndexCount = MeshSectionData.Triangles.Num();
+	Primitive.Min = FVector3f(MAX_flt);
+	Primitive.Max = FVector3f(-MAX_flt);
+
+	// Write the positions and track their bounds, which are required by the format
+	for (const auto& Vertex : MeshSectionData.Vertices)
+	{
+		const auto P = ConvertVector(Vertex, METERS_PER_UNIT);
+		Primitive.Min = Primitive.Min.ComponentMin(P);
+		Primitive.Max = Primitive.Max.ComponentMax(P);
+		AppendValue(SpoolBuffer, P);
+		FlushSpool();
+	}
+	// Write the normals
+	for (auto I = 0; I < Primitive.VertexCount; I++)
+	{
+		const auto Normal = MeshSectionData.Normals.IsValidIndex(I) ? MeshSectionData.Normals[I] : FVector::Zero();
+		AppendValue(SpoolBuffer, ConvertVector(Normal, 1.0));
+		FlushSpool();
+	}
+	// Write the UV coordinates
+	for (auto I = 0; I < Primitive.VertexCount; I++)
+	{
+		const auto UV = MeshSectionData.UVs.IsValidIndex(I) ? MeshSectionData.UVs[I] : FVector2D::Zero();
+		AppendValue(SpoolBuffer, FVector2f(UV));
+		FlushSpool();
+	}
+	// Write the indices
+	SpoolBuffer.Append(reinterpret_cast<const uint8*>(MeshSectionData.Triangles.GetData()),
+	                   Primitive.IndexCount * sizeof(int32));
+	FlushSpool();
+}
+
+/**
+ * Writes the JSON chunk of a binary glTF file and appends the binary chunk, or writes the JSON of a text glTF file
+ * and closes its .bin file.
+ */
+void FTerrainMeshExporter::CloseGltf()
+{
+	// The size of the binary chunk padded to four bytes
+	const auto BinaryLength = Align(Spool->Tell() + SpoolBuffer.Num(), 4);
+
+	// Create the buffer views, accessors and primitives, every primitive uses four views
+	FString BufferViews;
+	FString Accessors;
+	FString MeshPrimitives;
+	for (auto I = 0; I < Primitives.Num(); I++)
+	{
+		const auto& Primitive = Primitives[I];
+		const auto Separator = I > 0 ? TEXT(",") : TEXT("");
+		const auto PositionOffset = Primitive.ByteOffset;
+		const auto NormalOffset = PositionOffset + Primitive.VertexCount * 12;
+		const auto UVOffset = NormalOffset + Primitive.VertexCount * 12;
+		const auto IndexOffset = UVOffset + Primitive.VertexCount * 8;
+		BufferViews += FString::Printf(
+			TEXT("%s{\"buffer\":0,\"byteOffset\":%lld,\"byteLength\":%d,\"target\":34962},")
+			TEXT("{\"buffer\":0,\"byteOffset\":%lld,\"byteLength\":%d,\"target\":34962},")
+			TEXT("{\"buffer\":0,\"byteOffset\":%lld,\"byteLength\":%d,\"target\":34962},")
+			TEXT("{\"buffer\":0,\"byteOffset\":%lld,\"byteLength\":%d,\"target\":34963}"), Separator,
+			PositionOffset, Primitive.VertexCount * 12, NormalOffset, Primitive.VertexCount * 12, UVOffset,
+			Primitive.VertexCount * 8, IndexOffset, Primitive.IndexCount * 4);
+		Accessors += FString::Printf(
+			TEXT("%s{\"bufferView\":%d,\"componentType\":5126,\"count\":%d,\"type\":\"VEC3\",")
+			TEXT("\"min\":[%.9g,%.9g,%.9g],\"max\":[%.9g,%.9g,%.9g]},")
+			TEXT("{\"bufferView\":%d,\"componentType\":5126,\"count\":%d,\"type\":\"VEC3\"},")
+			TEXT("{\"bufferView\":%d,\"componentType\":5126,\"count\":%d,\"type\":\"VEC2\"},")
+			TEXT("{\"bufferView\":%d,\"componentType\":5125,\"count\":%d,\"type\":\"SCALAR\"}"), Separator,
+			I * 4, Primitive.VertexCount, Primitive.Min.X, Primitive.Min.Y, Primitive.Min.Z, Primitive.Max.X,
+			Primitive.Max.Y, Primitive.Max.Z, I * 4 + 1, Primitive.VertexCount, I * 4 + 2, Primitive.VertexCount,
+			I * 4 + 3, Primitive.IndexCount);
+		MeshPrimitives += FString::Printf(
+			TEXT("%s{\"attributes\":{\"POSITION\":%d,\"NORMAL\":%d,\"TEXCOORD_0\":%d},\"indices\":%d}"), Separator,
+			I * 4, I * 4 + 1, I * 4 + 2, I * 4 + 3);
+	}
+	// A text glTF file references the .bin file by its relative name
+	const auto Uri = Format == GltfText
+		                 ? FString::Printf(TEXT(",\"uri\":\"%s\""), *FPaths::GetCleanFilename(SpoolFilename))
+		                 : FString();
+	const auto Json = FString::Printf(
+		TEXT("{\"asset\":{\"version\":\"2.0\",\"generator\":\"HexWorld\"},\"scene\":0,\"scenes\":[{\"nodes\":[0]}],")
+		TEXT("\"nodes\":[{\"mesh\":0,\"name\":\"Terrain\"}],\"meshes\":[{\"primitives\":[%s]}],")
+		TEXT("\"buffers\":[{\"byteLength\":%lld%s}],\"bufferViews\":[%s],\"accessors\":[%s]}"),
+		*MeshPrimitives, BinaryLength, *Uri, *BufferViews, *Accessors);
+
+	// The JSON of a text glTF file is the whole file, the .bin file is padded and closed
+	if (Format == GltfText)
+	{
+		while ((Spool->Tell() + SpoolBuffer.Num()) % 4 != 0)
+		{
+			SpoolBuffer.Add(0);
+		}
+		FlushSpool(true);
+		if (!Spool->Close())
+		{
+			Writer->SetError();
+		}
+		Spool.Reset();
+		const FTCHARToUTF8 TextUtf8(*Json);
+		Buffer.Append(reinterpret_cast<const uint8*>(TextUtf8.Get()), TextUtf8.Length());
+		AppendText(Buffer, "\n");
+		return;
+	}
+
+	// Convert the JSON chunk and pad it with spaces
+	const FTCHARToUTF8 JsonUtf8(*Json);
+	const auto JsonLength = Align(JsonUtf8.Length(), 4);
+
+	// The format limits the file size to 4 GB
+	const auto TotalLength = 12 + 8 + static_cast<int64>(JsonLength) + 8 + BinaryLength;
+	if (TotalLength > MAX_uint32)
+	{
+		UE_LOG(TerrainMeshExporter, Warning, TEXT("Export file %s exceeds the size limit of binary glTF."), *Filename);
+		Writer->SetError();
+		return;
+	}
+
+	// Write the file header
+	AppendValue(Buffer, static_cast<uint32>(GLTF_MAGIC));
+	AppendValue(Buffer, static_cast<uint32>(2));
+	AppendValue(Buffer, static_cast<uint32>(TotalLength));
+	// Write the JSON chunk
+	AppendValue(Buffer, static_cast<uint32>(JsonLength));
+	AppendValue(Buffer, static_cast<uint32>(GLTF_CHUNK_JSON));
+	Buffer.Append(reinterpret_cast<const uint8*>(JsonUtf8.Get()), JsonUtf8.Length());
+	while (Buffer.Num() % 4 != 0)
+	{
+		Buffer.Add(' ');
+	}
+	// Write the binary chunk
+	AppendValue(Buffer, static_cast<uint32>(BinaryLength));
+	AppendValue(Buffer, static_cast<uint32>(GLTF_CHUNK_BIN));
+	AppendSpool(4);
+}
+
+/**
+ * Appends the spool file to the export file and deletes it.
+ *
+ * @param Alignment The size the appended data is padded to with zeros.
+ */
+void FTerrainMeshExporter::AppendSpool(const int32 Alignment)
+{
+	// Close the spool file
+	FlushSpool(true);
+	const auto SpoolLength = Spool->Tell();
+	const auto bSpoolWritten = Spool->Close();
+	Spool.Reset();
+	if (!bSpoolWritten)
+	{
+		Writer->SetError();
+		IFileManager::Get().Delete(*SpoolFilename);
+		return;
+	}
+
+	// Copy the spool file block by block
+	const TUniquePtr<FArchive> Reader(IFileManager::Get().CreateFileReader(*SpoolFilename));
+	if (Reader.IsValid())
+	{
+		Flush(true);
+		Buffer.SetNumUninitialized(BUFFER_SIZE);
+		for (int64 Offset = 0; Offset < SpoolLength; Offset += BUFFER_SIZE)
+		{
+			const auto Length = FMath::Min<int64>(BUFFER_SIZE, SpoolLength - Offset);
+			Reader->Serialize(Buffer.GetData(), Length);
+			Writer->Serialize(Buffer.GetData(), Length);
+		}
+		Buffer.Reset();
+		if (Reader->IsError())
+		{
+			Writer->SetError();
+		}
+		Reader->Close();
+	}
+	else
+	{
+		Writer->SetError();
+	}
+	IFileManager::Get().Delete(*SpoolFilename);
+
+	// Pad the appended data
+	for (auto Length = SpoolLength; Length % Alignment != 0; Length++)
+	{
+		Buffer.Add(0);
+	}
+}
+
+/**
+ * Writes the buffer to the export file, if it is full or if flushing is forced.
+ *
+ * @param bForce If <b>true</b>, the buffer is written in any case.
+ */
+void FTerrainMeshExporter::Flush(const bool bForce)
+{
+	if (Buffer.Num() >= BUFFER_SIZE || (bForce && Buffer.Num() > 0))
+	{
+		Writer->Serialize(Buffer.GetData(), Buffer.Num());
+		Buffer.Reset();
+	}
+}
+
+/**
+ * Writes the spool buffer to the spool file, if it is full or if flushing is forced.
+ *
+ * @param bForce If <b>true</b>, the buffer is written in any case.
+ */
+void FTerrainMeshExporter::FlushSpool(const bool bForce)
+{
+	if (SpoolBuffer.Num() >= BUFFER_SIZE || (bForce && SpoolBuffer.Num() > 0))
+	{
+		Spool->Serialize(SpoolBuffer.GetData(), SpoolBuffer.Num());
+		SpoolBuffer.Reset();
+	}
+}
+
+/**
+ * Appends text to the specified buffer.
+ *
+ * @param Target The buffer.
+ * @param Text The text.
+ */
+void FTerrainMeshExporter::AppendText(TArray<uint8>& Target, const FAnsiStringView& Text)
+{
+	Target.Append(reinterpret_cast<const uint8*>(Text.GetData()), Text.Len());
+}
+
+/**
+ * Converts a vector from the Unreal coordinate system into the coordinate system of the export file. Swapping the Y
+ * and Z axes turns the left-handed, Z up system into a right-handed, Y up system and keeps the winding of the
+ * triangles front facing.
+ *
+ * @param Vector The vector in Unreal coordinates.
+ * @param Factor The factor applied to all components.
+ *
+ * @return The converted vector.
+ */
+FVector3f FTerrainMeshExporter::ConvertVector(const FVector& Vector, const double Factor)
+{
+	return FVector3f(Vector.X * Factor, Vector.Z * Factor, Vector.Y * Factor);
+}
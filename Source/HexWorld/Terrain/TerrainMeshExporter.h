@@ -0,0 +1,248 @@
+//
+// (C) Copyright 2024 Dirk Michael
+// dirkmichaelnm@gmail.com
+//
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MeshSectionData.h"
+#include "TerrainExportFormat.h"
+
+// Defines the log category of this class.
+DECLARE_LOG_CATEGORY_EXTERN(TerrainMeshExporter, Log, All);
+
+/**
+ * This class writes mesh sections into an OBJ, PLY or glTF file. The sections are written as soon as they are
+ * added, so the memory needed does not depend on the size of the exported mesh. Data that has to be placed behind
+ * all vertices (PLY faces, glTF binary chunk) is spooled into a temporary file and appended when the exporter is
+ * closed. A text glTF file references its binary data in a .bin file next to it, which is written like the spool
+ * file and kept. The coordinates are converted from Unreal (left-handed, Z up, centimeters) to the right-handed,
+ * Y up coordinate system in meters used by these formats.
+ */
+class HEXWORLD_API FTerrainMeshExporter
+{
+public:
+	/**
+	 * Creates the export file.
+	 *
+	 * @param InFilename The name of the export file.
+	 * @param InFormat The format of the export file.
+	 */
+	FTerrainMeshExporter(const FString& InFilename, const ETerrainExportFormat InFormat);
+
+	/**
+	 * Discards the export file, if the exporter was not closed.
+	 */
+	~FTerrainMeshExporter();
+
+	/**
+	 * Returns <b>true</b>, if the files could be opened and all writes succeeded so far.
+	 *
+	 * @return The validity flag.
+	 */
+	bool IsValid() const;
+
+	/**
+	 * Writes the specified mesh section.
+	 *
+	 * @param MeshSectionData The mesh section data.
+	 */
+	void AddSection(const FMeshSectionData& MeshSectionData);
+
+	/**
+	 * Writes the remaining data and closes the export file.
+	 *
+	 * @return <b>true</b>, if the export file was written successfully.
+	 */
+	bool Close();
+
+	/**
+	 * Returns the number of vertices written so far.
+	 *
+	 * @return The vertex count.
+	 */
+	FORCEINLINE int64 GetVertexCount() const { return VertexCount; }
+
+	/**
+	 * Returns the number of triangles written so far.
+	 *
+	 * @return The triangle count.
+	 */
+	FORCEINLINE int64 GetTriangleCount() const { return TriangleCount; }
+
+private:
+	/**
+	 * A primitive of the glTF file, every mesh section becomes one primitive.
+	 */
+	struct FGltfPrimitive
+	{
+		/**
+		 * The offset of the section data within the binary chunk.
+		 */
+		int64 ByteOffset;
+
+		/**
+		 * The number of vertices.
+		 */
+		int32 VertexCount;
+
+		/**
+		 * The number of triangle indices.
+		 */
+		int32 IndexCount;
+
+		/**
+		 * The minimal position.
+		 */
+		FVector3f Min;
+
+		/**
+		 * The maximal position.
+		 */
+		FVector3f Max;
+	};
+
+	/**
+	 * The name of the export file.
+	 */
+	FString Filename;
+
+	/**
+	 * The name of the temporary spool file, or of the .bin file of a text glTF file.
+	 */
+	FString SpoolFilename;
+
+	/**
+	 * The format of the export file.
+	 */
+	ETerrainExportFormat Format;
+
+	/**
+	 * The archive writing the export file.
+	 */
+	TUniquePtr<FArchive> Writer;
+
+	/**
+	 * The archive writing the spool file.
+	 */
+	TUniquePtr<FArchive> Spool;
+
+	/**
+	 * Buffer collecting the data for the export file.
+	 */
+	TArray<uint8> Buffer;
+
+	/**
+	 * Buffer collecting the data for the spool file.
+	 */
+	TArray<uint8> SpoolBuffer;
+
+	/**
+	 * The number of vertices written so far.
+	 */
+	int64 VertexCount;
+
+	/**
+	 * The number of triangles written so far.
+	 */
+	int64 TriangleCount;
+
+	/**
+	 * The offset of the vertex count within a PLY header.
+	 */
+	int64 VertexCountOffset;
+
+	/**
+	 * The offset of the face count within a PLY header.
+	 */
+	int64 FaceCountOffset;
+
+	/**
+	 * The primitives of a glTF file.
+	 */
+	TArray<FGltfPrimitive> Primitives;
+
+	/**
+	 * Writes the header of the export file.
+	 */
+	void WriteHeader();
+
+	/**
+	 * Writes a mesh section into an OBJ file.
+	 *
+	 * @param MeshSectionData The mesh section data.
+	 */
+	void AddObjSection(const FMeshSectionData& MeshSectionData);
+
+	/**
+	 * Writes a mesh section into a PLY file.
+	 *
+	 * @param MeshSectionData The mesh section data.
+	 */
+	void AddPlySection(const FMeshSectionData& MeshSectionData);
+
+	/**
+	 * Writes a mesh section into the binary chunk of a glTF file.
+	 *
+	 * @param MeshSectionData The mesh section data.
+	 */
+	void AddGltfSection(const FMeshSectionData& MeshSectionData);
+
+	/**
+	 * Writes the JSON chunk of a binary glTF file and appends the binary chunk, or writes the JSON of a text glTF file
+	 * and closes its .bin file.
+	 */
+	void CloseGltf();
+
+	/**
+	 * Appends the spool file to the export file and deletes it.
+	 *
+	 * @param Alignment The size the appended data is padded to with zeros.
+	 */
+	void AppendSpool(const int32 Alignment);
+
+	/**
+	 * Writes the buffer to the export file, if it is full or if flushing is forced.
+	 *
+	 * @param bForce If <b>true</b>, the buffer is written in any case.
+	 */
+	void Flush(const bool bForce = false);
+
+	/**
+	 * Writes the spool buffer to the spool file, if it is full or if flushing is forced.
+	 *
+	 * @param bForce If <b>true</b>, the buffer is written in any case.
+	 */
+	void FlushSpool(const bool bForce = false);
+
+	/**
+	 * Appends text to the specified buffer.
+	 *
+	 * @param Target The buffer.
+	 * @param Text The text.
+	 */
+	static void AppendText(TArray<uint8>& Target, const FAnsiStringView& Text);
+
+	/**
+	 * Appends the raw bytes of a value to the specified buffer.
+	 *
+	 * @param Target The buffer.
+	 * @param Value The value.
+	 */
+	template <typename T>
+	static void AppendValue(TArray<uint8>& Target, const T& Value)
+	{
+		Target.Append(reinterpret_cast<const uint8*>(&Value), sizeof(T));
+	}
+
+	/**
+	 * Converts a vector from the Unreal coordinate system into the coordinate system of the export file.
+	 *
+	 * @param Vector The vector in Unreal coordinates.
+	 * @param Factor The factor applied to all components.
+	 *
+	 * @return The converted vector.
+	 */
+	static FVector3f ConvertVector(const FVector& Vector, const double Factor);
+};
@@ -0,0 +1,352 @@
+//
+// (C) Copyright 2024 Dirk Michael
+// dirkmichaelnm@gmail.com
+//
+
+#include "TerrainSaveFile.h"
+
+#include <atomic>
+#include "Async/ParallelFor.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/Compression.h"
+
+// Defines the log category of this class.
+DEFINE_LOG_CATEGORY(TerrainSaveFile)
+
+// The number of tiles of a chunk
+#define CHUNK_TILES (TERRAIN_SAVE_CHUNK_SIZE * TERRAIN_SAVE_CHUNK_SIZE)
+
+/**
+ * Maps the specified save file and validates its header and tables. No chunk is decompressed yet.
+ *
+ * @param Filename The name of the save file.
+ */
+FTerrainSaveFile::FTerrainSaveFile(const FString& Filename)
+{
+	Data = nullptr;
+	FMemory::Memzero(Header);
+
+	// Map the whole file
+	MappedFile = TUniquePtr<IMappedFileHandle>(FPlatformFileManager::Get().GetPlatformFile().OpenMapped(*Filename));
+	if (!MappedFile.IsValid() || MappedFile->GetFileSize() < static_cast<int64>(sizeof(FTerrainSaveHeader)))
+	{
+		UE_LOG(TerrainSaveFile, Warning, TEXT("Save file %s could not be opened."), *Filename);
+		return;
+	}
+	MappedRegion = TUniquePtr<IMappedFileRegion>(MappedFile->MapRegion(0, MappedFile->GetFileSize()));
+	if (!MappedRegion.IsValid())
+	{
+		return;
+	}
+	const auto Mapped = MappedRegion->GetMappedPtr();
+	const auto Size = MappedRegion->GetMappedSize();
+
+	// Validate the header
+	FMemory::Memcpy(&Header, Mapped, sizeof(Header));
+	if (Header.Magic != TERRAIN_SAVE_MAGIC || Header.Version != TERRAIN_SAVE_VERSION
+		|| Header.ChunkSize != TERRAIN_SAVE_CHUNK_SIZE)
+	{
+		UE_LOG(TerrainSaveFile, Warning, TEXT("Save file %s has an unknown format."), *Filename);
+		return;
+	}
+	const auto ChunkCountX = FMath::DivideAndRoundUp(Header.SizeX, TERRAIN_SAVE_CHUNK_SIZE);
+	const auto ChunkCountY = FMath::DivideAndRoundUp(Header.SizeY, TERRAIN_SAVE_CHUNK_SIZE);
+	const auto LayerTableSize = Header.LayerCount * static_cast<int64>(sizeof(FTerrainSaveLayerEntry));
+	const auto ChunkTableSize = Header.ChunkCount * static_cast<int64>(sizeof(FTerrainSaveChunkEntry));
+	if (Header.SizeX <= 0 || Header.SizeY <= 0 || Header.LayerCount < 0
+		|| Header.ChunkCount != ChunkCountX * ChunkCountY || sizeof(Header) + LayerTableSize + ChunkTableSize > Size)
+	{
+		UE_LOG(TerrainSaveFile, Warning, TEXT("Save file %s is corrupt."), *Filename);
+		return;
+	}
+
+	// Read the layer table
+	auto Offset = static_cast<int64>(sizeof(Header));
+	for (auto Layer = 0; Layer < Header.LayerCount; Layer++)
+	{
+		FTerrainSaveLayerEntry Entry;
+		FMemory::Memcpy(&Entry, Mapped + Offset, sizeof(Entry));
+		Entry.Name[TERRAIN_SAVE_LAYER_NAME_LENGTH - 1] = 0;
+		LayerNames.Add(FName(ANSI_TO_TCHAR(Entry.Name)));
+		Offset += sizeof(Entry);
+	}
+
+	// Read and validate the chunk table
+	const auto UncompressedSize = CHUNK_TILES * (static_cast<int32>(sizeof(int16)) + Header.LayerCount);
+	Entries.SetNumUninitialized(Header.ChunkCount);
+	FMemory::Memcpy(Entries.GetData(), Mapped + Offset, ChunkTableSize);
+	for (const auto& Entry : Entries)
+	{
+		if (Entry.UncompressedSize != UncompressedSize || Entry.CompressedSize <= 0
+			|| Entry.CompressedSize > Entry.UncompressedSize || Entry.DataOffset < Offset + ChunkTableSize
+			|| Entry.DataOffset + Entry.CompressedSize > Size)
+		{
+			UE_LOG(TerrainSaveFile, Warning, TEXT("Save file %s is corrupt."), *Filename);
+			Entries.Empty();
+			LayerNames.Empty();
+			return;
+		}
+	}
+
+	// The file is valid
+	Data = Mapped;
+}
+
+/**
+ * Writes the specified heights and layers into a save file.
+ *
+ * @param Filename The name of the save file.
+ * @param HeightGrid The height grid.
+ * @param LayerNames The names of the layers, they are truncated to 31 characters.
+ * @param Layers The values of the layers, one per tile, Index = X + Y * SizeX.
+ * @param CompressionFormat The compression format of the chunks, e.g. NAME_LZ4 or NAME_Oodle.
+ *
+ * @return <b>true</b>, if the file was written.
+ */
+bool FTerrainSaveFile::Write(const FString& Filename, const FHexHeightGrid& HeightGrid,
+                             const TArray<FName>& LayerNames, const TArray<TArray<uint8>>& Layers,
+                             const FName& CompressionFormat)
+{
+	check(LayerNames.Num() == Layers.Num());
+	if (HeightGrid.IsEmpty())
+	{
+		return false;
+	}
+	const auto StartTime = FPlatformTime::Seconds();
+
+	// Initialize the header
+	auto Header = FTerrainSaveHeader();
+	FMemory::Memzero(Header);
+	Header.Magic = TERRAIN_SAVE_MAGIC;
+	Header.Version = TERRAIN_SAVE_VERSION;
+	Header.SizeX = HeightGrid.GetSizeX();
+	Header.SizeY = HeightGrid.GetSizeY();
+	Header.ChunkSize = TERRAIN_SAVE_CHUNK_SIZE;
+	Header.LayerCount = LayerNames.Num();
+	for (auto Compression = 1; Compression < 4; Compression++)
+	{
+		if (GetCompressionFormat(Compression) == CompressionFormat)
+		{
+			Header.Compression = Compression;
+		}
+	}
+	const auto ChunkCountX = FMath::DivideAndRoundUp(Header.SizeX, TERRAIN_SAVE_CHUNK_SIZE);
+	Header.ChunkCount = ChunkCountX * FMath::DivideAndRoundUp(Header.SizeY, TERRAIN_SAVE_CHUNK_SIZE);
+
+	// Compress the chunks in parallel
+	const auto Format = GetCompressionFormat(Header.Compression);
+	const auto UncompressedSize = CHUNK_TILES * (static_cast<int32>(sizeof(int16)) + Header.LayerCount);
+	auto Chunks = TArray<TArray<uint8>>();
+	Chunks.SetNum(Header.ChunkCount);
+	ParallelFor(Header.ChunkCount, [&](const int32 Chunk)
+	{
+		// Gather the heights and the layers of the chunk, the tiles beyond the edge are zero
+		auto Uncompressed = TArray<uint8>();
+		Uncompressed.SetNumZeroed(UncompressedSize);
+		const auto Heights = reinterpret_cast<int16*>(Uncompressed.GetData());
+		const auto LayerValues = Uncompressed.GetData() + CHUNK_TILES * sizeof(int16);
+		const auto MinX = Chunk % ChunkCountX * TERRAIN_SAVE_CHUNK_SIZE;
+		const auto MinY = Chunk / ChunkCountX * TERRAIN_SAVE_CHUNK_SIZE;
+		const auto Width = FMath::Min(Header.SizeX - MinX, TERRAIN_SAVE_CHUNK_SIZE);
+		const auto Height = FMath::Min(Header.SizeY - MinY, TERRAIN_SAVE_CHUNK_SIZE);
+		for (auto Y = 0; Y < Height; Y++)
+		{
+			for (auto X = 0; X < Width; X++)
+			{
+				const auto Tile = X + Y * TERRAIN_SAVE_CHUNK_SIZE;
+				const auto Index = MinX + X + (MinY + Y) * Header.SizeX;
+				Heights[Tile] = HeightGrid.GetHeight(MinX + X, MinY + Y);
+				for (auto Layer = 0; Layer < Header.LayerCount; Layer++)
+				{
+					const auto& Values = Layers[Layer];
+					LayerValues[Tile + Layer * CHUNK_TILES] = Values.IsValidIndex(Index) ? Values[Index] : 0;
+				}
+			}
+		}
+
+		// Compress the chunk, it is stored uncompressed if that does not pay off
+		auto& Compressed = Chunks[Chunk];
+		if (!Format.IsNone())
+		{
+			auto CompressedSize = FCompression::CompressMemoryBound(Format, UncompressedSize);
+			Compressed.SetNumUninitialized(CompressedSize);
+			if (FCompression::CompressMemory(Format, Compressed.GetData(), CompressedSize, Uncompressed.GetData(),
+			                                 UncompressedSize) && CompressedSize < UncompressedSize)
+			{
+				Compressed.SetNum(CompressedSize);
+				return;
+			}
+		}
+		Compressed = MoveTemp(Uncompressed);
+	});
+
+	// Create the layer table and the chunk table
+	auto LayerEntries = TArray<FTerrainSaveLayerEntry>();
+	LayerEntries.SetNumZeroed(Header.LayerCount);
+	for (auto Layer = 0; Layer < Header.LayerCount; Layer++)
+	{
+		FCStringAnsi::Strncpy(LayerEntries[Layer].Name, TCHAR_TO_ANSI(*LayerNames[Layer].ToString()),
+		                      TERRAIN_SAVE_LAYER_NAME_LENGTH);
+	}
+	auto Entries = TArray<FTerrainSaveChunkEntry>();
+	Entries.SetNumZeroed(Header.ChunkCount);
+	auto Offset = static_cast<int64>(sizeof(Header) + LayerEntries.Num() * sizeof(FTerrainSaveLayerEntry)
+		+ Entries.Num() * sizeof(FTerrainSaveChunkEntry));
+	for (auto Chunk = 0; Chunk < Header.ChunkCount; Chunk++)
+	{
+		Entries[Chunk].DataOffset = Offset;
+		Entries[Chunk].CompressedSize = Chunks[Chunk].Num();
+		Entries[Chunk].UncompressedSize = UncompressedSize;
+		Offset += Chunks[Chunk].Num();
+	}
+
+	// Write the file
+	const auto Writer = TUniquePtr<FArchive>(IFileManager::Get().CreateFileWriter(*Filename));
+	if (!Writer.IsValid())
+	{
+		UE_LOG(TerrainSaveFile, Warning, TEXT("Save file %s could not be created."), *Filename);
+		return false;
+	}
+	Writer->Serialize(&Header, sizeof(Header));
+	Writer->Serialize(LayerEntries.GetData(), LayerEntries.Num() * sizeof(FTerrainSaveLayerEntry));
+	Writer->Serialize(Entries.GetData(), Entries.Num() * sizeof(FTerrainSaveChunkEntry));
+	for (auto& Chunk : Chunks)
+	{
+		Writer->Serialize(Chunk.GetData(), Chunk.Num());
+	}
+	if (!Writer->Close())
+	{
+		UE_LOG(TerrainSaveFile, Warning, TEXT("Save file %s could not be written."), *Filename);
+		return false;
+	}
+
+	// Log
+	UE_LOG(TerrainSaveFile, Display, TEXT("Save file %s written (%.1f ms, %d x %d tiles, %d layers, %.1f KB)."),
+	       *Filename, (FPlatformTime::Seconds() - StartTime) * 1000.0, Header.SizeX, Header.SizeY, Header.LayerCount,
+	       Offset / 1024.0);
+	return true;
+}
+
+/**
+ * Reads the tiles within the specified region. Only the chunks overlapping the region are decompressed, the tiles
+ * outside of the region keep their values.
+ *
+ * @param Region The tile rectangle, the maximum is exclusive.
+ * @param HeightGrid The height grid, it must have the size of the map.
+ * @param Layers The values of the layers in the order of the layer names, missing layers are added.
+ *
+ * @return <b>true</b>, if all chunks were read.
+ */
+bool FTerrainSaveFile::Read(const FIntRect& Region, FHexHeightGrid& HeightGrid, TArray<TArray<uint8>>& Layers) const
+{
+	if (!IsValid() || HeightGrid.GetSizeX() != Header.SizeX || HeightGrid.GetSizeY() != Header.SizeY)
+	{
+		return false;
+	}
+	const auto StartTime = FPlatformTime::Seconds();
+
+	// Prepare the layers
+	Layers.SetNum(Header.LayerCount);
+	for (auto& Layer : Layers)
+	{
+		Layer.SetNumZeroed(Header.SizeX * Header.SizeY);
+	}
+
+	// Collect the chunks overlapping the region
+	const auto Clipped = FIntRect(FIntPoint::ComponentMax(Region.Min, FIntPoint::ZeroValue),
+	                              FIntPoint::ComponentMin(Region.Max, FIntPoint(Header.SizeX, Header.SizeY)));
+	if (Clipped.Min.X >= Clipped.Max.X || Clipped.Min.Y >= Clipped.Max.Y)
+	{
+		return true;
+	}
+	const auto ChunkCountX = FMath::DivideAndRoundUp(Header.SizeX, TERRAIN_SAVE_CHUNK_SIZE);
+	const auto MinChunkX = Clipped.Min.X >> TERRAIN_SAVE_CHUNK_SHIFT;
+	const auto MinChunkY = Clipped.Min.Y >> TERRAIN_SAVE_CHUNK_SHIFT;
+	const auto MaxChunkX = (Clipped.Max.X - 1) >> TERRAIN_SAVE_CHUNK_SHIFT;
+	const auto MaxChunkY = (Clipped.Max.Y - 1) >> TERRAIN_SAVE_CHUNK_SHIFT;
+	auto Chunks = TArray<int32>();
+	for (auto ChunkY = MinChunkY; ChunkY <= MaxChunkY; ChunkY++)
+	{
+		for (auto ChunkX = MinChunkX; ChunkX <= MaxChunkX; ChunkX++)
+		{
+			Chunks.Add(ChunkX + ChunkY * ChunkCountX);
+		}
+	}
+
+	// Decompress the chunks in parallel, every chunk writes its own tiles
+	const auto Format = GetCompressionFormat(Header.Compression);
+	auto FailedChunks = std::atomic<int32>(0);
+	ParallelFor(Chunks.Num(), [&](const int32 Index)
+	{
+		const auto Chunk = Chunks[Index];
+		const auto& Entry = Entries[Chunk];
+		auto Uncompressed = TArray<uint8>();
+		Uncompressed.SetNumUninitialized(Entry.UncompressedSize);
+		if (Entry.CompressedSize == Entry.UncompressedSize)
+		{
+			FMemory::Memcpy(Uncompressed.GetData(), Data + Entry.DataOffset, Entry.UncompressedSize);
+		}
+		else if (Format.IsNone() || !FCompression::UncompressMemory(Format, Uncompressed.GetData(),
+		                                                             Entry.UncompressedSize, Data + Entry.DataOffset,
+		                                                             Entry.CompressedSize))
+		{
+			++FailedChunks;
+			return;
+		}
+
+		// Copy the tiles within the region
+		const auto Heights = reinterpret_cast<const int16*>(Uncompressed.GetData());
+		const auto LayerValues = Uncompressed.GetData() + CHUNK_TILES * sizeof(int16);
+		const auto ChunkMinX = Chunk % ChunkCountX * TERRAIN_SAVE_CHUNK_SIZE;
+		const auto ChunkMinY = Chunk / ChunkCountX * TERRAIN_SAVE_CHUNK_SIZE;
+		const auto MinX = FMath::Max(Clipped.Min.X, ChunkMinX);
+		const auto MinY = FMath::Max(Clipped.Min.Y, ChunkMinY);
+		const auto MaxX = FMath::Min(Clipped.Max.X, ChunkMinX + TERRAIN_SAVE_CHUNK_SIZE);
+		const auto MaxY = FMath::Min(Clipped.Max.Y, ChunkMinY + TERRAIN_SAVE_CHUNK_SIZE);
+		for (auto Y = MinY; Y < MaxY; Y++)
+		{
+			for (auto X = MinX; X < MaxX; X++)
+			{
+				const auto Tile = X - ChunkMinX + (Y - ChunkMinY) * TERRAIN_SAVE_CHUNK_SIZE;
+				HeightGrid.SetHeight(X, Y, Heights[Tile]);
+				for (auto Layer = 0; Layer < Header.LayerCount; Layer++)
+				{
+					Layers[Layer][X + Y * Header.SizeX] = LayerValues[Tile + Layer * CHUNK_TILES];
+				}
+			}
+		}
+	});
+
+	// Log
+	if (FailedChunks > 0)
+	{
+		UE_LOG(TerrainSaveFile, Warning, TEXT("%d chunks of the save file could not be decompressed."),
+		       FailedChunks.load());
+		return false;
+	}
+	UE_LOG(TerrainSaveFile, Display, TEXT("Save file read (%.1f ms, Chunks: %d, Region: %d x %d)."),
+	       (FPlatformTime::Seconds() - StartTime) * 1000.0, Chunks.Num(), Clipped.Width(), Clipped.Height());
+	return true;
+}
+
+/**
+ * Returns the name of the compression format stored in the header.
+ *
+ * @param Compression The compression format stored in the header.
+ *
+ * @return The name of the compression format, NAME_None for uncompressed chunks.
+ */
+FName FTerrainSaveFile::GetCompressionFormat(const int32 Compression)
+{
+	switch (Compression)
+	{
+	case 1:
+		return NAME_LZ4;
+	case 2:
+		return NAME_Oodle;
+	case 3:
+		return NAME_Zlib;
+	default:
+		return NAME_None;
+	}
+}
@@ -0,0 +1,125 @@
+//
+// (C) Copyright 2024 Dirk Michael
+// dirkmichaelnm@gmail.com
+//
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HexHeightGrid.h"
+#include "TerrainSaveFormat.h"
+#include "Async/MappedFileHandle.h"
+
+// Defines the log category of this class.
+DECLARE_LOG_CATEGORY_EXTERN(TerrainSaveFile, Log, All);
+
+/**
+ * This class writes and reads the state of all tiles, i.e. the heights and any number of layers with one byte per
+ * tile, in a versioned binary file. The tiles are split into square chunks that are compressed and decompressed in
+ * parallel, so a region of the map can be loaded without decompressing the other chunks. The file is memory mapped
+ * for reading.
+ */
+class HEXWORLD_API FTerrainSaveFile
+{
+public:
+	/**
+	 * Maps the specified save file and validates its header and tables. No chunk is decompressed yet.
+	 *
+	 * @param Filename The name of the save file.
+	 */
+	explicit FTerrainSaveFile(const FString& Filename);
+
+	/**
+	 * Writes the specified heights and layers into a save file.
+	 *
+	 * @param Filename The name of the save file.
+	 * @param HeightGrid The height grid.
+	 * @param LayerNames The names of the layers, they are truncated to 31 characters.
+	 * @param Layers The values of the layers, one per tile, Index = X + Y * SizeX.
+	 * @param CompressionFormat The compression format of the chunks, e.g. NAME_LZ4 or NAME_Oodle.
+	 *
+	 * @return <b>true</b>, if the file was written.
+	 */
+	static bool Write(const FString& Filename, const FHexHeightGrid& HeightGrid, const TArray<FName>& LayerNames,
+	                  const TArray<TArray<uint8>>& Layers, const FName& CompressionFormat);
+
+	/**
+	 * Returns <b>true</b>, if the file exists and is valid.
+	 *
+	 * @return The validity flag.
+	 */
+	FORCEINLINE bool IsValid() const { return Data != nullptr; }
+
+	/**
+	 * Returns the width of the map counted in tiles.
+	 *
+	 * @return The width.
+	 */
+	FORCEINLINE int32 GetSizeX() const { return Header.SizeX; }
+
+	/**
+	 * Returns the length of the map counted in tiles.
+	 *
+	 * @return The length.
+	 */
+	FORCEINLINE int32 GetSizeY() const { return Header.SizeY; }
+
+	/**
+	 * Returns the names of the layers in the order of the layer table.
+	 *
+	 * @return The layer names.
+	 */
+	FORCEINLINE const TArray<FName>& GetLayerNames() const { return LayerNames; }
+
+	/**
+	 * Reads the tiles within the specified region. Only the chunks overlapping the region are decompressed, the tiles
+	 * outside of the region keep their values.
+	 *
+	 * @param Region The tile rectangle, the maximum is exclusive.
+	 * @param HeightGrid The height grid, it must have the size of the map.
+	 * @param Layers The values of the layers in the order of the layer names, missing layers are added.
+	 *
+	 * @return <b>true</b>, if all chunks were read.
+	 */
+	bool Read(const FIntRect& Region, FHexHeightGrid& HeightGrid, TArray<TArray<uint8>>& Layers) const;
+
+private:
+	/**
+	 * The handle of the mapped file.
+	 */
+	TUniquePtr<IMappedFileHandle> MappedFile;
+
+	/**
+	 * The mapped region covering the whole file.
+	 */
+	TUniquePtr<IMappedFileRegion> MappedRegion;
+
+	/**
+	 * The beginning of the mapped file, <b>nullptr</b> if the file is invalid.
+	 */
+	const uint8* Data;
+
+	/**
+	 * The header of the file.
+	 */
+	FTerrainSaveHeader Header;
+
+	/**
+	 * The names of the layers.
+	 */
+	TArray<FName> LayerNames;
+
+	/**
+	 * The chunk table.
+	 */
+	TArray<FTerrainSaveChunkEntry> Entries;
+
+	/**
+	 * Returns the name of the compression format stored in the header.
+	 *
+	 * @param Compression The compression format stored in the header.
+	 *
+	 * @return The name of the compression format, NAME_None for uncompressed chunks.
+	 */
+	static FName GetCompressionFormat(const int32 Compression);
+};
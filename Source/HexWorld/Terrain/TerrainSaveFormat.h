@@ -0,0 +1,100 @@
+//
+// (C) Copyright 2024 Dirk Michael
+// dirkmichaelnm@gmail.com
+//
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// The magic number at the beginning of a terrain save file ("HXSV")
+#define TERRAIN_SAVE_MAGIC 0x56535848
+// The version of the terrain save file format
+#define TERRAIN_SAVE_VERSION 1
+// The binary logarithm of the number of tiles along each side of a save chunk
+#define TERRAIN_SAVE_CHUNK_SHIFT 6
+// The number of tiles along each side of a save chunk
+#define TERRAIN_SAVE_CHUNK_SIZE (1 << TERRAIN_SAVE_CHUNK_SHIFT)
+// The maximal length of a layer name including the terminating zero
+#define TERRAIN_SAVE_LAYER_NAME_LENGTH 32
+
+/**
+ * The header at the beginning of a terrain save file. It is followed by the layer table, the chunk table and the
+ * compressed chunks. Every chunk contains the heights of TERRAIN_SAVE_CHUNK_SIZE x TERRAIN_SAVE_CHUNK_SIZE tiles as
+ * 16 bit integers followed by one byte per tile for every layer. The chunks at the right and the bottom edge are
+ * padded with zeros.
+ */
+struct FTerrainSaveHeader
+{
+	/**
+	 * The magic number.
+	 */
+	uint32 Magic;
+
+	/**
+	 * The version of the file format.
+	 */
+	uint32 Version;
+
+	/**
+	 * The width of the map counted in tiles.
+	 */
+	int32 SizeX;
+
+	/**
+	 * The length of the map counted in tiles.
+	 */
+	int32 SizeY;
+
+	/**
+	 * The number of tiles along each side of a chunk.
+	 */
+	int32 ChunkSize;
+
+	/**
+	 * The number of chunks.
+	 */
+	int32 ChunkCount;
+
+	/**
+	 * The number of layers.
+	 */
+	int32 LayerCount;
+
+	/**
+	 * The compression format of the chunks (0 = None, 1 = LZ4, 2 = Oodle, 3 = Zlib).
+	 */
+	int32 Compression;
+};
+
+/**
+ * An entry of the layer table.
+ */
+struct FTerrainSaveLayerEntry
+{
+	/**
+	 * The name of the layer as zero terminated ANSI string.
+	 */
+	ANSICHAR Name[TERRAIN_SAVE_LAYER_NAME_LENGTH];
+};
+
+/**
+ * An entry of the chunk table, the chunks are stored in row-major order.
+ */
+struct FTerrainSaveChunkEntry
+{
+	/**
+	 * The offset of the chunk data within the file.
+	 */
+	int64 DataOffset;
+
+	/**
+	 * The size of the compressed chunk data. If it equals the uncompressed size, the chunk is stored uncompressed.
+	 */
+	int32 CompressedSize;
+
+	/**
+	 * The size of the uncompressed chunk data.
+	 */
+	int32 UncompressedSize;
+};
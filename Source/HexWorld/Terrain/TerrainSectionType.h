@@ -0,0 +1,22 @@
+//
+// (C) Copyright 2024 Dirk Michael
+// dirkmichaelnm@gmail.com
+//
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * This enumeration defines the types of mesh sections that are created for every chunk of the terrain. The index of
+ * a mesh section is calculated by Index = Chunk * SectionTypeCount + Type. The collision section is invisible and
+ * the only section with collision enabled.
+ */
+UENUM()
+enum ETerrainSectionType
+{
+	TerrainSection = 0,
+	WaterSection = 1,
+	CollisionSection = 2,
+	SectionTypeCount = 3 UMETA(Hidden)
+};
@@ -30,4 +30,14 @@ struct FTerrainSize
 	 * The minimal Y coordinate.
 	 */
 	double MaximalY;
+
+	/**
+	 * If <b>true</b>, the terrain wraps around along the X axis.
+	 */
+	bool bWrapX;
+
+	/**
+	 * The distance after which the terrain repeats along the X axis, if it wraps around.
+	 */
+	double WrapWidth;
 };
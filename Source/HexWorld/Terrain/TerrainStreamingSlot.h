@@ -0,0 +1,47 @@
+//
+// (C) Copyright 2024 Dirk Michael
+// dirkmichaelnm@gmail.com
+//
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * A slot of mesh sections holding a streamed chunk. The mesh sections of a slot are reused for other chunks, so the
+ * number of mesh sections is bounded by the mesh section budget and not by the size of the map.
+ */
+struct FTerrainStreamingSlot
+{
+	/**
+	 * Creates an empty slot.
+	 */
+	FTerrainStreamingSlot()
+	{
+		Chunk = INDEX_NONE;
+		Coordinates = FIntPoint::ZeroValue;
+		LastUsed = 0.0;
+		Bytes = 0;
+	}
+
+	/**
+	 * The index of the chunk in the slot or INDEX_NONE, if the slot is free.
+	 */
+	int32 Chunk;
+
+	/**
+	 * The coordinates of the chunk in the streaming ring. Beyond the seam of a wrapping terrain the X coordinate
+	 * continues outside of the terrain and the sections are shifted by the wrap width.
+	 */
+	FIntPoint Coordinates;
+
+	/**
+	 * The time the chunk was within the streaming ring the last time.
+	 */
+	double LastUsed;
+
+	/**
+	 * The estimated memory of the mesh sections of the chunk.
+	 */
+	int64 Bytes;
+};
@@ -0,0 +1,114 @@
+//
+// (C) Copyright 2024 Dirk Michael
+// dirkmichaelnm@gmail.com
+//
+
+#include "CoreMinimal.h"
+#include "Async/Async.h"
+#include "Misc/AutomationTest.h"
+#include "../HexTerrainBuilder.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHexTerrainBuilderParallelTest, "HexWorld.Terrain.Builder.ParallelBuild",
+                                 EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+/**
+ * Creates a small grid with land, coast and water tiles.
+ *
+ * @return The height grid.
+ */
+static FHexHeightGrid CreateTestHeightGrid()
+{
+	auto HeightGrid = FHexHeightGrid(24, 20);
+	for (auto Y = 0; Y < HeightGrid.GetSizeY(); Y++)
+	{
+		for (auto X = 0; X < HeightGrid.GetSizeX(); X++)
+		{
+			HeightGrid.SetHeight(X, Y, (X * 7 + Y * 13) % 5 - 1);
+		}
+	}
+	return HeightGrid;
+}
+
+/**
+ * Creates the settings with several chunks and a distortion.
+ *
+ * @return The settings struct.
+ */
+static FHexTerrainSettings CreateTestSettings()
+{
+	auto Settings = FHexTerrainSettings();
+	Settings.ChunkSize = 8;
+	for (auto Params : {&Settings.NoiseParameterX, &Settings.NoiseParameterY, &Settings.NoiseParameterZ})
+	{
+		Params->Size = FVector2D(10.0, 10.0);
+		Params->Offset = FVector2D(0.5, 0.25);
+		Params->Octaves = 2;
+		Params->Frequency = 1.0;
+		Params->Amplitude = 0.2;
+		Params->Redistribution = 1.0;
+	}
+	return Settings;
+}
+
+/**
+ * Builds two terrains on two threads without a world and compares their buffers with a single-threaded build.
+ *
+ * @param Parameters Unused.
+ *
+ * @return <b>true</b>, if the test passed.
+ */
+bool FHexTerrainBuilderParallelTest::RunTest(const FString& Parameters)
+{
+	const auto Settings = CreateTestSettings();
+
+	// The reference generates one chunk after the other on this thread
+	const auto Reference = FHexTerrainBuilder(Settings, CreateTestHeightGrid());
+	auto Chunks = TArray<int32>();
+	auto Expected = TArray<FHexTerrainChunkData>();
+	for (auto Chunk = 0; Chunk < Reference.GetChunkCount(); Chunk++)
+	{
+		Chunks.Add(Chunk);
+		Expected.Add(Reference.GenerateChunk(Chunk));
+	}
+	TestTrue(TEXT("The terrain has several chunks"), Chunks.Num() > 1);
+
+	// Every thread creates its own builder and generates all chunks in parallel
+	auto Futures = TArray<TFuture<TArray<FHexTerrainChunkData>>>();
+	for (auto Thread = 0; Thread < 2; Thread++)
+	{
+		Futures.Add(Async(EAsyncExecution::Thread, [Settings, Chunks]
+		{
+			const auto Builder = FHexTerrainBuilder(Settings, CreateTestHeightGrid());
+			return Builder.GenerateChunks(Chunks);
+		}));
+	}
+
+	// The buffers have to match exactly
+	for (auto Thread = 0; Thread < Futures.Num(); Thread++)
+	{
+		const auto Actual = Futures[Thread].Get();
+		if (!TestEqual(TEXT("Chunk count"), Actual.Num(), Expected.Num()))
+		{
+			continue;
+		}
+		for (auto I = 0; I < Expected.Num(); I++)
+		{
+			TestEqual(TEXT("Chunk index"), Actual[I].Chunk, Expected[I].Chunk);
+			for (auto Type = 0; Type < SectionTypeCount; Type++)
+			{
+				const auto& ActualSection = Actual[I].Sections[Type];
+				const auto& ExpectedSection = Expected[I].Sections[Type];
+				const auto Context = FString::Printf(TEXT("Thread %d, Chunk %d, Section %d"), Thread, I, Type);
+				TestTrue(Context + TEXT(" vertices"), ActualSection.Vertices == ExpectedSection.Vertices);
+				TestTrue(Context + TEXT(" triangles"), ActualSection.Triangles == ExpectedSection.Triangles);
+				TestTrue(Context + TEXT(" normals"), ActualSection.Normals == ExpectedSection.Normals);
+				TestTrue(Context + TEXT(" UVs"), ActualSection.UVs == ExpectedSection.UVs);
+			}
+		}
+	}
+	return true;
+}
+
+#endif
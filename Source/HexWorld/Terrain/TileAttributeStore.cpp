@@ -0,0 +1,176 @@
+//
+// (C) Copyright 2024 Dirk Michael
+// dirkmichaelnm@gmail.com
+//
+
+#include "TileAttributeStore.h"
+
+// Defines the log category of this class.
+DEFINE_LOG_CATEGORY(TileAttributeStore)
+
+/**
+ * Creates an empty store.
+ */
+FTileAttributeStore::FTileAttributeStore()
+{
+	SizeX = 0;
+	SizeY = 0;
+	ChunkSize = 1;
+	ChunkCountX = 0;
+	ChunkCount = 0;
+	ConsumerCount = 0;
+}
+
+/**
+ * Resizes all columns, if the size of the terrain changed. The values are kept, if the size did not change,
+ * otherwise they are cleared and all chunks are marked as dirty.
+ *
+ * @param InSizeX The width of the terrain counted in tiles.
+ * @param InSizeY The length of the terrain counted in tiles.
+ * @param InChunkSize The number of tiles along each side of a chunk.
+ */
+void FTileAttributeStore::Init(const int32 InSizeX, const int32 InSizeY, const int32 InChunkSize)
+{
+	const auto bSameSize = SizeX == FMath::Max(InSizeX, 0) && SizeY == FMath::Max(InSizeY, 0);
+	if (bSameSize && ChunkSize == FMath::Max(InChunkSize, 1))
+	{
+		return;
+	}
+	SizeX = FMath::Max(InSizeX, 0);
+	SizeY = FMath::Max(InSizeY, 0);
+	ChunkSize = FMath::Max(InChunkSize, 1);
+	ChunkCountX = FMath::DivideAndRoundUp(SizeX, ChunkSize);
+	ChunkCount = ChunkCountX * FMath::DivideAndRoundUp(SizeY, ChunkSize);
+
+	// Clear the values of a new size, the chunks are marked as dirty in any case
+	for (auto& Column : Columns)
+	{
+		if (!bSameSize)
+		{
+			Column.Values.Reset();
+			Column.Values.SetNumZeroed(SizeX * SizeY * Column.ElementSize);
+		}
+		for (auto& DirtyChunks : Column.DirtyChunks)
+		{
+			DirtyChunks.Init(true, ChunkCount);
+		}
+	}
+
+	// Log
+	UE_LOG(TileAttributeStore, Display, TEXT("Tile attributes initialized (%d x %d, Attributes: %d, %.1f KB)."),
+	       SizeX, SizeY, Columns.Num(), GetAllocatedSize() / 1024.0);
+}
+
+/**
+ * Registers an attribute with values of the specified size.
+ *
+ * @param Name The name of the attribute.
+ * @param ElementSize The size of a value in bytes.
+ *
+ * @return The index of the attribute.
+ */
+int32 FTileAttributeStore::RegisterAttribute(const FName& Name, const int32 ElementSize)
+{
+	// An attribute is registered only once
+	const auto Existing = FindAttribute(Name);
+	if (Existing != INDEX_NONE)
+	{
+		checkf(Columns[Existing].ElementSize == ElementSize, TEXT("Tile attribute %s has another type."),
+		       *Name.ToString());
+		return Existing;
+	}
+
+	// Add a cleared column, all chunks are dirty for every consumer
+	auto& Column = Columns.AddDefaulted_GetRef();
+	Column.Name = Name;
+	Column.ElementSize = ElementSize;
+	Column.Values.SetNumZeroed(SizeX * SizeY * ElementSize);
+	Column.DirtyChunks.SetNum(ConsumerCount);
+	for (auto& DirtyChunks : Column.DirtyChunks)
+	{
+		DirtyChunks.Init(true, ChunkCount);
+	}
+	return Columns.Num() - 1;
+}
+
+/**
+ * Returns the index of the attribute with the specified name.
+ *
+ * @param Name The name of the attribute.
+ *
+ * @return The index of the attribute or INDEX_NONE, if there is no such attribute.
+ */
+int32 FTileAttributeStore::FindAttribute(const FName& Name) const
+{
+	return Columns.IndexOfByPredicate([&Name](const FColumn& Column) { return Column.Name == Name; });
+}
+
+/**
+ * Registers a consumer of the changes. All chunks are dirty for a new consumer.
+ *
+ * @return The index of the consumer.
+ */
+int32 FTileAttributeStore::RegisterConsumer()
+{
+	for (auto& Column : Columns)
+	{
+		Column.DirtyChunks.Emplace(true, ChunkCount);
+	}
+	return ConsumerCount++;
+}
+
+/**
+ * Returns the chunks with changes of the specified attribute since the last fetch of the consumer and clears them
+ * for the consumer.
+ *
+ * @param Consumer The index of the consumer.
+ * @param Attribute The index of the attribute.
+ *
+ * @return The indices of the dirty chunks, Index = ChunkX + ChunkY * ChunkCountX.
+ */
+TArray<int32> FTileAttributeStore::FetchDirtyChunks(const int32 Consumer, const int32 Attribute)
+{
+	auto Chunks = TArray<int32>();
+	auto& DirtyChunks = Columns[Attribute].DirtyChunks[Consumer];
+	for (TConstSetBitIterator<> It(DirtyChunks); It; ++It)
+	{
+		Chunks.Add(It.GetIndex());
+	}
+	DirtyChunks.SetRange(0, DirtyChunks.Num(), false);
+	return Chunks;
+}
+
+/**
+ * Returns the memory allocated by the columns and the dirty bitmaps.
+ *
+ * @return The allocated memory in bytes.
+ */
+SIZE_T FTileAttributeStore::GetAllocatedSize() const
+{
+	auto Size = Columns.GetAllocatedSize();
+	for (const auto& Column : Columns)
+	{
+		Size += Column.Values.GetAllocatedSize() + Column.DirtyChunks.GetAllocatedSize();
+		for (const auto& DirtyChunks : Column.DirtyChunks)
+		{
+			Size += DirtyChunks.GetAllocatedSize();
+		}
+	}
+	return Size;
+}
+
+/**
+ * Marks the chunk of the specified tile as dirty for all consumers.
+ *
+ * @param Attribute The index of the attribute.
+ * @param X The X coordinate of the tile.
+ * @param Y The Y coordinate of the tile.
+ */
+void FTileAttributeStore::MarkDirty(const int32 Attribute, const int32 X, const int32 Y)
+{
+	const auto Chunk = X / ChunkSize + Y / ChunkSize * ChunkCountX;
+	for (auto& DirtyChunks : Columns[Attribute].DirtyChunks)
+	{
+		DirtyChunks[Chunk] = true;
+	}
+}
@@ -0,0 +1,263 @@
+//
+// (C) Copyright 2024 Dirk Michael
+// dirkmichaelnm@gmail.com
+//
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Defines the log category of this class.
+DECLARE_LOG_CATEGORY_EXTERN(TileAttributeStore, Log, All);
+
+/**
+ * This class stores gameplay attributes of the tiles, e.g. terrain type, owner or visibility, next to the height
+ * grid. Every registered attribute is a tightly packed column with one value per tile, so a pass over one attribute
+ * touches no other data. Changes are tracked per chunk of tiles in one dirty bitmap per consumer, so every
+ * downstream system, e.g. rendering, AI or saving, can fetch only the chunks changed since its last sync.
+ */
+class HEXWORLD_API FTileAttributeStore
+{
+public:
+	/**
+	 * Creates an empty store.
+	 */
+	FTileAttributeStore();
+
+	/**
+	 * Resizes all columns, if the size of the terrain changed. The values are kept, if the size did not change,
+	 * otherwise they are cleared and all chunks are marked as dirty.
+	 *
+	 * @param InSizeX The width of the terrain counted in tiles.
+	 * @param InSizeY The length of the terrain counted in tiles.
+	 * @param InChunkSize The number of tiles along each side of a chunk.
+	 */
+	void Init(const int32 InSizeX, const int32 InSizeY, const int32 InChunkSize);
+
+	/**
+	 * Registers an attribute with the specified value type. Registering an existing name returns the existing
+	 * attribute, its value type must match.
+	 *
+	 * @param Name The name of the attribute.
+	 *
+	 * @return The index of the attribute.
+	 */
+	template <typename T>
+	int32 RegisterAttribute(const FName& Name)
+	{
+		static_assert(TIsTriviallyCopyConstructible<T>::Value, "Tile attributes must be trivially copyable.");
+		return RegisterAttribute(Name, sizeof(T));
+	}
+
+	/**
+	 * Returns the index of the attribute with the specified name.
+	 *
+	 * @param Name The name of the attribute.
+	 *
+	 * @return The index of the attribute or INDEX_NONE, if there is no such attribute.
+	 */
+	int32 FindAttribute(const FName& Name) const;
+
+	/**
+	 * Returns the number of registered attributes.
+	 *
+	 * @return The attribute count.
+	 */
+	FORCEINLINE int32 GetAttributeCount() const { return Columns.Num(); }
+
+	/**
+	 * Returns the name of the specified attribute.
+	 *
+	 * @param Attribute The index of the attribute.
+	 *
+	 * @return The name.
+	 */
+	FORCEINLINE const FName& GetAttributeName(const int32 Attribute) const { return Columns[Attribute].Name; }
+
+	/**
+	 * Returns the size of a value of the specified attribute in bytes.
+	 *
+	 * @param Attribute The index of the attribute.
+	 *
+	 * @return The value size.
+	 */
+	FORCEINLINE int32 GetElementSize(const int32 Attribute) const { return Columns[Attribute].ElementSize; }
+
+	/**
+	 * Registers a consumer of the changes. All chunks are dirty for a new consumer.
+	 *
+	 * @return The index of the consumer.
+	 */
+	int32 RegisterConsumer();
+
+	/**
+	 * Returns the value of an attribute of the tile at the specified coordinates, which must be within the terrain.
+	 *
+	 * @param Attribute The index of the attribute.
+	 * @param X The X coordinate of the tile.
+	 * @param Y The Y coordinate of the tile.
+	 *
+	 * @return The value.
+	 */
+	template <typename T>
+	FORCEINLINE T Get(const int32 Attribute, const int32 X, const int32 Y) const
+	{
+		return GetColumn<T>(Attribute)[X + Y * SizeX];
+	}
+
+	/**
+	 * Sets the value of an attribute of the tile at the specified coordinates, which must be within the terrain. Only
+	 * a real change marks the chunk of the tile as dirty.
+	 *
+	 * @param Attribute The index of the attribute.
+	 * @param X The X coordinate of the tile.
+	 * @param Y The Y coordinate of the tile.
+	 * @param Value The new value.
+	 */
+	template <typename T>
+	void Set(const int32 Attribute, const int32 X, const int32 Y, const T& Value)
+	{
+		auto& Stored = GetMutableColumn<T>(Attribute)[X + Y * SizeX];
+		if (FMemory::Memcmp(&Stored, &Value, sizeof(T)) != 0)
+		{
+			Stored = Value;
+			MarkDirty(Attribute, X, Y);
+		}
+	}
+
+	/**
+	 * Returns the values of an attribute of all tiles, e.g. for a pass over the whole terrain.
+	 *
+	 * @param Attribute The index of the attribute.
+	 *
+	 * @return The values, Index = X + Y * SizeX.
+	 */
+	template <typename T>
+	TArrayView<const T> GetColumn(const int32 Attribute) const
+	{
+		const auto& Column = Columns[Attribute];
+		check(Column.ElementSize == sizeof(T));
+		return TArrayView<const T>(reinterpret_cast<const T*>(Column.Values.GetData()), SizeX * SizeY);
+	}
+
+	/**
+	 * Returns the chunks with changes of the specified attribute since the last fetch of the consumer and clears
+	 * them for the consumer.
+	 *
+	 * @param Consumer The index of the consumer.
+	 * @param Attribute The index of the attribute.
+	 *
+	 * @return The indices of the dirty chunks, Index = ChunkX + ChunkY * ChunkCountX.
+	 */
+	TArray<int32> FetchDirtyChunks(const int32 Consumer, const int32 Attribute);
+
+	/**
+	 * Returns the number of tiles along each side of a chunk.
+	 *
+	 * @return The chunk size.
+	 */
+	FORCEINLINE int32 GetChunkSize() const { return ChunkSize; }
+
+	/**
+	 * Returns the memory allocated by the columns and the dirty bitmaps.
+	 *
+	 * @return The allocated memory in bytes.
+	 */
+	SIZE_T GetAllocatedSize() const;
+
+private:
+	/**
+	 * The values of an attribute and its dirty bitmaps.
+	 */
+	struct FColumn
+	{
+		/**
+		 * The name of the attribute.
+		 */
+		FName Name;
+
+		/**
+		 * The size of a value in bytes.
+		 */
+		int32 ElementSize;
+
+		/**
+		 * The values of all tiles, Index = X + Y * SizeX.
+		 */
+		TArray<uint8> Values;
+
+		/**
+		 * The dirty flags of the chunks for every consumer, Index = ChunkX + ChunkY * ChunkCountX.
+		 */
+		TArray<TBitArray<>> DirtyChunks;
+	};
+
+	/**
+	 * The width of the terrain counted in tiles.
+	 */
+	int32 SizeX;
+
+	/**
+	 * The length of the terrain counted in tiles.
+	 */
+	int32 SizeY;
+
+	/**
+	 * The number of tiles along each side of a chunk.
+	 */
+	int32 ChunkSize;
+
+	/**
+	 * The number of chunks along the X axis.
+	 */
+	int32 ChunkCountX;
+
+	/**
+	 * The number of chunks.
+	 */
+	int32 ChunkCount;
+
+	/**
+	 * The number of registered consumers.
+	 */
+	int32 ConsumerCount;
+
+	/**
+	 * The columns of the registered attributes.
+	 */
+	TArray<FColumn> Columns;
+
+	/**
+	 * Registers an attribute with values of the specified size.
+	 *
+	 * @param Name The name of the attribute.
+	 * @param ElementSize The size of a value in bytes.
+	 *
+	 * @return The index of the attribute.
+	 */
+	int32 RegisterAttribute(const FName& Name, const int32 ElementSize);
+
+	/**
+	 * Returns the values of an attribute of all tiles for writing.
+	 *
+	 * @param Attribute The index of the attribute.
+	 *
+	 * @return The values, Index = X + Y * SizeX.
+	 */
+	template <typename T>
+	TArrayView<T> GetMutableColumn(const int32 Attribute)
+	{
+		auto& Column = Columns[Attribute];
+		check(Column.ElementSize == sizeof(T));
+		return TArrayView<T>(reinterpret_cast<T*>(Column.Values.GetData()), SizeX * SizeY);
+	}
+
+	/**
+	 * Marks the chunk of the specified tile as dirty for all consumers.
+	 *
+	 * @param Attribute The index of the attribute.
+	 * @param X The X coordinate of the tile.
+	 * @param Y The Y coordinate of the tile.
+	 */
+	void MarkDirty(const int32 Attribute, const int32 X, const int32 Y);
+};
@@ -0,0 +1,52 @@
+//
+// (C) Copyright 2024 Dirk Michael
+// dirkmichaelnm@gmail.com
+//
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "TileChangeBatch.generated.h"
+
+/**
+ * This struct contains the tiles changed within a frame. Every tile is contained only once, no matter how often it
+ * was changed, and the chunks of the changed tiles are summarized for bulk updates.
+ */
+USTRUCT(BlueprintType)
+struct FTileChangeBatch
+{
+	GENERATED_BODY()
+
+	/**
+	 * Creates an empty batch.
+	 */
+	FTileChangeBatch()
+	{
+		bHeightsChanged = false;
+		bTileDataChanged = false;
+	}
+
+	/**
+	 * The coordinates of the changed tiles in row-major order.
+	 */
+	UPROPERTY(BlueprintReadOnly, Category = "Tile Changes")
+	TArray<FIntPoint> Tiles;
+
+	/**
+	 * The indices of the chunks containing changed tiles in ascending order, Index = ChunkX + ChunkY * ChunkCountX.
+	 */
+	UPROPERTY(BlueprintReadOnly, Category = "Tile Changes")
+	TArray<int32> Chunks;
+
+	/**
+	 * If <b>true</b>, the height of at least one tile changed.
+	 */
+	UPROPERTY(BlueprintReadOnly, Category = "Tile Changes")
+	bool bHeightsChanged;
+
+	/**
+	 * If <b>true</b>, the tile data of at least one tile changed.
+	 */
+	UPROPERTY(BlueprintReadOnly, Category = "Tile Changes")
+	bool bTileDataChanged;
+};
@@ -0,0 +1,125 @@
+//
+// (C) Copyright 2024 Dirk Michael
+// dirkmichaelnm@gmail.com
+//
+
+#include "TileChangeHub.h"
+
+#include "Algo/Unique.h"
+
+// Defines the log category of this class.
+DEFINE_LOG_CATEGORY(TileChangeHub)
+
+/**
+ * Creates an empty hub.
+ */
+FTileChangeHub::FTileChangeHub()
+{
+	SizeX = 0;
+	SizeY = 0;
+	ChunkSize = 1;
+	ChunkCountX = 0;
+	bHeightsChanged = false;
+	bTileDataChanged = false;
+}
+
+/**
+ * Resizes the hub, if the size of the terrain changed. Pending changes of another size are discarded.
+ *
+ * @param InSizeX The width of the terrain counted in tiles.
+ * @param InSizeY The length of the terrain counted in tiles.
+ * @param InChunkSize The number of tiles along each side of a chunk.
+ */
+void FTileChangeHub::Init(const int32 InSizeX, const int32 InSizeY, const int32 InChunkSize)
+{
+	if (SizeX == FMath::Max(InSizeX, 0) && SizeY == FMath::Max(InSizeY, 0) && ChunkSize == FMath::Max(InChunkSize, 1))
+	{
+		return;
+	}
+	SizeX = FMath::Max(InSizeX, 0);
+	SizeY = FMath::Max(InSizeY, 0);
+	ChunkSize = FMath::Max(InChunkSize, 1);
+	ChunkCountX = FMath::DivideAndRoundUp(SizeX, ChunkSize);
+	ChangedTiles.Init(false, SizeX * SizeY);
+	PendingTiles.Reset();
+	bHeightsChanged = false;
+	bTileDataChanged = false;
+}
+
+/**
+ * Adds the specified tiles to the changes of the current frame.
+ *
+ * @param Tiles The coordinates of the changed tiles.
+ * @param bHeights If <b>true</b>, the heights changed, otherwise the tile data.
+ */
+void FTileChangeHub::AddChanges(const TArray<FIntPoint>& Tiles, const bool bHeights)
+{
+	for (const auto& Tile : Tiles)
+	{
+		AddChange(Tile.X, Tile.Y, bHeights);
+	}
+}
+
+/**
+ * Adds the specified tile to the changes of the current frame.
+ *
+ * @param X The X coordinate of the tile.
+ * @param Y The Y coordinate of the tile.
+ * @param bHeights If <b>true</b>, the height changed, otherwise the tile data.
+ */
+void FTileChangeHub::AddChange(const int32 X, const int32 Y, const bool bHeights)
+{
+	if (X < 0 || X >= SizeX || Y < 0 || Y >= SizeY)
+	{
+		return;
+	}
+	(bHeights ? bHeightsChanged : bTileDataChanged) = true;
+	// A tile changed several times within a frame is dispatched only once
+	const auto Index = X + Y * SizeX;
+	if (!ChangedTiles[Index])
+	{
+		ChangedTiles[Index] = true;
+		PendingTiles.Add(Index);
+	}
+}
+
+/**
+ * Dispatches the changes of the current frame as one batch to all subscribers.
+ *
+ * @return The dispatched batch, empty if there were no changes.
+ */
+FTileChangeBatch FTileChangeHub::Dispatch()
+{
+	auto Batch = FTileChangeBatch();
+	if (!HasChanges())
+	{
+		return Batch;
+	}
+
+	// Collect the tiles in row-major order and summarize their chunks
+	PendingTiles.Sort();
+	Batch.Tiles.Reserve(PendingTiles.Num());
+	for (const auto Index : PendingTiles)
+	{
+		const auto X = Index % SizeX;
+		const auto Y = Index / SizeX;
+		Batch.Tiles.Add(FIntPoint(X, Y));
+		Batch.Chunks.Add(X / ChunkSize + Y / ChunkSize * ChunkCountX);
+		ChangedTiles[Index] = false;
+	}
+	Batch.Chunks.Sort();
+	Batch.Chunks.SetNum(Algo::Unique(Batch.Chunks));
+	Batch.bHeightsChanged = bHeightsChanged;
+	Batch.bTileDataChanged = bTileDataChanged;
+
+	// The next frame starts without changes, subscribers may already add new ones
+	PendingTiles.Reset();
+	bHeightsChanged = false;
+	bTileDataChanged = false;
+
+	// Log
+	UE_LOG(TileChangeHub, Verbose, TEXT("Tile changes dispatched (Tiles: %d, Chunks: %d)."), Batch.Tiles.Num(),
+	       Batch.Chunks.Num());
+	Delegate.Broadcast(Batch);
+	return Batch;
+}
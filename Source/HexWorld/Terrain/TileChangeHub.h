@@ -0,0 +1,122 @@
+//
+// (C) Copyright 2024 Dirk Michael
+// dirkmichaelnm@gmail.com
+//
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "TileChangeBatch.h"
+
+// Defines the log category of this class.
+DECLARE_LOG_CATEGORY_EXTERN(TileChangeHub, Log, All);
+
+// The delegate receiving the tile changes of a frame
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnTileChangeBatch, const FTileChangeBatch&);
+
+/**
+ * This class collects the changes of tiles, e.g. all dabs of a brush stroke, and dispatches them once per frame as a
+ * single batch to every subscriber, e.g. minimap, pathfinding caches or fog of war. Tiles changed several times are
+ * contained only once, so the subscribers can do bulk incremental updates instead of reacting to every change.
+ */
+class HEXWORLD_API FTileChangeHub
+{
+public:
+	/**
+	 * Creates an empty hub.
+	 */
+	FTileChangeHub();
+
+	/**
+	 * Resizes the hub, if the size of the terrain changed. Pending changes of another size are discarded.
+	 *
+	 * @param InSizeX The width of the terrain counted in tiles.
+	 * @param InSizeY The length of the terrain counted in tiles.
+	 * @param InChunkSize The number of tiles along each side of a chunk.
+	 */
+	void Init(const int32 InSizeX, const int32 InSizeY, const int32 InChunkSize);
+
+	/**
+	 * Returns the delegate the subscribers are added to.
+	 *
+	 * @return The delegate.
+	 */
+	FORCEINLINE FOnTileChangeBatch& OnTileChanges() { return Delegate; }
+
+	/**
+	 * Adds the specified tiles to the changes of the current frame.
+	 *
+	 * @param Tiles The coordinates of the changed tiles.
+	 * @param bHeights If <b>true</b>, the heights changed, otherwise the tile data.
+	 */
+	void AddChanges(const TArray<FIntPoint>& Tiles, const bool bHeights);
+
+	/**
+	 * Adds the specified tile to the changes of the current frame.
+	 *
+	 * @param X The X coordinate of the tile.
+	 * @param Y The Y coordinate of the tile.
+	 * @param bHeights If <b>true</b>, the height changed, otherwise the tile data.
+	 */
+	void AddChange(const int32 X, const int32 Y, const bool bHeights);
+
+	/**
+	 * Returns <b>true</b>, if there are changes that were not dispatched yet.
+	 *
+	 * @return The pending flag.
+	 */
+	FORCEINLINE bool HasChanges() const { return !PendingTiles.IsEmpty(); }
+
+	/**
+	 * Dispatches the changes of the current frame as one batch to all subscribers.
+	 *
+	 * @return The dispatched batch, empty if there were no changes.
+	 */
+	FTileChangeBatch Dispatch();
+
+private:
+	/**
+	 * The width of the terrain counted in tiles.
+	 */
+	int32 SizeX;
+
+	/**
+	 * The length of the terrain counted in tiles.
+	 */
+	int32 SizeY;
+
+	/**
+	 * The number of tiles along each side of a chunk.
+	 */
+	int32 ChunkSize;
+
+	/**
+	 * The number of chunks along the X axis.
+	 */
+	int32 ChunkCountX;
+
+	/**
+	 * The flags of the changed tiles, Index = X + Y * SizeX.
+	 */
+	TBitArray<> ChangedTiles;
+
+	/**
+	 * The indices of the changed tiles in the order of their first change.
+	 */
+	TArray<int32> PendingTiles;
+
+	/**
+	 * If <b>true</b>, a height changed in the current frame.
+	 */
+	bool bHeightsChanged;
+
+	/**
+	 * If <b>true</b>, tile data changed in the current frame.
+	 */
+	bool bTileDataChanged;
+
+	/**
+	 * The subscribers.
+	 */
+	FOnTileChangeBatch Delegate;
+};
@@ -0,0 +1,273 @@
+//
+// (C) Copyright 2024 Dirk Michael
+// dirkmichaelnm@gmail.com
+//
+
+#include "TileDataBuffer.h"
+
+#include "Engine/Texture2D.h"
+
+// Defines the log category of this class.
+DEFINE_LOG_CATEGORY(TileDataBuffer)
+
+// The width and length of a dirty block counted in tiles
+#define BLOCK_SIZE 16
+
+/**
+ * Creates an empty buffer.
+ */
+FTileDataBuffer::FTileDataBuffer()
+{
+	SizeX = 0;
+	SizeY = 0;
+	BlockCountX = 0;
+	DirtyBlockCount = 0;
+}
+
+/**
+ * Resizes the buffer and creates the texture, if the size of the terrain changed. The tile data is kept, if the size
+ * did not change.
+ *
+ * @param InSizeX The width of the terrain counted in tiles.
+ * @param InSizeY The length of the terrain counted in tiles.
+ * @param Outer The owner of a new texture.
+ *
+ * @return The texture, which is a new one if the size changed.
+ */
+UTexture2D* FTileDataBuffer::Init(const int32 InSizeX, const int32 InSizeY, UObject* Outer)
+{
+	// Keep the tile data of a terrain with the same size
+	if (Texture.IsValid() && SizeX == FMath::Max(InSizeX, 1) && SizeY == FMath::Max(InSizeY, 1))
+	{
+		return Texture.Get();
+	}
+	SizeX = FMath::Max(InSizeX, 1);
+	SizeY = FMath::Max(InSizeY, 1);
+	BlockCountX = FMath::DivideAndRoundUp(SizeX, BLOCK_SIZE);
+	// Clear the tile data
+	Pixels.Reset();
+	Pixels.SetNumZeroed(SizeX * SizeY);
+
+	// Create a texture with one pixel per tile, unless the current one has the right size
+	if (!Texture.IsValid() || Texture->GetSizeX() != SizeX || Texture->GetSizeY() != SizeY)
+	{
+		const auto NewTexture = UTexture2D::CreateTransient(SizeX, SizeY, PF_B8G8R8A8, TEXT("Tile Data Texture"));
+		NewTexture->Rename(nullptr, Outer);
+		NewTexture->CompressionSettings = TC_VectorDisplacementmap;
+		NewTexture->Filter = TF_Nearest;
+		NewTexture->AddressX = TA_Clamp;
+		NewTexture->AddressY = TA_Clamp;
+		NewTexture->SRGB = false;
+		NewTexture->UpdateResource();
+		Texture = NewTexture;
+	}
+
+	// The whole texture is uploaded with the next flush
+	DirtyBlocks.Init(true, BlockCountX * FMath::DivideAndRoundUp(SizeY, BLOCK_SIZE));
+	DirtyBlockCount = DirtyBlocks.Num();
+
+	// Log
+	UE_LOG(TileDataBuffer, Display, TEXT("Tile data initialized (%d x %d)."), SizeX, SizeY);
+	return Texture.Get();
+}
+
+/**
+ * Returns the value of a channel of the tile at the specified coordinates.
+ *
+ * @param X The X coordinate of the tile.
+ * @param Y The Y coordinate of the tile.
+ * @param Channel The data channel.
+ *
+ * @return The value, zero for coordinates outside of the terrain.
+ */
+uint8 FTileDataBuffer::GetTileData(const int32 X, const int32 Y, const ETileDataChannel Channel) const
+{
+	if (X < 0 || X >= SizeX || Y < 0 || Y >= SizeY || Pixels.IsEmpty())
+	{
+		return 0;
+	}
+	auto Pixel = Pixels[X + Y * SizeX];
+	return GetChannel(Pixel, Channel);
+}
+
+/**
+ * Sets the value of a channel of the tile at the specified coordinates. The texture is updated when the buffer is
+ * flushed.
+ *
+ * @param X The X coordinate of the tile.
+ * @param Y The Y coordinate of the tile.
+ * @param Channel The data channel.
+ * @param Value The new value.
+ *
+ * @return <b>true</b>, if the value changed.
+ */
+bool FTileDataBuffer::SetTileData(const int32 X, const int32 Y, const ETileDataChannel Channel, const uint8 Value)
+{
+	if (X < 0 || X >= SizeX || Y < 0 || Y >= SizeY || Pixels.IsEmpty())
+	{
+		return false;
+	}
+	// Only real changes mark the block as dirty
+	auto& Byte = GetChannel(Pixels[X + Y * SizeX], Channel);
+	if (Byte == Value)
+	{
+		return false;
+	}
+	Byte = Value;
+	const auto Block = X / BLOCK_SIZE + Y / BLOCK_SIZE * BlockCountX;
+	if (!DirtyBlocks[Block])
+	{
+		DirtyBlocks[Block] = true;
+		DirtyBlockCount++;
+	}
+	return true;
+}
+
+/**
+ * Returns the values of a channel of all tiles, e.g. for saving them.
+ *
+ * @param Channel The data channel.
+ *
+ * @return The values, Index = X + Y * SizeX.
+ */
+TArray<uint8> FTileDataBuffer::ReadChannel(const ETileDataChannel Channel) const
+{
+	auto Values = TArray<uint8>();
+	Values.SetNumUninitialized(Pixels.Num());
+	for (auto Index = 0; Index < Pixels.Num(); Index++)
+	{
+		auto Pixel = Pixels[Index];
+		Values[Index] = GetChannel(Pixel, Channel);
+	}
+	return Values;
+}
+
+/**
+ * Sets the values of a channel of the tiles within the specified region. Only the blocks with real changes are
+ * marked as dirty.
+ *
+ * @param Channel The data channel.
+ * @param Values The values of all tiles, Index = X + Y * SizeX.
+ * @param Region The tile rectangle, the maximum is exclusive.
+ *
+ * @return The coordinates of the changed tiles.
+ */
+TArray<FIntPoint> FTileDataBuffer::WriteChannel(const ETileDataChannel Channel, const TArray<uint8>& Values,
+                                                const FIntRect& Region)
+{
+	auto ChangedTiles = TArray<FIntPoint>();
+	if (Values.Num() != Pixels.Num())
+	{
+		return ChangedTiles;
+	}
+	for (auto Y = FMath::Max(Region.Min.Y, 0); Y < FMath::Min(Region.Max.Y, SizeY); Y++)
+	{
+		for (auto X = FMath::Max(Region.Min.X, 0); X < FMath::Min(Region.Max.X, SizeX); X++)
+		{
+			if (SetTileData(X, Y, Channel, Values[X + Y * SizeX]))
+			{
+				ChangedTiles.Add(FIntPoint(X, Y));
+			}
+		}
+	}
+	return ChangedTiles;
+}
+
+/**
+ * Uploads all dirty blocks into the texture with a single region update.
+ */
+void FTileDataBuffer::Flush()
+{
+	// Keep the changes until the texture can be updated
+	const auto TargetTexture = Texture.Get();
+	if (!IsDirty() || TargetTexture == nullptr || TargetTexture->GetResource() == nullptr)
+	{
+		return;
+	}
+
+	// Combine consecutive dirty blocks of a block row into one region. The regions are stacked in the staging
+	// buffer, so all of them share one pitch.
+	auto Regions = TArray<FUpdateTextureRegion2D>();
+	auto StagingWidth = 0;
+	auto StagingHeight = 0;
+	const auto BlockCountY = DirtyBlocks.Num() / BlockCountX;
+	for (auto BlockY = 0; BlockY < BlockCountY; BlockY++)
+	{
+		for (auto BlockX = 0; BlockX < BlockCountX; BlockX++)
+		{
+			if (!DirtyBlocks[BlockX + BlockY * BlockCountX])
+			{
+				continue;
+			}
+			// Find the end of the run
+			auto EndX = BlockX + 1;
+			while (EndX < BlockCountX && DirtyBlocks[EndX + BlockY * BlockCountX])
+			{
+				EndX++;
+			}
+			// Clip the region to the texture
+			const auto DestX = BlockX * BLOCK_SIZE;
+			const auto DestY = BlockY * BLOCK_SIZE;
+			const auto Width = FMath::Min(EndX * BLOCK_SIZE, SizeX) - DestX;
+			const auto Height = FMath::Min(DestY + BLOCK_SIZE, SizeY) - DestY;
+			Regions.Add(FUpdateTextureRegion2D(DestX, DestY, 0, StagingHeight, Width, Height));
+			StagingWidth = FMath::Max(StagingWidth, Width);
+			StagingHeight += Height;
+			BlockX = EndX;
+		}
+	}
+
+	// Copy the pixels of the regions into the staging buffer, which is owned by the render thread from now on
+	const auto Staging = new TArray<FColor>();
+	Staging->SetNumUninitialized(StagingWidth * StagingHeight);
+	for (const auto& Region : Regions)
+	{
+		for (auto Row = 0u; Row < Region.Height; Row++)
+		{
+			FMemory::Memcpy(&(*Staging)[(Region.SrcY + Row) * StagingWidth],
+			                &Pixels[Region.DestX + (Region.DestY + Row) * SizeX], Region.Width * sizeof(FColor));
+		}
+	}
+	const auto RegionData = new FUpdateTextureRegion2D[Regions.Num()];
+	FMemory::Memcpy(RegionData, Regions.GetData(), Regions.Num() * sizeof(FUpdateTextureRegion2D));
+
+	// Upload all regions at once, the buffers are deleted after the upload
+	TargetTexture->UpdateTextureRegions(0, Regions.Num(), RegionData, StagingWidth * sizeof(FColor), sizeof(FColor),
+	                                    reinterpret_cast<uint8*>(Staging->GetData()),
+	                                    [Staging](uint8*, const FUpdateTextureRegion2D* UploadedRegions)
+	                                    {
+		                                    delete Staging;
+		                                    delete[] UploadedRegions;
+	                                    });
+
+	// Log
+	UE_LOG(TileDataBuffer, Verbose, TEXT("Tile data flushed (Blocks: %d, Regions: %d, Bytes: %d)."),
+	       DirtyBlockCount, Regions.Num(), StagingWidth * StagingHeight * static_cast<int32>(sizeof(FColor)));
+
+	// All blocks are clean again
+	DirtyBlocks.SetRange(0, DirtyBlocks.Num(), false);
+	DirtyBlockCount = 0;
+}
+
+/**
+ * Returns a reference to the byte of the specified channel within the specified pixel.
+ *
+ * @param Pixel The pixel.
+ * @param Channel The data channel.
+ *
+ * @return The channel byte.
+ */
+uint8& FTileDataBuffer::GetChannel(FColor& Pixel, const ETileDataChannel Channel)
+{
+	switch (Channel)
+	{
+	case HighlightChannel:
+		return Pixel.R;
+	case OwnerChannel:
+		return Pixel.G;
+	case FogChannel:
+		return Pixel.B;
+	default:
+		return Pixel.A;
+	}
+}
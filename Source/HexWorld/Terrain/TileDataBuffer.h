@@ -0,0 +1,149 @@
+//
+// (C) Copyright 2024 Dirk Michael
+// dirkmichaelnm@gmail.com
+//
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "TileDataChannel.h"
+
+// Defines the log category of this class.
+DECLARE_LOG_CATEGORY_EXTERN(TileDataBuffer, Log, All);
+
+/**
+ * This class holds the visual state of every tile, e.g. highlight, owner tint, fog and biome, as one pixel per tile
+ * on the CPU and uploads it into a texture sampled by the terrain material. Changes only mark square blocks of tiles
+ * as dirty, all dirty blocks are uploaded together with a single region update when the buffer is flushed, so many
+ * changes within a frame cost one small upload and no mesh rebuild.
+ */
+class HEXWORLD_API FTileDataBuffer
+{
+public:
+	/**
+	 * Creates an empty buffer.
+	 */
+	FTileDataBuffer();
+
+	/**
+	 * Resizes the buffer and creates the texture, if the size of the terrain changed. The tile data is kept, if the
+	 * size did not change.
+	 *
+	 * @param InSizeX The width of the terrain counted in tiles.
+	 * @param InSizeY The length of the terrain counted in tiles.
+	 * @param Outer The owner of a new texture.
+	 *
+	 * @return The texture, which is a new one if the size changed.
+	 */
+	UTexture2D* Init(const int32 InSizeX, const int32 InSizeY, UObject* Outer);
+
+	/**
+	 * Returns the texture, it is <b>nullptr</b> until the buffer was initialized.
+	 *
+	 * @return The texture.
+	 */
+	FORCEINLINE UTexture2D* GetTexture() const { return Texture.Get(); }
+
+	/**
+	 * Returns the value of a channel of the tile at the specified coordinates.
+	 *
+	 * @param X The X coordinate of the tile.
+	 * @param Y The Y coordinate of the tile.
+	 * @param Channel The data channel.
+	 *
+	 * @return The value, zero for coordinates outside of the terrain.
+	 */
+	uint8 GetTileData(const int32 X, const int32 Y, const ETileDataChannel Channel) const;
+
+	/**
+	 * Sets the value of a channel of the tile at the specified coordinates. The texture is updated when the buffer is
+	 * flushed.
+	 *
+	 * @param X The X coordinate of the tile.
+	 * @param Y The Y coordinate of the tile.
+	 * @param Channel The data channel.
+	 * @param Value The new value.
+	 *
+	 * @return <b>true</b>, if the value changed.
+	 */
+	bool SetTileData(const int32 X, const int32 Y, const ETileDataChannel Channel, const uint8 Value);
+
+	/**
+	 * Returns the values of a channel of all tiles, e.g. for saving them.
+	 *
+	 * @param Channel The data channel.
+	 *
+	 * @return The values, Index = X + Y * SizeX.
+	 */
+	TArray<uint8> ReadChannel(const ETileDataChannel Channel) const;
+
+	/**
+	 * Sets the values of a channel of the tiles within the specified region. Only the blocks with real changes are
+	 * marked as dirty.
+	 *
+	 * @param Channel The data channel.
+	 * @param Values The values of all tiles, Index = X + Y * SizeX.
+	 * @param Region The tile rectangle, the maximum is exclusive.
+	 *
+	 * @return The coordinates of the changed tiles.
+	 */
+	TArray<FIntPoint> WriteChannel(const ETileDataChannel Channel, const TArray<uint8>& Values, const FIntRect& Region);
+
+	/**
+	 * Returns <b>true</b>, if there are changes that were not uploaded yet.
+	 *
+	 * @return The dirty flag.
+	 */
+	FORCEINLINE bool IsDirty() const { return DirtyBlockCount > 0; }
+
+	/**
+	 * Uploads all dirty blocks into the texture with a single region update.
+	 */
+	void Flush();
+
+private:
+	/**
+	 * The width of the terrain counted in tiles.
+	 */
+	int32 SizeX;
+
+	/**
+	 * The length of the terrain counted in tiles.
+	 */
+	int32 SizeY;
+
+	/**
+	 * The number of blocks along the X axis.
+	 */
+	int32 BlockCountX;
+
+	/**
+	 * The number of dirty blocks.
+	 */
+	int32 DirtyBlockCount;
+
+	/**
+	 * The pixels of all tiles, Index = X + Y * SizeX.
+	 */
+	TArray<FColor> Pixels;
+
+	/**
+	 * The dirty flags of the blocks, Index = BlockX + BlockY * BlockCountX.
+	 */
+	TBitArray<> DirtyBlocks;
+
+	/**
+	 * The texture the pixels are uploaded to. It is referenced by the material and the owner of the buffer.
+	 */
+	TWeakObjectPtr<UTexture2D> Texture;
+
+	/**
+	 * Returns a reference to the byte of the specified channel within the specified pixel.
+	 *
+	 * @param Pixel The pixel.
+	 * @param Channel The data channel.
+	 *
+	 * @return The channel byte.
+	 */
+	static uint8& GetChannel(FColor& Pixel, const ETileDataChannel Channel);
+};
@@ -0,0 +1,25 @@
+//
+// (C) Copyright 2024 Dirk Michael
+// dirkmichaelnm@gmail.com
+//
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * This enumeration defines the channels of the tile data texture. Every channel stores one byte per tile, the value
+ * is interpreted by the terrain material.
+ */
+UENUM(BlueprintType)
+enum ETileDataChannel
+{
+	// The highlight intensity of the tile (texture channel R)
+	HighlightChannel = 0,
+	// The index of the owner whose tint is applied to the tile (texture channel G)
+	OwnerChannel = 1,
+	// The fog of war density above the tile (texture channel B)
+	FogChannel = 2,
+	// The index of the biome of the tile (texture channel A)
+	BiomeChannel = 3
+};